@@ -18,7 +18,9 @@ CREATE TABLE IF NOT EXISTS generation_runs (
     config JSONB NOT NULL,
     error TEXT NULL,
     request_id TEXT NULL,
-    updated_at TIMESTAMPTZ NOT NULL DEFAULT NOW()
+    updated_at TIMESTAMPTZ NOT NULL DEFAULT NOW(),
+    rollups_enabled BOOLEAN NOT NULL DEFAULT FALSE,
+    stats_enabled BOOLEAN NOT NULL DEFAULT FALSE
 );
 
 -- Table: host_telemetry_archival
@@ -39,14 +41,16 @@ CREATE TABLE IF NOT EXISTS host_telemetry_archival (
     run_id UUID NOT NULL REFERENCES generation_runs(run_id),
     is_anomaly BOOLEAN NOT NULL DEFAULT FALSE,
     anomaly_type TEXT NULL,
-    PRIMARY KEY (ingestion_time, record_id)
+    -- run_id is part of the key so months can be sub-partitioned by HASH(run_id)
+    PRIMARY KEY (ingestion_time, run_id, record_id)
 ) PARTITION BY RANGE (ingestion_time);
 
 -- Default partition for catching data outside specific ranges
 CREATE TABLE IF NOT EXISTS host_telemetry_archival_default 
     PARTITION OF host_telemetry_archival DEFAULT;
 
--- Initial partitions (e.g. for Jan 2026)
+-- Initial partitions (e.g. for Jan 2026); later months are created ahead of
+-- time by the services (DbClient::MaintainPartitions)
 CREATE TABLE IF NOT EXISTS host_telemetry_archival_2026_01 
     PARTITION OF host_telemetry_archival 
     FOR VALUES FROM ('2026-01-01') TO ('2026-02-01');
@@ -60,7 +64,8 @@ CREATE INDEX IF NOT EXISTS idx_telemetry_run_id ON host_telemetry_archival(run_i
 CREATE INDEX IF NOT EXISTS idx_telemetry_run_anomaly ON host_telemetry_archival(run_id, is_anomaly);
 CREATE INDEX IF NOT EXISTS idx_telemetry_host_ts ON host_telemetry_archival(host_id, metric_timestamp);
 CREATE INDEX IF NOT EXISTS idx_telemetry_region_ts ON host_telemetry_archival(region, metric_timestamp);
-CREATE INDEX IF NOT EXISTS idx_telemetry_run_ts ON host_telemetry_archival(run_id, metric_timestamp);
+-- Also serves keyset pagination of record search (metric_timestamp, record_id)
+CREATE INDEX IF NOT EXISTS idx_telemetry_run_ts_record ON host_telemetry_archival(run_id, metric_timestamp, record_id);
 CREATE INDEX IF NOT EXISTS idx_telemetry_run_type ON host_telemetry_archival(run_id, anomaly_type);
 CREATE INDEX IF NOT EXISTS idx_generation_runs_request_id ON generation_runs(request_id);
 -- BRIN index is good for naturally ordered time-series data
@@ -68,6 +73,65 @@ CREATE INDEX IF NOT EXISTS idx_telemetry_brin_ts ON host_telemetry_archival USIN
 -- GIN index for JSONB labels querying
 CREATE INDEX IF NOT EXISTS idx_telemetry_labels ON host_telemetry_archival USING GIN(labels);
 
+-- Table: telemetry_rollups
+-- Per-run time-bucket aggregates maintained at ingest (resolutions 1m/5m/1h/1d)
+CREATE OR REPLACE FUNCTION rollup_sketch_merge(a BIGINT[], b BIGINT[]) RETURNS BIGINT[] AS $$
+    SELECT COALESCE(array_agg(COALESCE(x, 0) + COALESCE(y, 0) ORDER BY i), '{}'::BIGINT[])
+    FROM unnest(a, b) WITH ORDINALITY AS t(x, y, i)
+$$ LANGUAGE SQL IMMUTABLE;
+
+DROP AGGREGATE IF EXISTS rollup_sketch_sum(BIGINT[]);
+CREATE AGGREGATE rollup_sketch_sum(BIGINT[]) (
+    SFUNC = rollup_sketch_merge,
+    STYPE = BIGINT[]
+);
+
+CREATE TABLE IF NOT EXISTS telemetry_rollups (
+    run_id UUID NOT NULL REFERENCES generation_runs(run_id) ON DELETE CASCADE,
+    resolution_seconds INT NOT NULL,
+    bucket_ts TIMESTAMPTZ NOT NULL,
+    region TEXT NOT NULL,
+    is_anomaly BOOLEAN NOT NULL,
+    metric TEXT NOT NULL,
+    count BIGINT NOT NULL,
+    sum DOUBLE PRECISION NOT NULL,
+    sumsq DOUBLE PRECISION NOT NULL,
+    min DOUBLE PRECISION NOT NULL,
+    max DOUBLE PRECISION NOT NULL,
+    sketch BIGINT[] NOT NULL,
+    PRIMARY KEY (run_id, resolution_seconds, metric, region, is_anomaly, bucket_ts)
+);
+
+-- Tables: dataset_stats, dataset_metric_stats, dataset_anomaly_type_counts
+-- Per-run stats catalog maintained at ingest (row count, time bounds,
+-- Welford moments per metric, anomaly type counts)
+CREATE TABLE IF NOT EXISTS dataset_stats (
+    run_id UUID PRIMARY KEY REFERENCES generation_runs(run_id) ON DELETE CASCADE,
+    row_count BIGINT NOT NULL DEFAULT 0,
+    anomaly_count BIGINT NOT NULL DEFAULT 0,
+    min_ts TIMESTAMPTZ NULL,
+    max_ts TIMESTAMPTZ NULL,
+    updated_at TIMESTAMPTZ NOT NULL DEFAULT NOW()
+);
+
+CREATE TABLE IF NOT EXISTS dataset_metric_stats (
+    run_id UUID NOT NULL REFERENCES generation_runs(run_id) ON DELETE CASCADE,
+    metric TEXT NOT NULL,
+    count BIGINT NOT NULL,
+    mean DOUBLE PRECISION NOT NULL,
+    m2 DOUBLE PRECISION NOT NULL,
+    min DOUBLE PRECISION NOT NULL,
+    max DOUBLE PRECISION NOT NULL,
+    PRIMARY KEY (run_id, metric)
+);
+
+CREATE TABLE IF NOT EXISTS dataset_anomaly_type_counts (
+    run_id UUID NOT NULL REFERENCES generation_runs(run_id) ON DELETE CASCADE,
+    anomaly_type TEXT NOT NULL,
+    count BIGINT NOT NULL,
+    PRIMARY KEY (run_id, anomaly_type)
+);
+
 -- Table: alerts
 -- Stores anomalies detected by fusion engine
 CREATE TABLE IF NOT EXISTS alerts (
@@ -154,16 +218,45 @@ CREATE TABLE IF NOT EXISTS dataset_score_jobs (
     completed_at TIMESTAMPTZ NULL
 );
 
-CREATE TABLE IF NOT EXISTS dataset_scores (
-    score_id BIGSERIAL PRIMARY KEY,
+-- Table: dataset_score_sets
+-- One row per scored (dataset, model) pair; scored_at is its last insert
+CREATE TABLE IF NOT EXISTS dataset_score_sets (
+    score_set_id SERIAL PRIMARY KEY,
     dataset_id UUID NOT NULL REFERENCES generation_runs(run_id),
     model_run_id UUID NOT NULL REFERENCES model_runs(model_run_id),
+    scored_at TIMESTAMPTZ NOT NULL DEFAULT NOW(),
+    UNIQUE (dataset_id, model_run_id)
+);
+
+CREATE INDEX IF NOT EXISTS idx_score_sets_model ON dataset_score_sets(model_run_id);
+
+-- Table: dataset_scores
+-- List-partitioned by score set (dataset_scores_<score_set_id>, created by
+-- the services) so deleting or rescoring a pair drops a table. Columns are
+-- ordered widest first to avoid alignment padding.
+CREATE TABLE IF NOT EXISTS dataset_scores (
     record_id BIGINT NOT NULL,
     reconstruction_error DOUBLE PRECISION NOT NULL,
-    predicted_is_anomaly BOOLEAN NOT NULL,
-    scored_at TIMESTAMPTZ NOT NULL DEFAULT NOW()
-);
+    score_set_id INTEGER NOT NULL,
+    predicted_is_anomaly BOOLEAN NOT NULL
+) PARTITION BY LIST (score_set_id);
+
+-- Holds every set when SCORE_SET_PARTITIONS=false
+CREATE TABLE IF NOT EXISTS dataset_scores_default
+    PARTITION OF dataset_scores DEFAULT;
 
 CREATE INDEX IF NOT EXISTS idx_score_jobs_request_id ON dataset_score_jobs(request_id);
-CREATE INDEX IF NOT EXISTS idx_scores_dataset_model ON dataset_scores(dataset_id, model_run_id);
 CREATE INDEX IF NOT EXISTS idx_scores_record_id ON dataset_scores(record_id);
+CREATE INDEX IF NOT EXISTS idx_scores_default_set ON dataset_scores_default(score_set_id);
+
+-- Table: dataset_eval_aggregates
+-- Confusion counts, error histogram and per-dimension error stats saved by a
+-- completed score job (see src/eval_aggregates.h)
+CREATE TABLE IF NOT EXISTS dataset_eval_aggregates (
+    dataset_id UUID NOT NULL REFERENCES generation_runs(run_id) ON DELETE CASCADE,
+    model_run_id UUID NOT NULL REFERENCES model_runs(model_run_id) ON DELETE CASCADE,
+    samples BIGINT NOT NULL,
+    aggregates JSONB NOT NULL,
+    updated_at TIMESTAMPTZ NOT NULL DEFAULT NOW(),
+    PRIMARY KEY (dataset_id, model_run_id)
+);
@@ -0,0 +1,32 @@
+-- Migration: Pre-aggregated time-bucket rollups maintained at ingest
+-- Existing runs keep rollups_enabled = FALSE and are served from the raw table.
+
+ALTER TABLE generation_runs ADD COLUMN IF NOT EXISTS rollups_enabled BOOLEAN NOT NULL DEFAULT FALSE;
+
+-- Elementwise sum of two sketch bin arrays (see telemetry::rollup::QuantileSketch)
+CREATE OR REPLACE FUNCTION rollup_sketch_merge(a BIGINT[], b BIGINT[]) RETURNS BIGINT[] AS $$
+    SELECT COALESCE(array_agg(COALESCE(x, 0) + COALESCE(y, 0) ORDER BY i), '{}'::BIGINT[])
+    FROM unnest(a, b) WITH ORDINALITY AS t(x, y, i)
+$$ LANGUAGE SQL IMMUTABLE;
+
+DROP AGGREGATE IF EXISTS rollup_sketch_sum(BIGINT[]);
+CREATE AGGREGATE rollup_sketch_sum(BIGINT[]) (
+    SFUNC = rollup_sketch_merge,
+    STYPE = BIGINT[]
+);
+
+CREATE TABLE IF NOT EXISTS telemetry_rollups (
+    run_id UUID NOT NULL REFERENCES generation_runs(run_id) ON DELETE CASCADE,
+    resolution_seconds INT NOT NULL, -- 60, 300, 3600, 86400
+    bucket_ts TIMESTAMPTZ NOT NULL,
+    region TEXT NOT NULL,
+    is_anomaly BOOLEAN NOT NULL,
+    metric TEXT NOT NULL,
+    count BIGINT NOT NULL,
+    sum DOUBLE PRECISION NOT NULL,
+    sumsq DOUBLE PRECISION NOT NULL,
+    min DOUBLE PRECISION NOT NULL,
+    max DOUBLE PRECISION NOT NULL,
+    sketch BIGINT[] NOT NULL,
+    PRIMARY KEY (run_id, resolution_seconds, metric, region, is_anomaly, bucket_ts)
+);
@@ -0,0 +1,33 @@
+-- Migration: Per-dataset stats catalog maintained at ingest
+-- Runs created before this migration get their catalog built once when they
+-- transition to SUCCEEDED; until then analytics fall back to raw scans.
+
+ALTER TABLE generation_runs ADD COLUMN IF NOT EXISTS stats_enabled BOOLEAN NOT NULL DEFAULT FALSE;
+
+CREATE TABLE IF NOT EXISTS dataset_stats (
+    run_id UUID PRIMARY KEY REFERENCES generation_runs(run_id) ON DELETE CASCADE,
+    row_count BIGINT NOT NULL DEFAULT 0,
+    anomaly_count BIGINT NOT NULL DEFAULT 0,
+    min_ts TIMESTAMPTZ NULL,
+    max_ts TIMESTAMPTZ NULL,
+    updated_at TIMESTAMPTZ NOT NULL DEFAULT NOW()
+);
+
+-- Welford moments per metric; m2 is the sum of squared deviations from mean
+CREATE TABLE IF NOT EXISTS dataset_metric_stats (
+    run_id UUID NOT NULL REFERENCES generation_runs(run_id) ON DELETE CASCADE,
+    metric TEXT NOT NULL,
+    count BIGINT NOT NULL,
+    mean DOUBLE PRECISION NOT NULL,
+    m2 DOUBLE PRECISION NOT NULL,
+    min DOUBLE PRECISION NOT NULL,
+    max DOUBLE PRECISION NOT NULL,
+    PRIMARY KEY (run_id, metric)
+);
+
+CREATE TABLE IF NOT EXISTS dataset_anomaly_type_counts (
+    run_id UUID NOT NULL REFERENCES generation_runs(run_id) ON DELETE CASCADE,
+    anomaly_type TEXT NOT NULL,
+    count BIGINT NOT NULL,
+    PRIMARY KEY (run_id, anomaly_type)
+);
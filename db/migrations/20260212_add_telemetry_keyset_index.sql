@@ -0,0 +1,6 @@
+-- Migration: Keyset pagination index for record search
+-- Record search pages by (metric_timestamp, record_id) within a run; this
+-- index supersedes idx_telemetry_run_ts (same leading columns).
+
+CREATE INDEX IF NOT EXISTS idx_telemetry_run_ts_record ON host_telemetry_archival(run_id, metric_timestamp, record_id);
+DROP INDEX IF EXISTS idx_telemetry_run_ts;
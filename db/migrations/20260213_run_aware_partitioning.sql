@@ -0,0 +1,28 @@
+-- Migration: Run-aware partitioning and partition-drop retention
+-- Month partitions may now be sub-partitioned by HASH(run_id)
+-- (PARTITION_HASH_MODULUS). Postgres requires every partition key in the
+-- primary key of a partitioned table, so run_id joins it. Existing month
+-- partitions keep their layout; new months are created by the services.
+
+ALTER TABLE host_telemetry_archival DROP CONSTRAINT IF EXISTS host_telemetry_archival_pkey;
+ALTER TABLE host_telemetry_archival ADD PRIMARY KEY (ingestion_time, run_id, record_id);
+
+-- Retention now drops whole month partitions from the services
+-- (TELEMETRY_RETENTION_DAYS); the row-deleting procedure is kept only for
+-- manual use and no longer scans dataset_scores with NOT IN.
+CREATE OR REPLACE PROCEDURE cleanup_old_telemetry(retention_days INT)
+LANGUAGE plpgsql
+AS $$
+BEGIN
+    DELETE FROM dataset_scores s
+    USING host_telemetry_archival t
+    WHERE s.dataset_id = t.run_id
+      AND s.record_id = t.record_id
+      AND t.ingestion_time < NOW() - (retention_days || ' days')::interval;
+
+    DELETE FROM host_telemetry_archival
+    WHERE ingestion_time < NOW() - (retention_days || ' days')::interval;
+
+    COMMIT;
+END;
+$$;
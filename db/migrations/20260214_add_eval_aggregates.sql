@@ -0,0 +1,13 @@
+-- Migration: Eval aggregates persisted by score jobs
+-- A score job that scores a dataset from the first row saves its confusion
+-- counts, error histogram and per-dimension error stats here on completion;
+-- /eval and /error_distribution read them instead of scanning dataset_scores.
+
+CREATE TABLE IF NOT EXISTS dataset_eval_aggregates (
+    dataset_id UUID NOT NULL REFERENCES generation_runs(run_id) ON DELETE CASCADE,
+    model_run_id UUID NOT NULL REFERENCES model_runs(model_run_id) ON DELETE CASCADE,
+    samples BIGINT NOT NULL,
+    aggregates JSONB NOT NULL,
+    updated_at TIMESTAMPTZ NOT NULL DEFAULT NOW(),
+    PRIMARY KEY (dataset_id, model_run_id)
+);
@@ -0,0 +1,77 @@
+-- Migration: Compact dataset_scores keyed by score set
+-- Each scored (dataset, model) pair gets a dataset_score_sets row. Score rows
+-- carry its 4-byte id instead of two UUIDs, a BIGSERIAL and a timestamp, and
+-- are list-partitioned by it so deleting or rescoring a pair drops a table.
+-- scored_at moves to the set. Existing scores are copied into per-set
+-- partitions.
+
+BEGIN;
+
+CREATE TABLE IF NOT EXISTS dataset_score_sets (
+    score_set_id SERIAL PRIMARY KEY,
+    dataset_id UUID NOT NULL REFERENCES generation_runs(run_id),
+    model_run_id UUID NOT NULL REFERENCES model_runs(model_run_id),
+    scored_at TIMESTAMPTZ NOT NULL DEFAULT NOW(),
+    UNIQUE (dataset_id, model_run_id)
+);
+
+CREATE INDEX IF NOT EXISTS idx_score_sets_model ON dataset_score_sets(model_run_id);
+
+ALTER TABLE dataset_scores RENAME TO dataset_scores_legacy;
+DROP INDEX IF EXISTS idx_scores_dataset_model;
+DROP INDEX IF EXISTS idx_scores_record_id;
+
+CREATE TABLE dataset_scores (
+    record_id BIGINT NOT NULL,
+    reconstruction_error DOUBLE PRECISION NOT NULL,
+    score_set_id INTEGER NOT NULL,
+    predicted_is_anomaly BOOLEAN NOT NULL
+) PARTITION BY LIST (score_set_id);
+
+CREATE TABLE dataset_scores_default PARTITION OF dataset_scores DEFAULT;
+
+INSERT INTO dataset_score_sets (dataset_id, model_run_id, scored_at)
+SELECT dataset_id, model_run_id, MAX(scored_at)
+FROM dataset_scores_legacy
+GROUP BY dataset_id, model_run_id;
+
+DO $$
+DECLARE
+    s RECORD;
+BEGIN
+    FOR s IN SELECT score_set_id FROM dataset_score_sets LOOP
+        EXECUTE format('CREATE TABLE dataset_scores_%s PARTITION OF dataset_scores FOR VALUES IN (%s)',
+                       s.score_set_id, s.score_set_id);
+    END LOOP;
+END;
+$$;
+
+INSERT INTO dataset_scores (record_id, reconstruction_error, score_set_id, predicted_is_anomaly)
+SELECT l.record_id, l.reconstruction_error, ss.score_set_id, l.predicted_is_anomaly
+FROM dataset_scores_legacy l
+JOIN dataset_score_sets ss ON ss.dataset_id = l.dataset_id AND ss.model_run_id = l.model_run_id;
+
+DROP TABLE dataset_scores_legacy;
+
+CREATE INDEX IF NOT EXISTS idx_scores_record_id ON dataset_scores(record_id);
+CREATE INDEX IF NOT EXISTS idx_scores_default_set ON dataset_scores_default(score_set_id);
+
+CREATE OR REPLACE PROCEDURE cleanup_old_telemetry(retention_days INT)
+LANGUAGE plpgsql
+AS $$
+BEGIN
+    DELETE FROM dataset_scores s
+    USING dataset_score_sets ss, host_telemetry_archival t
+    WHERE s.score_set_id = ss.score_set_id
+      AND ss.dataset_id = t.run_id
+      AND s.record_id = t.record_id
+      AND t.ingestion_time < NOW() - (retention_days || ' days')::interval;
+
+    DELETE FROM host_telemetry_archival
+    WHERE ingestion_time < NOW() - (retention_days || ' days')::interval;
+
+    COMMIT;
+END;
+$$;
+
+COMMIT;
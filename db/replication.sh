@@ -0,0 +1,5 @@
+#!/bin/bash
+# Lets the streaming read replica (docker-compose.infra.yml, profile
+# "replica") take a base backup and follow this server's WAL.
+set -e
+echo "host replication all all scram-sha-256" >> "$PGDATA/pg_hba.conf"
@@ -0,0 +1,137 @@
+#include "analytics_cache.h"
+#include <spdlog/spdlog.h>
+#include <cstdlib>
+#include "obs/metrics.h"
+
+namespace telemetry::api {
+
+namespace {
+
+// Bookkeeping per entry on top of key and payload (list node, index slot).
+constexpr size_t kEntryOverheadBytes = 128;
+
+} // namespace
+
+auto AnalyticsCache::AnalyticsCacheArgs::FromEnv() -> AnalyticsCacheArgs {
+    AnalyticsCacheArgs args;
+    if (const char* env_bytes = std::getenv("ANALYTICS_CACHE_MAX_BYTES")) {
+        try { args.max_bytes = std::stoul(env_bytes); } catch (...) {}
+    }
+    if (const char* env_ttl = std::getenv("ANALYTICS_CACHE_TTL_MS")) {
+        try { args.in_progress_ttl = std::chrono::milliseconds(std::stol(env_ttl)); } catch (...) {}
+    }
+    return args;
+}
+
+AnalyticsCache::AnalyticsCache(AnalyticsCacheArgs args)
+    : max_bytes_(args.max_bytes), in_progress_ttl_(args.in_progress_ttl) {
+    spdlog::info("Initialized AnalyticsCache with max_bytes={}, in_progress_ttl={}ms",
+                 max_bytes_, in_progress_ttl_.count());
+}
+
+AnalyticsCache::AnalyticsCache() : AnalyticsCache(AnalyticsCacheArgs{}) {}
+
+auto AnalyticsCache::Fingerprint(const std::string& endpoint,
+                                 const std::string& dataset_id,
+                                 const std::map<std::string, std::string>& params) -> std::string {
+    // Every part is length-prefixed, so no value can spell a different
+    // parameter list (e.g. region "a&k=5").
+    std::string key;
+    auto append = [&key](const std::string& part) {
+        key += std::to_string(part.size());
+        key += ':';
+        key += part;
+    };
+    append(endpoint);
+    append(dataset_id);
+    for (const auto& [name, value] : params) {
+        if (value.empty()) { continue; }
+        append(name);
+        append(value);
+    }
+    return key;
+}
+
+auto AnalyticsCache::Get(const std::string& key, const DatasetVersion& version) -> std::optional<nlohmann::json> {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+        const auto& entry = *it->second;
+        bool expired = entry.expires_at && std::chrono::steady_clock::now() >= *entry.expires_at;
+        // An entry is only reusable at the same row count: a loading dataset
+        // grows, and retention shrinks finished ones. One written while the
+        // dataset was loading is never reused once it has finished (the final
+        // row count may equal the last in-progress one).
+        bool stale = entry.version.rows != version.rows ||
+                     (!entry.version.immutable && version.immutable);
+        if (!expired && !stale) {
+            lru_.splice(lru_.begin(), lru_, it->second);
+            hits_++;
+            telemetry::obs::EmitCounter("analytics_cache_hits", 1, "hits", "analytics_cache");
+            return entry.value;
+        }
+        EraseLocked(it->second);
+    }
+    misses_++;
+    telemetry::obs::EmitCounter("analytics_cache_misses", 1, "misses", "analytics_cache");
+    return std::nullopt;
+}
+
+auto AnalyticsCache::Put(const std::string& key,
+                         const std::string& dataset_id,
+                         const DatasetVersion& version,
+                         const nlohmann::json& value) -> void {
+    size_t bytes = key.size() + dataset_id.size() + value.dump().size() + kEntryOverheadBytes;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (auto it = index_.find(key); it != index_.end()) {
+        EraseLocked(it->second);
+    }
+    if (bytes > max_bytes_) {
+        return; // also covers max_bytes == 0 (disabled)
+    }
+    while (!lru_.empty() && current_bytes_ + bytes > max_bytes_) {
+        EraseLocked(std::prev(lru_.end()));
+        evictions_++;
+        telemetry::obs::EmitCounter("analytics_cache_evictions", 1, "evictions", "analytics_cache");
+    }
+
+    CacheEntry entry{key, dataset_id, version, std::nullopt, value, bytes};
+    if (!version.immutable) {
+        entry.expires_at = std::chrono::steady_clock::now() + in_progress_ttl_;
+    }
+    lru_.push_front(std::move(entry));
+    index_[key] = lru_.begin();
+    current_bytes_ += bytes;
+    telemetry::obs::EmitGauge("analytics_cache_bytes_used", static_cast<double>(current_bytes_), "bytes", "analytics_cache");
+}
+
+auto AnalyticsCache::InvalidateDataset(const std::string& dataset_id) -> void {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = lru_.begin(); it != lru_.end();) {
+        auto next = std::next(it);
+        if (it->dataset_id == dataset_id) { EraseLocked(it); }
+        it = next;
+    }
+    telemetry::obs::EmitGauge("analytics_cache_bytes_used", static_cast<double>(current_bytes_), "bytes", "analytics_cache");
+}
+
+auto AnalyticsCache::Clear() -> void {
+    std::lock_guard<std::mutex> lock(mutex_);
+    lru_.clear();
+    index_.clear();
+    current_bytes_ = 0;
+    telemetry::obs::EmitGauge("analytics_cache_bytes_used", 0.0, "bytes", "analytics_cache");
+}
+
+auto AnalyticsCache::GetStats() const -> AnalyticsCache::CacheStats {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return {lru_.size(), current_bytes_, max_bytes_, hits_, misses_, evictions_};
+}
+
+void AnalyticsCache::EraseLocked(EntryList::iterator it) {
+    current_bytes_ -= it->bytes;
+    index_.erase(it->key);
+    lru_.erase(it);
+}
+
+} // namespace telemetry::api
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <chrono>
+#include <list>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <nlohmann/json.hpp>
+
+namespace telemetry::api {
+
+/**
+ * @brief Byte-bounded LRU cache for analytics responses (summary, topk,
+ * timeseries, histogram).
+ *
+ * Entries are keyed by a normalized query fingerprint and tagged with the
+ * dataset version they were computed from. Datasets in a terminal SUCCEEDED
+ * state never change, so their entries live until evicted or invalidated;
+ * entries for in-progress datasets expire after a short TTL and are dropped
+ * as soon as the dataset's inserted row count moves.
+ */
+class AnalyticsCache {
+public:
+    struct AnalyticsCacheArgs {
+        size_t max_bytes = 64ULL * 1024ULL * 1024ULL; // 0 disables the cache
+        std::chrono::milliseconds in_progress_ttl{5000};
+
+        // ANALYTICS_CACHE_MAX_BYTES, ANALYTICS_CACHE_TTL_MS
+        static auto FromEnv() -> AnalyticsCacheArgs;
+    };
+
+    // What the cached result was computed against.
+    struct DatasetVersion {
+        bool immutable = false; // run SUCCEEDED
+        long rows = 0;          // inserted_rows at query time (retention can lower it)
+    };
+
+    explicit AnalyticsCache(AnalyticsCacheArgs args);
+    AnalyticsCache();
+
+    /**
+     * @brief Builds a cache key from the endpoint, dataset and query
+     * parameters. Parameters are sorted and empty values dropped, so the
+     * same query spelled differently maps to one entry; each part is
+     * length-prefixed, so values may contain any character.
+     */
+    static auto Fingerprint(const std::string& endpoint,
+                            const std::string& dataset_id,
+                            const std::map<std::string, std::string>& params) -> std::string;
+
+    auto Get(const std::string& key, const DatasetVersion& version) -> std::optional<nlohmann::json>;
+    auto Put(const std::string& key,
+             const std::string& dataset_id,
+             const DatasetVersion& version,
+             const nlohmann::json& value) -> void;
+
+    // Drops every entry for a dataset (deleted, or new scores written).
+    auto InvalidateDataset(const std::string& dataset_id) -> void;
+    auto Clear() -> void;
+
+    struct CacheStats {
+        size_t size;
+        size_t bytes_used;
+        size_t max_bytes;
+        long long hits;
+        long long misses;
+        long long evictions;
+    };
+    auto GetStats() const -> CacheStats;
+
+private:
+    struct CacheEntry {
+        std::string key;
+        std::string dataset_id;
+        DatasetVersion version;
+        std::optional<std::chrono::steady_clock::time_point> expires_at;
+        nlohmann::json value;
+        size_t bytes = 0;
+    };
+    using EntryList = std::list<CacheEntry>;
+
+    void EraseLocked(EntryList::iterator it);
+
+    size_t max_bytes_;
+    std::chrono::milliseconds in_progress_ttl_;
+    size_t current_bytes_ = 0;
+    mutable std::mutex mutex_;
+    EntryList lru_; // most recently used first
+    std::unordered_map<std::string, EntryList::iterator> index_;
+
+    long long hits_ = 0;
+    long long misses_ = 0;
+    long long evictions_ = 0;
+};
+
+} // namespace telemetry::api
@@ -0,0 +1,192 @@
+#include "analytics_queries.h"
+
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
+
+namespace telemetry::db {
+
+// NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
+auto AppendRawFilters(ShapedQuery& q,
+                      std::string& where,
+                      const std::string& region,
+                      const std::string& is_anomaly,
+                      const std::string& anomaly_type,
+                      const std::string& start_time,
+                      const std::string& end_time) -> void {
+    if (!region.empty()) { where += " AND region = " + q.Bind(region, "text"); }
+    if (!is_anomaly.empty()) { where += " AND is_anomaly = " + q.Bind(is_anomaly == "true" ? "true" : "false", "boolean"); }
+    if (!anomaly_type.empty()) { where += " AND anomaly_type = " + q.Bind(anomaly_type, "text"); }
+    if (!start_time.empty()) { where += " AND metric_timestamp >= " + q.Bind(start_time, "timestamptz"); }
+    if (!end_time.empty()) { where += " AND metric_timestamp <= " + q.Bind(end_time, "timestamptz"); }
+}
+
+// NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
+auto BuildTopKQueries(const std::string& run_id,
+                      const std::string& column,
+                      int k,
+                      const std::string& region,
+                      const std::string& is_anomaly,
+                      const std::string& anomaly_type,
+                      const std::string& start_time,
+                      const std::string& end_time,
+                      bool include_total_distinct) -> TopKQueries {
+    TopKQueries out;
+    ShapedQuery& q = out.rows;
+    std::string filter = "WHERE run_id = " + q.Bind(run_id, "uuid");
+    AppendRawFilters(q, filter, region, is_anomaly, anomaly_type, start_time, end_time);
+
+    if (include_total_distinct) {
+        ShapedQuery count_q = q;
+        count_q.sql = "SELECT COUNT(DISTINCT " + column + ") FROM host_telemetry_archival " + filter;
+        out.total_distinct = std::move(count_q);
+    }
+
+    q.sql = "SELECT " + column + ", COUNT(*) FROM host_telemetry_archival " + filter +
+            " GROUP BY " + column + " ORDER BY COUNT(*) DESC LIMIT ";
+    q.sql += q.Bind(std::to_string(k + 1), "bigint");
+    return out;
+}
+
+// NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
+auto BuildRawTimeSeriesQueries(const std::string& run_id,
+                               const std::vector<std::string>& metrics,
+                               const std::vector<std::string>& aggs,
+                               int bucket_seconds,
+                               bool approx,
+                               const std::string& region,
+                               const std::string& is_anomaly,
+                               const std::string& anomaly_type,
+                               const std::string& start_time,
+                               const std::string& end_time) -> RawTimeSeriesQueries {
+    RawTimeSeriesQueries out;
+    ShapedQuery& q = out.rows;
+    std::string bucket_param = q.Bind(std::to_string(bucket_seconds), "integer");
+    std::string bucket_expr = "to_timestamp(floor(extract(epoch from metric_timestamp) / " +
+                              bucket_param + ") * " + bucket_param + ")";
+
+    std::string select = bucket_expr + " AS bucket_ts";
+    for (const auto& metric : metrics) {
+        for (const auto& agg : aggs) {
+            const std::string& col = metric;
+            std::string alias = metric;
+            alias += "_";
+            alias += agg;
+            if (agg == "mean") { select += ", AVG("; select += col; select += ") AS "; select += alias; }
+            else if (agg == "min") { select += ", MIN("; select += col; select += ") AS "; select += alias; }
+            else if (agg == "max") { select += ", MAX("; select += col; select += ") AS "; select += alias; }
+            else if (approx && (agg == "p50" || agg == "p95")) { select += ", NULL::double precision AS "; select += alias; }
+            else if (agg == "p50") { select += ", PERCENTILE_CONT(0.5) WITHIN GROUP (ORDER BY "; select += col; select += ") AS "; select += alias; }
+            else if (agg == "p95") { select += ", PERCENTILE_CONT(0.95) WITHIN GROUP (ORDER BY "; select += col; select += ") AS "; select += alias; }
+        }
+    }
+    select += ", COUNT(*) AS bucket_count";
+
+    std::string where = " FROM host_telemetry_archival WHERE run_id = " + q.Bind(run_id, "uuid");
+    AppendRawFilters(q, where, region, is_anomaly, anomaly_type, start_time, end_time);
+    q.sql = "SELECT " + select + where + " GROUP BY bucket_ts ORDER BY bucket_ts ASC";
+
+    bool has_percentiles = std::find(aggs.begin(), aggs.end(), "p50") != aggs.end() ||
+                           std::find(aggs.begin(), aggs.end(), "p95") != aggs.end();
+    if (approx && has_percentiles) {
+        // Build each bucket's sketch from per-bin counts: Postgres hash-
+        // aggregates (bucket, bin) instead of sorting every bucket's rows.
+        for (const auto& metric : metrics) {
+            ShapedQuery bins_q = q; // same placeholders, same params
+            bins_q.sql = "SELECT " + bucket_expr + " AS bucket_ts, " +
+                         telemetry::rollup::QuantileSketch::BinIndexSql(metric) + " AS bin, COUNT(*)" + where +
+                         " GROUP BY 1, 2";
+            out.sketch_bins.emplace_back(metric, std::move(bins_q));
+        }
+    }
+    return out;
+}
+
+auto ResolveSearchSort(const std::string& sort_by,
+                       const std::string& sort_order,
+                       const std::string& cursor,
+                       int offset) -> SearchSort {
+    SearchSort sort;
+    if (!sort_by.empty() && sort_by != "metric_timestamp") {
+        throw std::invalid_argument("Invalid sort_by: " + sort_by);
+    }
+    if (!sort_order.empty()) {
+        std::string lower = sort_order;
+        std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+        if (lower != "asc" && lower != "desc") {
+            throw std::invalid_argument("Invalid sort_order: " + sort_order);
+        }
+        sort.dir = lower;
+    }
+    if (!cursor.empty()) {
+        sort.after = telemetry::api::DecodeSearchCursor(cursor);
+        if (!sort.after.has_value()) {
+            throw std::invalid_argument("Invalid cursor");
+        }
+        if (sort.after->sort_order != sort.dir) {
+            throw std::invalid_argument("cursor was issued for sort_order=" + sort.after->sort_order);
+        }
+        if (offset > 0) {
+            throw std::invalid_argument("cursor and offset cannot be combined");
+        }
+    }
+    return sort;
+}
+
+// NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
+auto BuildSearchQueries(const std::string& run_id,
+                        int limit,
+                        int offset,
+                        const std::string& start_time,
+                        const std::string& end_time,
+                        const std::string& is_anomaly,
+                        const std::string& anomaly_type,
+                        const std::string& host_id,
+                        const std::string& region,
+                        const std::string& anchor_time,
+                        const SearchSort& sort) -> SearchQueries {
+    SearchQueries out;
+    ShapedQuery filters;
+    std::string where = "WHERE run_id = " + filters.Bind(run_id, "uuid");
+    AppendRawFilters(filters, where, region, is_anomaly, anomaly_type, start_time, end_time);
+    if (!host_id.empty()) { where += " AND host_id = " + filters.Bind(host_id, "text"); }
+    if (!anchor_time.empty()) {
+        where += std::string(" AND metric_timestamp ") + (sort.dir == "asc" ? ">= " : "<= ") +
+                 filters.Bind(anchor_time, "timestamptz");
+    }
+    out.catalog_shape = start_time.empty() && end_time.empty() && anchor_time.empty() &&
+                        anomaly_type.empty() && host_id.empty() && region.empty();
+
+    out.exact_count = filters;
+    out.exact_count.sql = "SELECT COUNT(*) FROM host_telemetry_archival " + where;
+    out.estimate = filters;
+    out.estimate.sql = "EXPLAIN (FORMAT JSON) SELECT 1 FROM host_telemetry_archival " + where;
+
+    // The cursor bound is rebuilt from integer microseconds so it compares
+    // exactly against the stored timestamp.
+    ShapedQuery& q = out.page;
+    q = std::move(filters);
+    if (sort.after.has_value()) {
+        std::string ts_us = q.Bind(std::to_string(sort.after->ts_us), "bigint");
+        std::string record_id = q.Bind(std::to_string(sort.after->record_id), "bigint");
+        where += std::string(" AND (metric_timestamp, record_id) ") + (sort.dir == "asc" ? ">" : "<") +
+                 " (TIMESTAMPTZ 'epoch' + " + ts_us + " * INTERVAL '1 microsecond', " + record_id + ")";
+    }
+    q.sql = std::string("SELECT ") + kSearchColumns + " FROM host_telemetry_archival " + where +
+            " ORDER BY " + sort.column + " " + sort.dir + ", record_id " + sort.dir + " LIMIT ";
+    q.sql += q.Bind(std::to_string(limit + 1), "bigint");
+    q.sql += " OFFSET ";
+    q.sql += q.Bind(std::to_string(sort.after.has_value() ? 0 : offset), "bigint");
+    return out;
+}
+
+auto CatalogSearchTotal(long rows, long anomalies, const std::string& is_anomaly) -> long {
+    if (is_anomaly.empty()) { return rows; }
+    return is_anomaly == "true" ? anomalies : rows - anomalies;
+}
+
+auto PlanRowsEstimate(const char* plan_json) -> long {
+    return nlohmann::json::parse(plan_json)[0]["Plan"].value("Plan Rows", 0L);
+}
+
+} // namespace telemetry::db
@@ -0,0 +1,241 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "json_stream.h"
+#include "pagination.h"
+#include "rollup.h"
+
+/**
+ * @brief SQL builders and result shaping for the dataset analytics reads,
+ * shared by the blocking DbClient (pqxx) and AsyncDbClient (libpq). The
+ * shaping templates accept any result type with the pqxx row/field subset
+ * (row[i].is_null(), .as<T>(), .c_str()), so both clients return identical
+ * JSON and, with identical SQL text, share shape-keyed statement names.
+ */
+namespace telemetry::db {
+
+// Analytics SQL whose text depends only on the request's shape (columns,
+// aggregations, which filters are present); values are bound as params.
+struct ShapedQuery {
+    std::string sql;
+    std::vector<std::string> params;
+
+    // Appends a parameter and returns its typed placeholder, e.g. "$2::uuid".
+    auto Bind(std::string value, const char* type) -> std::string {
+        params.push_back(std::move(value));
+        return "$" + std::to_string(params.size()) + "::" + type;
+    }
+};
+
+// Appends the optional region/is_anomaly/anomaly_type/time filters shared
+// by the raw-table analytics queries.
+auto AppendRawFilters(ShapedQuery& q,
+                      std::string& where,
+                      const std::string& region,
+                      const std::string& is_anomaly,
+                      const std::string& anomaly_type,
+                      const std::string& start_time,
+                      const std::string& end_time) -> void;
+
+struct TopKQueries {
+    ShapedQuery rows;                          // k + 1 rows, to detect truncation
+    std::optional<ShapedQuery> total_distinct; // when requested
+};
+
+// column must already be validated against the dimension allowlist.
+auto BuildTopKQueries(const std::string& run_id,
+                      const std::string& column,
+                      int k,
+                      const std::string& region,
+                      const std::string& is_anomaly,
+                      const std::string& anomaly_type,
+                      const std::string& start_time,
+                      const std::string& end_time,
+                      bool include_total_distinct) -> TopKQueries;
+
+struct RawTimeSeriesQueries {
+    ShapedQuery rows;
+    // Per-metric (bucket, bin, count) queries backing approx p50/p95.
+    std::vector<std::pair<std::string, ShapedQuery>> sketch_bins;
+};
+
+// metrics and aggs must already be validated against their allowlists.
+auto BuildRawTimeSeriesQueries(const std::string& run_id,
+                               const std::vector<std::string>& metrics,
+                               const std::vector<std::string>& aggs,
+                               int bucket_seconds,
+                               bool approx,
+                               const std::string& region,
+                               const std::string& is_anomaly,
+                               const std::string& anomaly_type,
+                               const std::string& start_time,
+                               const std::string& end_time) -> RawTimeSeriesQueries;
+
+// Fills out["items"] / out["truncated"] from a BuildTopKQueries rows result.
+template <typename Result>
+auto AppendTopKRows(nlohmann::json& out, const Result& res, int k) -> void {
+    bool truncated = false;
+    size_t count = 0;
+    for (const auto& row : res) {
+        if (count >= static_cast<size_t>(k)) {
+            truncated = true;
+            break;
+        }
+        nlohmann::json j;
+        j["label"] = row[0].is_null() ? "" : row[0].template as<std::string>();
+        j["count"] = row[1].template as<long>();
+        out["items"].push_back(j);
+        count++;
+    }
+    out["truncated"] = truncated;
+}
+
+template <typename Result>
+auto TimeSeriesRowsToJson(const Result& res,
+                          const std::vector<std::string>& metrics,
+                          const std::vector<std::string>& aggs) -> nlohmann::json {
+    nlohmann::json out = nlohmann::json::array();
+    for (const auto& row : res) {
+        nlohmann::json j;
+        j["ts"] = row[0].template as<std::string>();
+        int col_idx = 1;
+        for (const auto& metric : metrics) {
+            for (const auto& agg : aggs) {
+                std::string key = metric;
+                key += "_";
+                key += agg;
+                j[key] = row[col_idx].is_null() ? 0.0 : row[col_idx].template as<double>();
+                col_idx++;
+            }
+        }
+        j["count"] = row[col_idx].template as<long>();
+        out.push_back(j);
+    }
+    return out;
+}
+
+// Overwrites metric's p50/p95 in out from a sketch_bins result.
+template <typename Result>
+auto ApplySketchBins(nlohmann::json& out,
+                     const Result& bins,
+                     const std::string& metric,
+                     const std::vector<std::string>& aggs) -> void {
+    std::unordered_map<std::string, size_t> bucket_index;
+    for (size_t i = 0; i < out.size(); ++i) { bucket_index[out[i]["ts"].get<std::string>()] = i; }
+    std::unordered_map<std::string, telemetry::rollup::QuantileSketch> sketches;
+    for (const auto& row : bins) {
+        sketches[row[0].template as<std::string>()].AddBin(static_cast<size_t>(row[1].template as<int>()),
+                                                           row[2].template as<long>());
+    }
+    for (const auto& [ts, sketch] : sketches) {
+        auto it = bucket_index.find(ts);
+        if (it == bucket_index.end()) { continue; }
+        auto& j = out[it->second];
+        for (const auto& agg : aggs) {
+            if (agg == "p50") { j[metric + "_p50"] = sketch.Quantile(0.5); }
+            else if (agg == "p95") { j[metric + "_p95"] = sketch.Quantile(0.95); }
+        }
+    }
+}
+
+struct SearchSort {
+    std::string column = "metric_timestamp";
+    std::string dir = "desc";
+    std::optional<telemetry::api::SearchCursor> after;
+};
+
+// Validates sort and cursor arguments; throws std::invalid_argument.
+auto ResolveSearchSort(const std::string& sort_by,
+                       const std::string& sort_order,
+                       const std::string& cursor,
+                       int offset) -> SearchSort;
+
+struct SearchQueries {
+    ShapedQuery page;          // limit + 1 rows past the offset or cursor
+    ShapedQuery exact_count;   // COUNT(*) under the same filters
+    ShapedQuery estimate;      // EXPLAIN (FORMAT JSON) under the same filters
+    bool catalog_shape = false; // only run_id/is_anomaly set: the catalog is exact
+};
+
+// Record search SQL shared by both clients. The anchor bounds the first
+// page in sort direction; sort.after continues past a cursor on
+// (metric_timestamp, record_id), which idx_telemetry_run_ts_record serves
+// as a range scan however deep the page is.
+auto BuildSearchQueries(const std::string& run_id,
+                        int limit,
+                        int offset,
+                        const std::string& start_time,
+                        const std::string& end_time,
+                        const std::string& is_anomaly,
+                        const std::string& anomaly_type,
+                        const std::string& host_id,
+                        const std::string& region,
+                        const std::string& anchor_time,
+                        const SearchSort& sort) -> SearchQueries;
+
+// Search total from a get_dataset_catalog (rows, anomalies) pair.
+auto CatalogSearchTotal(long rows, long anomalies, const std::string& is_anomaly) -> long;
+
+// "Plan Rows" of an EXPLAIN (FORMAT JSON) result's text.
+auto PlanRowsEstimate(const char* plan_json) -> long;
+
+// Columns every record search selects, in SearchRowToJson order; the last
+// is the row's timestamp in epoch microseconds, for the next cursor.
+inline constexpr const char* kSearchColumns =
+    "record_id, host_id, metric_timestamp, cpu_usage, memory_usage, disk_utilization, "
+    "network_rx_rate, network_tx_rate, is_anomaly, anomaly_type, region, project_id, labels, "
+    "(extract(epoch FROM metric_timestamp) * 1000000)::bigint";
+
+template <typename Row>
+auto SearchRowToJson(const Row& row) -> nlohmann::json {
+    nlohmann::json j;
+    j["record_id"] = row[0].template as<long>();
+    j["host_id"] = row[1].template as<std::string>();
+    j["timestamp"] = row[2].template as<std::string>();
+    j["cpu_usage"] = row[3].template as<double>();
+    j["memory_usage"] = row[4].template as<double>();
+    j["disk_utilization"] = row[5].template as<double>();
+    j["network_rx_rate"] = row[6].template as<double>();
+    j["network_tx_rate"] = row[7].template as<double>();
+    j["is_anomaly"] = row[8].template as<bool>();
+    j["anomaly_type"] = row[9].is_null() ? "" : row[9].template as<std::string>();
+    j["region"] = row[10].template as<std::string>();
+    j["project_id"] = row[11].template as<std::string>();
+    j["labels"] = row[12].is_null() ? nlohmann::json::object() : nlohmann::json::parse(row[12].c_str());
+    return j;
+}
+
+// SearchRowToJson's object written straight to out; labels are copied as
+// the column's JSON text.
+template <typename Row>
+auto WriteSearchRow(telemetry::api::JsonStreamWriter& out, const Row& row) -> void {
+    out.BeginObject()
+        .Key("record_id").Int(row[0].template as<long>())
+        .Key("host_id").String(row[1].c_str())
+        .Key("timestamp").String(row[2].c_str())
+        .Key("cpu_usage").Double(row[3].template as<double>())
+        .Key("memory_usage").Double(row[4].template as<double>())
+        .Key("disk_utilization").Double(row[5].template as<double>())
+        .Key("network_rx_rate").Double(row[6].template as<double>())
+        .Key("network_tx_rate").Double(row[7].template as<double>())
+        .Key("is_anomaly").Bool(row[8].template as<bool>())
+        .Key("anomaly_type").String(row[9].is_null() ? "" : row[9].c_str())
+        .Key("region").String(row[10].c_str())
+        .Key("project_id").String(row[11].c_str());
+    out.Key("labels");
+    if (row[12].is_null()) {
+        out.BeginObject().EndObject();
+    } else {
+        out.Raw(row[12].c_str());
+    }
+    out.EndObject();
+}
+
+} // namespace telemetry::db
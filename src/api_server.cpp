@@ -1,11 +1,15 @@
 #include "detectors/pca_model.h"
 #include "api_server.h"
 #include "api_response_meta.h"
+#include "analytics_queries.h"
 #include "api_debug.h"
+#include "inference_codec.h"
 #include "route_registry.h"
 #include "time_resolution.h"
 #include "training/pca_trainer.h"
 #include <spdlog/spdlog.h>
+#include <fmt/format.h>
+#include <algorithm>
 #include <filesystem>
 #include <thread>
 #include <chrono>
@@ -22,6 +26,8 @@
 #include "obs/context.h"
 #include "obs/error_codes.h"
 #include "obs/http_log.h"
+#include "progress_reporter.h"
+#include "eval_aggregates.h"
 
 #include <uuid/uuid.h>
 #include <array>
@@ -57,15 +63,29 @@ auto GetRequestId(const httplib::Request& req) -> std::string {
     return GenerateUuid();
 }
 
+// POST /inference rejects bodies with more samples than this.
+constexpr size_t kMaxInferenceSamples = 1000;
+
+// POST /inference/batch serves its packed results in slices of this size.
+constexpr size_t kBatchResponseChunkBytes = 64 * 1024;
+
+static auto RowsPerSecond(size_t rows, double latency_ms) -> double {
+    return latency_ms > 0.0 ? static_cast<double>(rows) / (latency_ms / 1000.0) : 0.0;
+}
+
 static auto ClassifyHttpError(const std::exception& e) -> const char* {
     auto msg = std::string(e.what());
     try {
         throw; // Re-throw to check type
     } catch (const nlohmann::json::parse_error&) {
         return telemetry::obs::kErrHttpJsonParseError;
+    } catch (const JsonSyntaxError&) {
+        return telemetry::obs::kErrHttpJsonParseError;
     } catch (const nlohmann::json::out_of_range&) {
         // e.g. "key 'x' not found"
         return telemetry::obs::kErrHttpMissingField;
+    } catch (const JsonMissingField&) {
+        return telemetry::obs::kErrHttpMissingField;
     } catch (const std::invalid_argument&) {
          return telemetry::obs::kErrHttpInvalidArgument;
     } catch (const std::out_of_range&) {
@@ -85,6 +105,31 @@ static auto ClassifyHttpError(const std::exception& e) -> const char* {
     }
 }
 
+static auto PoolStatsJson(const PooledDbConnectionManager::PoolStats& stats) -> nlohmann::json {
+    nlohmann::json out = {{"size", stats.size},
+                          {"in_use", stats.in_use},
+                          {"available", stats.available},
+                          {"total_acquires", stats.total_acquires},
+                          {"total_timeouts", stats.total_timeouts},
+                          {"total_created", stats.total_created},
+                          {"total_reaped", stats.total_reaped},
+                          {"total_recycled", stats.total_recycled},
+                          {"total_broken", stats.total_broken}};
+    out["lanes"] = nlohmann::json::object();
+    for (size_t i = 0; i < kDbLaneCount; ++i) {
+        const auto& lane = stats.lanes[i];
+        out["lanes"][DbLaneName(static_cast<DbLane>(i))] = {{"in_use", lane.in_use},
+                                                             {"waiting", lane.waiting},
+                                                             {"limit", lane.limit},
+                                                             {"total_acquires", lane.total_acquires},
+                                                             {"total_timeouts", lane.total_timeouts},
+                                                             {"wait_p50_ms", lane.wait_p50_ms},
+                                                             {"wait_p95_ms", lane.wait_p95_ms},
+                                                             {"wait_p99_ms", lane.wait_p99_ms}};
+    }
+    return out;
+}
+
 static auto ClassifyTrainError(const std::string& msg) -> const char* {
     if (msg.find("Cancelled") != std::string::npos) {
         return "E_CANCELLED";
@@ -120,12 +165,43 @@ ApiServer::ApiServer(std::string grpc_target, std::string db_conn_str)
         } catch (...) {}
     }
 
-    auto manager = std::make_shared<PooledDbConnectionManager>(
+    PooledDbConnectionManager::ElasticArgs elastic;
+    elastic.health_check_interval = std::chrono::milliseconds(30000);
+    // Score, training and tuning jobs take the batch lane; /datasets and
+    // friends keep two slots of their own.
+    PooledDbConnectionManager::LaneArgs lanes;
+    lanes.interactive_reserved = 2;
+    lanes.maintenance_max = 1;
+    lanes.batch_timeout = std::chrono::milliseconds(60000);
+    lanes.maintenance_timeout = std::chrono::milliseconds(60000);
+    std::shared_ptr<DbConnectionManager> manager = std::make_shared<PooledDbConnectionManager>(
         db_conn_str, pool_size, std::chrono::milliseconds(timeout_ms),
         [](pqxx::connection& C) {
-            DbClient::PrepareStatements(C);
-        });
-    
+            DbClient::AttachConnection(C);
+        },
+        PooledDbConnectionManager::ElasticArgs::FromEnv(elastic),
+        PooledDbConnectionManager::LaneArgs::FromEnv(lanes));
+
+    // Analytics reads move to a replica when one is configured.
+    const char* env_read_conn = std::getenv("DB_READ_CONNECTION_STRING");
+    if (env_read_conn && *env_read_conn) {
+        size_t read_pool_size = pool_size;
+        if (const char* env_read_size = std::getenv("DB_READ_POOL_SIZE")) {
+            try {
+                read_pool_size = std::stoul(env_read_size);
+            } catch (...) {}
+        }
+        auto replica = std::make_shared<PooledDbConnectionManager>(
+            env_read_conn, read_pool_size, std::chrono::milliseconds(timeout_ms),
+            [](pqxx::connection& C) {
+                DbClient::AttachConnection(C);
+            },
+            PooledDbConnectionManager::ElasticArgs::FromEnv(elastic),
+            PooledDbConnectionManager::LaneArgs::FromEnv(lanes));
+        manager = std::make_shared<ReadReplicaDbConnectionManager>(manager, replica, DbReplicaArgs::FromEnv());
+        spdlog::info("Routing analytics reads to the read replica (pool size {})", read_pool_size);
+    }
+
     db_client_ = std::make_shared<DbClient>(manager);
     db_manager_ = manager;
     Initialize();
@@ -174,9 +250,17 @@ void ApiServer::Initialize() {
     }
 
     model_cache_ = std::make_unique<telemetry::anomaly::PcaModelCache>(telemetry::anomaly::PcaModelCache::PcaModelCacheArgs{cache_size, cache_max_bytes, cache_ttl});
+    analytics_cache_ = std::make_unique<AnalyticsCache>(AnalyticsCache::AnalyticsCacheArgs::FromEnv());
+    hot_datasets_ = std::make_unique<HotDatasetCache>(
+        HotDatasetCache::HotDatasetCacheArgs::FromEnv(),
+        [db = db_client_](const std::string& run_id) { return db->LoadColumnarDataset(run_id); });
 
     // Configure HTTP Server Limits
-    svr_.set_payload_max_length(1024ULL * 1024ULL * 50ULL); // 50MB
+    const char* env_payload_max = std::getenv("API_PAYLOAD_MAX_BYTES");
+    if (env_payload_max) {
+        try { payload_max_bytes_ = std::stoull(env_payload_max); } catch (...) {}
+    }
+    svr_.set_payload_max_length(payload_max_bytes_); // 50MB default
     svr_.set_read_timeout(5, 0); // 5 seconds
     svr_.set_write_timeout(5, 0); // 5 seconds
 
@@ -245,6 +329,11 @@ void ApiServer::Initialize() {
         HandleInference(req, res);
     });
 
+    svr_.Post("/inference/batch", [this](const httplib::Request& req, httplib::Response& res,
+                                         const httplib::ContentReader& content_reader) {
+        HandleInferenceBatch(req, res, content_reader);
+    });
+
     svr_.Get("/inference_runs", [this](const httplib::Request& req, httplib::Response& res) {
         HandleListInferenceRuns(req, res);
     });
@@ -404,6 +493,29 @@ void ApiServer::Initialize() {
         res.set_content(telemetry::metrics::MetricsRegistry::Instance().ToPrometheus(), "text/plain");
     });
 
+    svr_.Get("/debug/db_pool", [this](const httplib::Request& req, httplib::Response& res) {
+        std::string rid = GetRequestId(req);
+        telemetry::obs::HttpRequestLogScope log({req, res, "api_server", rid});
+        auto routing = std::dynamic_pointer_cast<ReadReplicaDbConnectionManager>(db_manager_);
+        auto pool = std::dynamic_pointer_cast<PooledDbConnectionManager>(routing ? routing->Primary() : db_manager_);
+        if (!pool) {
+            log.RecordError({telemetry::obs::kErrHttpNotFound, "Connection pool not in use", 404});
+            SendError({res, "Connection pool not in use", 404, telemetry::obs::kErrHttpNotFound, rid});
+            return;
+        }
+        nlohmann::json out = PoolStatsJson(pool->GetStats());
+        if (routing) {
+            auto routes = routing->GetStats();
+            auto replica = std::dynamic_pointer_cast<PooledDbConnectionManager>(routing->Replica());
+            out["replica"] = replica ? PoolStatsJson(replica->GetStats()) : nlohmann::json::object();
+            out["replica"]["routing"] = {{"replica_reads", routes.replica_reads},
+                                         {"stale_fallbacks", routes.stale_fallbacks},
+                                         {"error_fallbacks", routes.error_fallbacks},
+                                         {"last_lag_ms", routes.last_lag_ms}};
+        }
+        SendJson(res, out, 200, rid);
+    });
+
     svr_.Get("/schema/metrics", [this](const httplib::Request& req, httplib::Response& res) {
         std::string rid = GetRequestId(req);
         telemetry::obs::HttpRequestLogScope log({req, res, "api_server", rid});
@@ -613,6 +725,31 @@ void ApiServer::HandleGetDataset(const httplib::Request& req, httplib::Response&
     }
 }
 
+auto ApiServer::EvalCacheTag(const std::string& dataset_id, const std::string& model_run_id) -> std::string {
+    return "eval:" + dataset_id + ":" + model_run_id;
+}
+
+auto ApiServer::AnalyticsVersion(const std::string& run_id) -> std::optional<AnalyticsCache::DatasetVersion> {
+    // Read where the analytics reads go: a lagging replica's rows must not be
+    // cached under the primary's newer version.
+    auto status = db_client_->GetAnalyticsRunStatus(run_id);
+    if (status.status().empty()) {
+        // Unknown run: drop anything cached for a dataset that has since been deleted.
+        analytics_cache_->InvalidateDataset(run_id);
+        hot_datasets_->Invalidate(run_id);
+        return std::nullopt;
+    }
+    if (status.status() == "ERROR") { return std::nullopt; }
+    return AnalyticsCache::DatasetVersion{status.status() == "SUCCEEDED", status.inserted_rows()};
+}
+
+auto ApiServer::HotDataset(const std::string& run_id, const std::optional<AnalyticsCache::DatasetVersion>& version)
+    -> std::shared_ptr<const ColumnarDataset> {
+    // Rows are only final once the run has SUCCEEDED.
+    if (!version || !version->immutable) { return nullptr; }
+    return hot_datasets_->Acquire(run_id, version->rows);
+}
+
 void ApiServer::HandleDatasetSummary(const httplib::Request& req, httplib::Response& res) {
     std::string rid = GetRequestId(req);
     telemetry::obs::HttpRequestLogScope log({req, res, "api_server", rid});
@@ -622,18 +759,22 @@ void ApiServer::HandleDatasetSummary(const httplib::Request& req, httplib::Respo
     bool debug = GetStrParam(req, "debug") == "true";
     try {
         auto start = std::chrono::steady_clock::now();
-        auto summary = db_client_->GetDatasetSummary(run_id, topk);
+        auto cache_key = AnalyticsCache::Fingerprint("summary", run_id, {{"topk", std::to_string(topk)}});
+        auto version = AnalyticsVersion(run_id);
+        auto cached = version ? analytics_cache_->Get(cache_key, *version) : std::nullopt;
+        auto summary = cached ? *cached : db_client_->GetDatasetSummary(run_id, topk);
         auto end = std::chrono::steady_clock::now();
         if (summary.empty()) {
             log.RecordError({telemetry::obs::kErrHttpNotFound, "Dataset not found", 404});
             SendError({res, "Dataset not found", 404, telemetry::obs::kErrHttpNotFound, rid});
             return;
         }
+        if (!cached && version) { analytics_cache_->Put(cache_key, run_id, *version, summary); }
         double duration_ms = std::chrono::duration<double, std::milli>(end - start).count();
         summary["meta"]["duration_ms"] = duration_ms;
         summary["meta"]["rows_scanned"] = nullptr;
         summary["meta"]["rows_returned"] = 1;
-        summary["meta"]["cache_hit"] = false;
+        summary["meta"]["cache_hit"] = cached.has_value();
         summary["meta"]["request_id"] = rid;
         if (debug) {
             long row_count = summary.value("row_count", 0L);
@@ -675,7 +816,23 @@ void ApiServer::HandleDatasetTopK(const httplib::Request& req, httplib::Response
     bool include_total = GetStrParam(req, "include_total_distinct") == "true";
     try {
         auto start = std::chrono::steady_clock::now();
-        auto data_obj = db_client_->GetTopK(run_id, allowed[column], k, region, is_anomaly, anomaly_type, start_time, end_time, include_total);
+        auto cache_key = AnalyticsCache::Fingerprint("topk", run_id, {
+            {"column", allowed[column]}, {"k", std::to_string(k)}, {"region", region}, {"is_anomaly", is_anomaly},
+            {"anomaly_type", anomaly_type}, {"start_time", start_time}, {"end_time", end_time},
+            {"include_total_distinct", include_total ? "true" : ""}});
+        auto pin = db_client_->PinAnalyticsReads();
+        auto version = AnalyticsVersion(run_id);
+        auto cached = version ? analytics_cache_->Get(cache_key, *version) : std::nullopt;
+        std::optional<nlohmann::json> in_memory;
+        if (!cached) {
+            if (auto hot = HotDataset(run_id, version)) {
+                in_memory = hot->TopK(allowed[column], k, {region, is_anomaly, anomaly_type, start_time, end_time}, include_total);
+            }
+        }
+        auto data_obj = cached      ? *cached
+                        : in_memory ? *in_memory
+                                    : db_client_->GetTopK(run_id, allowed[column], k, region, is_anomaly, anomaly_type, start_time, end_time, include_total);
+        if (!cached && version) { analytics_cache_->Put(cache_key, run_id, *version, data_obj); }
         auto end = std::chrono::steady_clock::now();
         double duration_ms = std::chrono::duration<double, std::milli>(end - start).count();
         
@@ -705,7 +862,8 @@ void ApiServer::HandleDatasetTopK(const httplib::Request& req, httplib::Response
         resp["meta"]["duration_ms"] = duration_ms;
         resp["meta"]["rows_scanned"] = nullptr;
         resp["meta"]["rows_returned"] = static_cast<int>(items.size());
-        resp["meta"]["cache_hit"] = false;
+        resp["meta"]["cache_hit"] = cached.has_value();
+        resp["meta"]["in_memory"] = in_memory.has_value();
         resp["meta"]["request_id"] = rid;
 
         if (debug) {
@@ -736,6 +894,7 @@ void ApiServer::HandleDatasetTimeSeries(const httplib::Request& req, httplib::Re
     std::string is_anomaly = GetStrParam(req, "is_anomaly");
     std::string anomaly_type = GetStrParam(req, "anomaly_type");
     std::string compare_mode = GetStrParam(req, "compare_mode");
+    std::string percentile_param = GetStrParam(req, "percentile_mode");
     std::string start_time = GetStrParam(req, "start_time");
     std::string end_time = GetStrParam(req, "end_time");
 
@@ -772,6 +931,13 @@ void ApiServer::HandleDatasetTimeSeries(const httplib::Request& req, httplib::Re
     else if (bucket == "7d") { bucket_seconds = 604800; }
     else if (bucket.empty() || bucket == "auto") { bucket_seconds = telemetry::api::SelectBucketSeconds(start_time, end_time); }
 
+    auto percentile_mode = telemetry::api::ResolvePercentileMode(percentile_param, bucket_seconds);
+    if (!percentile_mode.has_value()) {
+        log.RecordError({telemetry::obs::kErrHttpInvalidArgument, "invalid percentile_mode", 400});
+        SendError({res, "percentile_mode must be exact, approx or auto", 400, telemetry::obs::kErrHttpInvalidArgument, rid});
+        return;
+    }
+
     bool debug = GetStrParam(req, "debug") == "true";
     std::optional<std::pair<std::string, std::string>> baseline_window;
     if (compare_mode == "previous_period") {
@@ -784,32 +950,80 @@ void ApiServer::HandleDatasetTimeSeries(const httplib::Request& req, httplib::Re
     }
     try {
         auto start = std::chrono::steady_clock::now();
-        auto data = db_client_->GetTimeSeries(run_id, metrics, aggs, bucket_seconds, region, is_anomaly, anomaly_type, start_time, end_time);
+        // metrics/aggs order shapes the response, so it stays in the key as given.
+        auto cache_key = AnalyticsCache::Fingerprint("timeseries", run_id, {
+            {"metrics", metrics_param}, {"aggs", aggs_param.empty() ? "mean" : aggs_param},
+            {"bucket_seconds", std::to_string(bucket_seconds)}, {"region", region}, {"is_anomaly", is_anomaly},
+            {"anomaly_type", anomaly_type}, {"compare_mode", compare_mode}, {"start_time", start_time},
+            {"end_time", end_time}, {"percentile_mode", *percentile_mode}});
+        auto pin = db_client_->PinAnalyticsReads();
+        auto version = AnalyticsVersion(run_id);
+        auto cached = version ? analytics_cache_->Get(cache_key, *version) : std::nullopt;
+        nlohmann::json data;
         nlohmann::json baseline;
-        if (baseline_window.has_value()) {
-            baseline = db_client_->GetTimeSeries(
-                run_id,
-                metrics,
-                aggs,
-                bucket_seconds,
-                region,
-                is_anomaly,
-                anomaly_type,
-                baseline_window->first,
-                baseline_window->second);
+        bool in_memory = false;
+        // Percentiles computed in memory are always exact, and the key only
+        // carries the requested mode, so the served one is cached with them.
+        std::string served_mode = *percentile_mode;
+        if (cached) {
+            data = (*cached)["items"];
+            baseline = (*cached)["baseline"];
+            served_mode = cached->value("percentile_mode", served_mode);
+        } else {
+            if (auto hot = HotDataset(run_id, version)) {
+                // All-or-nothing: the baseline window must be answerable too.
+                auto hot_data = hot->TimeSeries(metrics, aggs, bucket_seconds, {region, is_anomaly, anomaly_type, start_time, end_time});
+                std::optional<nlohmann::json> hot_baseline = nlohmann::json();
+                if (hot_data && baseline_window.has_value()) {
+                    hot_baseline = hot->TimeSeries(metrics, aggs, bucket_seconds,
+                                                   {region, is_anomaly, anomaly_type, baseline_window->first, baseline_window->second});
+                }
+                if (hot_data && hot_baseline) {
+                    data = std::move(*hot_data);
+                    baseline = std::move(*hot_baseline);
+                    in_memory = true;
+                    served_mode = "exact";
+                }
+            }
+            if (!in_memory) {
+                data = db_client_->GetTimeSeries(run_id, metrics, aggs, bucket_seconds, region, is_anomaly, anomaly_type, start_time, end_time, *percentile_mode);
+                if (baseline_window.has_value()) {
+                    baseline = db_client_->GetTimeSeries(
+                        run_id,
+                        metrics,
+                        aggs,
+                        bucket_seconds,
+                        region,
+                        is_anomaly,
+                        anomaly_type,
+                        baseline_window->first,
+                        baseline_window->second,
+                        *percentile_mode);
+                }
+            }
+            if (version) {
+                analytics_cache_->Put(cache_key, run_id, *version,
+                                      {{"items", data}, {"baseline", baseline}, {"percentile_mode", served_mode}});
+            }
         }
         auto end = std::chrono::steady_clock::now();
         double duration_ms = std::chrono::duration<double, std::milli>(end - start).count();
+        auto rows_returned = static_cast<int>(data.size());
         nlohmann::json resp;
-        resp["items"] = data;
+        resp["items"] = std::move(data);
         if (baseline_window.has_value()) {
-            resp["baseline"] = baseline;
+            resp["baseline"] = std::move(baseline);
         }
         resp["bucket_seconds"] = bucket_seconds;
         resp["meta"]["start_time"] = start_time;
         resp["meta"]["end_time"] = end_time;
         resp["meta"]["bucket_seconds"] = bucket_seconds;
         resp["meta"]["resolution"] = telemetry::api::BucketLabel(bucket_seconds);
+        bool approx = served_mode == "approx";
+        resp["meta"]["percentile_mode"] = approx ? "approx" : "exact";
+        // Sketch estimates are within this relative error of a sample at the requested rank.
+        resp["meta"]["percentile_relative_error"] =
+            approx ? telemetry::rollup::QuantileSketch::kRelativeAccuracy : 0.0;
         if (baseline_window.has_value()) {
             resp["meta"]["compare_mode"] = compare_mode;
             resp["meta"]["baseline_start_time"] = baseline_window->first;
@@ -818,17 +1032,20 @@ void ApiServer::HandleDatasetTimeSeries(const httplib::Request& req, httplib::Re
         resp["meta"]["server_time"] = FormatServerTime();
         resp["meta"]["duration_ms"] = duration_ms;
         resp["meta"]["rows_scanned"] = nullptr;
-        resp["meta"]["rows_returned"] = static_cast<int>(data.size());
-        resp["meta"]["cache_hit"] = false;
+        resp["meta"]["rows_returned"] = rows_returned;
+        resp["meta"]["cache_hit"] = cached.has_value();
+        resp["meta"]["in_memory"] = in_memory;
         resp["meta"]["request_id"] = rid;
         if (debug) {
             nlohmann::json resolved;
             resolved["metrics"] = metrics;
             resolved["aggs"] = aggs;
             resolved["bucket_seconds"] = bucket_seconds;
-            resp["debug"] = BuildDebugMeta({duration_ms, static_cast<long>(data.size()), resolved});
+            resp["debug"] = BuildDebugMeta({duration_ms, static_cast<long>(rows_returned), resolved});
         }
-        SendJson(res, resp, 200, rid);
+        // Already a DOM (it is what the cache holds); streaming it still
+        // skips the full dump() string.
+        SendJsonStream(res, [resp = std::move(resp)](telemetry::api::JsonStreamWriter& out) { out.Fields(resp); }, rid);
     } catch (const std::invalid_argument& e) {
         log.RecordError({telemetry::obs::kErrHttpInvalidArgument, e.what(), 400});
         SendError({res, e.what(), 400, telemetry::obs::kErrHttpInvalidArgument, rid});
@@ -866,7 +1083,23 @@ void ApiServer::HandleDatasetHistogram(const httplib::Request& req, httplib::Res
     bool debug = GetStrParam(req, "debug") == "true";
     try {
         auto start = std::chrono::steady_clock::now();
-        auto data = db_client_->GetHistogram(run_id, metric, bins, min_val, max_val, region, is_anomaly, anomaly_type, start_time, end_time);
+        auto cache_key = AnalyticsCache::Fingerprint("histogram", run_id, {
+            {"metric", metric}, {"bins", std::to_string(bins)}, {"min", fmt::format("{:.17g}", min_val)},
+            {"max", fmt::format("{:.17g}", max_val)}, {"region", region}, {"is_anomaly", is_anomaly},
+            {"anomaly_type", anomaly_type}, {"start_time", start_time}, {"end_time", end_time}});
+        auto pin = db_client_->PinAnalyticsReads();
+        auto version = AnalyticsVersion(run_id);
+        auto cached = version ? analytics_cache_->Get(cache_key, *version) : std::nullopt;
+        std::optional<nlohmann::json> in_memory;
+        if (!cached) {
+            if (auto hot = HotDataset(run_id, version)) {
+                in_memory = hot->Histogram(metric, bins, min_val, max_val, {region, is_anomaly, anomaly_type, start_time, end_time});
+            }
+        }
+        auto data = cached      ? *cached
+                    : in_memory ? *in_memory
+                                : db_client_->GetHistogram(run_id, metric, bins, min_val, max_val, region, is_anomaly, anomaly_type, start_time, end_time);
+        if (!cached && version) { analytics_cache_->Put(cache_key, run_id, *version, data); }
         auto end = std::chrono::steady_clock::now();
         double duration_ms = std::chrono::duration<double, std::milli>(end - start).count();
         
@@ -887,7 +1120,8 @@ void ApiServer::HandleDatasetHistogram(const httplib::Request& req, httplib::Res
         data["meta"]["duration_ms"] = duration_ms;
         data["meta"]["rows_scanned"] = nullptr;
         data["meta"]["rows_returned"] = returned_bins;
-        data["meta"]["cache_hit"] = false;
+        data["meta"]["cache_hit"] = cached.has_value();
+        data["meta"]["in_memory"] = in_memory.has_value();
         data["meta"]["request_id"] = rid;
         
         if (debug) {
@@ -926,22 +1160,16 @@ void ApiServer::HandleGetDatasetSamples(const httplib::Request& req, httplib::Re
     std::string sort_by = GetStrParam(req, "sort_by");
     std::string sort_order = GetStrParam(req, "sort_order");
     std::string anchor_time = GetStrParam(req, "anchor_time");
+    std::string cursor = GetStrParam(req, "cursor");
+    bool exact_count = GetStrParam(req, "exact_count") == "true";
 
+    // The queries run here, so sort, cursor and DB errors still get their
+    // status; only serializing the fetched page is left to the stream.
     try {
-        auto data = db_client_->SearchDatasetRecords(
-            run_id,
-            limit,
-            offset,
-            start_time,
-            end_time,
-            is_anomaly,
-            anomaly_type,
-            host_id,
-            region,
-            sort_by,
-            sort_order,
-            anchor_time);
-        SendJson(res, data, 200, rid);
+        auto fields = db_client_->QueryDatasetRecords(run_id, limit, offset, start_time, end_time, is_anomaly,
+                                                      anomaly_type, host_id, region, sort_by, sort_order, anchor_time,
+                                                      cursor, exact_count);
+        SendJsonStream(res, std::move(fields), rid);
     } catch (const std::invalid_argument& e) {
         log.RecordError({telemetry::obs::kErrHttpInvalidArgument, e.what(), 400});
         SendError({res, e.what(), 400, telemetry::obs::kErrHttpInvalidArgument, rid});
@@ -1067,6 +1295,10 @@ void ApiServer::OrchestrateTuning(TuningTask task) {
         // Execution loop with concurrency control
         size_t next_trial = 0;
         std::map<std::string, bool> active_trials;
+        telemetry::ProgressReporter reporter(nullptr, [this, parent_run_id = task.parent_run_id]() {
+            db_client_->Heartbeat(IDbClient::JobType::ModelRun, parent_run_id);
+        });
+        reporter.Start();
 
         while (next_trial < trial_ids.size() || !active_trials.empty()) {
             if (stop_flag->load()) {
@@ -1087,7 +1319,7 @@ void ApiServer::OrchestrateTuning(TuningTask task) {
             }
 
             // Wait and check for trial completions
-            db_client_->Heartbeat(IDbClient::JobType::ModelRun, task.parent_run_id);
+            reporter.Beat();
             std::this_thread::sleep_for(std::chrono::seconds(2));
             
             auto it = active_trials.begin();
@@ -1136,9 +1368,13 @@ void ApiServer::RunPcaTraining(const std::string& model_run_id,
         try {
             std::filesystem::create_directories(output_dir);
 
-            auto artifact = telemetry::training::TrainPcaFromDb(db_manager_, dataset_id, n_components, percentile, [this, model_run_id]() {
+            telemetry::ProgressReporter reporter(nullptr, [this, model_run_id]() {
                 db_client_->Heartbeat(IDbClient::JobType::ModelRun, model_run_id);
             });
+            reporter.Start();
+            auto artifact = telemetry::training::TrainPcaFromDb(db_manager_, dataset_id, n_components, percentile,
+                                                                [&reporter]() { reporter.Beat(); });
+            reporter.Stop();
 
             if (stop_flag->load()) {
                 spdlog::info("Training for model {} aborted by cancellation.", model_run_id);
@@ -1613,9 +1849,12 @@ void ApiServer::HandleGetScores(const httplib::Request& req, httplib::Response&
         return;
     }
 
+    // Pages can run to any limit, so rows stream out of the fetched result;
+    // the queries run first so a failure is still a 500.
     try {
-        auto data = db_client_->GetScores(dataset_id, model_run_id, limit, offset, only_anomalies, min_score, max_score);
-        SendJson(res, data, 200, rid);
+        auto fields = db_client_->QueryScores(dataset_id, model_run_id, limit, offset, only_anomalies, min_score,
+                                              max_score);
+        SendJsonStream(res, std::move(fields), rid);
     } catch (const std::exception& e) {
         log.RecordError({telemetry::obs::kErrDbQueryFailed, e.what(), 500});
         SendError({res, e.what(), 500, telemetry::obs::kErrDbQueryFailed, rid});
@@ -1627,25 +1866,10 @@ void ApiServer::HandleInference(const httplib::Request& req, httplib::Response&
     telemetry::obs::HttpRequestLogScope log({req, res, "api_server", rid});
     try {
         auto start = std::chrono::steady_clock::now();
-        auto j = nlohmann::json::parse(req.body);
-        std::string model_run_id = j.at("model_run_id");
-        auto samples = j.at("samples");
-        
-        // Safety: Limit number of samples
-        if (samples.size() > 1000) {
-            log.RecordError({telemetry::obs::kErrHttpInvalidArgument, "Too many samples (max 1000)", 400});
-            SendError({res, "Too many samples (max 1000)", 400, telemetry::obs::kErrHttpInvalidArgument, rid});
-            return;
-        }
-
-        // Safety: Validate feature vector size (first sample check sufficient for batch consistency)
-        if (!samples.empty()) {
-             // 5 features expected: cpu, mem, disk, rx, tx
-             // In unstructured json, checking size might be tricky if keys are optional.
-             // But valid samples should have keys.
-             // Let's enforce reasonable size or keys.
-             // For strict validation, we'd check each. For simple safety, check count.
-        }
+        // Parsed in one pass straight into feature vectors; stops at the
+        // first sample past the limit.
+        auto request = ParseInferenceRequest(req.body, kMaxInferenceSamples);
+        const std::string& model_run_id = request.model_run_id;
 
         log.AddFields({{"model_run_id", model_run_id}});
         telemetry::obs::Context ctx;
@@ -1655,32 +1879,11 @@ void ApiServer::HandleInference(const httplib::Request& req, httplib::Response&
         telemetry::obs::LogEvent(telemetry::obs::LogLevel::Info, "infer_start", "model",
                                  {{"request_id", rid}, {"model_run_id", model_run_id}});
 
-        // 1. Get Model Info
-        auto model_info = db_client_->GetModelRun(model_run_id);
-        if (model_info.empty()) {
-            log.RecordError({telemetry::obs::kErrHttpNotFound, "Model not found", 404});
-            SendError({res, "Model not found", 404, telemetry::obs::kErrHttpNotFound, rid});
-            return;
-        }
-
-        std::string artifact_path = model_info.value("artifact_path", "");
-        if (artifact_path.empty()) {
-            log.RecordError({telemetry::obs::kErrHttpBadRequest, "Model is not yet complete or has no artifact", 400});
-            SendError({res, "Model is not yet complete or has no artifact", 400, telemetry::obs::kErrHttpBadRequest, rid});
-            return;
-        }
+        // 1. Get Model Info + Load Model (with cache)
+        auto pca = LoadInferenceModel(model_run_id, rid, log, res);
+        if (!pca) { return; }
 
-        // 2. Load Model (with cache)
-        std::shared_ptr<telemetry::anomaly::PcaModel> pca;
-        try {
-            pca = model_cache_->GetOrCreate(model_run_id, artifact_path);
-        } catch (const std::exception& e) {
-            log.RecordError({telemetry::obs::kErrModelLoadFailed, e.what(), 500});
-            SendError({res, "Failed to load PCA model artifact: " + std::string(e.what()), 500, telemetry::obs::kErrModelLoadFailed, rid});
-            return;
-        }
-
-        // 3. Process Samples
+        // 2. Process Samples
         std::string inference_id = db_client_->CreateInferenceRun(model_run_id);
         if (!inference_id.empty()) {
             log.AddFields({{"inference_run_id", inference_id}});
@@ -1688,50 +1891,65 @@ void ApiServer::HandleInference(const httplib::Request& req, httplib::Response&
             telemetry::obs::UpdateContext(ctx);
             // Optional: Transition to RUNNING if CreateInferenceRun returns PENDING
         }
-        int anomaly_count = 0;
-        nlohmann::json results = nlohmann::json::array();
-        for (const auto& s : samples) {
-            telemetry::anomaly::FeatureVector v;
-            v.data[0] = s.value("cpu_usage", 0.0);
-            v.data[1] = s.value("memory_usage", 0.0);
-            v.data[2] = s.value("disk_utilization", 0.0);
-            v.data[3] = s.value("network_rx_rate", 0.0);
-            v.data[4] = s.value("network_tx_rate", 0.0);
-
-            auto score = pca->Score(v);
-            
-            nlohmann::json r;
-            r["is_anomaly"] = score.is_anomaly;
-            r["score"] = score.reconstruction_error;
-            results.push_back(r);
-            if (score.is_anomaly) { anomaly_count++; }
+        const size_t rows = request.samples.size();
+        std::vector<double> errors(rows);
+        std::vector<uint8_t> flags(rows);
+        int anomaly_count = static_cast<int>(pca->ScoreBatch(request.samples.data(), rows, errors.data(), flags.data()));
+
+        // The results array is serialized once and reused for both the
+        // inference run's details and the response body.
+        std::string results;
+        results.reserve(rows * 40 + 2);
+        JsonStreamWriter out([&results](std::string_view chunk) {
+            results.append(chunk);
+            return true;
+        });
+        out.BeginArray();
+        for (size_t i = 0; i < rows; ++i) {
+            out.BeginObject()
+                .Key("is_anomaly").Bool(flags[i] != 0)
+                .Key("score").Double(errors[i])
+                .EndObject();
         }
+        out.EndArray();
+        out.Flush();
 
         auto end = std::chrono::steady_clock::now();
         double latency_ms = std::chrono::duration<double, std::milli>(end - start).count();
         if (!inference_id.empty()) {
-            db_client_->UpdateInferenceRunStatus(inference_id, "COMPLETED", anomaly_count, results, latency_ms);
+            db_client_->UpdateInferenceRunStatusRaw(inference_id, "COMPLETED", anomaly_count, results, latency_ms);
         }
         telemetry::obs::EmitHistogram("infer_duration_ms", latency_ms, "ms", "model",
                                       {{"model_run_id", model_run_id}},
                                       {{"inference_run_id", inference_id}});
-        telemetry::obs::EmitCounter("infer_rows_scored", static_cast<long>(results.size()), "rows", "model",
+        telemetry::obs::EmitCounter("infer_rows_scored", static_cast<long>(rows), "rows", "model",
                                     {{"model_run_id", model_run_id}},
-                                    {{"inference_run_id", inference_id}});
+                                    {{"inference_run_id", inference_id},
+                                     {"rows_per_sec", RowsPerSecond(rows, latency_ms)}});
         telemetry::obs::LogEvent(telemetry::obs::LogLevel::Info, "infer_end", "model",
                                  {{"request_id", rid},
                                   {"model_run_id", model_run_id},
                                   {"inference_run_id", inference_id},
-                                  {"rows", results.size()},
+                                  {"rows", rows},
                                   {"duration_ms", latency_ms}});
 
-        nlohmann::json resp;
-        resp["results"] = results;
-        resp["model_run_id"] = model_run_id;
-        resp["inference_id"] = inference_id;
-        resp["inference_run_id"] = inference_id;
-        resp["anomaly_count"] = anomaly_count;
-        SendJson(res, resp, 200, rid);
+        std::string body;
+        body.reserve(results.size() + 256);
+        JsonStreamWriter resp([&body](std::string_view chunk) {
+            body.append(chunk);
+            return true;
+        });
+        resp.BeginObject()
+            .Key("anomaly_count").Int(anomaly_count)
+            .Key("inference_id").String(inference_id)
+            .Key("inference_run_id").String(inference_id)
+            .Key("model_run_id").String(model_run_id)
+            .Key("request_id").String(rid)
+            .Key("results").Raw(results)
+            .EndObject();
+        resp.Flush();
+        res.status = 200;
+        res.set_content(body, "application/json");
 
     } catch (const std::exception& e) {
         auto code = ClassifyHttpError(e);
@@ -1752,6 +1970,172 @@ void ApiServer::HandleInference(const httplib::Request& req, httplib::Response&
     }
 }
 
+void ApiServer::HandleInferenceBatch(const httplib::Request& req, httplib::Response& res,
+                                     const httplib::ContentReader& content_reader) {
+    std::string rid = GetRequestId(req);
+    telemetry::obs::HttpRequestLogScope log({req, res, "api_server", rid});
+    std::string model_run_id = GetStrParam(req, "model_run_id");
+    if (model_run_id.empty()) {
+        log.RecordError({telemetry::obs::kErrHttpMissingField, "model_run_id is required", 400});
+        SendError({res, "model_run_id is required", 400, telemetry::obs::kErrHttpMissingField, rid});
+        return;
+    }
+    if (req.get_header_value("Content-Type").rfind("application/octet-stream", 0) != 0) {
+        log.RecordError({telemetry::obs::kErrHttpBadRequest, "Content-Type must be application/octet-stream", 400});
+        SendError({res, "Content-Type must be application/octet-stream", 400, telemetry::obs::kErrHttpBadRequest, rid});
+        return;
+    }
+    // Content-Length is only a hint: chunked uploads are decoded the same way.
+    size_t content_length = 0;
+    if (req.has_header("Content-Length")) {
+        try { content_length = std::stoull(req.get_header_value("Content-Length")); } catch (...) {}
+    }
+    if (content_length > payload_max_bytes_) {
+        log.RecordError({telemetry::obs::kErrHttpResourceExhausted, "Payload too large", 413});
+        SendError({res, "Payload too large", 413, telemetry::obs::kErrHttpResourceExhausted, rid});
+        return;
+    }
+    if (content_length % kBatchRowBytes != 0) {
+        log.RecordError({telemetry::obs::kErrHttpInvalidArgument, "Body must be rows of 5 float64", 400});
+        SendError({res, "Body length must be a multiple of " + std::to_string(kBatchRowBytes) +
+                        " bytes (rows of 5 little-endian float64)",
+                   400, telemetry::obs::kErrHttpInvalidArgument, rid});
+        return;
+    }
+
+    try {
+        log.AddFields({{"model_run_id", model_run_id}});
+        telemetry::obs::Context ctx;
+        ctx.request_id = rid;
+        ctx.model_run_id = model_run_id;
+        telemetry::obs::ScopedContext scope(ctx);
+        telemetry::obs::LogEvent(telemetry::obs::LogLevel::Info, "infer_start", "model",
+                                 {{"request_id", rid}, {"model_run_id", model_run_id}, {"format", "f64le"}});
+
+        auto pca = LoadInferenceModel(model_run_id, rid, log, res);
+        if (!pca) { return; }
+
+        std::string inference_id = db_client_->CreateInferenceRun(model_run_id);
+        if (!inference_id.empty()) {
+            log.AddFields({{"inference_run_id", inference_id}});
+            ctx.inference_run_id = inference_id;
+            telemetry::obs::UpdateContext(ctx);
+        }
+
+        // Rows are scored batch by batch as the body arrives, so only the
+        // packed results (9 bytes a row) are held, never the 40-byte rows.
+        struct Results {
+            std::vector<double> errors;
+            std::vector<uint8_t> flags;
+        };
+        auto results = std::make_shared<Results>();
+        results->errors.reserve(content_length / kBatchRowBytes);
+        results->flags.reserve(content_length / kBatchRowBytes);
+        size_t anomaly_count = 0;
+        auto start = std::chrono::steady_clock::now();
+        BatchRowDecoder decoder([&](const telemetry::anomaly::FeatureVector* rows, size_t n) {
+            size_t offset = results->errors.size();
+            results->errors.resize(offset + n);
+            results->flags.resize(offset + n);
+            anomaly_count += pca->ScoreBatch(rows, n, results->errors.data() + offset, results->flags.data() + offset);
+        });
+        if (!content_reader([&decoder](const char* data, size_t len) {
+                decoder.Feed(data, len);
+                return true;
+            })) {
+            log.RecordError({telemetry::obs::kErrHttpBadRequest, "Failed to read request body", 400});
+            SendError({res, "Failed to read request body", 400, telemetry::obs::kErrHttpBadRequest, rid});
+            return;
+        }
+        decoder.Finish();
+        const size_t rows = decoder.Rows();
+
+        auto end = std::chrono::steady_clock::now();
+        double latency_ms = std::chrono::duration<double, std::milli>(end - start).count();
+        double rows_per_sec = RowsPerSecond(rows, latency_ms);
+        if (!inference_id.empty()) {
+            // Per-row results are too large for the run record; keep a summary.
+            nlohmann::json details = {{"format", "f64le"}, {"rows", rows}, {"rows_per_sec", rows_per_sec}};
+            db_client_->UpdateInferenceRunStatus(inference_id, "COMPLETED", static_cast<int>(anomaly_count),
+                                                 details, latency_ms);
+        }
+        telemetry::obs::EmitHistogram("infer_duration_ms", latency_ms, "ms", "model",
+                                      {{"model_run_id", model_run_id}},
+                                      {{"inference_run_id", inference_id}});
+        telemetry::obs::EmitCounter("infer_rows_scored", static_cast<long>(rows), "rows", "model",
+                                    {{"model_run_id", model_run_id}},
+                                    {{"inference_run_id", inference_id}, {"rows_per_sec", rows_per_sec}});
+        telemetry::obs::LogEvent(telemetry::obs::LogLevel::Info, "infer_end", "model",
+                                 {{"request_id", rid},
+                                  {"model_run_id", model_run_id},
+                                  {"inference_run_id", inference_id},
+                                  {"rows", rows},
+                                  {"rows_per_sec", rows_per_sec},
+                                  {"duration_ms", latency_ms}});
+
+        // Body: rows float64 errors, then rows uint8 flags (1 = anomaly).
+        StoreFloat64LE(results->errors);
+        res.status = 200;
+        res.set_header("X-Request-ID", rid);
+        res.set_header("X-Inference-Run-Id", inference_id);
+        res.set_header("X-Rows", std::to_string(rows));
+        res.set_header("X-Anomaly-Count", std::to_string(anomaly_count));
+        res.set_content_provider(
+            rows * (sizeof(double) + sizeof(uint8_t)), "application/octet-stream",
+            [results](size_t offset, size_t length, httplib::DataSink& sink) {
+                const size_t error_bytes = results->errors.size() * sizeof(double);
+                const char* data = nullptr;
+                size_t available = 0;
+                if (offset < error_bytes) {
+                    data = reinterpret_cast<const char*>(results->errors.data()) + offset;
+                    available = error_bytes - offset;
+                } else {
+                    data = reinterpret_cast<const char*>(results->flags.data()) + (offset - error_bytes);
+                    available = results->flags.size() - (offset - error_bytes);
+                }
+                return sink.write(data, std::min({available, length, kBatchResponseChunkBytes}));
+            });
+
+    } catch (const std::exception& e) {
+        auto code = ClassifyHttpError(e);
+        int status = 500;
+        if (code == telemetry::obs::kErrHttpInvalidArgument || code == telemetry::obs::kErrHttpBadRequest) {
+            status = 400;
+        }
+        telemetry::obs::LogEvent(telemetry::obs::LogLevel::Error, "infer_error", "model",
+                                 {{"request_id", rid}, {"error_code", code}, {"error", e.what()}});
+        log.RecordError({code, e.what(), status});
+        SendError({res, std::string("Error: ") + e.what(), status, code, rid});
+    }
+}
+
+auto ApiServer::LoadInferenceModel(const std::string& model_run_id,
+                                   const std::string& rid,
+                                   telemetry::obs::HttpRequestLogScope& log,
+                                   httplib::Response& res) -> std::shared_ptr<telemetry::anomaly::PcaModel> {
+    auto model_info = db_client_->GetModelRun(model_run_id);
+    if (model_info.empty()) {
+        log.RecordError({telemetry::obs::kErrHttpNotFound, "Model not found", 404});
+        SendError({res, "Model not found", 404, telemetry::obs::kErrHttpNotFound, rid});
+        return nullptr;
+    }
+
+    std::string artifact_path = model_info.value("artifact_path", "");
+    if (artifact_path.empty()) {
+        log.RecordError({telemetry::obs::kErrHttpBadRequest, "Model is not yet complete or has no artifact", 400});
+        SendError({res, "Model is not yet complete or has no artifact", 400, telemetry::obs::kErrHttpBadRequest, rid});
+        return nullptr;
+    }
+
+    try {
+        return model_cache_->GetOrCreate(model_run_id, artifact_path);
+    } catch (const std::exception& e) {
+        log.RecordError({telemetry::obs::kErrModelLoadFailed, e.what(), 500});
+        SendError({res, "Failed to load PCA model artifact: " + std::string(e.what()), 500, telemetry::obs::kErrModelLoadFailed, rid});
+        return nullptr;
+    }
+}
+
 void ApiServer::HandleListInferenceRuns(const httplib::Request& req, httplib::Response& res) {
     std::string rid = GetRequestId(req);
     telemetry::obs::HttpRequestLogScope log({req, res, "api_server", rid});
@@ -1873,6 +2257,7 @@ auto ApiServer::HandleScoreDatasetJob(const httplib::Request& req, httplib::Resp
                                       {"model_run_id", model_run_id},
                                       {"score_job_id", job_id}});
             auto job_start = std::chrono::steady_clock::now();
+            std::unique_ptr<telemetry::ProgressReporter> reporter;
             try {
                 auto job_info = db_client_->GetScoreJob(job_id);
                 long total = job_info.value("total_rows", 0L);
@@ -1893,6 +2278,31 @@ auto ApiServer::HandleScoreDatasetJob(const httplib::Request& req, httplib::Resp
                 }
                 auto model = model_cache_->GetOrCreate(model_run_id, artifact_path);
 
+                // processed_rows/last_record_id double as the resume checkpoint; they are
+                // coalesced to one UPDATE per interval instead of one per batch.
+                reporter = std::make_unique<telemetry::ProgressReporter>(
+                    [this, job_id, total](const telemetry::ProgressSnapshot& p) {
+                        db_client_->UpdateScoreJob(job_id, "RUNNING", total, p.rows, p.cursor);
+                    },
+                    [this, job_id]() { db_client_->Heartbeat(IDbClient::JobType::ScoreJob, job_id); });
+                reporter->Update(processed, last_record);
+                reporter->Start();
+
+                // Eval aggregates are only complete when this run scored every
+                // row; a resumed job leaves /eval on the dataset_scores scan.
+                // A job starting from the first row replaces earlier scores
+                // of the pair (a partition drop) instead of appending to them.
+                db_client_->DeleteEvalAggregates(dataset_id, model_run_id);
+                std::optional<telemetry::stats::EvalAggregates> aggregates;
+                if (processed == 0) {
+                    db_client_->ResetDatasetScores(dataset_id, model_run_id);
+                    aggregates.emplace();
+                } else {
+                    // The checkpoint is coalesced, so batches inserted after
+                    // it would be scored a second time; drop them first.
+                    db_client_->TruncateDatasetScores(dataset_id, model_run_id, last_record);
+                }
+
                 const int batch = 5000;
                 while (!stop_flag->load()) {
                     auto rows = db_client_->FetchScoringRowsAfterRecord(dataset_id, last_record, batch);
@@ -1908,12 +2318,18 @@ auto ApiServer::HandleScoreDatasetJob(const httplib::Request& req, httplib::Resp
                         v.data[4] = r.tx;
                         auto score = model->Score(v);
                         scores.emplace_back(r.record_id, std::make_pair(score.reconstruction_error, score.is_anomaly));
+                        if (aggregates) {
+                            aggregates->Add(score.reconstruction_error, score.is_anomaly, r.is_anomaly,
+                                            {r.region, r.project_id, r.anomaly_type});
+                        }
                     }
                     db_client_->InsertDatasetScores(dataset_id, model_run_id, scores);
+                    analytics_cache_->InvalidateDataset(EvalCacheTag(dataset_id, model_run_id));
                     processed += static_cast<long>(rows.size());
                     last_record = rows.back().record_id;
-                    db_client_->UpdateScoreJob(job_id, "RUNNING", total, processed, last_record);
+                    reporter->Update(processed, last_record);
                 }
+                reporter->Stop();
                 
                 if (stop_flag->load()) {
                     spdlog::info("Job {} cancelled by request.", job_id);
@@ -1928,7 +2344,17 @@ auto ApiServer::HandleScoreDatasetJob(const httplib::Request& req, httplib::Resp
                                               {"status", "CANCELLED"},
                                               {"duration_ms", duration_ms}});
                 } else {
+                    if (aggregates) {
+                        try {
+                            db_client_->SaveEvalAggregates(dataset_id, model_run_id, aggregates->ToJson());
+                        } catch (const std::exception& e) {
+                            spdlog::warn("Job {}: eval aggregates not saved: {}", job_id, e.what());
+                        }
+                    }
+                    // /eval may have cached a scan since the last batch.
+                    analytics_cache_->InvalidateDataset(EvalCacheTag(dataset_id, model_run_id));
                     db_client_->UpdateScoreJob(job_id, "COMPLETED", total, processed, last_record);
+                    analytics_cache_->InvalidateDataset(dataset_id);
                     auto job_end = std::chrono::steady_clock::now();
                     double duration_ms = std::chrono::duration<double, std::milli>(job_end - job_start).count();
                     telemetry::obs::LogEvent(telemetry::obs::LogLevel::Info, "score_job_end", "model",
@@ -1944,6 +2370,13 @@ auto ApiServer::HandleScoreDatasetJob(const httplib::Request& req, httplib::Resp
                 long total = job_info.value("total_rows", 0L);
                 long processed = job_info.value("processed_rows", 0L);
                 long last_record = job_info.value("last_record_id", 0L);
+                if (reporter) {
+                    // The DB checkpoint may trail the rows already inserted.
+                    reporter->Stop();
+                    auto p = reporter->Snapshot();
+                    processed = p.rows;
+                    last_record = p.cursor;
+                }
                 db_client_->UpdateScoreJob(job_id, "FAILED", total, processed, last_record, e.what());
                 auto job_end = std::chrono::steady_clock::now();
                 double duration_ms = std::chrono::duration<double, std::milli>(job_end - job_start).count();
@@ -2030,8 +2463,27 @@ void ApiServer::HandleModelEval(const httplib::Request& req, httplib::Response&
     }
     try {
         auto start = std::chrono::steady_clock::now();
-        auto eval = db_client_->GetEvalMetrics(dataset_id, model_run_id, points, max_samples);
+        // Curves only change when new scores land; see EvalCacheTag(). The
+        // dataset version never moves once it SUCCEEDED, so entries are keyed
+        // by the score job that wrote them and only stored once that job is
+        // COMPLETED on the server the scan read from; a scan that raced a
+        // running job (or a lagging replica) is served but not cached.
+        auto pin = db_client_->PinAnalyticsReads();
+        auto job = db_client_->GetAnalyticsLatestScoreJob(dataset_id, model_run_id);
+        bool scores_settled = job.value("status", "") == "COMPLETED";
+        auto cache_key = AnalyticsCache::Fingerprint("eval", dataset_id,
+                                                     {{"model_run_id", model_run_id},
+                                                      {"score_job_id", job.value("job_id", "")},
+                                                      {"points", std::to_string(points)},
+                                                      {"max_samples", std::to_string(max_samples)}});
+        auto version = AnalyticsVersion(dataset_id);
+        auto cached = version && scores_settled ? analytics_cache_->Get(cache_key, *version) : std::nullopt;
+        auto eval = cached ? *cached : db_client_->GetEvalMetrics(dataset_id, model_run_id, points, max_samples);
         auto end = std::chrono::steady_clock::now();
+        if (!cached && version && scores_settled && !eval.empty()) {
+            analytics_cache_->Put(cache_key, EvalCacheTag(dataset_id, model_run_id), *version, eval);
+        }
+        eval["meta"]["cache_hit"] = cached.has_value();
         if (debug) {
             double duration_ms = std::chrono::duration<double, std::milli>(end - start).count();
             long row_count = static_cast<long>(eval.value("roc", nlohmann::json::array()).size());
@@ -2100,6 +2552,35 @@ auto ApiServer::SendJson(httplib::Response& res, nlohmann::json j, int status, c
     res.set_content(j.dump(), "application/json");
 }
 
+auto ApiServer::SendJsonStream(httplib::Response& res,
+                               telemetry::api::JsonFieldsWriter write_fields,
+                               const std::string& request_id) -> void {
+    res.status = 200;
+    res.set_chunked_content_provider(
+        "application/json",
+        [write_fields = std::move(write_fields), request_id](size_t /*offset*/, httplib::DataSink& sink) {
+            telemetry::api::JsonStreamWriter out([&sink](std::string_view chunk) {
+                return sink.write(chunk.data(), chunk.size());
+            });
+            try {
+                out.BeginObject();
+                write_fields(out);
+                if (!request_id.empty()) { out.Key("request_id").String(request_id); }
+                out.EndObject();
+                out.Flush();
+            } catch (const telemetry::api::JsonStreamAborted&) {
+                return false;
+            } catch (const std::exception& e) {
+                spdlog::error("Aborting streamed response after {} bytes (request_id={}): {}",
+                              out.BytesWritten(), request_id, e.what());
+                telemetry::metrics::MetricsRegistry::Instance().Increment("http_stream_aborts_total", {});
+                return false;
+            }
+            sink.done();
+            return true;
+        });
+}
+
 // NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
 void ApiServer::SendError(const ApiErrorArgs& args) {
     telemetry::metrics::MetricsRegistry::Instance().Increment("http_errors_total", {{"status", std::to_string(args.status)}, {"code", args.code}});
@@ -2138,8 +2619,8 @@ auto ApiServer::GetStrParam(const httplib::Request& req, const std::string& key)
 auto ApiServer::ValidateRoutes() -> void {
     // Basic sanity check: ensure registry matches expected count
     // We don't do deep introspection of httplib because it's hard.
-    if (kRequiredRoutes.size() != 35) {
-        spdlog::warn("Route registry count mismatch! Expected 35, got {}", kRequiredRoutes.size());
+    if (kRequiredRoutes.size() != 37) {
+        spdlog::warn("Route registry count mismatch! Expected 37, got {}", kRequiredRoutes.size());
     } else {
         spdlog::info("Route registry validated ({} routes)", kRequiredRoutes.size());
     }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -11,8 +12,15 @@
 #include "job_manager.h"
 #include "job_reconciler.h"
 #include "pca_model_cache.h"
+#include "analytics_cache.h"
+#include "hot_dataset_cache.h"
+#include "json_stream.h"
 #include "training/pca_trainer.h"
 
+namespace telemetry::obs {
+class HttpRequestLogScope;
+}
+
 namespace telemetry::api {
 
 class ApiServer {
@@ -57,6 +65,8 @@ private:
     void HandleGetModelScoredDatasets(const httplib::Request& req, httplib::Response& res);
     void HandleGetScores(const httplib::Request& req, httplib::Response& res);
     void HandleInference(const httplib::Request& req, httplib::Response& res);
+    void HandleInferenceBatch(const httplib::Request& req, httplib::Response& res,
+                              const httplib::ContentReader& content_reader);
     void HandleListInferenceRuns(const httplib::Request& req, httplib::Response& res);
     void HandleGetInferenceRun(const httplib::Request& req, httplib::Response& res);
     void HandleListJobs(const httplib::Request& req, httplib::Response& res);
@@ -74,8 +84,34 @@ private:
 
     void ValidateRoutes();
 
+    // Looks up the model run and loads its artifact through the model cache.
+    // Returns nullptr after sending the 404/400/500 response on failure.
+    auto LoadInferenceModel(const std::string& model_run_id,
+                            const std::string& rid,
+                            telemetry::obs::HttpRequestLogScope& log,
+                            httplib::Response& res) -> std::shared_ptr<telemetry::anomaly::PcaModel>;
+
+    // Dataset version used to key analytics cache entries; nullopt when the
+    // dataset is unknown or its status could not be read (bypass the cache).
+    auto AnalyticsVersion(const std::string& run_id) -> std::optional<AnalyticsCache::DatasetVersion>;
+    // Analytics cache tag for /eval curves; dropped whenever the scorer
+    // writes scores for that (dataset, model) pair.
+    static auto EvalCacheTag(const std::string& dataset_id, const std::string& model_run_id) -> std::string;
+    // Resident columnar copy of a finished dataset, or nullptr (and a load is
+    // queued) when the request has to go to SQL.
+    auto HotDataset(const std::string& run_id, const std::optional<AnalyticsCache::DatasetVersion>& version)
+        -> std::shared_ptr<const ColumnarDataset>;
+
     // Helpers
     void SendJson(httplib::Response& res, nlohmann::json j, int status = 200, const std::string& request_id = "");
+    // 200 with a chunked JSON object: write_fields fills it from the content
+    // provider, after the handler has returned, through one reusable chunk
+    // buffer; request_id is appended. A failure mid-body can no longer
+    // change the status, so it aborts the connection instead: run queries
+    // before calling this and leave write_fields only serialization.
+    void SendJsonStream(httplib::Response& res,
+                        telemetry::api::JsonFieldsWriter write_fields,
+                        const std::string& request_id = "");
     struct ApiErrorArgs {
         httplib::Response& res;
         std::string message;
@@ -90,6 +126,7 @@ private:
     static auto GetStrParam(const httplib::Request& req, const std::string& key) -> std::string;
 
     httplib::Server svr_;
+    size_t payload_max_bytes_ = 1024ULL * 1024ULL * 50ULL; // API_PAYLOAD_MAX_BYTES
     std::unique_ptr<telemetry::TelemetryService::Stub> stub_;
     std::string grpc_target_;
     std::string db_conn_str_;
@@ -98,6 +135,8 @@ private:
     std::unique_ptr<JobManager> job_manager_;
     std::unique_ptr<JobReconciler> job_reconciler_;
     std::unique_ptr<telemetry::anomaly::PcaModelCache> model_cache_;
+    std::unique_ptr<AnalyticsCache> analytics_cache_;
+    std::unique_ptr<HotDatasetCache> hot_datasets_;
 };
 
 } // namespace telemetry::api
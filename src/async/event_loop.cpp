@@ -0,0 +1,137 @@
+#include "async/event_loop.h"
+
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace telemetry::async {
+
+EventLoop::EventLoop() {
+    epoll_fd_ = ::epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd_ < 0) {
+        throw std::runtime_error(std::string("epoll_create1 failed: ") + std::strerror(errno));
+    }
+    wake_fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wake_fd_ < 0) {
+        ::close(epoll_fd_);
+        throw std::runtime_error(std::string("eventfd failed: ") + std::strerror(errno));
+    }
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = wake_fd_;
+    ::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &ev);
+}
+
+EventLoop::~EventLoop() {
+    Stop();
+    ::close(wake_fd_);
+    ::close(epoll_fd_);
+}
+
+auto EventLoop::Start() -> void {
+    if (running_.exchange(true)) { return; }
+    thread_ = std::thread(&EventLoop::Run, this);
+}
+
+auto EventLoop::Stop() -> void {
+    if (!running_.exchange(false)) { return; }
+    uint64_t one = 1;
+    [[maybe_unused]] auto n = ::write(wake_fd_, &one, sizeof(one));
+    if (thread_.joinable()) { thread_.join(); }
+}
+
+auto EventLoop::Post(std::function<void()> fn) -> void {
+    {
+        std::lock_guard<std::mutex> lock(posted_mutex_);
+        posted_.push_back(std::move(fn));
+    }
+    uint64_t one = 1;
+    [[maybe_unused]] auto n = ::write(wake_fd_, &one, sizeof(one));
+}
+
+auto EventLoop::IsLoopThread() const -> bool {
+    return loop_thread_.load(std::memory_order_relaxed) == std::this_thread::get_id();
+}
+
+auto EventLoop::Arm(int fd, uint32_t events, std::coroutine_handle<> h, uint32_t* ready) -> void {
+    if (!IsLoopThread()) {
+        throw std::logic_error("EventLoop::WaitFd awaited off the loop thread");
+    }
+    epoll_event ev{};
+    ev.events = events | EPOLLONESHOT;
+    ev.data.fd = fd;
+    std::lock_guard<std::mutex> lock(fds_mutex_);
+    int op = registered_[fd] ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+    if (::epoll_ctl(epoll_fd_, op, fd, &ev) != 0) {
+        // The fd was closed and reused behind our back; start over.
+        if (op == EPOLL_CTL_MOD && errno == ENOENT) {
+            op = EPOLL_CTL_ADD;
+        } else if (op == EPOLL_CTL_ADD && errno == EEXIST) {
+            op = EPOLL_CTL_MOD;
+        } else {
+            throw std::runtime_error(std::string("epoll_ctl failed: ") + std::strerror(errno));
+        }
+        if (::epoll_ctl(epoll_fd_, op, fd, &ev) != 0) {
+            throw std::runtime_error(std::string("epoll_ctl failed: ") + std::strerror(errno));
+        }
+    }
+    registered_[fd] = true;
+    waiters_[fd] = Waiter{h, ready};
+}
+
+auto EventLoop::Forget(int fd) -> void {
+    std::lock_guard<std::mutex> lock(fds_mutex_);
+    if (registered_.erase(fd) > 0) {
+        ::epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+    }
+    waiters_.erase(fd);
+}
+
+auto EventLoop::DrainPosted() -> void {
+    uint64_t count = 0;
+    [[maybe_unused]] auto n = ::read(wake_fd_, &count, sizeof(count));
+    std::vector<std::function<void()>> batch;
+    {
+        std::lock_guard<std::mutex> lock(posted_mutex_);
+        batch.swap(posted_);
+    }
+    for (auto& fn : batch) { fn(); }
+}
+
+auto EventLoop::Run() -> void {
+    loop_thread_.store(std::this_thread::get_id(), std::memory_order_relaxed);
+    std::array<epoll_event, 64> events{};
+    while (running_.load()) {
+        int n = ::epoll_wait(epoll_fd_, events.data(), static_cast<int>(events.size()), -1);
+        if (n < 0) {
+            if (errno == EINTR) { continue; }
+            break;
+        }
+        for (int i = 0; i < n; ++i) {
+            int fd = events[static_cast<size_t>(i)].data.fd;
+            if (fd == wake_fd_) {
+                DrainPosted();
+                continue;
+            }
+            Waiter waiter;
+            {
+                std::lock_guard<std::mutex> lock(fds_mutex_);
+                auto it = waiters_.find(fd);
+                if (it == waiters_.end()) { continue; }
+                waiter = it->second;
+                waiters_.erase(it);
+            }
+            *waiter.ready = events[static_cast<size_t>(i)].events;
+            waiter.handle.resume();
+        }
+    }
+    loop_thread_.store(std::thread::id{}, std::memory_order_relaxed);
+}
+
+} // namespace telemetry::async
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <coroutine>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace telemetry::async {
+
+/**
+ * @brief Single-threaded epoll reactor that resumes coroutines.
+ *
+ * Any thread may Post() work or co_await Schedule() to hop onto the loop.
+ * WaitFd() must be awaited from the loop thread: the fd is armed one-shot
+ * and the awaiting coroutine resumes there once it is ready. Each fd has at
+ * most one waiter at a time.
+ */
+class EventLoop {
+public:
+    EventLoop();
+    ~EventLoop();
+    EventLoop(const EventLoop&) = delete;
+    auto operator=(const EventLoop&) -> EventLoop& = delete;
+
+    // Runs the reactor on a background thread until Stop().
+    auto Start() -> void;
+    // Stops and joins; work posted afterwards is dropped.
+    auto Stop() -> void;
+
+    auto Post(std::function<void()> fn) -> void;
+    [[nodiscard]] auto IsLoopThread() const -> bool;
+
+    // Resumes the awaiting coroutine on the loop thread (inline when
+    // already there).
+    auto Schedule() noexcept {
+        struct Awaiter {
+            EventLoop* loop;
+            auto await_ready() const noexcept -> bool { return loop->IsLoopThread(); }
+            auto await_suspend(std::coroutine_handle<> h) -> void { loop->Post([h]() { h.resume(); }); }
+            auto await_resume() const noexcept -> void {}
+        };
+        return Awaiter{this};
+    }
+
+    // Suspends until fd reports any of events (EPOLLIN/EPOLLOUT); returns
+    // the epoll event mask, which may include EPOLLERR/EPOLLHUP.
+    auto WaitFd(int fd, uint32_t events) noexcept {
+        struct Awaiter {
+            EventLoop* loop;
+            int fd;
+            uint32_t events;
+            uint32_t ready = 0;
+            auto await_ready() const noexcept -> bool { return false; }
+            auto await_suspend(std::coroutine_handle<> h) -> void { loop->Arm(fd, events, h, &ready); }
+            auto await_resume() const noexcept -> uint32_t { return ready; }
+        };
+        return Awaiter{this, fd, events};
+    }
+
+    // Drops fd from the reactor before it is closed. Any thread: owners
+    // (e.g. a PgConnection) may be destroyed off the loop.
+    auto Forget(int fd) -> void;
+
+private:
+    struct Waiter {
+        std::coroutine_handle<> handle;
+        uint32_t* ready;
+    };
+
+    auto Arm(int fd, uint32_t events, std::coroutine_handle<> h, uint32_t* ready) -> void;
+    auto Run() -> void;
+    auto DrainPosted() -> void;
+
+    int epoll_fd_ = -1;
+    int wake_fd_ = -1;
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+    std::atomic<std::thread::id> loop_thread_{};
+
+    std::mutex posted_mutex_;
+    std::vector<std::function<void()>> posted_;
+
+    // Written by Arm() on the loop thread and Forget() on any thread.
+    std::mutex fds_mutex_;
+    std::unordered_map<int, Waiter> waiters_;
+    std::unordered_map<int, bool> registered_;
+};
+
+} // namespace telemetry::async
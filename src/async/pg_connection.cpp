@@ -0,0 +1,219 @@
+#include "async/pg_connection.h"
+
+#include <sys/epoll.h>
+
+namespace telemetry::async {
+
+namespace {
+
+auto ParamValues(const PgParams& params) -> std::vector<const char*> {
+    std::vector<const char*> values;
+    values.reserve(params.size());
+    for (const auto& p : params) { values.push_back(p ? p->c_str() : nullptr); }
+    return values;
+}
+
+} // namespace
+
+PgConnection::~PgConnection() {
+    if (conn_ == nullptr) { return; }
+    int fd = PQsocket(conn_);
+    if (fd >= 0) { loop_->Forget(fd); }
+    PQfinish(conn_);
+}
+
+auto PgConnection::Connect(EventLoop& loop, std::string conninfo) -> Task<std::unique_ptr<PgConnection>> {
+    PGconn* raw = PQconnectStart(conninfo.c_str());
+    if (raw == nullptr) { throw std::runtime_error("PQconnectStart: out of memory"); }
+    std::unique_ptr<PgConnection> conn(new PgConnection(loop, raw));
+    if (PQstatus(raw) == CONNECTION_BAD) { throw std::runtime_error(PQerrorMessage(raw)); }
+
+    // Per libpq: behave as if the last poll said WRITING.
+    auto status = PGRES_POLLING_WRITING;
+    while (status != PGRES_POLLING_OK) {
+        if (status == PGRES_POLLING_FAILED) { throw std::runtime_error(PQerrorMessage(raw)); }
+        // The socket can change between polls (host fallback, SSL retry).
+        co_await loop.WaitFd(PQsocket(raw), status == PGRES_POLLING_READING ? EPOLLIN : EPOLLOUT);
+        status = PQconnectPoll(raw);
+    }
+    if (PQsetnonblocking(raw, 1) != 0) { throw std::runtime_error(PQerrorMessage(raw)); }
+    co_return conn;
+}
+
+auto PgConnection::Quote(const std::string& value) const -> std::string {
+    char* escaped = PQescapeLiteral(conn_, value.c_str(), value.size());
+    if (escaped == nullptr) { throw std::runtime_error(PQerrorMessage(conn_)); }
+    std::string out(escaped);
+    PQfreemem(escaped);
+    return out;
+}
+
+auto PgConnection::Broken() const -> bool {
+    return PQstatus(conn_) != CONNECTION_OK;
+}
+
+auto PgConnection::Flush() -> Task<void> {
+    while (true) {
+        int rc = PQflush(conn_);
+        if (rc == 0) { co_return; }
+        if (rc < 0) { throw std::runtime_error(PQerrorMessage(conn_)); }
+        // Output is backed up: the server may be waiting for us to read.
+        auto ready = co_await loop_->WaitFd(PQsocket(conn_), EPOLLIN | EPOLLOUT);
+        if ((ready & EPOLLIN) != 0 && PQconsumeInput(conn_) == 0) {
+            throw std::runtime_error(PQerrorMessage(conn_));
+        }
+    }
+}
+
+auto PgConnection::Collect() -> Task<PgResult> {
+    PgResult last;
+    std::string error;
+    while (true) {
+        while (PQisBusy(conn_) != 0) {
+            co_await loop_->WaitFd(PQsocket(conn_), EPOLLIN);
+            if (PQconsumeInput(conn_) == 0) { throw std::runtime_error(PQerrorMessage(conn_)); }
+        }
+        PGresult* res = PQgetResult(conn_);
+        if (res == nullptr) { break; }
+        auto status = PQresultStatus(res);
+        if (status == PGRES_TUPLES_OK || status == PGRES_COMMAND_OK) {
+            last = PgResult(res);
+        } else {
+            // Keep draining so the connection is ready for the next query.
+            if (error.empty()) { error = PQresultErrorMessage(res); }
+            PQclear(res);
+        }
+    }
+    if (!error.empty()) { throw std::runtime_error(error); }
+    co_return last;
+}
+
+auto PgConnection::Query(std::string sql, PgParams params) -> Task<PgResult> {
+    auto values = ParamValues(params);
+    if (PQsendQueryParams(conn_, sql.c_str(), static_cast<int>(values.size()), nullptr, values.data(),
+                          nullptr, nullptr, 0) == 0) {
+        throw std::runtime_error(PQerrorMessage(conn_));
+    }
+    co_await Flush();
+    co_return co_await Collect();
+}
+
+auto PgConnection::QueryPrepared(std::string name, std::string sql, PgParams params) -> Task<PgResult> {
+    if (prepared_.count(name) == 0) {
+        if (PQsendPrepare(conn_, name.c_str(), sql.c_str(), 0, nullptr) == 0) {
+            throw std::runtime_error(PQerrorMessage(conn_));
+        }
+        co_await Flush();
+        co_await Collect();
+        prepared_.insert(name);
+    }
+    auto values = ParamValues(params);
+    if (PQsendQueryPrepared(conn_, name.c_str(), static_cast<int>(values.size()), values.data(),
+                            nullptr, nullptr, 0) == 0) {
+        throw std::runtime_error(PQerrorMessage(conn_));
+    }
+    co_await Flush();
+    co_return co_await Collect();
+}
+
+auto AsyncPgPool::Lease::operator=(Lease&& other) noexcept -> Lease& {
+    if (this != &other) {
+        if (conn_ && pool_ != nullptr) { pool_->Release(std::move(conn_)); }
+        pool_ = other.pool_;
+        conn_ = std::move(other.conn_);
+    }
+    return *this;
+}
+
+AsyncPgPool::Lease::~Lease() {
+    if (conn_ && pool_ != nullptr) { pool_->Release(std::move(conn_)); }
+}
+
+AsyncPgPool::AsyncPgPool(std::string conninfo, std::vector<EventLoop*> loops, size_t size)
+    : conninfo_(std::move(conninfo)), loops_(std::move(loops)), size_(size > 0 ? size : 1) {
+    if (loops_.empty()) { throw std::invalid_argument("AsyncPgPool needs at least one event loop"); }
+}
+
+AsyncPgPool::~AsyncPgPool() = default;
+
+auto AsyncPgPool::NextLoop() -> EventLoop& {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return *loops_[next_loop_++ % loops_.size()];
+}
+
+auto AsyncPgPool::Acquire() -> Task<Lease> {
+    // Takes an idle connection, claims a slot to open one, or queues.
+    struct SlotAwaiter {
+        AsyncPgPool* pool;
+        std::unique_ptr<PgConnection>* slot;
+        auto await_ready() const noexcept -> bool { return false; }
+        auto await_suspend(std::coroutine_handle<> h) -> bool {
+            std::lock_guard<std::mutex> lock(pool->mutex_);
+            if (!pool->idle_.empty()) {
+                *slot = std::move(pool->idle_.back());
+                pool->idle_.pop_back();
+                return false;
+            }
+            if (pool->open_ < pool->size_) {
+                pool->open_++;
+                return false;
+            }
+            pool->waiters_.push_back(Waiter{h, slot});
+            return true;
+        }
+        auto await_resume() const noexcept -> void {}
+    };
+
+    std::unique_ptr<PgConnection> conn;
+    co_await SlotAwaiter{this, &conn};
+    if (conn) {
+        co_await conn->Loop().Schedule();
+        co_return Lease{this, std::move(conn)};
+    }
+
+    EventLoop& loop = NextLoop();
+    co_await loop.Schedule();
+    bool failed = false;
+    std::string error;
+    try {
+        conn = co_await PgConnection::Connect(loop, conninfo_);
+    } catch (const std::exception& e) {
+        failed = true;
+        error = e.what();
+    }
+    if (failed) {
+        Release(nullptr); // give the slot back
+        throw std::runtime_error("Async DB connect failed: " + error);
+    }
+    co_return Lease{this, std::move(conn)};
+}
+
+auto AsyncPgPool::Release(std::unique_ptr<PgConnection> conn) -> void {
+    if (conn && conn->Broken()) { conn.reset(); }
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (waiters_.empty()) {
+        if (conn) {
+            idle_.push_back(std::move(conn));
+        } else {
+            open_--;
+        }
+        return;
+    }
+    Waiter waiter = waiters_.front();
+    waiters_.pop_front();
+    EventLoop* target = loops_[next_loop_++ % loops_.size()];
+    if (conn) {
+        target = &conn->Loop();
+        *waiter.slot = std::move(conn);
+    }
+    lock.unlock();
+    // An empty slot tells the waiter to open a replacement itself.
+    target->Post([h = waiter.handle]() { h.resume(); });
+}
+
+auto AsyncPgPool::GetStats() const -> Stats {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return Stats{size_, open_, idle_.size(), waiters_.size()};
+}
+
+} // namespace telemetry::async
@@ -0,0 +1,206 @@
+#pragma once
+
+#include <charconv>
+#include <cstdlib>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_set>
+#include <vector>
+
+#include <libpq-fe.h>
+
+#include "async/event_loop.h"
+#include "async/task.h"
+
+namespace telemetry::async {
+
+/**
+ * @brief Read-only view of a libpq result with the subset of the
+ * pqxx::result/row/field API the analytics code uses, so result shaping can
+ * be shared between the blocking and async clients.
+ */
+class PgResult {
+public:
+    class Field {
+    public:
+        Field(const PGresult* res, int row, int col) : res_(res), row_(row), col_(col) {}
+        [[nodiscard]] auto is_null() const -> bool { return PQgetisnull(res_, row_, col_) != 0; }
+        [[nodiscard]] auto c_str() const -> const char* { return PQgetvalue(res_, row_, col_); }
+
+        template <typename T>
+        [[nodiscard]] auto as() const -> T {
+            if (is_null()) { throw std::domain_error("Null value in column " + std::to_string(col_)); }
+            const char* s = c_str();
+            if constexpr (std::is_same_v<T, std::string>) {
+                return std::string(s, static_cast<size_t>(PQgetlength(res_, row_, col_)));
+            } else if constexpr (std::is_same_v<T, bool>) {
+                return s[0] == 't';
+            } else if constexpr (std::is_integral_v<T>) {
+                T v{};
+                const char* end = s + PQgetlength(res_, row_, col_);
+                auto [ptr, ec] = std::from_chars(s, end, v);
+                if (ec != std::errc{} || ptr != end) { throw std::invalid_argument(std::string("Not an integer: ") + s); }
+                return v;
+            } else {
+                static_assert(std::is_floating_point_v<T>, "unsupported conversion");
+                // strtod also takes Postgres' NaN/Infinity spellings.
+                return static_cast<T>(std::strtod(s, nullptr));
+            }
+        }
+
+    private:
+        const PGresult* res_;
+        int row_;
+        int col_;
+    };
+
+    class Row {
+    public:
+        Row(const PGresult* res, int row) : res_(res), row_(row) {}
+        auto operator[](int col) const -> Field { return {res_, row_, col}; }
+        auto operator[](size_t col) const -> Field { return {res_, row_, static_cast<int>(col)}; }
+
+    private:
+        const PGresult* res_;
+        int row_;
+    };
+
+    class Iterator {
+    public:
+        Iterator(const PGresult* res, int row) : res_(res), row_(row) {}
+        auto operator*() const -> Row { return {res_, row_}; }
+        auto operator++() -> Iterator& { ++row_; return *this; }
+        auto operator!=(const Iterator& other) const -> bool { return row_ != other.row_; }
+
+    private:
+        const PGresult* res_;
+        int row_;
+    };
+
+    PgResult() = default;
+    explicit PgResult(PGresult* res) : res_(res, PQclear) {}
+
+    [[nodiscard]] auto size() const -> size_t { return res_ ? static_cast<size_t>(PQntuples(res_.get())) : 0; }
+    [[nodiscard]] auto empty() const -> bool { return size() == 0; }
+    [[nodiscard]] auto columns() const -> int { return res_ ? PQnfields(res_.get()) : 0; }
+    [[nodiscard]] auto affected_rows() const -> long {
+        return res_ ? std::strtol(PQcmdTuples(res_.get()), nullptr, 10) : 0;
+    }
+    auto operator[](size_t row) const -> Row { return {res_.get(), static_cast<int>(row)}; }
+    auto operator[](int row) const -> Row { return {res_.get(), row}; }
+    [[nodiscard]] auto begin() const -> Iterator { return {res_.get(), 0}; }
+    [[nodiscard]] auto end() const -> Iterator { return {res_.get(), static_cast<int>(size())}; }
+
+private:
+    std::shared_ptr<PGresult> res_;
+};
+
+using PgParams = std::vector<std::optional<std::string>>;
+
+/**
+ * @brief Nonblocking libpq connection driven by an EventLoop. All I/O
+ * happens on that loop's thread; callers hop there (Schedule()) first.
+ * One statement is in flight at a time.
+ */
+class PgConnection {
+public:
+    // Safe on any thread (pools close idle connections after their loop stops).
+    ~PgConnection();
+    PgConnection(const PgConnection&) = delete;
+    auto operator=(const PgConnection&) -> PgConnection& = delete;
+
+    // Opens a connection without blocking the loop. Call on loop's thread.
+    static auto Connect(EventLoop& loop, std::string conninfo) -> Task<std::unique_ptr<PgConnection>>;
+
+    // Unnamed statement with text parameters.
+    auto Query(std::string sql, PgParams params) -> Task<PgResult>;
+
+    // Named statement, prepared on this connection the first time it runs.
+    auto QueryPrepared(std::string name, std::string sql, PgParams params) -> Task<PgResult>;
+
+    // SQL literal for value, escaped for this connection's encoding.
+    [[nodiscard]] auto Quote(const std::string& value) const -> std::string;
+
+    [[nodiscard]] auto Broken() const -> bool;
+    [[nodiscard]] auto Loop() const -> EventLoop& { return *loop_; }
+
+private:
+    PgConnection(EventLoop& loop, PGconn* conn) : loop_(&loop), conn_(conn) {}
+
+    auto Flush() -> Task<void>;
+    auto Collect() -> Task<PgResult>;
+
+    EventLoop* loop_;
+    PGconn* conn_;
+    std::unordered_set<std::string> prepared_;
+};
+
+/**
+ * @brief Bounded set of PgConnections spread round-robin over event loops.
+ * Acquire() suspends instead of blocking when every connection is busy;
+ * the releasing coroutine hands its connection straight to the next waiter.
+ * A connection that broke mid-query is closed rather than reused. Stop the
+ * loops before destroying the pool: idle connections unregister from them.
+ */
+class AsyncPgPool {
+public:
+    class Lease {
+    public:
+        Lease() = default;
+        Lease(AsyncPgPool* pool, std::unique_ptr<PgConnection> conn) : pool_(pool), conn_(std::move(conn)) {}
+        Lease(Lease&& other) noexcept = default;
+        auto operator=(Lease&& other) noexcept -> Lease&;
+        Lease(const Lease&) = delete;
+        auto operator=(const Lease&) -> Lease& = delete;
+        ~Lease();
+
+        auto operator->() const -> PgConnection* { return conn_.get(); }
+        auto operator*() const -> PgConnection& { return *conn_; }
+
+    private:
+        AsyncPgPool* pool_ = nullptr;
+        std::unique_ptr<PgConnection> conn_;
+    };
+
+    AsyncPgPool(std::string conninfo, std::vector<EventLoop*> loops, size_t size);
+    ~AsyncPgPool();
+    AsyncPgPool(const AsyncPgPool&) = delete;
+    auto operator=(const AsyncPgPool&) -> AsyncPgPool& = delete;
+
+    // Resolves on the leased connection's loop thread.
+    auto Acquire() -> Task<Lease>;
+
+    struct Stats {
+        size_t size = 0;
+        size_t open = 0;
+        size_t idle = 0;
+        size_t waiting = 0;
+    };
+    [[nodiscard]] auto GetStats() const -> Stats;
+
+private:
+    struct Waiter {
+        std::coroutine_handle<> handle;
+        std::unique_ptr<PgConnection>* slot; // empty on resume: open a new one
+    };
+
+    auto Release(std::unique_ptr<PgConnection> conn) -> void;
+    auto NextLoop() -> EventLoop&;
+
+    std::string conninfo_;
+    std::vector<EventLoop*> loops_;
+    size_t size_;
+
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<PgConnection>> idle_;
+    std::deque<Waiter> waiters_;
+    size_t open_ = 0;
+    size_t next_loop_ = 0;
+};
+
+} // namespace telemetry::async
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <future>
+#include <memory>
+#include <optional>
+#include <utility>
+
+namespace telemetry::async {
+
+template <typename T = void>
+class Task;
+
+namespace detail {
+
+struct PromiseBase {
+    std::coroutine_handle<> continuation = std::noop_coroutine();
+    std::exception_ptr error;
+
+    struct FinalAwaiter {
+        auto await_ready() noexcept -> bool { return false; }
+        template <typename Promise>
+        auto await_suspend(std::coroutine_handle<Promise> h) noexcept -> std::coroutine_handle<> {
+            return h.promise().continuation;
+        }
+        auto await_resume() noexcept -> void {}
+    };
+
+    auto initial_suspend() noexcept -> std::suspend_always { return {}; }
+    auto final_suspend() noexcept -> FinalAwaiter { return {}; }
+    auto unhandled_exception() noexcept -> void { error = std::current_exception(); }
+};
+
+template <typename T>
+struct Promise : PromiseBase {
+    std::optional<T> value;
+
+    auto get_return_object() -> Task<T>;
+    template <typename U>
+    auto return_value(U&& v) -> void { value.emplace(std::forward<U>(v)); }
+    auto Take() -> T {
+        if (error) { std::rethrow_exception(error); }
+        return std::move(*value);
+    }
+};
+
+template <>
+struct Promise<void> : PromiseBase {
+    auto get_return_object() -> Task<void>;
+    auto return_void() noexcept -> void {}
+    auto Take() -> void {
+        if (error) { std::rethrow_exception(error); }
+    }
+};
+
+// Fire-and-forget frame used to drive a Task from non-coroutine code.
+struct Detached {
+    struct promise_type {
+        auto get_return_object() noexcept -> Detached { return {}; }
+        auto initial_suspend() noexcept -> std::suspend_never { return {}; }
+        auto final_suspend() noexcept -> std::suspend_never { return {}; }
+        auto return_void() noexcept -> void {}
+        auto unhandled_exception() noexcept -> void { std::terminate(); }
+    };
+};
+
+} // namespace detail
+
+/**
+ * @brief Lazily started coroutine returning T. Nothing runs until the task
+ * is awaited (or handed to ToFuture); completion resumes the awaiter by
+ * symmetric transfer, and exceptions propagate to it.
+ *
+ * Coroutine parameters are copied into the frame, so take them by value:
+ * a reference parameter outlives nothing once the caller moves on.
+ */
+template <typename T>
+class [[nodiscard]] Task {
+public:
+    using promise_type = detail::Promise<T>;
+
+    Task() = default;
+    explicit Task(std::coroutine_handle<promise_type> h) : handle_(h) {}
+    Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+    auto operator=(Task&& other) noexcept -> Task& {
+        if (this != &other) {
+            if (handle_) { handle_.destroy(); }
+            handle_ = std::exchange(other.handle_, {});
+        }
+        return *this;
+    }
+    Task(const Task&) = delete;
+    auto operator=(const Task&) -> Task& = delete;
+    ~Task() {
+        if (handle_) { handle_.destroy(); }
+    }
+
+    auto operator co_await() && noexcept {
+        struct Awaiter {
+            std::coroutine_handle<promise_type> handle;
+            auto await_ready() const noexcept -> bool { return !handle || handle.done(); }
+            auto await_suspend(std::coroutine_handle<> awaiting) noexcept -> std::coroutine_handle<> {
+                handle.promise().continuation = awaiting;
+                return handle;
+            }
+            auto await_resume() -> T { return handle.promise().Take(); }
+        };
+        return Awaiter{handle_};
+    }
+
+private:
+    std::coroutine_handle<promise_type> handle_;
+};
+
+namespace detail {
+
+template <typename T>
+auto Promise<T>::get_return_object() -> Task<T> {
+    return Task<T>{std::coroutine_handle<Promise<T>>::from_promise(*this)};
+}
+
+inline auto Promise<void>::get_return_object() -> Task<void> {
+    return Task<void>{std::coroutine_handle<Promise<void>>::from_promise(*this)};
+}
+
+template <typename T>
+auto Drive(Task<T> task, std::shared_ptr<std::promise<T>> result) -> Detached {
+    try {
+        if constexpr (std::is_void_v<T>) {
+            co_await std::move(task);
+            result->set_value();
+        } else {
+            result->set_value(co_await std::move(task));
+        }
+    } catch (...) {
+        result->set_exception(std::current_exception());
+    }
+}
+
+} // namespace detail
+
+/**
+ * @brief Starts task on the calling thread and returns its eventual result.
+ * The task runs inline until its first suspension (typically a hop onto an
+ * EventLoop), so many tasks can be started before any is waited on.
+ */
+template <typename T>
+auto ToFuture(Task<T> task) -> std::future<T> {
+    auto result = std::make_shared<std::promise<T>>();
+    auto future = result->get_future();
+    detail::Drive(std::move(task), std::move(result));
+    return future;
+}
+
+// Blocks the calling thread on task. Never call it from an EventLoop thread.
+template <typename T>
+auto SyncWait(Task<T> task) -> T {
+    return ToFuture(std::move(task)).get();
+}
+
+} // namespace telemetry::async
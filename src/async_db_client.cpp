@@ -0,0 +1,239 @@
+#include "async_db_client.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+#include <spdlog/spdlog.h>
+
+#include "db_client.h"
+#include "pagination.h"
+#include "statement_registry.h"
+
+using telemetry::async::PgConnection;
+using telemetry::async::PgParams;
+using telemetry::async::PgResult;
+using telemetry::db::ShapedQuery;
+
+auto AsyncDbArgs::FromEnv() -> AsyncDbArgs {
+    AsyncDbArgs args;
+    try {
+        if (const char* env = std::getenv("ASYNC_DB_THREADS")) {
+            long v = std::stol(env);
+            if (v > 0) { args.threads = static_cast<size_t>(v); }
+        }
+    } catch (...) {}
+    try {
+        if (const char* env = std::getenv("ASYNC_DB_CONNECTIONS")) {
+            long v = std::stol(env);
+            if (v > 0) { args.connections = static_cast<size_t>(v); }
+        }
+    } catch (...) {}
+    return args;
+}
+
+AsyncDbClient::AsyncDbClient(std::string connection_string, AsyncDbArgs args) {
+    DbClient::RegisterStatements();
+    std::vector<telemetry::async::EventLoop*> loops;
+    for (size_t i = 0; i < std::max<size_t>(args.threads, 1); ++i) {
+        loops_.push_back(std::make_unique<telemetry::async::EventLoop>());
+        loops_.back()->Start();
+        loops.push_back(loops_.back().get());
+    }
+    pool_ = std::make_unique<telemetry::async::AsyncPgPool>(std::move(connection_string), std::move(loops),
+                                                             args.connections);
+}
+
+AsyncDbClient::~AsyncDbClient() {
+    // Loops first, so no coroutine touches a connection while it closes.
+    for (auto& loop : loops_) { loop->Stop(); }
+    pool_.reset();
+    loops_.clear();
+}
+
+auto AsyncDbClient::ExecShaped(PgConnection& conn, ShapedQuery q) -> Task<PgResult> {
+    PgParams params(q.params.begin(), q.params.end());
+    auto name = telemetry::db::StatementRegistry::Instance().RegisterShape(q.sql);
+    if (!name) { co_return co_await conn.Query(std::move(q.sql), std::move(params)); }
+    co_return co_await conn.QueryPrepared(std::move(*name), std::move(q.sql), std::move(params));
+}
+
+auto AsyncDbClient::ExecNamed(PgConnection& conn, std::string name, PgParams params) -> Task<PgResult> {
+    auto sql = telemetry::db::StatementRegistry::Instance().Sql(name);
+    co_return co_await conn.QueryPrepared(std::move(name), std::move(sql), std::move(params));
+}
+
+auto AsyncDbClient::FetchScoringRowsAfterRecord(std::string dataset_id,
+                                                long last_record_id,
+                                                int limit) -> Task<std::vector<IDbClient::ScoringRow>> {
+    std::vector<IDbClient::ScoringRow> rows;
+    try {
+        auto conn = co_await pool_->Acquire();
+        PgParams params{dataset_id, std::to_string(last_record_id), std::to_string(limit)};
+        auto res = co_await ExecNamed(*conn, "fetch_scoring_rows", std::move(params));
+        rows.reserve(res.size());
+        for (const auto& row : res) {
+            IDbClient::ScoringRow r;
+            r.record_id = row[0].as<long>();
+            r.is_anomaly = row[1].as<bool>();
+            r.cpu = row[2].as<double>();
+            r.mem = row[3].as<double>();
+            r.disk = row[4].as<double>();
+            r.rx = row[5].as<double>();
+            r.tx = row[6].as<double>();
+            r.region = row[7].as<std::string>();
+            r.project_id = row[8].as<std::string>();
+            r.anomaly_type = row[9].as<std::string>();
+            rows.push_back(r);
+        }
+    } catch (const std::exception& e) {
+        spdlog::error("Failed to fetch scoring rows: {}", e.what());
+        throw;
+    }
+    co_return rows;
+}
+
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+auto AsyncDbClient::GetTopK(std::string run_id,
+                            std::string column,
+                            int k,
+                            std::string region,
+                            std::string is_anomaly,
+                            std::string anomaly_type,
+                            std::string start_time,
+                            std::string end_time,
+                            bool include_total_distinct) -> Task<nlohmann::json> { // NOLINTEND(bugprone-easily-swappable-parameters)
+    if (!DbClient::IsValidDimension(column)) {
+        throw std::invalid_argument("Invalid column: " + column);
+    }
+    nlohmann::json out;
+    out["items"] = nlohmann::json::array();
+    try {
+        auto queries = telemetry::db::BuildTopKQueries(run_id, column, k, region, is_anomaly, anomaly_type,
+                                                       start_time, end_time, include_total_distinct);
+        auto conn = co_await pool_->Acquire();
+        if (queries.total_distinct) {
+            auto res_count = co_await ExecShaped(*conn, *queries.total_distinct);
+            out["total_distinct"] = res_count.empty() ? 0 : res_count[0][0].as<long>();
+        }
+        auto res = co_await ExecShaped(*conn, queries.rows);
+        telemetry::db::AppendTopKRows(out, res, k);
+    } catch (const std::exception& e) {
+        spdlog::error("Failed to get topk for {}: {}", run_id, e.what());
+        throw;
+    }
+    co_return out;
+}
+
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+auto AsyncDbClient::GetTimeSeries(std::string run_id,
+                                  std::vector<std::string> metrics,
+                                  std::vector<std::string> aggs,
+                                  int bucket_seconds,
+                                  std::string region,
+                                  std::string is_anomaly,
+                                  std::string anomaly_type,
+                                  std::string start_time,
+                                  std::string end_time,
+                                  std::string percentile_mode) -> Task<nlohmann::json> { // NOLINTEND(bugprone-easily-swappable-parameters)
+    for (const auto& metric : metrics) {
+        if (!DbClient::IsValidMetric(metric)) {
+            throw std::invalid_argument("Invalid metric: " + metric);
+        }
+    }
+    for (const auto& agg : aggs) {
+        if (!DbClient::IsValidAggregation(agg)) {
+            throw std::invalid_argument("Invalid aggregation: " + agg);
+        }
+    }
+    if (percentile_mode != "exact" && percentile_mode != "approx") {
+        throw std::invalid_argument("Invalid percentile_mode: " + percentile_mode);
+    }
+    nlohmann::json out = nlohmann::json::array();
+    try {
+        auto queries = telemetry::db::BuildRawTimeSeriesQueries(run_id, metrics, aggs, bucket_seconds,
+                                                                percentile_mode == "approx", region, is_anomaly,
+                                                                anomaly_type, start_time, end_time);
+        auto conn = co_await pool_->Acquire();
+        out = telemetry::db::TimeSeriesRowsToJson(co_await ExecShaped(*conn, queries.rows), metrics, aggs);
+        for (const auto& [metric, bins_q] : queries.sketch_bins) {
+            telemetry::db::ApplySketchBins(out, co_await ExecShaped(*conn, bins_q), metric, aggs);
+        }
+    } catch (const std::exception& e) {
+        spdlog::error("Failed to get timeseries {}: {}", run_id, e.what());
+        throw;
+    }
+    co_return out;
+}
+
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+auto AsyncDbClient::SearchDatasetRecords(std::string run_id,
+                                         int limit,
+                                         int offset,
+                                         std::string start_time,
+                                         std::string end_time,
+                                         std::string is_anomaly,
+                                         std::string anomaly_type,
+                                         std::string host_id,
+                                         std::string region,
+                                         std::string sort_by,
+                                         std::string sort_order,
+                                         std::string anchor_time,
+                                         std::string cursor,
+                                         bool exact_count) -> Task<nlohmann::json> { // NOLINTEND(bugprone-easily-swappable-parameters)
+    nlohmann::json out = nlohmann::json::object();
+    out["items"] = nlohmann::json::array();
+    try {
+        auto sort = telemetry::db::ResolveSearchSort(sort_by, sort_order, cursor, offset);
+        const std::string& sort_dir = sort.dir;
+        const auto& after = sort.after;
+
+        auto conn = co_await pool_->Acquire();
+        auto queries = telemetry::db::BuildSearchQueries(run_id, limit, offset, start_time, end_time, is_anomaly,
+                                                         anomaly_type, host_id, region, anchor_time, sort);
+        auto res = co_await ExecShaped(*conn, std::move(queries.page));
+        bool has_more = static_cast<int>(res.size()) > limit;
+        std::optional<telemetry::api::SearchCursor> last;
+        for (const auto& row : res) {
+            if (static_cast<int>(out["items"].size()) >= limit) { break; }
+            out["items"].push_back(telemetry::db::SearchRowToJson(row));
+            last = telemetry::api::SearchCursor{row[13].as<int64_t>(), row[0].as<long>(), sort_dir};
+        }
+
+        std::optional<long> total;
+        std::string count_source = "exact";
+        if (exact_count) {
+            auto count_res = co_await ExecShaped(*conn, std::move(queries.exact_count));
+            total = count_res.empty() ? 0 : count_res[0][0].as<long>();
+        } else if (queries.catalog_shape) {
+            auto catalog = co_await ExecNamed(*conn, "get_dataset_catalog", PgParams(1, run_id));
+            if (!catalog.empty()) {
+                total = telemetry::db::CatalogSearchTotal(catalog[0][0].as<long>(), catalog[0][1].as<long>(), is_anomaly);
+                count_source = "catalog";
+            }
+        }
+        if (!total.has_value()) {
+            auto plan = co_await ExecShaped(*conn, std::move(queries.estimate));
+            total = plan.empty() ? 0 : telemetry::db::PlanRowsEstimate(plan[0][0].c_str());
+            count_source = "estimate";
+        }
+
+        out["total"] = *total;
+        out["total_is_estimate"] = count_source == "estimate";
+        out["count_source"] = count_source;
+        out["limit"] = limit;
+        out["offset"] = after.has_value() ? 0 : offset;
+        out["returned"] = static_cast<int>(out["items"].size());
+        out["has_more"] = has_more;
+        out["next_cursor"] = has_more && last.has_value() ? nlohmann::json(telemetry::api::EncodeSearchCursor(*last))
+                                                          : nlohmann::json(nullptr);
+        out["sort_by"] = sort.column;
+        out["sort_order"] = sort_dir;
+        if (!anchor_time.empty()) {
+            out["anchor_time"] = anchor_time;
+        }
+    } catch (const std::exception& e) {
+        spdlog::error("Failed to search dataset records: {}", e.what());
+        throw;
+    }
+    co_return out;
+}
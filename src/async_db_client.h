@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "analytics_queries.h"
+#include "async/event_loop.h"
+#include "async/pg_connection.h"
+#include "async/task.h"
+#include "idb_client.h"
+
+struct AsyncDbArgs {
+    size_t threads = 2;      // event loops driving the connections
+    size_t connections = 16; // libpq connections across all loops
+
+    // ASYNC_DB_THREADS, ASYNC_DB_CONNECTIONS.
+    static auto FromEnv() -> AsyncDbArgs;
+};
+
+/**
+ * @brief Awaitable variants of the hot DbClient read paths, on nonblocking
+ * libpq connections driven by a few epoll event loops. A handful of loop
+ * threads keeps hundreds of queries in flight; callers suspend on
+ * connection checkout instead of parking an OS thread.
+ *
+ * Results match DbClient's: SQL text and JSON shaping come from
+ * analytics_queries.h, and named statements come from DbClient's catalog,
+ * prepared lazily per connection. GetTimeSeries always scans the raw table
+ * (DbClient may answer from telemetry_rollups; the numbers agree).
+ *
+ * Tasks are lazy and take parameters by value. Every task must finish
+ * before the client is destroyed.
+ */
+class AsyncDbClient {
+public:
+    template <typename T>
+    using Task = telemetry::async::Task<T>;
+
+    explicit AsyncDbClient(std::string connection_string, AsyncDbArgs args = AsyncDbArgs::FromEnv());
+    ~AsyncDbClient();
+    AsyncDbClient(const AsyncDbClient&) = delete;
+    auto operator=(const AsyncDbClient&) -> AsyncDbClient& = delete;
+
+    auto FetchScoringRowsAfterRecord(std::string dataset_id,
+                                     long last_record_id,
+                                     int limit) -> Task<std::vector<IDbClient::ScoringRow>>;
+
+    auto GetTopK(std::string run_id,
+                 std::string column,
+                 int k,
+                 std::string region,
+                 std::string is_anomaly,
+                 std::string anomaly_type,
+                 std::string start_time,
+                 std::string end_time,
+                 bool include_total_distinct = false) -> Task<nlohmann::json>;
+
+    auto GetTimeSeries(std::string run_id,
+                       std::vector<std::string> metrics,
+                       std::vector<std::string> aggs,
+                       int bucket_seconds,
+                       std::string region,
+                       std::string is_anomaly,
+                       std::string anomaly_type,
+                       std::string start_time,
+                       std::string end_time,
+                       std::string percentile_mode = "exact") -> Task<nlohmann::json>;
+
+    auto SearchDatasetRecords(std::string run_id,
+                              int limit,
+                              int offset,
+                              std::string start_time,
+                              std::string end_time,
+                              std::string is_anomaly,
+                              std::string anomaly_type,
+                              std::string host_id,
+                              std::string region,
+                              std::string sort_by,
+                              std::string sort_order,
+                              std::string anchor_time,
+                              std::string cursor = "",
+                              bool exact_count = false) -> Task<nlohmann::json>;
+
+    [[nodiscard]] auto GetPoolStats() const -> telemetry::async::AsyncPgPool::Stats { return pool_->GetStats(); }
+
+private:
+    // Runs q as a shape-keyed prepared statement (unnamed past the budget).
+    static auto ExecShaped(telemetry::async::PgConnection& conn, telemetry::db::ShapedQuery q)
+        -> Task<telemetry::async::PgResult>;
+    // Runs a statement from DbClient's catalog.
+    static auto ExecNamed(telemetry::async::PgConnection& conn, std::string name, telemetry::async::PgParams params)
+        -> Task<telemetry::async::PgResult>;
+
+    std::vector<std::unique_ptr<telemetry::async::EventLoop>> loops_;
+    std::unique_ptr<telemetry::async::AsyncPgPool> pool_;
+};
@@ -0,0 +1,680 @@
+#include "async_server.h"
+
+#include <grpcpp/alarm.h>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+
+// Fixed set of threads for handler work that blocks on the database, so a
+// slow query stalls one worker instead of every call on a completion queue.
+class AsyncBlockingPool {
+public:
+    explicit AsyncBlockingPool(size_t threads) {
+        for (size_t i = 0; i < threads; ++i) {
+            workers_.emplace_back([this]() { Run(); });
+        }
+    }
+
+    ~AsyncBlockingPool() {
+        {
+            std::lock_guard<std::mutex> lock(mu_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        for (auto& t : workers_) { t.join(); }
+    }
+
+    AsyncBlockingPool(const AsyncBlockingPool&) = delete;
+    auto operator=(const AsyncBlockingPool&) -> AsyncBlockingPool& = delete;
+
+    auto Post(std::function<void()> fn) -> void {
+        {
+            std::lock_guard<std::mutex> lock(mu_);
+            queue_.push_back(std::move(fn));
+        }
+        cv_.notify_one();
+    }
+
+private:
+    auto Run() -> void {
+        for (;;) {
+            std::function<void()> fn;
+            {
+                std::unique_lock<std::mutex> lock(mu_);
+                cv_.wait(lock, [this]() { return stop_ || !queue_.empty(); });
+                if (queue_.empty()) { return; }
+                fn = std::move(queue_.front());
+                queue_.pop_front();
+            }
+            fn();
+        }
+    }
+
+    std::mutex mu_;
+    std::condition_variable cv_;
+    std::deque<std::function<void()>> queue_;
+    bool stop_ = false;
+    std::vector<std::thread> workers_;
+};
+
+namespace {
+
+using telemetry::TelemetryService;
+
+struct CallEnv {
+    TelemetryServiceImpl* impl;
+    TelemetryService::AsyncService* service;
+    grpc::ServerCompletionQueue* cq;
+    std::atomic<int>* active_flushes;
+    // Offloaded jobs whose resume tag has not been handled yet.
+    std::atomic<int>* active_steps;
+    AsyncBlockingPool* blocking;
+};
+
+class CallData {
+public:
+    virtual ~CallData() = default;
+    virtual auto OnEvent(int kind, bool ok) -> void = 0;
+};
+
+// Completion-queue tag: identifies the call and which operation completed.
+struct Op {
+    CallData* call;
+    int kind;
+};
+
+// Longest gap between WatchRun wake-ups, so shutdown and client
+// cancellation are noticed even when the requested interval is long.
+constexpr auto kMaxWatchTick = std::chrono::milliseconds(1000);
+
+// How long Shutdown() lets in-flight calls finish before cancelling them.
+constexpr auto kShutdownGrace = std::chrono::seconds(5);
+
+// Runs @p fn on the blocking pool, then queues @p tag on the call's
+// completion queue so the call resumes on its own poller. @p fn must not throw.
+// The handler of @p tag decrements env.active_steps once it has queued any
+// follow-up work, so Shutdown() never sees a gap between two steps.
+auto Offload(const CallEnv& env, std::unique_ptr<grpc::Alarm>& alarm, void* tag, std::function<void()> fn) -> void {
+    env.active_steps->fetch_add(1);
+    alarm = std::make_unique<grpc::Alarm>();
+    env.blocking->Post([fn = std::move(fn), alarm = alarm.get(), cq = env.cq, tag]() {
+        fn();
+        alarm->Set(cq, std::chrono::system_clock::now(), tag);
+    });
+}
+
+template <typename Req, typename Resp>
+class UnaryCall final : public CallData {
+public:
+    using RequestFn = std::function<void(grpc::ServerContext*, Req*, grpc::ServerAsyncResponseWriter<Resp>*,
+                                         grpc::ServerCompletionQueue*, void*)>;
+    using HandleFn = std::function<Status(ServerContext*, const Req*, Resp*)>;
+
+    UnaryCall(CallEnv env, RequestFn request, HandleFn handle)
+        : env_(env), request_(std::move(request)), handle_(std::move(handle)), responder_(&ctx_) {
+        request_(&ctx_, &req_, &responder_, env_.cq, &request_op_);
+    }
+
+    auto OnEvent(int kind, bool ok) -> void override {
+        if (kind == kFinish || (kind == kRequest && !ok)) {
+            delete this;
+            return;
+        }
+        if (kind == kRequest) {
+            new UnaryCall(env_, request_, handle_);
+            Offload(env_, alarm_, &handled_op_, [this]() {
+                try {
+                    status_ = handle_(&ctx_, &req_, &resp_);
+                } catch (const std::exception& e) {
+                    spdlog::error("Async unary handler failed: {}", e.what());
+                    status_ = {grpc::StatusCode::INTERNAL, e.what()};
+                }
+            });
+            return;
+        }
+        responder_.Finish(resp_, status_, &finish_op_);
+        env_.active_steps->fetch_sub(1);
+    }
+
+private:
+    enum Kind { kRequest, kHandled, kFinish };
+
+    CallEnv env_;
+    RequestFn request_;
+    HandleFn handle_;
+    grpc::ServerContext ctx_;
+    Req req_;
+    Resp resp_;
+    Status status_;
+    grpc::ServerAsyncResponseWriter<Resp> responder_;
+    std::unique_ptr<grpc::Alarm> alarm_;
+    Op request_op_{this, kRequest};
+    Op handled_op_{this, kHandled};
+    Op finish_op_{this, kFinish};
+};
+
+class WatchRunCall final : public CallData {
+public:
+    explicit WatchRunCall(CallEnv env) : env_(env), writer_(&ctx_) {
+        ctx_.AsyncNotifyWhenDone(&done_op_);
+        env_.service->RequestWatchRun(&ctx_, &req_, &writer_, env_.cq, env_.cq, &request_op_);
+    }
+
+    auto OnEvent(int kind, bool ok) -> void override {
+        switch (kind) {
+            case kRequest:
+                if (!ok) { delete this; return; }
+                new WatchRunCall(env_);
+                Start();
+                return;
+            case kTick:
+                Tick();
+                return;
+            case kPolled:
+                OnPolled();
+                env_.active_steps->fetch_sub(1);
+                return;
+            case kWrite:
+                if (!ok) {
+                    writer_.Finish(Status::CANCELLED, &finish_op_);
+                } else if (terminal_) {
+                    writer_.Finish(Status::OK, &finish_op_);
+                } else {
+                    ScheduleTick();
+                }
+                return;
+            case kDone:
+                done_ = true;
+                break;
+            default:
+                finished_ = true;
+                break;
+        }
+        if (finished_ && done_) { delete this; }
+    }
+
+private:
+    enum Kind { kRequest, kTick, kPolled, kWrite, kFinish, kDone };
+
+    auto Start() -> void {
+        if (req_.run_id().empty()) {
+            writer_.Finish({grpc::StatusCode::INVALID_ARGUMENT, "run_id is required"}, &finish_op_);
+            return;
+        }
+        interval_ = env_.impl->ResolveWatchInterval(req_);
+        progress_ = env_.impl->Progress()->Find(req_.run_id());
+        Tick();
+    }
+
+    auto Tick() -> void {
+        // The done tag only arrives early when the client went away.
+        if (done_ || ctx_.IsCancelled()) {
+            writer_.Finish({grpc::StatusCode::CANCELLED, "WatchRun cancelled by client"}, &finish_op_);
+            return;
+        }
+        auto now = std::chrono::steady_clock::now();
+        if (sent_any_ && now < last_send_ + interval_) {
+            ScheduleTick();
+            return;
+        }
+
+        if (!progress_) {
+            // Runs owned elsewhere are polled from the DB on the blocking pool.
+            Offload(env_, poll_alarm_, &polled_op_, [this]() {
+                try {
+                    if (!db_) { db_ = env_.impl->NewDbClient(); }
+                    polled_ = db_->GetRunStatus(req_.run_id());
+                } catch (const std::exception& e) {
+                    poll_error_ = e.what();
+                }
+            });
+            return;
+        }
+        auto snap = progress_->Snapshot();
+        bool changed = !sent_any_ || snap.version != sent_version_;
+        sent_version_ = snap.version;
+        current_ = ToRunStatus(snap);
+        terminal_ = telemetry::RunProgress::IsTerminalStatus(snap.status);
+        Publish(changed);
+    }
+
+    auto OnPolled() -> void {
+        if (poll_error_) {
+            writer_.Finish({grpc::StatusCode::INTERNAL, *poll_error_}, &finish_op_);
+            return;
+        }
+        if (done_) {
+            writer_.Finish({grpc::StatusCode::CANCELLED, "WatchRun cancelled by client"}, &finish_op_);
+            return;
+        }
+        // GetRunStatus reports a failed read as "ERROR": retry it on the next
+        // tick instead of streaming it, and give up once the DB stays down.
+        if (polled_.status() == "ERROR") {
+            if (++error_polls_ >= TelemetryServiceImpl::kMaxWatchErrorPolls) {
+                writer_.Finish({grpc::StatusCode::UNAVAILABLE, "run status unavailable: " + polled_.error()},
+                               &finish_op_);
+            } else {
+                ScheduleTick();
+            }
+            return;
+        }
+        error_polls_ = 0;
+        current_ = std::move(polled_);
+        std::string encoded = current_.SerializeAsString();
+        bool changed = !sent_any_ || encoded != last_encoded_;
+        last_encoded_ = std::move(encoded);
+        terminal_ = current_.status().empty() || telemetry::RunProgress::IsTerminalStatus(current_.status());
+        Publish(changed);
+    }
+
+    auto Publish(bool changed) -> void {
+        if (changed) {
+            sent_any_ = true;
+            last_send_ = std::chrono::steady_clock::now();
+            writer_.Write(current_, &write_op_);
+        } else if (terminal_) {
+            writer_.Finish(Status::OK, &finish_op_);
+        } else {
+            ScheduleTick();
+        }
+    }
+
+    auto ScheduleTick() -> void {
+        alarm_ = std::make_unique<grpc::Alarm>();
+        alarm_->Set(env_.cq, std::chrono::system_clock::now() + std::min(interval_, kMaxWatchTick), &tick_op_);
+    }
+
+    CallEnv env_;
+    grpc::ServerContext ctx_;
+    WatchRunRequest req_;
+    RunStatus current_;
+    RunStatus polled_;
+    std::optional<std::string> poll_error_;
+    grpc::ServerAsyncWriter<RunStatus> writer_;
+    std::unique_ptr<grpc::Alarm> alarm_;
+    std::unique_ptr<grpc::Alarm> poll_alarm_;
+
+    std::chrono::milliseconds interval_{1000};
+    std::shared_ptr<telemetry::RunProgress> progress_;
+    std::shared_ptr<IDbClient> db_;
+    std::chrono::steady_clock::time_point last_send_{};
+    uint64_t sent_version_ = 0;
+    int error_polls_ = 0;
+    std::string last_encoded_;
+    bool sent_any_ = false;
+    bool terminal_ = false;
+    bool finished_ = false;
+    bool done_ = false;
+
+    Op request_op_{this, kRequest};
+    Op tick_op_{this, kTick};
+    Op polled_op_{this, kPolled};
+    Op write_op_{this, kWrite};
+    Op finish_op_{this, kFinish};
+    Op done_op_{this, kDone};
+};
+
+class IngestCall final : public CallData {
+public:
+    explicit IngestCall(CallEnv env) : env_(env), reader_(&ctx_) {
+        ctx_.AsyncNotifyWhenDone(&done_op_);
+        env_.service->RequestIngestTelemetry(&ctx_, &reader_, env_.cq, env_.cq, &request_op_);
+    }
+
+    auto OnEvent(int kind, bool ok) -> void override {
+        auto* steps = env_.active_steps;
+        switch (kind) {
+            case kRequest:
+                if (!ok) { delete this; return; }
+                new IngestCall(env_);
+                Read();
+                return;
+            case kRead:
+                OnRead(ok);
+                return;
+            case kFlushDone:
+                OnFlushDone();
+                // Only now: OnFlushDone() may have offloaded the next step.
+                env_.active_flushes->fetch_sub(1);
+                return;
+            case kBegun:
+                TakeStepResult();
+                if (error_) {
+                    TryFail();
+                } else {
+                    Consume();
+                }
+                steps->fetch_sub(1);
+                return;
+            case kCollected:
+                OnCollected();
+                steps->fetch_sub(1);
+                return;
+            case kFailed:
+                step_pending_ = false;
+                reader_.FinishWithError(*error_, &finish_op_);
+                steps->fetch_sub(1);
+                return;
+            case kDone:
+                done_ = true;
+                break;
+            default:
+                finished_ = true;
+                break;
+        }
+        MaybeRelease();
+    }
+
+private:
+    enum Kind { kRequest, kRead, kFlushDone, kBegun, kCollected, kFailed, kFinish, kDone };
+
+    auto Read() -> void {
+        reading_ = true;
+        reader_.Read(&batch_, &read_op_);
+    }
+
+    // A COPY chunk or a blocking step is outstanding; the session must not
+    // be touched until it reports back.
+    auto Busy() const -> bool { return flushing_ || step_pending_; }
+
+    auto OnRead(bool ok) -> void {
+        reading_ = false;
+        if (error_) {
+            MaybeRelease(); // the call is already failing
+            return;
+        }
+        if (!ok) {
+            if (!session_) {
+                reader_.FinishWithError({grpc::StatusCode::INVALID_ARGUMENT,
+                                         "IngestTelemetry stream contained no batches"}, &finish_op_);
+                return;
+            }
+            // A cancelled stream also ends reads with !ok. IsCancelled() only
+            // turns reliable once the done tag is delivered, so Settle()
+            // checks again before the run is marked SUCCEEDED.
+            if (ctx_.IsCancelled()) {
+                Abort({grpc::StatusCode::CANCELLED, "IngestTelemetry cancelled by client"});
+                return;
+            }
+            draining_ = true;
+            if (!Busy()) { Drain(); }
+            return;
+        }
+        if (!session_) {
+            // Creating the run is a DB write; batch_ stays untouched until kBegun.
+            session_ = env_.impl->NewIngestSession();
+            Step(&begun_op_, [this]() {
+                try {
+                    session_->Begin(batch_, GenerateUUID());
+                } catch (const std::invalid_argument& e) {
+                    step_error_ = Status{grpc::StatusCode::INVALID_ARGUMENT, e.what()};
+                } catch (const std::exception& e) {
+                    step_error_ = Status{grpc::StatusCode::INTERNAL, e.what()};
+                }
+            });
+            return;
+        }
+        Consume();
+    }
+
+    auto Consume() -> void {
+        try {
+            if (session_->Append(batch_)) {
+                if (Busy()) {
+                    // Stop reading until the outstanding chunk is collected.
+                    waiting_ = true;
+                    return;
+                }
+                StartFlush();
+            }
+            Read();
+        } catch (const std::invalid_argument& e) {
+            Abort({grpc::StatusCode::INVALID_ARGUMENT, e.what()});
+        } catch (const std::exception& e) {
+            Abort({grpc::StatusCode::INTERNAL, e.what()});
+        }
+    }
+
+    auto OnFlushDone() -> void {
+        flushing_ = false;
+        if (error_) {
+            TryFail();
+            return;
+        }
+        // Joins the chunk and checkpoints heartbeat and run status.
+        Step(&collected_op_, [this]() {
+            try {
+                session_->CollectInFlight();
+            } catch (const std::exception& e) {
+                step_error_ = Status{grpc::StatusCode::INTERNAL, e.what()};
+            }
+        });
+    }
+
+    auto OnCollected() -> void {
+        TakeStepResult();
+        if (error_) {
+            TryFail();
+        } else if (waiting_) {
+            waiting_ = false;
+            StartFlush();
+            Read();
+        } else if (draining_) {
+            Drain();
+        }
+    }
+
+    auto StartFlush() -> void {
+        // Safe to replace: CollectInFlight() has joined the worker that set the previous alarm.
+        flush_alarm_ = std::make_unique<grpc::Alarm>();
+        flushing_ = true;
+        env_.active_flushes->fetch_add(1);
+        auto* alarm = flush_alarm_.get();
+        auto* cq = env_.cq;
+        auto* tag = &flush_op_;
+        session_->FlushAsync([alarm, cq, tag]() { alarm->Set(cq, std::chrono::system_clock::now(), tag); });
+    }
+
+    auto Drain() -> void {
+        if (session_->HasPending()) {
+            StartFlush();
+            return;
+        }
+        session_->FillResponse(&resp_);
+        completing_ = true;
+        reader_.Finish(resp_, Status::OK, &finish_op_);
+    }
+
+    // Runs @p fn on the blocking pool and resumes on @p op.
+    auto Step(Op* op, std::function<void()> fn) -> void {
+        step_pending_ = true;
+        Offload(env_, step_alarm_, op, std::move(fn));
+    }
+
+    // Back on the poller after a step: adopt the error it reported.
+    auto TakeStepResult() -> void {
+        step_pending_ = false;
+        if (step_error_ && !error_) { error_ = std::move(step_error_); }
+        step_error_.reset();
+    }
+
+    auto Abort(const Status& status) -> void {
+        if (!error_) { error_ = status; }
+        TryFail();
+    }
+
+    // Marks the run FAILED and ends the call with error_, once nothing is
+    // outstanding (a pending chunk or step calls back in here).
+    auto TryFail() -> void {
+        if (Busy()) { return; }
+        if (!session_) {
+            reader_.FinishWithError(*error_, &finish_op_);
+            return;
+        }
+        Step(&failed_op_, [this]() {
+            try {
+                session_->Fail(error_->error_message());
+            } catch (const std::exception& e) {
+                spdlog::error("IngestTelemetry for run {} could not record its status: {}", session_->RunId(), e.what());
+            }
+        });
+    }
+
+    // Frees the call once every tag has come back. A successful stream
+    // records its terminal status first, on the blocking pool: only the done
+    // tag says whether the client half-closed or went away.
+    auto MaybeRelease() -> void {
+        if (!finished_ || !done_ || reading_) { return; }
+        if (!completing_) {
+            delete this;
+            return;
+        }
+        bool cancelled = ctx_.IsCancelled();
+        auto* steps = env_.active_steps;
+        steps->fetch_add(1);
+        env_.blocking->Post([this, cancelled, steps]() {
+            Settle(cancelled);
+            delete this;
+            steps->fetch_sub(1);
+        });
+    }
+
+    auto Settle(bool cancelled) -> void {
+        try {
+            if (cancelled) {
+                session_->Fail("cancelled by client");
+            } else {
+                session_->Complete(&resp_);
+            }
+        } catch (const std::exception& e) {
+            spdlog::error("IngestTelemetry for run {} could not record its status: {}", session_->RunId(), e.what());
+        }
+    }
+
+    CallEnv env_;
+    grpc::ServerContext ctx_;
+    grpc::ServerAsyncReader<IngestResponse, TelemetryBatch> reader_;
+    TelemetryBatch batch_;
+    IngestResponse resp_;
+    std::unique_ptr<telemetry::ingest::IngestSession> session_;
+    std::unique_ptr<grpc::Alarm> flush_alarm_;
+    std::unique_ptr<grpc::Alarm> step_alarm_;
+    std::optional<Status> error_;
+    // Written by a step on the blocking pool; read once its tag resumes the call.
+    std::optional<Status> step_error_;
+    bool reading_ = false;
+    bool flushing_ = false;
+    bool step_pending_ = false;
+    bool waiting_ = false;
+    bool draining_ = false;
+    bool completing_ = false;
+    bool finished_ = false;
+    bool done_ = false;
+
+    Op request_op_{this, kRequest};
+    Op read_op_{this, kRead};
+    Op flush_op_{this, kFlushDone};
+    Op begun_op_{this, kBegun};
+    Op collected_op_{this, kCollected};
+    Op failed_op_{this, kFailed};
+    Op finish_op_{this, kFinish};
+    Op done_op_{this, kDone};
+};
+
+} // namespace
+
+AsyncTelemetryServer::AsyncTelemetryServer(TelemetryServiceImpl& impl, size_t polling_threads,
+                                           size_t blocking_threads)
+    : impl_(impl), polling_threads_(std::max<size_t>(1, polling_threads)),
+      blocking_(std::make_unique<AsyncBlockingPool>(std::max<size_t>(1, blocking_threads))) {}
+
+AsyncTelemetryServer::~AsyncTelemetryServer() {
+    Shutdown();
+}
+
+auto AsyncTelemetryServer::Start(const std::string& address) -> void {
+    grpc::ServerBuilder builder;
+    if (!address.empty()) {
+        builder.AddListeningPort(address, grpc::InsecureServerCredentials());
+    }
+    builder.RegisterService(&service_);
+    for (size_t i = 0; i < polling_threads_; ++i) {
+        cqs_.push_back(builder.AddCompletionQueue());
+    }
+    server_ = builder.BuildAndStart();
+    if (!server_) {
+        throw std::runtime_error("Failed to start async gRPC server on " + address);
+    }
+
+    for (auto& cq : cqs_) {
+        CallEnv env{&impl_, &service_, cq.get(), &active_flushes_, &active_steps_, blocking_.get()};
+        auto* service = &service_;
+        auto* impl = &impl_;
+        new UnaryCall<GenerateRequest, GenerateResponse>(
+            env,
+            [service](grpc::ServerContext* ctx, GenerateRequest* req,
+                      grpc::ServerAsyncResponseWriter<GenerateResponse>* resp,
+                      grpc::ServerCompletionQueue* q, void* tag) {
+                service->RequestGenerateTelemetry(ctx, req, resp, q, q, tag);
+            },
+            [impl](ServerContext* ctx, const GenerateRequest* req, GenerateResponse* resp) {
+                return impl->GenerateTelemetry(ctx, req, resp);
+            });
+        new UnaryCall<GetRunRequest, RunStatus>(
+            env,
+            [service](grpc::ServerContext* ctx, GetRunRequest* req,
+                      grpc::ServerAsyncResponseWriter<RunStatus>* resp,
+                      grpc::ServerCompletionQueue* q, void* tag) {
+                service->RequestGetRun(ctx, req, resp, q, q, tag);
+            },
+            [impl](ServerContext* ctx, const GetRunRequest* req, RunStatus* resp) {
+                return impl->GetRun(ctx, req, resp);
+            });
+        new WatchRunCall(env);
+        new IngestCall(env);
+        threads_.emplace_back(&AsyncTelemetryServer::PollLoop, this, cq.get());
+    }
+    spdlog::info("Async gRPC server started with {} polling threads", polling_threads_);
+}
+
+auto AsyncTelemetryServer::PollLoop(grpc::ServerCompletionQueue* cq) -> void {
+    void* tag = nullptr;
+    bool ok = false;
+    while (cq->Next(&tag, &ok)) {
+        auto* op = static_cast<Op*>(tag);
+        op->call->OnEvent(op->kind, ok);
+    }
+}
+
+auto AsyncTelemetryServer::Wait() -> void {
+    if (server_) { server_->Wait(); }
+}
+
+auto AsyncTelemetryServer::Shutdown() -> void {
+    if (!server_ || shutdown_.exchange(true)) { return; }
+    server_->Shutdown(std::chrono::system_clock::now() + kShutdownGrace);
+    // Pollers must keep running until every in-flight COPY and blocking job
+    // has reported back through its alarm; shutting the queues down first
+    // would orphan them.
+    while (active_flushes_.load() > 0 || active_steps_.load() > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    for (auto& cq : cqs_) { cq->Shutdown(); }
+    for (auto& t : threads_) {
+        if (t.joinable()) { t.join(); }
+    }
+    // Draining the queues may have released ingest calls that still record
+    // their status on the pool; they must finish before the server goes.
+    while (active_steps_.load() > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+}
+
+auto AsyncTelemetryServer::InProcessChannel() -> std::shared_ptr<grpc::Channel> {
+    return server_->InProcessChannel(grpc::ChannelArguments());
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <grpcpp/grpcpp.h>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "telemetry.grpc.pb.h"
+#include "server.h"
+
+class AsyncBlockingPool;
+
+/**
+ * @brief Completion-queue front end for TelemetryServiceImpl.
+ *
+ * Each polling thread owns one ServerCompletionQueue and drives every call
+ * registered on it, so a call's events are handled serially on one thread and
+ * no thread is parked per RPC. WatchRun ticks with grpc::Alarm instead of
+ * sleeping, and IngestTelemetry resumes reading from an alarm fired when its
+ * COPY chunk completes. Handlers that block on the database (GetRun,
+ * GenerateTelemetry, WatchRun's DB fallback, and IngestTelemetry's run
+ * creation, checkpoints and final status) run on a separate worker pool and
+ * resume on their queue the same way. The business logic stays in
+ * TelemetryServiceImpl.
+ */
+class AsyncTelemetryServer {
+public:
+    static constexpr size_t kDefaultBlockingThreads = 8;
+
+    AsyncTelemetryServer(TelemetryServiceImpl& impl, size_t polling_threads,
+                         size_t blocking_threads = kDefaultBlockingThreads);
+    ~AsyncTelemetryServer();
+    AsyncTelemetryServer(const AsyncTelemetryServer&) = delete;
+    auto operator=(const AsyncTelemetryServer&) -> AsyncTelemetryServer& = delete;
+
+    // Builds and starts the server. An empty address registers no listening
+    // port (in-process channels only).
+    auto Start(const std::string& address) -> void;
+    auto Wait() -> void;
+    auto Shutdown() -> void;
+
+    auto InProcessChannel() -> std::shared_ptr<grpc::Channel>;
+    auto PollingThreads() const -> size_t { return polling_threads_; }
+
+private:
+    auto PollLoop(grpc::ServerCompletionQueue* cq) -> void;
+
+    TelemetryServiceImpl& impl_;
+    size_t polling_threads_;
+    std::unique_ptr<AsyncBlockingPool> blocking_;
+    telemetry::TelemetryService::AsyncService service_;
+    std::unique_ptr<grpc::Server> server_;
+    std::vector<std::unique_ptr<grpc::ServerCompletionQueue>> cqs_;
+    std::vector<std::thread> threads_;
+    std::atomic<int> active_flushes_{0};
+    std::atomic<int> active_steps_{0};
+    std::atomic<bool> shutdown_{false};
+};
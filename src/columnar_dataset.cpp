@@ -0,0 +1,291 @@
+#include "columnar_dataset.h"
+#include "rollup.h"
+#include "time_resolution.h"
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <limits>
+#include <map>
+
+namespace telemetry::api {
+
+namespace {
+
+// Only the unambiguous ISO form is evaluated in memory; anything Postgres
+// would parse differently (offsets, fractions, dates only) goes to SQL.
+auto ParseBound(const std::string& text) -> std::optional<int64_t> {
+    bool plain = text.size() == 19 || (text.size() == 20 && text.back() == 'Z');
+    if (!plain || text[10] != 'T') { return std::nullopt; }
+    auto tp = ParseIsoTime(text);
+    if (!tp) { return std::nullopt; }
+    return std::chrono::duration_cast<std::chrono::microseconds>(tp->time_since_epoch()).count();
+}
+
+auto FloorDiv(int64_t a, int64_t b) -> int64_t {
+    int64_t q = a / b;
+    return (a % b != 0 && (a < 0) != (b < 0)) ? q - 1 : q;
+}
+
+// PERCENTILE_CONT over a sorted range.
+auto PercentileCont(const std::vector<double>& sorted, double q) -> double {
+    if (sorted.empty()) { return 0.0; }
+    double pos = q * static_cast<double>(sorted.size() - 1);
+    auto lo = static_cast<size_t>(std::floor(pos));
+    auto hi = static_cast<size_t>(std::ceil(pos));
+    return sorted[lo] + (sorted[hi] - sorted[lo]) * (pos - static_cast<double>(lo));
+}
+
+} // namespace
+
+auto ColumnarDataset::Dictionary::Encode(const std::string& value) -> uint32_t {
+    auto [it, inserted] = lookup.try_emplace(value, static_cast<uint32_t>(values.size()));
+    if (inserted) { values.push_back(value); }
+    return it->second;
+}
+
+auto ColumnarDataset::Dictionary::Find(const std::string& value) const -> std::optional<uint32_t> {
+    auto it = lookup.find(value);
+    if (it == lookup.end()) { return std::nullopt; }
+    return it->second;
+}
+
+ColumnarDataset::ColumnarDataset(std::string run_id) : run_id_(std::move(run_id)) {
+    anomaly_type_dict_.values.emplace_back(); // NULL; deliberately not in lookup
+}
+
+auto ColumnarDataset::Append(int64_t metric_ts_us,
+                             const std::string& host_id,
+                             const std::string& project_id,
+                             const std::string& region,
+                             const std::array<double, kMetricCount>& metrics,
+                             bool is_anomaly,
+                             const std::optional<std::string>& anomaly_type) -> void {
+    ts_us_.push_back(metric_ts_us);
+    host_.push_back(host_dict_.Encode(host_id));
+    project_.push_back(project_dict_.Encode(project_id));
+    region_.push_back(region_dict_.Encode(region));
+    anomaly_type_.push_back(anomaly_type ? anomaly_type_dict_.Encode(*anomaly_type) : 0);
+    is_anomaly_.push_back(is_anomaly ? 1 : 0);
+    for (size_t m = 0; m < kMetricCount; ++m) { metrics_[m].push_back(metrics[m]); }
+}
+
+auto ColumnarDataset::Finish() -> void {
+    ts_us_.shrink_to_fit();
+    host_.shrink_to_fit();
+    project_.shrink_to_fit();
+    region_.shrink_to_fit();
+    anomaly_type_.shrink_to_fit();
+    is_anomaly_.shrink_to_fit();
+    bytes_ = ts_us_.capacity() * sizeof(int64_t) + is_anomaly_.capacity() +
+             (host_.capacity() + project_.capacity() + region_.capacity() + anomaly_type_.capacity()) * sizeof(uint32_t);
+    for (auto& column : metrics_) {
+        column.shrink_to_fit();
+        bytes_ += column.capacity() * sizeof(double);
+    }
+    for (const auto* dict : {&host_dict_, &project_dict_, &region_dict_, &anomaly_type_dict_}) {
+        for (const auto& v : dict->values) { bytes_ += 2 * (v.size() + sizeof(std::string)) + 16; }
+    }
+}
+
+auto ColumnarDataset::MetricIndex(const std::string& metric) -> std::optional<size_t> {
+    for (size_t m = 0; m < telemetry::rollup::kMetrics.size(); ++m) {
+        if (metric == telemetry::rollup::kMetrics[m]) { return m; }
+    }
+    return std::nullopt;
+}
+
+auto ColumnarDataset::FormatPgTimestamp(int64_t epoch_seconds) -> std::string {
+    auto tt = static_cast<std::time_t>(epoch_seconds);
+    std::tm tm{};
+    gmtime_r(&tt, &tm);
+    char buf[32];
+    std::strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S+00", &tm);
+    return buf;
+}
+
+auto ColumnarDataset::Select(const Filter& filter) const -> std::optional<std::vector<uint32_t>> {
+    int64_t lo = std::numeric_limits<int64_t>::min();
+    int64_t hi = std::numeric_limits<int64_t>::max();
+    if (!filter.start_time.empty()) {
+        auto b = ParseBound(filter.start_time);
+        if (!b) { return std::nullopt; }
+        lo = *b;
+    }
+    if (!filter.end_time.empty()) {
+        auto b = ParseBound(filter.end_time);
+        if (!b) { return std::nullopt; }
+        hi = *b;
+    }
+    std::vector<uint32_t> rows;
+    // A value absent from the dictionary matches nothing.
+    std::optional<uint32_t> region_code;
+    std::optional<uint32_t> type_code;
+    if (!filter.region.empty()) {
+        region_code = region_dict_.Find(filter.region);
+        if (!region_code) { return rows; }
+    }
+    if (!filter.anomaly_type.empty()) {
+        type_code = anomaly_type_dict_.Find(filter.anomaly_type);
+        if (!type_code) { return rows; }
+    }
+    bool check_anomaly = !filter.is_anomaly.empty();
+    uint8_t want_anomaly = filter.is_anomaly == "true" ? 1 : 0;
+
+    const size_t n = Size();
+    rows.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        bool keep = ts_us_[i] >= lo && ts_us_[i] <= hi;
+        keep &= !region_code || region_[i] == *region_code;
+        keep &= !type_code || anomaly_type_[i] == *type_code;
+        keep &= !check_anomaly || is_anomaly_[i] == want_anomaly;
+        if (keep) { rows.push_back(static_cast<uint32_t>(i)); }
+    }
+    return rows;
+}
+
+auto ColumnarDataset::TopK(const std::string& column, int k, const Filter& filter, bool include_total_distinct) const
+    -> std::optional<nlohmann::json> {
+    const std::vector<uint32_t>* codes = nullptr;
+    const Dictionary* dict = nullptr;
+    if (column == "host_id") { codes = &host_; dict = &host_dict_; }
+    else if (column == "project_id") { codes = &project_; dict = &project_dict_; }
+    else if (column == "region") { codes = &region_; dict = &region_dict_; }
+    else if (column == "anomaly_type") { codes = &anomaly_type_; dict = &anomaly_type_dict_; }
+    else { return std::nullopt; }
+
+    auto rows = Select(filter);
+    if (!rows) { return std::nullopt; }
+    std::vector<long> counts(dict->values.size(), 0);
+    for (uint32_t r : *rows) { counts[(*codes)[r]]++; }
+
+    std::vector<uint32_t> order;
+    for (uint32_t c = 0; c < counts.size(); ++c) {
+        if (counts[c] > 0) { order.push_back(c); }
+    }
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        if (counts[a] != counts[b]) { return counts[a] > counts[b]; }
+        return dict->values[a] < dict->values[b];
+    });
+
+    nlohmann::json out;
+    out["items"] = nlohmann::json::array();
+    if (include_total_distinct) {
+        // COUNT(DISTINCT col) skips NULL anomaly types.
+        long distinct = 0;
+        for (uint32_t c : order) { distinct += (dict == &anomaly_type_dict_ && c == 0) ? 0 : 1; }
+        out["total_distinct"] = distinct;
+    }
+    size_t limit = k > 0 ? static_cast<size_t>(k) : 0;
+    for (size_t i = 0; i < order.size() && i < limit; ++i) {
+        out["items"].push_back({{"label", dict->values[order[i]]}, {"count", counts[order[i]]}});
+    }
+    out["truncated"] = order.size() > limit;
+    return out;
+}
+
+auto ColumnarDataset::Histogram(const std::string& metric, int bins, double min_val, double max_val,
+                                const Filter& filter) const -> std::optional<nlohmann::json> {
+    auto m = MetricIndex(metric);
+    if (!m || bins <= 0) { return std::nullopt; }
+    const int kMaxBins = 500;
+    int requested_bins = bins;
+    bins = std::min(bins, kMaxBins);
+    const auto& values = metrics_[*m];
+
+    nlohmann::json out;
+    out["requested_bins"] = requested_bins;
+    out["edges"] = nlohmann::json::array();
+    out["counts"] = nlohmann::json::array();
+    if (max_val <= min_val && !values.empty()) {
+        auto [lo, hi] = std::minmax_element(values.begin(), values.end());
+        min_val = *lo;
+        max_val = *hi;
+    }
+    if (max_val <= min_val) { return out; }
+
+    auto rows = Select(filter);
+    if (!rows) { return std::nullopt; }
+    double step = (max_val - min_val) / static_cast<double>(bins);
+    for (int i = 0; i <= bins; ++i) { out["edges"].push_back(min_val + step * i); }
+
+    // width_bucket() over the same bounds the SQL binds; values below the
+    // low bound or at/above the high one fall outside 1..bins.
+    std::vector<long> counts(static_cast<size_t>(bins), 0);
+    double scale = static_cast<double>(bins) / (max_val - min_val);
+    for (uint32_t r : *rows) {
+        double v = values[r];
+        if (!(v >= min_val) || v >= max_val) { continue; }
+        auto b = static_cast<size_t>(std::floor((v - min_val) * scale));
+        counts[std::min(b, counts.size() - 1)]++;
+    }
+    for (long c : counts) { out["counts"].push_back(c); }
+    return out;
+}
+
+auto ColumnarDataset::TimeSeries(const std::vector<std::string>& metrics,
+                                 const std::vector<std::string>& aggs,
+                                 int bucket_seconds,
+                                 const Filter& filter) const -> std::optional<nlohmann::json> {
+    if (bucket_seconds <= 0) { return std::nullopt; }
+    std::vector<size_t> metric_idx;
+    for (const auto& metric : metrics) {
+        auto m = MetricIndex(metric);
+        if (!m) { return std::nullopt; }
+        metric_idx.push_back(*m);
+    }
+    for (const auto& agg : aggs) {
+        if (agg != "mean" && agg != "min" && agg != "max" && agg != "p50" && agg != "p95") { return std::nullopt; }
+    }
+    bool want_percentiles = std::find(aggs.begin(), aggs.end(), "p50") != aggs.end() ||
+                            std::find(aggs.begin(), aggs.end(), "p95") != aggs.end();
+    auto rows = Select(filter);
+    if (!rows) { return std::nullopt; }
+
+    struct Acc {
+        long count = 0;
+        std::vector<double> sum, min, max;
+        std::vector<std::vector<double>> values;
+    };
+    const int64_t bucket_us = static_cast<int64_t>(bucket_seconds) * 1000000;
+    std::map<int64_t, Acc> buckets;
+    for (uint32_t r : *rows) {
+        auto& acc = buckets[FloorDiv(ts_us_[r], bucket_us)];
+        if (acc.count == 0) {
+            acc.sum.assign(metric_idx.size(), 0.0);
+            acc.min.assign(metric_idx.size(), std::numeric_limits<double>::infinity());
+            acc.max.assign(metric_idx.size(), -std::numeric_limits<double>::infinity());
+            if (want_percentiles) { acc.values.resize(metric_idx.size()); }
+        }
+        acc.count++;
+        for (size_t j = 0; j < metric_idx.size(); ++j) {
+            double v = metrics_[metric_idx[j]][r];
+            acc.sum[j] += v;
+            acc.min[j] = std::min(acc.min[j], v);
+            acc.max[j] = std::max(acc.max[j], v);
+            if (want_percentiles) { acc.values[j].push_back(v); }
+        }
+    }
+
+    nlohmann::json out = nlohmann::json::array();
+    for (auto& [bucket, acc] : buckets) {
+        nlohmann::json j;
+        j["ts"] = FormatPgTimestamp(bucket * bucket_seconds);
+        for (size_t m = 0; m < metric_idx.size(); ++m) {
+            if (want_percentiles) { std::sort(acc.values[m].begin(), acc.values[m].end()); }
+            for (const auto& agg : aggs) {
+                double value = 0.0;
+                if (agg == "mean") { value = acc.sum[m] / static_cast<double>(acc.count); }
+                else if (agg == "min") { value = acc.min[m]; }
+                else if (agg == "max") { value = acc.max[m]; }
+                else if (agg == "p50") { value = PercentileCont(acc.values[m], 0.5); }
+                else if (agg == "p95") { value = PercentileCont(acc.values[m], 0.95); }
+                j[metrics[m] + "_" + agg] = value;
+            }
+        }
+        j["count"] = acc.count;
+        out.push_back(j);
+    }
+    return out;
+}
+
+} // namespace telemetry::api
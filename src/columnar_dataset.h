@@ -0,0 +1,95 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace telemetry::api {
+
+/**
+ * @brief One dataset's telemetry held column-wise in process memory.
+ *
+ * Strings are dictionary-encoded (code 0 of anomaly_type is NULL), metrics
+ * are f64 and timestamps epoch microseconds. The query methods mirror the
+ * JSON produced by the matching DbClient analytics calls so a handler can
+ * answer from either source; they return std::nullopt when a request uses
+ * something they cannot reproduce exactly (e.g. a time bound that is not a
+ * plain "YYYY-MM-DDTHH:MM:SS[Z]" string), and the caller falls back to SQL.
+ *
+ * Immutable once Finish() has been called; safe to share across threads.
+ */
+class ColumnarDataset {
+public:
+    static constexpr size_t kMetricCount = 5;
+
+    struct Filter {
+        std::string region;
+        std::string is_anomaly; // "" | "true" | anything else = false
+        std::string anomaly_type;
+        std::string start_time;
+        std::string end_time;
+    };
+
+    explicit ColumnarDataset(std::string run_id);
+
+    auto Append(int64_t metric_ts_us,
+                const std::string& host_id,
+                const std::string& project_id,
+                const std::string& region,
+                const std::array<double, kMetricCount>& metrics,
+                bool is_anomaly,
+                const std::optional<std::string>& anomaly_type) -> void;
+    // Trims capacity and computes Bytes().
+    auto Finish() -> void;
+
+    auto RunId() const -> const std::string& { return run_id_; }
+    auto Size() const -> size_t { return ts_us_.size(); }
+    auto Bytes() const -> size_t { return bytes_; }
+
+    // Same shape as DbClient::GetTopK (column: host_id | project_id | region | anomaly_type).
+    auto TopK(const std::string& column, int k, const Filter& filter, bool include_total_distinct) const
+        -> std::optional<nlohmann::json>;
+    // Same shape as DbClient::GetHistogram; min_val >= max_val means the run-wide range.
+    auto Histogram(const std::string& metric, int bins, double min_val, double max_val, const Filter& filter) const
+        -> std::optional<nlohmann::json>;
+    // Same shape as DbClient::GetTimeSeries; percentiles are always exact here.
+    auto TimeSeries(const std::vector<std::string>& metrics,
+                    const std::vector<std::string>& aggs,
+                    int bucket_seconds,
+                    const Filter& filter) const -> std::optional<nlohmann::json>;
+
+    static auto MetricIndex(const std::string& metric) -> std::optional<size_t>;
+    // Postgres timestamptz text for a UTC session ("2026-02-03 00:00:00+00").
+    static auto FormatPgTimestamp(int64_t epoch_seconds) -> std::string;
+
+private:
+    struct Dictionary {
+        std::vector<std::string> values;
+        std::unordered_map<std::string, uint32_t> lookup;
+        auto Encode(const std::string& value) -> uint32_t;
+        auto Find(const std::string& value) const -> std::optional<uint32_t>;
+    };
+
+    // Row ids passing the filter; nullopt if the filter cannot be evaluated here.
+    auto Select(const Filter& filter) const -> std::optional<std::vector<uint32_t>>;
+
+    std::string run_id_;
+    std::vector<int64_t> ts_us_;
+    std::vector<uint32_t> host_;
+    std::vector<uint32_t> project_;
+    std::vector<uint32_t> region_;
+    std::vector<uint32_t> anomaly_type_;
+    std::vector<uint8_t> is_anomaly_;
+    std::array<std::vector<double>, kMetricCount> metrics_;
+    Dictionary host_dict_;
+    Dictionary project_dict_;
+    Dictionary region_dict_;
+    Dictionary anomaly_type_dict_; // entry 0 is NULL
+    size_t bytes_ = 0;
+};
+
+} // namespace telemetry::api
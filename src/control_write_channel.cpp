@@ -0,0 +1,185 @@
+#include "control_write_channel.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <exception>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include <spdlog/spdlog.h>
+
+#include "metrics.h"
+
+namespace telemetry::db {
+
+auto ControlWriteArgs::FromEnv() -> ControlWriteArgs {
+    ControlWriteArgs args;
+    try {
+        if (const char* env = std::getenv("CONTROL_WRITE_MAX_BATCH")) {
+            long v = std::stol(env);
+            if (v > 0) { args.max_batch = static_cast<size_t>(v); }
+        }
+    } catch (...) {}
+    try {
+        if (const char* env = std::getenv("CONTROL_WRITE_LINGER_MS")) {
+            long v = std::stol(env);
+            if (v >= 0) { args.linger = std::chrono::milliseconds(v); }
+        }
+    } catch (...) {}
+    return args;
+}
+
+auto InlineParams(const std::string& sql,
+                  const std::vector<std::optional<std::string>>& params,
+                  const std::function<std::string(const std::string&)>& quote) -> std::string {
+    std::string out;
+    out.reserve(sql.size() + 16 * params.size());
+    size_t i = 0;
+    while (i < sql.size()) {
+        if (sql[i] != '$' || i + 1 >= sql.size() || std::isdigit(static_cast<unsigned char>(sql[i + 1])) == 0) {
+            out += sql[i++];
+            continue;
+        }
+        size_t j = i + 1;
+        size_t index = 0;
+        while (j < sql.size() && std::isdigit(static_cast<unsigned char>(sql[j])) != 0) {
+            index = index * 10 + static_cast<size_t>(sql[j] - '0');
+            j++;
+        }
+        if (index == 0 || index > params.size()) {
+            throw std::out_of_range("Statement references missing parameter $" + std::to_string(index));
+        }
+        const auto& value = params[index - 1];
+        out += value ? quote(*value) : "NULL";
+        i = j;
+    }
+    return out;
+}
+
+ControlWriteChannel::ControlWriteChannel(ExecuteFn execute, ControlWriteArgs args)
+    : execute_(std::move(execute)), args_(args) {
+    if (args_.max_batch == 0) { args_.max_batch = 1; }
+    thread_ = std::thread(&ControlWriteChannel::Loop, this);
+}
+
+ControlWriteChannel::~ControlWriteChannel() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) { thread_.join(); }
+}
+
+auto ControlWriteChannel::Submit(ControlWrite write, Callback callback) -> void {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) { throw std::runtime_error("Control write channel is shut down"); }
+        queue_.push_back(Pending{std::move(write), std::move(callback)});
+        submitted_++;
+    }
+    cv_.notify_one();
+}
+
+auto ControlWriteChannel::Execute(ControlWrite write) -> ControlWriteResult {
+    auto promise = std::make_shared<std::promise<ControlWriteResult>>();
+    auto future = promise->get_future();
+    Submit(std::move(write), [promise](const ControlWriteResult& result) { promise->set_value(result); });
+    return future.get();
+}
+
+auto ControlWriteChannel::Sync() -> void {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto target = submitted_;
+    settled_cv_.wait(lock, [&]() { return settled_ >= target; });
+}
+
+auto ControlWriteChannel::GetStats() const -> Stats {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+auto ControlWriteChannel::Loop() -> void {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        cv_.wait(lock, [this]() { return !queue_.empty() || !running_; });
+        if (queue_.empty()) { break; } // stopped and drained
+        if (running_ && args_.linger.count() > 0 && queue_.size() < args_.max_batch) {
+            cv_.wait_for(lock, args_.linger, [this]() { return queue_.size() >= args_.max_batch || !running_; });
+        }
+        std::vector<Pending> batch;
+        size_t n = std::min(queue_.size(), args_.max_batch);
+        batch.reserve(n);
+        for (size_t i = 0; i < n; ++i) {
+            batch.push_back(std::move(queue_.front()));
+            queue_.pop_front();
+        }
+        lock.unlock();
+        RunBatch(std::move(batch));
+        lock.lock();
+        settled_ += n;
+        settled_cv_.notify_all();
+    }
+}
+
+auto ControlWriteChannel::RunBatch(std::vector<Pending> batch) -> void {
+    std::vector<ControlWriteResult> results(batch.size());
+    std::vector<size_t> open(batch.size()); // indices not yet settled
+    for (size_t i = 0; i < open.size(); ++i) { open[i] = i; }
+    long executions = 0;
+
+    while (!open.empty()) {
+        std::vector<ControlWrite> writes;
+        writes.reserve(open.size());
+        for (size_t i : open) { writes.push_back(batch[i].write); }
+        executions++;
+
+        ControlBatchOutcome outcome;
+        try {
+            outcome = execute_(writes);
+        } catch (const std::exception& e) {
+            for (size_t i : open) { results[i] = ControlWriteResult{false, 0, e.what()}; }
+            break;
+        }
+
+        if (outcome.failed_at == ControlBatchOutcome::kNone) {
+            for (size_t k = 0; k < open.size(); ++k) {
+                long affected = k < outcome.affected_rows.size() ? outcome.affected_rows[k] : 0;
+                results[open[k]] = ControlWriteResult{true, affected, ""};
+            }
+            break;
+        }
+        if (outcome.failed_at >= open.size()) {
+            for (size_t i : open) { results[i] = ControlWriteResult{false, 0, outcome.error}; }
+            break;
+        }
+        // Nothing committed: settle the offender and resend the rest.
+        results[open[outcome.failed_at]] = ControlWriteResult{false, 0, outcome.error};
+        open.erase(open.begin() + static_cast<std::ptrdiff_t>(outcome.failed_at));
+    }
+
+    long failures = std::count_if(results.begin(), results.end(), [](const auto& r) { return !r.ok; });
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.writes += static_cast<long>(batch.size());
+        stats_.batches += executions;
+        stats_.failures += failures;
+    }
+    auto& metrics = ::telemetry::metrics::MetricsRegistry::Instance();
+    metrics.Increment("db_control_writes_total", {}, static_cast<long>(batch.size()));
+    metrics.Increment("db_control_batches_total", {}, executions);
+    if (failures > 0) { metrics.Increment("db_control_write_failures_total", {}, failures); }
+
+    for (size_t i = 0; i < batch.size(); ++i) {
+        if (!batch[i].callback) { continue; }
+        try {
+            batch[i].callback(results[i]);
+        } catch (const std::exception& e) {
+            spdlog::warn("Control write callback for {} threw: {}", batch[i].write.statement, e.what());
+        }
+    }
+}
+
+} // namespace telemetry::db
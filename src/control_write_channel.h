@@ -0,0 +1,122 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace telemetry::db {
+
+/**
+ * @brief One small control-plane statement: a registered statement name
+ * and its text parameters (nullopt binds NULL).
+ */
+struct ControlWrite {
+    std::string statement;
+    std::vector<std::optional<std::string>> params;
+};
+
+/**
+ * @brief Substitutes $1..$n in sql with quote(param), or NULL for nullopt,
+ * for transports that only carry plain query text. Throws
+ * std::out_of_range when sql references a missing parameter.
+ */
+auto InlineParams(const std::string& sql,
+                  const std::vector<std::optional<std::string>>& params,
+                  const std::function<std::string(const std::string&)>& quote) -> std::string;
+
+struct ControlWriteResult {
+    bool ok = false;
+    long affected_rows = 0;
+    std::string error;
+};
+
+/**
+ * @brief What an executor reports for one batch. A batch either commits as
+ * a whole or not at all: on failure nothing is committed, failed_at names
+ * the statement that failed, and statements after it did not run.
+ */
+struct ControlBatchOutcome {
+    static constexpr size_t kNone = static_cast<size_t>(-1);
+
+    size_t failed_at = kNone;
+    std::string error;
+    std::vector<long> affected_rows; // per statement when committed
+};
+
+struct ControlWriteArgs {
+    size_t max_batch = 256;
+    // How long the writer waits for company after the first queued write.
+    std::chrono::milliseconds linger{2};
+
+    // CONTROL_WRITE_MAX_BATCH, CONTROL_WRITE_LINGER_MS.
+    static auto FromEnv() -> ControlWriteArgs;
+};
+
+/**
+ * @brief Coalesces heartbeats, status updates and state transitions from
+ * every in-process job into batches written by one background thread.
+ *
+ * Writes run in submission order. Each batch goes to the executor, which
+ * is expected to send it as one pipelined transaction; a failing statement
+ * is completed with its error and the rest of the batch is retried without
+ * it, so one bad write never takes its neighbours down. An executor that
+ * throws fails the whole batch.
+ */
+class ControlWriteChannel {
+public:
+    using Callback = std::function<void(const ControlWriteResult&)>;
+    using ExecuteFn = std::function<ControlBatchOutcome(const std::vector<ControlWrite>&)>;
+
+    explicit ControlWriteChannel(ExecuteFn execute, ControlWriteArgs args = ControlWriteArgs::FromEnv());
+    ~ControlWriteChannel();
+    ControlWriteChannel(const ControlWriteChannel&) = delete;
+    auto operator=(const ControlWriteChannel&) -> ControlWriteChannel& = delete;
+
+    // Queues write; callback runs on the writer thread once it is settled.
+    auto Submit(ControlWrite write, Callback callback = nullptr) -> void;
+
+    // Queues write and blocks until it is settled.
+    auto Execute(ControlWrite write) -> ControlWriteResult;
+
+    // Blocks until everything submitted before the call is settled.
+    auto Sync() -> void;
+
+    struct Stats {
+        long writes = 0;
+        long batches = 0;   // executor calls, including retries
+        long failures = 0;  // writes completed with an error
+    };
+    auto GetStats() const -> Stats;
+
+private:
+    struct Pending {
+        ControlWrite write;
+        Callback callback;
+    };
+
+    auto Loop() -> void;
+    auto RunBatch(std::vector<Pending> batch) -> void;
+
+    ExecuteFn execute_;
+    ControlWriteArgs args_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::condition_variable settled_cv_;
+    std::deque<Pending> queue_;
+    unsigned long submitted_ = 0;
+    unsigned long settled_ = 0;
+    bool running_ = true;
+    Stats stats_;
+    std::thread thread_;
+};
+
+} // namespace telemetry::db
@@ -0,0 +1,68 @@
+#include "dataset_stats.h"
+#include <algorithm>
+#include <cmath>
+
+namespace telemetry::stats {
+
+auto Moments::Add(double value) -> void {
+    if (count == 0) {
+        min = value;
+        max = value;
+    } else {
+        min = std::min(min, value);
+        max = std::max(max, value);
+    }
+    count += 1;
+    double delta = value - mean;
+    mean += delta / static_cast<double>(count);
+    m2 += delta * (value - mean);
+}
+
+auto Moments::Merge(const Moments& other) -> void {
+    if (other.count == 0) { return; }
+    if (count == 0) {
+        *this = other;
+        return;
+    }
+    auto n_a = static_cast<double>(count);
+    auto n_b = static_cast<double>(other.count);
+    double n = n_a + n_b;
+    double delta = other.mean - mean;
+    mean += delta * n_b / n;
+    m2 += other.m2 + delta * delta * n_a * n_b / n;
+    count += other.count;
+    min = std::min(min, other.min);
+    max = std::max(max, other.max);
+}
+
+auto Moments::StdDev() const -> std::optional<double> {
+    if (count < 2) { return std::nullopt; }
+    return std::sqrt(std::max(0.0, m2) / static_cast<double>(count - 1));
+}
+
+auto DatasetStatsAccumulator::Add(const TelemetryRecord& record) -> void {
+    // Round to microseconds the way Postgres stores the timestamp text.
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(record.metric_timestamp.time_since_epoch()).count();
+    int64_t ts_us = (ns >= 0 ? ns + 500 : ns - 500) / 1000;
+
+    auto& run = runs_[record.run_id];
+    if (run.row_count == 0) {
+        run.min_ts_us = ts_us;
+        run.max_ts_us = ts_us;
+    } else {
+        run.min_ts_us = std::min(run.min_ts_us, ts_us);
+        run.max_ts_us = std::max(run.max_ts_us, ts_us);
+    }
+    run.row_count++;
+    if (record.is_anomaly) {
+        run.anomaly_count++;
+        if (!record.anomaly_type.empty()) { run.anomaly_types[record.anomaly_type]++; }
+    }
+    run.metrics[0].Add(record.cpu_usage);
+    run.metrics[1].Add(record.memory_usage);
+    run.metrics[2].Add(record.disk_utilization);
+    run.metrics[3].Add(record.network_rx_rate);
+    run.metrics[4].Add(record.network_tx_rate);
+}
+
+} // namespace telemetry::stats
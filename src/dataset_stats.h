@@ -0,0 +1,49 @@
+#pragma once
+
+#include "types.h"
+#include <array>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+
+namespace telemetry::stats {
+
+/**
+ * @brief Streaming count/mean/M2/min/max (Welford), mergeable with Chan et
+ * al.'s pairwise update. The dataset_metric_stats upsert applies the same
+ * merge in SQL, so batches can be folded in any order.
+ */
+struct Moments {
+    long count = 0;
+    double mean = 0.0;
+    double m2 = 0.0;
+    double min = 0.0;
+    double max = 0.0;
+
+    auto Add(double value) -> void;
+    auto Merge(const Moments& other) -> void;
+    // Sample standard deviation (matches Postgres STDDEV); nullopt below two values.
+    auto StdDev() const -> std::optional<double>;
+};
+
+// Catalog contribution of one batch to one run.
+struct RunStatsDelta {
+    long row_count = 0;
+    long anomaly_count = 0;
+    int64_t min_ts_us = 0; // metric_timestamp bounds, epoch microseconds
+    int64_t max_ts_us = 0;
+    std::array<Moments, 5> metrics;            // indexed like rollup::kMetrics
+    std::map<std::string, long> anomaly_types; // is_anomaly rows with a type only
+};
+
+class DatasetStatsAccumulator {
+public:
+    auto Add(const TelemetryRecord& record) -> void;
+    auto Runs() const -> const std::map<std::string, RunStatsDelta>& { return runs_; }
+
+private:
+    std::map<std::string, RunStatsDelta> runs_;
+};
+
+} // namespace telemetry::stats
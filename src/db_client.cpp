@@ -2,21 +2,35 @@
 #include <spdlog/spdlog.h>
 #include <chrono>
 #include <string_view>
+#include <tuple>
 #include <vector>
 #include "obs/metrics.h"
 #include "pagination.h"
 #include "obs/context.h"
+#include "rollup.h"
+#include "dataset_stats.h"
+#include "columnar_dataset.h"
+#include "eval_curve.h"
+#include "statement_registry.h"
+#include "control_write_channel.h"
+#include "analytics_queries.h"
 #include <google/protobuf/util/json_util.h>
 #include <fmt/chrono.h>
 #include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <map>
+#include <mutex>
 #include <unordered_set>
 
-// Compatibility macros for libpqxx 6.x vs 7.x
+// Compatibility macros for libpqxx 6.x vs 7.x. Named statements are
+// prepared on the transaction's connection on first use.
+#define PQXX_USE_PREPARED(txn, stmt) telemetry::db::StatementRegistry::Instance().UsePrepared((txn).conn(), stmt)
 #if !defined(PQXX_VERSION_MAJOR) || (PQXX_VERSION_MAJOR < 7)
-#define PQXX_EXEC_PREPPED(txn, stmt, ...) (txn).exec_prepared(stmt, ##__VA_ARGS__) // NOLINT(clang-diagnostic-gnu-zero-variadic-macro-arguments)
+#define PQXX_EXEC_PREPPED(txn, stmt, ...) (PQXX_USE_PREPARED(txn, stmt), (txn).exec_prepared(stmt, ##__VA_ARGS__)) // NOLINT(clang-diagnostic-gnu-zero-variadic-macro-arguments)
 #define PQXX_EXEC_PARAMS(txn, query, ...) (txn).exec_params(query, ##__VA_ARGS__) // NOLINT(clang-diagnostic-gnu-zero-variadic-macro-arguments)
 #else
-#define PQXX_EXEC_PREPPED(txn, stmt, ...) (txn).exec(pqxx::prepped{stmt}, pqxx::params{__VA_ARGS__})
+#define PQXX_EXEC_PREPPED(txn, stmt, ...) (PQXX_USE_PREPARED(txn, stmt), (txn).exec(pqxx::prepped{stmt}, pqxx::params{__VA_ARGS__}))
 #define PQXX_EXEC_PARAMS(txn, query, ...) (txn).exec((query), pqxx::params{__VA_ARGS__})
 #endif
 
@@ -27,177 +41,435 @@
   #pragma GCC diagnostic push
   #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
 #endif
+namespace {
+
+// Month partitions known to exist, so ingest paths can call
+// EnsurePartition freely without issuing DDL each time.
+std::mutex g_partition_mutex;
+std::unordered_set<std::string> g_ensured_partitions;
+// Score set partitions likewise; ids are never reused.
+std::unordered_set<long> g_ensured_score_partitions;
+
+using telemetry::db::AppendRawFilters;
+using telemetry::db::ShapedQuery;
+
+// Checkout tag for the dataset analytics reads, which may be served by a
+// read replica up to DB_READ_MAX_STALENESS_MS (default 5000) behind.
+auto AnalyticsRead() -> DbAccess {
+    static const DbAccess access = []() {
+        std::chrono::milliseconds staleness{5000};
+        try {
+            if (const char* env = std::getenv("DB_READ_MAX_STALENESS_MS")) {
+                staleness = std::chrono::milliseconds(std::stol(env));
+            }
+        } catch (...) {}
+        return DbAccess::Read(staleness);
+    }();
+    return access;
+}
+
+// Set by DbClient::PinAnalyticsReads() for the current thread. A null
+// replica means the pinned reads go to the primary.
+struct AnalyticsPin {
+    const DbClient* owner = nullptr;
+    pqxx::connection* replica = nullptr;
+};
+thread_local AnalyticsPin t_analytics_pin;
+
+struct AnalyticsPinGuard {
+    DbConnectionPtr conn;
+    AnalyticsPinGuard() = default;
+    AnalyticsPinGuard(const AnalyticsPinGuard&) = delete;
+    auto operator=(const AnalyticsPinGuard&) -> AnalyticsPinGuard& = delete;
+    ~AnalyticsPinGuard() { t_analytics_pin = {}; }
+};
+
+// Retention removed rows from each run in `counts`, a CTE (defined by
+// `ctes`) yielding run_id, n. The runs' row counts drop by n, and their rollups and stats
+// catalog, which can no longer be trimmed to match, are dropped so reads
+// fall back to the raw rows. The row count change also moves the API
+// server's cache version, so its cached results and hot copies go stale.
+auto ForgetExpiredRows(pqxx::work& W, const std::string& ctes) -> size_t {
+    auto runs = W.exec("WITH " + ctes + " "
+                       "UPDATE generation_runs r SET inserted_rows = GREATEST(r.inserted_rows - c.n, 0), "
+                       "rollups_enabled = FALSE, stats_enabled = FALSE, updated_at = NOW() "
+                       "FROM counts c WHERE r.run_id = c.run_id RETURNING r.run_id");
+    for (const auto& row : runs) {
+        auto run_id = row[0].as<std::string>();
+        PQXX_EXEC_PREPPED(W, "delete_run_rollups", run_id);
+        PQXX_EXEC_PREPPED(W, "delete_dataset_stats", run_id);
+        PQXX_EXEC_PREPPED(W, "delete_dataset_metric_stats", run_id);
+        PQXX_EXEC_PREPPED(W, "delete_dataset_anomaly_type_counts", run_id);
+    }
+    return runs.size();
+}
+
+struct ScoreSetRef {
+    long id = 0;
+    std::string scored_at;
+};
+
+// The score set of a (dataset, model) pair; nullopt if it was never scored.
+auto FindScoreSet(pqxx::transaction_base& T,
+                  const std::string& dataset_id,
+                  const std::string& model_run_id) -> std::optional<ScoreSetRef> {
+    auto res = PQXX_EXEC_PREPPED(T, "get_score_set", dataset_id, model_run_id);
+    if (res.empty()) { return std::nullopt; }
+    return ScoreSetRef{res[0][0].as<long>(), res[0][1].as<std::string>()};
+}
+
+// Filter on the score set; a pair that was never scored matches no rows.
+auto ScoreSetFilter(const std::optional<ScoreSetRef>& set) -> std::string {
+    return "s.score_set_id = " + (set ? std::to_string(set->id) : std::string("NULL"));
+}
+
+// Drops each listed score set: its partition goes with DROP TABLE, and only
+// rows that landed in the default partition are deleted one by one.
+auto DropScoreSets(pqxx::work& W, const pqxx::result& sets) -> void {
+    for (const auto& row : sets) {
+        auto id = row[0].as<long>();
+        W.exec("DROP TABLE IF EXISTS " + telemetry::partitions::ScoreSetPartitionName(id));
+        W.exec("DELETE FROM dataset_scores_default WHERE score_set_id = " + std::to_string(id));
+        W.exec("DELETE FROM dataset_score_sets WHERE score_set_id = " + std::to_string(id));
+        std::lock_guard<std::mutex> lock(g_partition_mutex);
+        g_ensured_score_partitions.erase(id);
+    }
+}
+
+// Runs q as a shape-keyed prepared statement, or unnamed once the
+// registry's shape budget is spent.
+auto ExecShaped(pqxx::transaction_base& W, const ShapedQuery& q) -> pqxx::result {
+    auto name = telemetry::db::StatementRegistry::Instance().RegisterShape(q.sql);
+#if !defined(PQXX_VERSION_MAJOR) || (PQXX_VERSION_MAJOR < 7)
+    auto params = pqxx::prepare::make_dynamic_params(q.params);
+    if (!name) { return W.exec_params(q.sql, params); }
+    PQXX_USE_PREPARED(W, *name);
+    return W.exec_prepared(*name, params);
+#else
+    pqxx::params params;
+    for (const auto& p : q.params) { params.append(p); }
+    if (!name) { return W.exec(q.sql, params); }
+    PQXX_USE_PREPARED(W, *name);
+    return W.exec(pqxx::prepped{*name}, params);
+#endif
+}
+
+// Sends one control-write batch as a single pqxx::pipeline inside one
+// transaction: BEGIN, every statement in one round trip, COMMIT.
+auto ExecuteControlBatch(DbConnectionManager& manager, const std::vector<telemetry::db::ControlWrite>& writes)
+    -> telemetry::db::ControlBatchOutcome {
+    auto& registry = telemetry::db::StatementRegistry::Instance();
+    auto C_ptr = manager.GetConnection(); pqxx::connection& C = *C_ptr;
+    pqxx::work W(C);
+    telemetry::db::ControlBatchOutcome outcome;
+    {
+        pqxx::pipeline P(W);
+        P.retain(static_cast<int>(writes.size()));
+        auto quote = [&W](const std::string& value) { return W.quote(value); };
+        std::vector<pqxx::pipeline::query_id> ids;
+        ids.reserve(writes.size());
+        for (const auto& w : writes) {
+            ids.push_back(P.insert(telemetry::db::InlineParams(registry.Sql(w.statement), w.params, quote)));
+        }
+        for (size_t i = 0; i < ids.size(); ++i) {
+            try {
+                outcome.affected_rows.push_back(static_cast<long>(P.retrieve(ids[i]).affected_rows()));
+            } catch (const std::exception& e) {
+                // The transaction is aborted; W rolls back on scope exit.
+                outcome.failed_at = i;
+                outcome.error = e.what();
+                outcome.affected_rows.clear();
+                return outcome;
+            }
+        }
+        P.complete();
+    }
+    W.commit();
+    return outcome;
+}
+
+// One channel per connection manager, shared by every DbClient on it, so
+// concurrent jobs coalesce into the same batches.
+auto SharedControlChannel(const std::shared_ptr<DbConnectionManager>& manager)
+    -> std::shared_ptr<telemetry::db::ControlWriteChannel> {
+    try {
+        const char* env = std::getenv("CONTROL_WRITE_PIPELINE");
+        if (env && std::string(env) == "0") { return nullptr; }
+    } catch (...) {}
+
+    static std::mutex mutex;
+    static std::map<const DbConnectionManager*, std::weak_ptr<telemetry::db::ControlWriteChannel>> channels;
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& slot = channels[manager.get()];
+    if (auto existing = slot.lock()) { return existing; }
+    for (auto it = channels.begin(); it != channels.end();) {
+        it = it->second.expired() && it->first != manager.get() ? channels.erase(it) : std::next(it);
+    }
+    auto channel = std::make_shared<telemetry::db::ControlWriteChannel>(
+        [manager](const std::vector<telemetry::db::ControlWrite>& writes) {
+            return ExecuteControlBatch(*manager, writes);
+        });
+    slot = channel;
+    return channel;
+}
+
+} // namespace
+
 DbClient::DbClient(const std::string& connection_string) 
     : manager_(std::make_shared<SimpleDbConnectionManager>(connection_string, [](pqxx::connection& C) {
-        DbClient::PrepareStatements(C);
-    })) {}
+        DbClient::AttachConnection(C);
+    })),
+      control_writes_(SharedControlChannel(manager_)) {}
 
 DbClient::DbClient(std::shared_ptr<DbConnectionManager> manager) 
-    : manager_(std::move(manager)) {}
+    : manager_(std::move(manager)),
+      control_writes_(SharedControlChannel(manager_)) {}
 
-auto DbClient::PrepareStatements(pqxx::connection& C) -> void {
-    C.prepare("insert_generation_run",
-              "INSERT INTO generation_runs (run_id, tier, host_count, start_time, end_time, interval_seconds, seed, status, config, request_id) "
-              "VALUES ($1, $2, $3, $4, $5, $6, $7, $8, $9, $10)");
-    
-    C.prepare("update_generation_run",
-              "UPDATE generation_runs SET status = $1, inserted_rows = $2, updated_at = NOW() WHERE run_id = $3");
-              
-    C.prepare("update_generation_run_error",
-              "UPDATE generation_runs SET status = $1, inserted_rows = $2, error = $3, updated_at = NOW() WHERE run_id = $4");
-              
-    C.prepare("get_run_status",
-              "SELECT status, inserted_rows, error, request_id FROM generation_runs WHERE run_id = $1");
-
-    C.prepare("heartbeat_generation", "UPDATE generation_runs SET updated_at = NOW() WHERE run_id = $1");
-    C.prepare("heartbeat_model_run", "UPDATE model_runs SET updated_at = NOW() WHERE model_run_id = $1");
-    C.prepare("heartbeat_score_job", "UPDATE dataset_score_jobs SET updated_at = NOW() WHERE job_id = $1");
-
-    C.prepare("insert_alert",
-              "INSERT INTO alerts (host_id, run_id, timestamp, severity, detector_source, score, details) "
-              "VALUES ($1, $2, $3::timestamptz, $4, $5, $6, $7::jsonb)");
-
-    C.prepare("insert_model_run",
-              "INSERT INTO model_runs (dataset_id, name, status, request_id, training_config, hpo_config, candidate_fingerprint, generator_version, seed_used) "
-              "VALUES ($1, $2, 'PENDING', $3, $4, $5, $6, $7, $8) RETURNING model_run_id");
-
-    C.prepare("insert_hpo_trial",
-              "INSERT INTO model_runs (dataset_id, name, status, request_id, training_config, parent_run_id, trial_index, trial_params) "
-              "VALUES ($1, $2, 'PENDING', $3, $4, $5, $6, $7) RETURNING model_run_id");
-
-    C.prepare("update_model_run_completed",
-              "UPDATE model_runs SET status=$1, artifact_path=$2, completed_at=NOW(), updated_at=NOW() WHERE model_run_id=$3");
-
-    C.prepare("update_model_run_failed",
-              "UPDATE model_runs SET status=$1, error=$2, error_summary=$3, completed_at=NOW(), updated_at=NOW() WHERE model_run_id=$4");
-
-    C.prepare("update_model_run_status",
-              "UPDATE model_runs SET status=$1, updated_at=NOW() WHERE model_run_id=$2");
-
-    C.prepare("get_model_run",
-              "SELECT model_run_id, dataset_id, name, status, artifact_path, error, created_at, completed_at, request_id, training_config, "
-              "hpo_config, parent_run_id, trial_index, trial_params, "
-              "best_trial_run_id, best_metric_value, best_metric_name, "
-              "selection_metric_direction, tie_break_basis, is_eligible, eligibility_reason, selection_metric_value, "
-              "candidate_fingerprint, generator_version, seed_used, "
-              "error_summary, error_aggregates, "
-              "selection_metric_source, selection_metric_computed_at "
-              "FROM model_runs WHERE model_run_id = $1");
-
-    C.prepare("update_best_trial",
-              "UPDATE model_runs SET best_trial_run_id=$1, best_metric_value=$2, best_metric_name=$3, "
-              "selection_metric_direction=$4, tie_break_basis=$5 WHERE model_run_id=$6");
-
-    C.prepare("update_trial_eligibility",
-              "UPDATE model_runs SET is_eligible=$1, eligibility_reason=$2, selection_metric_value=$3, "
-              "selection_metric_source=$4, selection_metric_computed_at=NOW() "
-              "WHERE model_run_id=$5");
-
-    C.prepare("update_error_aggregates",
-              "UPDATE model_runs SET error_aggregates=$1 WHERE model_run_id=$2");
-
-    C.prepare("get_hpo_trials_paginated",
-              "SELECT model_run_id, status, trial_index, trial_params, created_at, completed_at, error, "
-              "is_eligible, eligibility_reason, selection_metric_value, selection_metric_source, error_summary, dataset_id, name, training_config "
-              "FROM model_runs WHERE parent_run_id = $1 ORDER BY trial_index ASC LIMIT $2 OFFSET $3");
-
-    C.prepare("insert_inference_run",
-              "INSERT INTO inference_runs (model_run_id, status) VALUES ($1, 'RUNNING') RETURNING inference_id");
-
-    C.prepare("update_inference_run",
-              "UPDATE inference_runs SET status=$1, anomaly_count=$2, details=$3::jsonb, latency_ms=$4 WHERE inference_id=$5");
-
-    C.prepare("get_inference_run",
-              "SELECT inference_id, model_run_id, status, anomaly_count, latency_ms, details, created_at "
-              "FROM inference_runs WHERE inference_id = $1");
-
-    C.prepare("get_models_for_dataset",
-              "SELECT model_run_id, name, status, created_at FROM model_runs WHERE dataset_id = $1 ORDER BY created_at DESC");
-
-    C.prepare("get_scored_datasets_for_model",
-              "SELECT DISTINCT ds.dataset_id, gr.created_at, ds.scored_at "
-              "FROM dataset_scores ds JOIN generation_runs gr ON ds.dataset_id = gr.run_id "
-              "WHERE ds.model_run_id = $1 ORDER BY ds.scored_at DESC");
-
-    C.prepare("get_dataset_detail",
-              "SELECT run_id, status, inserted_rows, created_at, start_time, end_time, interval_seconds, host_count, tier, error, request_id "
-              "FROM generation_runs WHERE run_id = $1");
-
-    C.prepare("get_dataset_samples",
-              "SELECT cpu_usage, memory_usage, disk_utilization, network_rx_rate, network_tx_rate, metric_timestamp, host_id "
-              "FROM host_telemetry_archival WHERE run_id = $1 ORDER BY metric_timestamp DESC LIMIT $2");
-
-    C.prepare("get_dataset_record",
-              "SELECT cpu_usage, memory_usage, disk_utilization, network_rx_rate, network_tx_rate, metric_timestamp, host_id, labels "
-              "FROM host_telemetry_archival WHERE run_id = $1 AND record_id = $2");
-
-    C.prepare("check_score_job_exists",
-              "SELECT job_id FROM dataset_score_jobs WHERE dataset_id = $1 AND model_run_id = $2 "
-              "AND status IN ('PENDING', 'RUNNING')");
-
-    C.prepare("insert_score_job",
-              "INSERT INTO dataset_score_jobs (dataset_id, model_run_id, status, request_id) "
-              "VALUES ($1, $2, 'PENDING', $3) RETURNING job_id");
-
-    C.prepare("update_score_job_completed",
-              "UPDATE dataset_score_jobs SET status=$1, total_rows=$2, processed_rows=$3, last_record_id=$4, updated_at=NOW(), completed_at=NOW() "
-              "WHERE job_id=$5");
-
-    C.prepare("update_score_job_error",
-              "UPDATE dataset_score_jobs SET status=$1, total_rows=$2, processed_rows=$3, last_record_id=$4, error=$5, updated_at=NOW() "
-              "WHERE job_id=$6");
-
-    C.prepare("update_score_job_status",
-              "UPDATE dataset_score_jobs SET status=$1, total_rows=$2, processed_rows=$3, last_record_id=$4, updated_at=NOW() "
-              "WHERE job_id=$5");
-
-    C.prepare("get_score_job",
-              "SELECT job_id, dataset_id, model_run_id, status, total_rows, processed_rows, last_record_id, error, created_at, updated_at, completed_at, request_id "
-              "FROM dataset_score_jobs WHERE job_id = $1");
-
-    C.prepare("fetch_scoring_rows",
-              "SELECT record_id, is_anomaly, cpu_usage, memory_usage, disk_utilization, network_rx_rate, network_tx_rate "
-              "FROM host_telemetry_archival WHERE run_id = $1 AND record_id > $2 ORDER BY record_id ASC LIMIT $3");
-
-    C.prepare("transition_model_run_status",
-              "UPDATE model_runs SET status = $1 WHERE model_run_id = $2 AND status = $3");
-
-    C.prepare("transition_score_job_status",
-              "UPDATE dataset_score_jobs SET status = $1, updated_at = NOW() WHERE job_id = $2 AND status = $3");
-
-    C.prepare("get_eval_metrics",
-              "SELECT s.reconstruction_error, s.predicted_is_anomaly, h.is_anomaly "
-              "FROM dataset_scores s JOIN host_telemetry_archival h ON s.record_id = h.record_id "
-              "WHERE s.dataset_id = $1 AND s.model_run_id = $2");
-
-    C.prepare("delete_dataset_scores", "DELETE FROM dataset_scores WHERE dataset_id = $1");
-    C.prepare("delete_dataset_score_jobs", "DELETE FROM dataset_score_jobs WHERE dataset_id = $1");
-    C.prepare("delete_host_telemetry", "DELETE FROM host_telemetry_archival WHERE run_id = $1");
-    C.prepare("delete_alerts", "DELETE FROM alerts WHERE run_id = $1");
-    C.prepare("delete_model_runs", "DELETE FROM model_runs WHERE dataset_id = $1");
-    C.prepare("delete_generation_run", "DELETE FROM generation_runs WHERE run_id = $1");
-    
-    // Additional useful ones
-    C.prepare("get_dataset_record_count", "SELECT COUNT(*) FROM host_telemetry_archival WHERE run_id = $1");
+auto DbClient::WriteControl(telemetry::db::ControlWrite write) -> telemetry::db::ControlWriteResult {
+    try {
+        RegisterStatements();
+        return control_writes_->Execute(std::move(write));
+    } catch (const std::exception& e) {
+        return {false, 0, e.what()};
+    }
+}
 
-    C.prepare("get_non_anomaly_count", "SELECT COUNT(*) FROM host_telemetry_archival WHERE run_id = $1 AND is_anomaly = false");
+auto DbClient::RegisterStatements() -> void {
+    static std::once_flag once;
+    std::call_once(once, []() {
+        auto& R = telemetry::db::StatementRegistry::Instance();
+        R.Register("insert_generation_run",
+                   "INSERT INTO generation_runs (run_id, tier, host_count, start_time, end_time, interval_seconds, seed, status, config, request_id, rollups_enabled, stats_enabled) "
+                   "VALUES ($1, $2, $3, $4, $5, $6, $7, $8, $9, $10, TRUE, TRUE)");
 
-    C.prepare("get_telemetry_batch",
-              "SELECT record_id, cpu_usage, memory_usage, disk_utilization, network_rx_rate, network_tx_rate "
-              "FROM host_telemetry_archival "
-              "WHERE run_id = $1 AND record_id > $2 "
-              "ORDER BY record_id "
-              "LIMIT $3");
+        R.Register("update_generation_run",
+                   "UPDATE generation_runs SET status = $1, inserted_rows = $2, updated_at = NOW() WHERE run_id = $3");
 
-    C.prepare("call_cleanup", "CALL cleanup_old_telemetry($1::INT)");
-    
-    // Dynamic column selection requires quoting, but base WHERE clause is static for bounds/stats
-    // For GetMetricStats/Histogram we need to inject the column name, so we can't fully prepare it 
-    // unless we prepare one for each metric (too many) or interpolate the column name (which we do) 
-    // and prepare the rest? No, prepared statement query string is fixed.
-    // So if the query has dynamic column names "MIN(" + metric + ")", we can't use prepared statements 
-    // unless we use the 'exec' approach with manual quoting. 
-    // But RunRetentionCleanup is static.
+        R.Register("update_generation_run_error",
+                   "UPDATE generation_runs SET status = $1, inserted_rows = $2, error = $3, updated_at = NOW() WHERE run_id = $4");
+
+        R.Register("get_run_status",
+                   "SELECT status, inserted_rows, error, request_id FROM generation_runs WHERE run_id = $1");
+
+        R.Register("heartbeat_generation", "UPDATE generation_runs SET updated_at = NOW() WHERE run_id = $1");
+        R.Register("heartbeat_model_run", "UPDATE model_runs SET updated_at = NOW() WHERE model_run_id = $1");
+        R.Register("heartbeat_score_job", "UPDATE dataset_score_jobs SET updated_at = NOW() WHERE job_id = $1");
+
+        R.Register("insert_alert",
+                   "INSERT INTO alerts (host_id, run_id, timestamp, severity, detector_source, score, details) "
+                   "VALUES ($1, $2, $3::timestamptz, $4, $5, $6, $7::jsonb)");
+
+        R.Register("insert_model_run",
+                   "INSERT INTO model_runs (dataset_id, name, status, request_id, training_config, hpo_config, candidate_fingerprint, generator_version, seed_used) "
+                   "VALUES ($1, $2, 'PENDING', $3, $4, $5, $6, $7, $8) RETURNING model_run_id");
+
+        R.Register("insert_hpo_trial",
+                   "INSERT INTO model_runs (dataset_id, name, status, request_id, training_config, parent_run_id, trial_index, trial_params) "
+                   "VALUES ($1, $2, 'PENDING', $3, $4, $5, $6, $7) RETURNING model_run_id");
+
+        R.Register("update_model_run_completed",
+                   "UPDATE model_runs SET status=$1, artifact_path=$2, completed_at=NOW(), updated_at=NOW() WHERE model_run_id=$3");
+
+        R.Register("update_model_run_failed",
+                   "UPDATE model_runs SET status=$1, error=$2, error_summary=$3, completed_at=NOW(), updated_at=NOW() WHERE model_run_id=$4");
+
+        R.Register("update_model_run_status",
+                   "UPDATE model_runs SET status=$1, updated_at=NOW() WHERE model_run_id=$2");
+
+        R.Register("get_model_run",
+                   "SELECT model_run_id, dataset_id, name, status, artifact_path, error, created_at, completed_at, request_id, training_config, "
+                   "hpo_config, parent_run_id, trial_index, trial_params, "
+                   "best_trial_run_id, best_metric_value, best_metric_name, "
+                   "selection_metric_direction, tie_break_basis, is_eligible, eligibility_reason, selection_metric_value, "
+                   "candidate_fingerprint, generator_version, seed_used, "
+                   "error_summary, error_aggregates, "
+                   "selection_metric_source, selection_metric_computed_at "
+                   "FROM model_runs WHERE model_run_id = $1");
+
+        R.Register("update_best_trial",
+                   "UPDATE model_runs SET best_trial_run_id=$1, best_metric_value=$2, best_metric_name=$3, "
+                   "selection_metric_direction=$4, tie_break_basis=$5 WHERE model_run_id=$6");
+
+        R.Register("update_trial_eligibility",
+                   "UPDATE model_runs SET is_eligible=$1, eligibility_reason=$2, selection_metric_value=$3, "
+                   "selection_metric_source=$4, selection_metric_computed_at=NOW() "
+                   "WHERE model_run_id=$5");
+
+        R.Register("update_error_aggregates",
+                   "UPDATE model_runs SET error_aggregates=$1 WHERE model_run_id=$2");
+
+        R.Register("get_hpo_trials_paginated",
+                   "SELECT model_run_id, status, trial_index, trial_params, created_at, completed_at, error, "
+                   "is_eligible, eligibility_reason, selection_metric_value, selection_metric_source, error_summary, dataset_id, name, training_config "
+                   "FROM model_runs WHERE parent_run_id = $1 ORDER BY trial_index ASC LIMIT $2 OFFSET $3");
+
+        R.Register("insert_inference_run",
+                   "INSERT INTO inference_runs (model_run_id, status) VALUES ($1, 'RUNNING') RETURNING inference_id");
+
+        R.Register("update_inference_run",
+                   "UPDATE inference_runs SET status=$1, anomaly_count=$2, details=$3::jsonb, latency_ms=$4 WHERE inference_id=$5");
+
+        R.Register("get_inference_run",
+                   "SELECT inference_id, model_run_id, status, anomaly_count, latency_ms, details, created_at "
+                   "FROM inference_runs WHERE inference_id = $1");
+
+        R.Register("get_models_for_dataset",
+                   "SELECT model_run_id, name, status, created_at FROM model_runs WHERE dataset_id = $1 ORDER BY created_at DESC");
+
+        R.Register("get_scored_datasets_for_model",
+                   "SELECT ss.dataset_id, gr.created_at, ss.scored_at "
+                   "FROM dataset_score_sets ss JOIN generation_runs gr ON ss.dataset_id = gr.run_id "
+                   "WHERE ss.model_run_id = $1 ORDER BY ss.scored_at DESC");
+
+        R.Register("get_dataset_detail",
+                   "SELECT run_id, status, inserted_rows, created_at, start_time, end_time, interval_seconds, host_count, tier, error, request_id "
+                   "FROM generation_runs WHERE run_id = $1");
+
+        R.Register("get_dataset_samples",
+                   "SELECT cpu_usage, memory_usage, disk_utilization, network_rx_rate, network_tx_rate, metric_timestamp, host_id "
+                   "FROM host_telemetry_archival WHERE run_id = $1 ORDER BY metric_timestamp DESC LIMIT $2");
+
+        R.Register("get_dataset_record",
+                   "SELECT cpu_usage, memory_usage, disk_utilization, network_rx_rate, network_tx_rate, metric_timestamp, host_id, labels "
+                   "FROM host_telemetry_archival WHERE run_id = $1 AND record_id = $2");
+
+        R.Register("check_score_job_exists",
+                   "SELECT job_id FROM dataset_score_jobs WHERE dataset_id = $1 AND model_run_id = $2 "
+                   "AND status IN ('PENDING', 'RUNNING')");
+
+        R.Register("insert_score_job",
+                   "INSERT INTO dataset_score_jobs (dataset_id, model_run_id, status, request_id) "
+                   "VALUES ($1, $2, 'PENDING', $3) RETURNING job_id");
+
+        R.Register("update_score_job_completed",
+                   "UPDATE dataset_score_jobs SET status=$1, total_rows=$2, processed_rows=$3, last_record_id=$4, updated_at=NOW(), completed_at=NOW() "
+                   "WHERE job_id=$5");
+
+        R.Register("update_score_job_error",
+                   "UPDATE dataset_score_jobs SET status=$1, total_rows=$2, processed_rows=$3, last_record_id=$4, error=$5, updated_at=NOW() "
+                   "WHERE job_id=$6");
+
+        R.Register("update_score_job_status",
+                   "UPDATE dataset_score_jobs SET status=$1, total_rows=$2, processed_rows=$3, last_record_id=$4, updated_at=NOW() "
+                   "WHERE job_id=$5");
+
+        R.Register("get_score_job",
+                   "SELECT job_id, dataset_id, model_run_id, status, total_rows, processed_rows, last_record_id, error, created_at, updated_at, completed_at, request_id "
+                   "FROM dataset_score_jobs WHERE job_id = $1");
+
+        R.Register("get_latest_score_job",
+                   "SELECT job_id, status, processed_rows FROM dataset_score_jobs "
+                   "WHERE dataset_id = $1 AND model_run_id = $2 ORDER BY created_at DESC LIMIT 1");
+
+        R.Register("fetch_scoring_rows",
+                   "SELECT record_id, is_anomaly, cpu_usage, memory_usage, disk_utilization, network_rx_rate, network_tx_rate, "
+                   "region, project_id, COALESCE(anomaly_type, '') "
+                   "FROM host_telemetry_archival WHERE run_id = $1 AND record_id > $2 ORDER BY record_id ASC LIMIT $3");
+
+        // Score-job eval aggregates (see eval_aggregates.h)
+        R.Register("upsert_eval_aggregates",
+                   "INSERT INTO dataset_eval_aggregates (dataset_id, model_run_id, samples, aggregates) "
+                   "VALUES ($1, $2, $3, $4::jsonb) "
+                   "ON CONFLICT (dataset_id, model_run_id) DO UPDATE SET "
+                   "samples = EXCLUDED.samples, aggregates = EXCLUDED.aggregates, updated_at = NOW()");
+        R.Register("get_eval_aggregates",
+                   "SELECT aggregates::text FROM dataset_eval_aggregates WHERE dataset_id = $1 AND model_run_id = $2");
+        R.Register("delete_eval_aggregates",
+                   "DELETE FROM dataset_eval_aggregates WHERE dataset_id = $1 AND model_run_id = $2");
+        R.Register("delete_dataset_eval_aggregates", "DELETE FROM dataset_eval_aggregates WHERE dataset_id = $1");
+
+        R.Register("transition_model_run_status",
+                   "UPDATE model_runs SET status = $1 WHERE model_run_id = $2 AND status = $3");
+
+        R.Register("transition_score_job_status",
+                   "UPDATE dataset_score_jobs SET status = $1, updated_at = NOW() WHERE job_id = $2 AND status = $3");
+
+        // Score sets (see InsertDatasetScores)
+        R.Register("ensure_score_set",
+                   "INSERT INTO dataset_score_sets (dataset_id, model_run_id) VALUES ($1, $2) "
+                   "ON CONFLICT (dataset_id, model_run_id) DO UPDATE SET scored_at = NOW() "
+                   "RETURNING score_set_id");
+        R.Register("get_score_set",
+                   "SELECT score_set_id, scored_at FROM dataset_score_sets WHERE dataset_id = $1 AND model_run_id = $2");
+        R.Register("lock_score_set",
+                   "SELECT score_set_id FROM dataset_score_sets WHERE dataset_id = $1 AND model_run_id = $2 FOR UPDATE");
+        R.Register("truncate_score_set",
+                   "DELETE FROM dataset_scores WHERE score_set_id = $1 AND record_id > $2");
+        R.Register("lock_dataset_score_sets",
+                   "SELECT score_set_id FROM dataset_score_sets WHERE dataset_id = $1 FOR UPDATE");
+        R.Register("delete_dataset_score_jobs", "DELETE FROM dataset_score_jobs WHERE dataset_id = $1");
+        R.Register("delete_telemetry_rollups", "DELETE FROM telemetry_rollups WHERE run_id = $1");
+
+        // Dataset stats catalog (see dataset_stats.h)
+        R.Register("upsert_dataset_stats",
+                   "INSERT INTO dataset_stats (run_id, row_count, anomaly_count, min_ts, max_ts) "
+                   "VALUES ($1, $2, $3, to_timestamp($4::double precision / 1000000.0), to_timestamp($5::double precision / 1000000.0)) "
+                   "ON CONFLICT (run_id) DO UPDATE SET "
+                   "row_count = dataset_stats.row_count + EXCLUDED.row_count, "
+                   "anomaly_count = dataset_stats.anomaly_count + EXCLUDED.anomaly_count, "
+                   "min_ts = LEAST(dataset_stats.min_ts, EXCLUDED.min_ts), "
+                   "max_ts = GREATEST(dataset_stats.max_ts, EXCLUDED.max_ts), "
+                   "updated_at = NOW()");
+        // Chan et al. pairwise merge; SET expressions see the pre-update row.
+        R.Register("upsert_dataset_metric_stats",
+                   "INSERT INTO dataset_metric_stats AS s (run_id, metric, count, mean, m2, min, max) "
+                   "VALUES ($1, $2, $3, $4, $5, $6, $7) "
+                   "ON CONFLICT (run_id, metric) DO UPDATE SET "
+                   "count = s.count + EXCLUDED.count, "
+                   "mean = s.mean + (EXCLUDED.mean - s.mean) * EXCLUDED.count / (s.count + EXCLUDED.count), "
+                   "m2 = s.m2 + EXCLUDED.m2 + (EXCLUDED.mean - s.mean) * (EXCLUDED.mean - s.mean) "
+                   "* s.count::double precision * EXCLUDED.count / (s.count + EXCLUDED.count), "
+                   "min = LEAST(s.min, EXCLUDED.min), "
+                   "max = GREATEST(s.max, EXCLUDED.max)");
+        R.Register("upsert_dataset_anomaly_type_count",
+                   "INSERT INTO dataset_anomaly_type_counts (run_id, anomaly_type, count) VALUES ($1, $2, $3) "
+                   "ON CONFLICT (run_id, anomaly_type) DO UPDATE SET "
+                   "count = dataset_anomaly_type_counts.count + EXCLUDED.count");
+        R.Register("get_dataset_catalog",
+                   "SELECT s.row_count, s.anomaly_count, s.min_ts, s.max_ts FROM generation_runs r "
+                   "JOIN dataset_stats s ON s.run_id = r.run_id WHERE r.run_id = $1 AND r.stats_enabled");
+        R.Register("get_dataset_metric_catalog",
+                   "SELECT m.metric, m.count, m.mean, m.m2, m.min, m.max FROM generation_runs r "
+                   "JOIN dataset_metric_stats m ON m.run_id = r.run_id WHERE r.run_id = $1 AND r.stats_enabled");
+        R.Register("get_dataset_anomaly_type_catalog",
+                   "SELECT anomaly_type, count FROM dataset_anomaly_type_counts WHERE run_id = $1 "
+                   "ORDER BY count DESC, anomaly_type ASC");
+        R.Register("get_stats_enabled", "SELECT stats_enabled FROM generation_runs WHERE run_id = $1");
+        R.Register("delete_dataset_stats", "DELETE FROM dataset_stats WHERE run_id = $1");
+        R.Register("delete_dataset_metric_stats", "DELETE FROM dataset_metric_stats WHERE run_id = $1");
+        R.Register("delete_dataset_anomaly_type_counts", "DELETE FROM dataset_anomaly_type_counts WHERE run_id = $1");
+        R.Register("delete_run_rollups", "DELETE FROM telemetry_rollups WHERE run_id = $1");
+        // One-off scan for runs ingested before the catalog existed.
+        R.Register("build_dataset_stats",
+                   "INSERT INTO dataset_stats (run_id, row_count, anomaly_count, min_ts, max_ts) "
+                   "SELECT run_id, COUNT(*), SUM(CASE WHEN is_anomaly THEN 1 ELSE 0 END), MIN(metric_timestamp), MAX(metric_timestamp) "
+                   "FROM host_telemetry_archival WHERE run_id = $1 GROUP BY run_id");
+        R.Register("build_dataset_metric_stats",
+                   "INSERT INTO dataset_metric_stats (run_id, metric, count, mean, m2, min, max) "
+                   "SELECT h.run_id, v.metric, COUNT(*), AVG(v.val), COALESCE(VAR_POP(v.val), 0) * COUNT(*), MIN(v.val), MAX(v.val) "
+                   "FROM host_telemetry_archival h CROSS JOIN LATERAL (VALUES "
+                   "('cpu_usage', h.cpu_usage), ('memory_usage', h.memory_usage), ('disk_utilization', h.disk_utilization), "
+                   "('network_rx_rate', h.network_rx_rate), ('network_tx_rate', h.network_tx_rate)) AS v(metric, val) "
+                   "WHERE h.run_id = $1 GROUP BY h.run_id, v.metric");
+        R.Register("build_dataset_anomaly_type_counts",
+                   "INSERT INTO dataset_anomaly_type_counts (run_id, anomaly_type, count) "
+                   "SELECT run_id, anomaly_type, COUNT(*) FROM host_telemetry_archival "
+                   "WHERE run_id = $1 AND is_anomaly = true AND anomaly_type IS NOT NULL GROUP BY run_id, anomaly_type");
+        R.Register("enable_dataset_stats", "UPDATE generation_runs SET stats_enabled = TRUE WHERE run_id = $1");
+        R.Register("delete_alerts", "DELETE FROM alerts WHERE run_id = $1");
+        R.Register("delete_model_runs", "DELETE FROM model_runs WHERE dataset_id = $1");
+        R.Register("delete_generation_run", "DELETE FROM generation_runs WHERE run_id = $1");
+
+        // Additional useful ones
+        R.Register("get_dataset_record_count", "SELECT COUNT(*) FROM host_telemetry_archival WHERE run_id = $1");
+
+        R.Register("get_non_anomaly_count", "SELECT COUNT(*) FROM host_telemetry_archival WHERE run_id = $1 AND is_anomaly = false");
+    });
+}
+
+auto DbClient::AttachConnection(pqxx::connection& C) -> void {
+    RegisterStatements();
+    telemetry::db::StatementRegistry::Instance().Attach(&C, C.backendpid());
 }
 
 // Static allowlist of valid metric column names from host_telemetry_archival schema.
@@ -265,10 +537,50 @@ auto DbClient::ReconcileStaleJobs(std::optional<std::chrono::seconds> stale_ttl)
 }
 
 auto DbClient::RunRetentionCleanup(int retention_days) -> void {
+    auto cutoff = std::chrono::system_clock::now() - std::chrono::hours(24) * retention_days;
     try {
         auto C_ptr = manager_->GetConnection(); pqxx::connection& C = *C_ptr;
+        std::vector<std::string> partitions;
+        {
+            pqxx::nontransaction N(C);
+            auto res = N.exec(
+                "SELECT c.relname FROM pg_inherits i JOIN pg_class c ON c.oid = i.inhrelid "
+                "WHERE i.inhparent = 'host_telemetry_archival'::regclass");
+            for (const auto& row : res) { partitions.push_back(row[0].as<std::string>()); }
+        }
+
+        // Whole months go by DETACH + DROP: no dead tuples, no vacuum debt.
+        // Scores are matched through their score set by a join against the
+        // partition being dropped.
+        for (const auto& month : telemetry::partitions::ExpiredMonths(partitions, cutoff)) {
+            auto name = month.Name();
+            pqxx::work W(C);
+            auto scores = W.exec("DELETE FROM dataset_scores s USING dataset_score_sets ss, " + name + " t "
+                                 "WHERE s.score_set_id = ss.score_set_id AND ss.dataset_id = t.run_id "
+                                 "AND s.record_id = t.record_id");
+            W.exec("ALTER TABLE host_telemetry_archival DETACH PARTITION " + name);
+            auto runs = ForgetExpiredRows(W, "counts AS (SELECT run_id, COUNT(*) AS n FROM " + name + " GROUP BY run_id)");
+            W.exec("DROP TABLE " + name);
+            W.commit();
+            {
+                std::lock_guard<std::mutex> lock(g_partition_mutex);
+                g_ensured_partitions.erase(name);
+            }
+            spdlog::info("Retention dropped partition {} ({} scores, {} runs).", name, scores.affected_rows(), runs);
+        }
+
+        // Rows that fell into the DEFAULT partition are the only ones still
+        // deleted row by row.
         pqxx::work W(C);
-        PQXX_EXEC_PREPPED(W, "call_cleanup", retention_days);
+        std::string cutoff_sql = "to_timestamp(" +
+            std::to_string(std::chrono::duration_cast<std::chrono::seconds>(cutoff.time_since_epoch()).count()) + ")";
+        W.exec("DELETE FROM dataset_scores s USING dataset_score_sets ss, host_telemetry_archival_default t "
+               "WHERE s.score_set_id = ss.score_set_id AND ss.dataset_id = t.run_id "
+               "AND s.record_id = t.record_id AND t.ingestion_time < " + cutoff_sql);
+        // The delete feeds the counts directly, so they match the rows removed.
+        ForgetExpiredRows(W, "gone AS (DELETE FROM host_telemetry_archival_default WHERE ingestion_time < " +
+                             cutoff_sql + " RETURNING run_id), "
+                             "counts AS (SELECT run_id, COUNT(*) AS n FROM gone GROUP BY run_id)");
         W.commit();
         spdlog::info("Retention cleanup completed for data older than {} days.", retention_days);
     } catch (const std::exception& e) {
@@ -277,38 +589,57 @@ auto DbClient::RunRetentionCleanup(int retention_days) -> void {
 }
 
 auto DbClient::EnsurePartition(std::chrono::system_clock::time_point tp) -> void {
-    try {
-        auto t_time = std::chrono::system_clock::to_time_t(tp);
-        std::tm tm = *std::gmtime(&t_time);
-        
-        std::string part_name = fmt::format("host_telemetry_archival_{:04d}_{:02d}", tm.tm_year + 1900, tm.tm_mon + 1);
-        std::string start_date = fmt::format("{:04d}-{:02d}-01", tm.tm_year + 1900, tm.tm_mon + 1);
-        
-        // Calculate end date (next month)
-        int end_year = tm.tm_year + 1900;
-        int end_mon = tm.tm_mon + 2;
-        if (end_mon > 12) {
-            end_mon = 1;
-            end_year++;
-        }
-        std::string end_date = fmt::format("{:04d}-{:02d}-01", end_year, end_mon);
+    EnsureMonthPartition(telemetry::partitions::MonthOf(tp));
+}
 
+auto DbClient::EnsureMonthPartition(const telemetry::partitions::MonthPartition& month) -> void {
+    auto part_name = month.Name();
+    {
+        std::lock_guard<std::mutex> lock(g_partition_mutex);
+        if (g_ensured_partitions.count(part_name) > 0) { return; }
+    }
+    const int modulus = partition_policy_.hash_modulus;
+    try {
         auto C_ptr = manager_->GetConnection(); pqxx::connection& C = *C_ptr;
         pqxx::work W(C);
-        
-        std::string query = fmt::format(
-            "CREATE TABLE IF NOT EXISTS {} PARTITION OF host_telemetry_archival "
-            "FOR VALUES FROM ('{}') TO ('{}')",
-            part_name, start_date, end_date);
-            
-        W.exec(query);
+
+        // An existing month keeps the layout it was created with.
+        auto existing = W.exec("SELECT relkind FROM pg_class WHERE relname = " + W.quote(part_name));
+        if (existing.empty()) {
+            W.exec(fmt::format(
+                "CREATE TABLE IF NOT EXISTS {} PARTITION OF host_telemetry_archival "
+                "FOR VALUES FROM ('{}') TO ('{}'){}",
+                part_name, month.From(), month.To(), modulus > 0 ? " PARTITION BY HASH (run_id)" : ""));
+            for (int r = 0; r < modulus; ++r) {
+                W.exec(fmt::format(
+                    "CREATE TABLE IF NOT EXISTS {} PARTITION OF {} FOR VALUES WITH (MODULUS {}, REMAINDER {})",
+                    month.LeafName(r), part_name, modulus, r));
+            }
+        }
         W.commit();
-        spdlog::info("Ensured partition {} exists for range [{}, {}).", part_name, start_date, end_date);
+        {
+            std::lock_guard<std::mutex> lock(g_partition_mutex);
+            g_ensured_partitions.insert(part_name);
+        }
+        if (existing.empty()) {
+            spdlog::info("Created partition {} for range [{}, {}) with {} hash leaves.",
+                         part_name, month.From(), month.To(), modulus);
+        }
     } catch (const std::exception& e) {
         spdlog::error("Failed to ensure partition: {}", e.what());
     }
 }
 
+auto DbClient::MaintainPartitions() -> void {
+    auto month = telemetry::partitions::MonthOf(std::chrono::system_clock::now());
+    for (int i = 0; i <= partition_policy_.premake_months; ++i, month = month.Next()) {
+        EnsureMonthPartition(month);
+    }
+    if (partition_policy_.retention_days > 0) {
+        RunRetentionCleanup(partition_policy_.retention_days);
+    }
+}
+
 auto DbClient::CreateRun(const std::string& run_id, 
                         const telemetry::GenerateRequest& config, 
                         const std::string& status,
@@ -333,6 +664,18 @@ auto DbClient::UpdateRunStatus(const std::string& run_id,
                               const std::string& status, 
                               long inserted_rows,
                               const std::string& error) -> void {
+    if (control_writes_ && status != "SUCCEEDED") {
+        telemetry::db::ControlWrite write{"update_generation_run", {status, std::to_string(inserted_rows), run_id}};
+        if (!error.empty()) {
+            write = {"update_generation_run_error", {status, std::to_string(inserted_rows), error, run_id}};
+        }
+        auto result = WriteControl(std::move(write));
+        if (!result.ok) { spdlog::error("Failed to update run status: {}", result.error); }
+        return;
+    }
+    // SUCCEEDED may also build the stats catalog, so it keeps its own
+    // transaction; queued writes for the run land first.
+    if (control_writes_) { control_writes_->Sync(); }
     try {
         auto C_ptr = manager_->GetConnection(); pqxx::connection& C = *C_ptr;
         pqxx::work W(C);
@@ -343,6 +686,20 @@ auto DbClient::UpdateRunStatus(const std::string& run_id,
              PQXX_EXEC_PREPPED(W, "update_generation_run",
                           status, inserted_rows, run_id);
         }
+        if (status == "SUCCEEDED") {
+            // Runs created with stats_enabled already have a complete catalog;
+            // older ones get it built once here from a single scan.
+            auto enabled = PQXX_EXEC_PREPPED(W, "get_stats_enabled", run_id);
+            if (!enabled.empty() && !enabled[0][0].as<bool>()) {
+                PQXX_EXEC_PREPPED(W, "delete_dataset_stats", run_id);
+                PQXX_EXEC_PREPPED(W, "delete_dataset_metric_stats", run_id);
+                PQXX_EXEC_PREPPED(W, "delete_dataset_anomaly_type_counts", run_id);
+                PQXX_EXEC_PREPPED(W, "build_dataset_stats", run_id);
+                PQXX_EXEC_PREPPED(W, "build_dataset_metric_stats", run_id);
+                PQXX_EXEC_PREPPED(W, "build_dataset_anomaly_type_counts", run_id);
+                PQXX_EXEC_PREPPED(W, "enable_dataset_stats", run_id);
+            }
+        }
         W.commit();
     } catch (const std::exception& e) {
         spdlog::error("Failed to update run status: {}", e.what());
@@ -416,6 +773,14 @@ auto DbClient::BatchInsertTelemetry(const std::vector<TelemetryRecord>& records)
         }
         stream.complete();
 
+        // Keep rollups in the same transaction so they never drift from the raw rows.
+        telemetry::rollup::BatchAccumulator rollups;
+        for (const auto& r : records) { rollups.Add(r); }
+        UpsertRollups(W, rollups);
+        telemetry::stats::DatasetStatsAccumulator catalog;
+        for (const auto& r : records) { catalog.Add(r); }
+        UpsertDatasetStats(W, catalog);
+
         W.commit();
     } catch (const std::exception& e) {
         spdlog::error("Batch insert failed: {}", e.what());
@@ -423,16 +788,97 @@ auto DbClient::BatchInsertTelemetry(const std::vector<TelemetryRecord>& records)
     }
 }
 
+auto DbClient::UpsertDatasetStats(pqxx::work& W, const telemetry::stats::DatasetStatsAccumulator& catalog) -> void {
+    for (const auto& [run_id, delta] : catalog.Runs()) {
+        PQXX_EXEC_PREPPED(W, "upsert_dataset_stats", run_id, delta.row_count, delta.anomaly_count,
+                          delta.min_ts_us, delta.max_ts_us);
+        for (size_t m = 0; m < delta.metrics.size(); ++m) {
+            const auto& mo = delta.metrics[m];
+            PQXX_EXEC_PREPPED(W, "upsert_dataset_metric_stats", run_id, std::string(telemetry::rollup::kMetrics[m]),
+                              mo.count, mo.mean, mo.m2, mo.min, mo.max);
+        }
+        for (const auto& [type, count] : delta.anomaly_types) {
+            PQXX_EXEC_PREPPED(W, "upsert_dataset_anomaly_type_count", run_id, type, count);
+        }
+    }
+}
+
+auto DbClient::CatalogMetricMoments(pqxx::work& W, const std::string& run_id)
+    -> std::map<std::string, telemetry::stats::Moments> {
+    std::map<std::string, telemetry::stats::Moments> out;
+    for (const auto& row : PQXX_EXEC_PREPPED(W, "get_dataset_metric_catalog", run_id)) {
+        telemetry::stats::Moments mo;
+        mo.count = row[1].as<long>();
+        mo.mean = row[2].as<double>();
+        mo.m2 = row[3].as<double>();
+        mo.min = row[4].as<double>();
+        mo.max = row[5].as<double>();
+        out[row[0].as<std::string>()] = mo;
+    }
+    return out;
+}
+
+auto DbClient::UpsertRollups(pqxx::work& W, const telemetry::rollup::BatchAccumulator& rollups) -> void {
+    // One multi-row upsert per chunk; keys are unique within a batch, so
+    // ON CONFLICT never sees the same row twice in one statement.
+    const size_t kRowsPerStatement = 500;
+    const std::string prefix =
+        "INSERT INTO telemetry_rollups (run_id, resolution_seconds, bucket_ts, region, is_anomaly, metric, "
+        "count, sum, sumsq, min, max, sketch) VALUES ";
+    const std::string suffix =
+        " ON CONFLICT (run_id, resolution_seconds, metric, region, is_anomaly, bucket_ts) DO UPDATE SET "
+        "count = telemetry_rollups.count + EXCLUDED.count, "
+        "sum = telemetry_rollups.sum + EXCLUDED.sum, "
+        "sumsq = telemetry_rollups.sumsq + EXCLUDED.sumsq, "
+        "min = LEAST(telemetry_rollups.min, EXCLUDED.min), "
+        "max = GREATEST(telemetry_rollups.max, EXCLUDED.max), "
+        "sketch = rollup_sketch_merge(telemetry_rollups.sketch, EXCLUDED.sketch)";
+
+    std::string values;
+    size_t rows = 0;
+    auto flush = [&]() {
+        if (rows == 0) { return; }
+        W.exec(prefix + values + suffix);
+        values.clear();
+        rows = 0;
+    };
+    for (const auto& [run_id, cells] : rollups.Cells()) {
+        std::string quoted_run = W.quote(run_id);
+        for (const auto& [key, stats] : cells) {
+            const auto& [resolution, bucket, region, is_anomaly, metric] = key;
+            if (rows > 0) { values += ", "; }
+            values += fmt::format("({}, {}, to_timestamp({}), {}, {}, '{}', {}, {}, {}, {}, {}, '{}'::BIGINT[])",
+                                  quoted_run, resolution, bucket, W.quote(region), is_anomaly ? "TRUE" : "FALSE",
+                                  telemetry::rollup::kMetrics[metric], stats.count, stats.sum, stats.sumsq,
+                                  stats.min, stats.max, stats.sketch.ToPgArray());
+            if (++rows >= kRowsPerStatement) { flush(); }
+        }
+    }
+    flush();
+}
+
 auto DbClient::Heartbeat(JobType type, const std::string& job_id) -> void {
+    std::string stmt;
+    switch (type) {
+        case JobType::Generation: stmt = "heartbeat_generation"; break;
+        case JobType::ModelRun: stmt = "heartbeat_model_run"; break;
+        case JobType::ScoreJob: stmt = "heartbeat_score_job"; break;
+    }
+    if (control_writes_) {
+        // Liveness only: nothing reads it back, so don't wait for the batch.
+        RegisterStatements();
+        try {
+            control_writes_->Submit({stmt, {job_id}}, [job_id](const telemetry::db::ControlWriteResult& result) {
+                if (!result.ok) { spdlog::error("Failed to send heartbeat for job {}: {}", job_id, result.error); }
+            });
+        } catch (const std::exception& e) {
+            spdlog::error("Failed to send heartbeat for job {}: {}", job_id, e.what());
+        }
+        return;
+    }
     try {
         auto C_ptr = manager_->GetConnection(); pqxx::connection& C = *C_ptr;
         pqxx::work W(C);
-        std::string stmt;
-        switch (type) {
-            case JobType::Generation: stmt = "heartbeat_generation"; break;
-            case JobType::ModelRun: stmt = "heartbeat_model_run"; break;
-            case JobType::ScoreJob: stmt = "heartbeat_score_job"; break;
-        }
         PQXX_EXEC_PREPPED(W, stmt, job_id);
         W.commit();
     } catch (const std::exception& e) {
@@ -459,6 +905,44 @@ auto DbClient::InsertAlert(const Alert& alert) -> void {
     }
 }
 
+auto DbClient::PinAnalyticsReads() -> std::shared_ptr<void> {
+    if (t_analytics_pin.owner != nullptr) { return nullptr; } // an outer pin is active
+    // Only a replica connection is held: the primary is always at least as
+    // new as anything read before, and holding a primary connection here
+    // could starve nested checkouts from the same pool.
+    auto guard = std::make_shared<AnalyticsPinGuard>();
+    guard->conn = manager_->GetReplicaConnectionFor(AnalyticsRead());
+    t_analytics_pin = {this, guard->conn.get()};
+    return guard;
+}
+
+auto DbClient::AnalyticsConnection() -> DbConnectionPtr {
+    if (t_analytics_pin.owner == this) {
+        if (t_analytics_pin.replica == nullptr) { return manager_->GetConnection(); }
+        return {t_analytics_pin.replica, [](pqxx::connection*) {}}; // owned by the pin
+    }
+    return manager_->GetConnectionFor(AnalyticsRead());
+}
+
+auto DbClient::GetAnalyticsRunStatus(const std::string& run_id) -> telemetry::RunStatus {
+    telemetry::RunStatus status;
+    status.set_run_id(run_id);
+    try {
+        auto C_ptr = AnalyticsConnection(); pqxx::connection& C = *C_ptr;
+        pqxx::nontransaction N(C);
+        auto res = PQXX_EXEC_PREPPED(N, "get_run_status", run_id);
+        if (!res.empty()) {
+            status.set_status(res[0][0].as<std::string>());
+            status.set_inserted_rows(res[0][1].as<long>());
+        }
+    } catch (const std::exception& e) {
+        spdlog::error("DB Error in GetAnalyticsRunStatus for {}: {}", run_id, e.what());
+        status.set_status("ERROR");
+        status.set_error(e.what());
+    }
+    return status;
+}
+
 auto DbClient::GetRunStatus(const std::string& run_id) -> telemetry::RunStatus {
     telemetry::RunStatus status;
     status.set_run_id(run_id);
@@ -695,7 +1179,16 @@ auto DbClient::UpdateTrialEligibility(const std::string& model_run_id,
                                 bool is_eligible,
                                 const std::string& reason,
                                 double metric_value,
-                                const std::string& source) -> void {    try {
+                                const std::string& source) -> void {
+    if (control_writes_) {
+        std::optional<std::string> src;
+        if (!source.empty()) { src = source; }
+        auto result = WriteControl({"update_trial_eligibility",
+                                    {is_eligible ? "true" : "false", reason, fmt::format("{:.17g}", metric_value), src, model_run_id}});
+        if (!result.ok) { spdlog::error("Failed to update trial eligibility for {}: {}", model_run_id, result.error); }
+        return;
+    }
+    try {
         auto C_ptr = manager_->GetConnection(); pqxx::connection& C = *C_ptr;
         pqxx::work W(C);
         
@@ -829,11 +1322,20 @@ auto DbClient::UpdateInferenceRunStatus(const std::string& inference_id,
                                           const std::string& status, 
                                           int anomaly_count, 
                                           const nlohmann::json& details,
-                                          double latency_ms) -> void {    try {
+                                          double latency_ms) -> void {
+    UpdateInferenceRunStatusRaw(inference_id, status, anomaly_count, details.dump(), latency_ms);
+}
+
+auto DbClient::UpdateInferenceRunStatusRaw(const std::string& inference_id,
+                                           const std::string& status,
+                                           int anomaly_count,
+                                           const std::string& details_json,
+                                           double latency_ms) -> void {
+    try {
         auto C_ptr = manager_->GetConnection(); pqxx::connection& C = *C_ptr;
         pqxx::work W(C);
         PQXX_EXEC_PREPPED(W, "update_inference_run",
-                      status, anomaly_count, details.dump(), latency_ms, inference_id);
+                      status, anomaly_count, details_json, latency_ms, inference_id);
         W.commit();
     } catch (const std::exception& e) {
         spdlog::error("Failed to update inference run {}: {}", inference_id, e.what());
@@ -1149,10 +1651,16 @@ auto DbClient::GetDatasetSummary(const std::string& run_id, int topk) -> nlohman
     try {
         auto C_ptr = manager_->GetConnection(); pqxx::connection& C = *C_ptr;
         pqxx::work W(C);
-        auto res = W.exec(
-            "SELECT COUNT(*), MIN(metric_timestamp), MAX(metric_timestamp), "
-            "SUM(CASE WHEN is_anomaly THEN 1 ELSE 0 END) "
-            "FROM host_telemetry_archival WHERE run_id = " + W.quote(run_id));
+        // The stats catalog answers counts, bounds and type counts without
+        // scanning; runs without one fall back to the raw table.
+        auto res = PQXX_EXEC_PREPPED(W, "get_dataset_catalog", run_id);
+        bool from_catalog = !res.empty();
+        if (!from_catalog) {
+            res = W.exec(
+                "SELECT COUNT(*), MIN(metric_timestamp), MAX(metric_timestamp), "
+                "SUM(CASE WHEN is_anomaly THEN 1 ELSE 0 END) "
+                "FROM host_telemetry_archival WHERE run_id = " + W.quote(run_id));
+        }
         if (!res.empty()) {
             long count = res[0][0].as<long>();
             j["row_count"] = count;
@@ -1162,10 +1670,12 @@ auto DbClient::GetDatasetSummary(const std::string& run_id, int topk) -> nlohman
             j["anomaly_rate"] = count > 0 ? static_cast<double>(anomalies) / static_cast<double>(count) : 0.0;
         }
 
-        auto res_types = W.exec(
-            "SELECT anomaly_type, COUNT(*) FROM host_telemetry_archival "
-            "WHERE run_id = " + W.quote(run_id) + " AND is_anomaly = true AND anomaly_type IS NOT NULL "
-            "GROUP BY anomaly_type ORDER BY COUNT(*) DESC");
+        auto res_types = from_catalog
+            ? PQXX_EXEC_PREPPED(W, "get_dataset_anomaly_type_catalog", run_id)
+            : W.exec(
+                  "SELECT anomaly_type, COUNT(*) FROM host_telemetry_archival "
+                  "WHERE run_id = " + W.quote(run_id) + " AND is_anomaly = true AND anomaly_type IS NOT NULL "
+                  "GROUP BY anomaly_type ORDER BY COUNT(*) DESC");
         nlohmann::json type_counts = nlohmann::json::array();
         long other = 0;
         int idx = 0;
@@ -1254,49 +1764,17 @@ auto DbClient::GetTopK(const std::string& run_id,
     nlohmann::json out;
     out["items"] = nlohmann::json::array();
     try {
-        auto C_ptr = manager_->GetConnection(); pqxx::connection& C = *C_ptr;
+        auto C_ptr = AnalyticsConnection(); pqxx::connection& C = *C_ptr;
         pqxx::work W(C);
         
-        std::string filter = "WHERE run_id = " + W.quote(run_id);
-        if (!region.empty()) {
-            filter += " AND region = " + W.quote(region);
-        }
-        if (!is_anomaly.empty()) {
-            filter += " AND is_anomaly = " + W.quote(is_anomaly == "true");
-        }
-        if (!anomaly_type.empty()) {
-            filter += " AND anomaly_type = " + W.quote(anomaly_type);
-        }
-        if (!start_time.empty()) {
-            filter += " AND metric_timestamp >= " + W.quote(start_time);
-        }
-        if (!end_time.empty()) {
-            filter += " AND metric_timestamp <= " + W.quote(end_time);
-        }
-
-        if (include_total_distinct) {
-            auto res_count = W.exec("SELECT COUNT(DISTINCT " + column + ") FROM host_telemetry_archival " + filter);
+        auto queries = telemetry::db::BuildTopKQueries(run_id, column, k, region, is_anomaly, anomaly_type,
+                                                       start_time, end_time, include_total_distinct);
+        if (queries.total_distinct) {
+            auto res_count = ExecShaped(W, *queries.total_distinct);
             out["total_distinct"] = res_count.empty() ? 0 : res_count[0][0].as<long>();
         }
-
-        std::string query = "SELECT " + column + ", COUNT(*) FROM host_telemetry_archival " + filter +
-                            " GROUP BY " + column + " ORDER BY COUNT(*) DESC LIMIT " + std::to_string(k + 1);
-        auto res = W.exec(query);
-        
-        bool truncated = false;
-        size_t count = 0;
-        for (const auto& row : res) {
-            if (count >= static_cast<size_t>(k)) {
-                truncated = true;
-                break;
-            }
-            nlohmann::json j;
-            j["label"] = row[0].is_null() ? "" : row[0].as<std::string>();
-            j["count"] = row[1].as<long>();
-            out["items"].push_back(j);
-            count++;
-        }
-        out["truncated"] = truncated;
+        auto res = ExecShaped(W, queries.rows);
+        telemetry::db::AppendTopKRows(out, res, k);
         W.commit();
     } catch (const std::exception& e) {
         spdlog::error("Failed to get topk for {}: {}", run_id, e.what());
@@ -1314,7 +1792,8 @@ auto DbClient::GetTimeSeries(const std::string& run_id,
                                      const std::string& is_anomaly,
                                      const std::string& anomaly_type,
                                      const std::string& start_time,
-                                     const std::string& end_time) -> nlohmann::json { // NOLINTEND(bugprone-easily-swappable-parameters)    // Validate all metrics against allowlist to prevent SQL injection
+                                     const std::string& end_time,
+                                     const std::string& percentile_mode) -> nlohmann::json { // NOLINTEND(bugprone-easily-swappable-parameters)    // Validate all metrics against allowlist to prevent SQL injection
     for (const auto& metric : metrics) {
         if (!IsValidMetric(metric)) {
             throw std::invalid_argument("Invalid metric: " + metric);
@@ -1326,62 +1805,56 @@ auto DbClient::GetTimeSeries(const std::string& run_id,
             throw std::invalid_argument("Invalid aggregation: " + agg);
         }
     }
+    if (percentile_mode != "exact" && percentile_mode != "approx") {
+        throw std::invalid_argument("Invalid percentile_mode: " + percentile_mode);
+    }
+    bool approx = percentile_mode == "approx";
+    bool has_percentiles = std::find(aggs.begin(), aggs.end(), "p50") != aggs.end() ||
+                           std::find(aggs.begin(), aggs.end(), "p95") != aggs.end();
     nlohmann::json out = nlohmann::json::array();
     try {
-        auto C_ptr = manager_->GetConnection(); pqxx::connection& C = *C_ptr;
+        auto C_ptr = AnalyticsConnection(); pqxx::connection& C = *C_ptr;
         pqxx::work W(C);
-        std::string bucket_expr = "to_timestamp(floor(extract(epoch from metric_timestamp) / " +
-                                  std::to_string(bucket_seconds) + ") * " + std::to_string(bucket_seconds) + ")";
 
-        std::string select = bucket_expr + " AS bucket_ts";
-        for (const auto& metric : metrics) {
-            for (const auto& agg : aggs) {
-                const std::string& col = metric;
-                std::string alias = metric;
-                alias += "_";
-                alias += agg;
-                if (agg == "mean") { select += ", AVG("; select += col; select += ") AS "; select += alias; }
-                else if (agg == "min") { select += ", MIN("; select += col; select += ") AS "; select += alias; }
-                else if (agg == "max") { select += ", MAX("; select += col; select += ") AS "; select += alias; }
-                else if (agg == "p50") { select += ", PERCENTILE_CONT(0.5) WITHIN GROUP (ORDER BY "; select += col; select += ") AS "; select += alias; }
-                else if (agg == "p95") { select += ", PERCENTILE_CONT(0.95) WITHIN GROUP (ORDER BY "; select += col; select += ") AS "; select += alias; }
+        // Runs created since rollups were introduced are answered from
+        // telemetry_rollups when the bucket and bounds line up with a
+        // maintained resolution; everything else scans the raw table.
+        // Rollup percentiles are sketch estimates, so exact mode skips them.
+        if (!metrics.empty() && (approx || !has_percentiles)) {
+            ShapedQuery probe;
+            probe.sql = "SELECT rollups_enabled, ";
+            probe.sql += start_time.empty() ? std::string("NULL") : "extract(epoch from " + probe.Bind(start_time, "timestamptz") + ")";
+            probe.sql += ", ";
+            probe.sql += end_time.empty() ? std::string("NULL") : "extract(epoch from " + probe.Bind(end_time, "timestamptz") + ")";
+            probe.sql += " FROM generation_runs WHERE run_id = " + probe.Bind(run_id, "uuid");
+            auto probe_res = ExecShaped(W, probe);
+            if (!probe_res.empty() && !probe_res[0][0].is_null() && probe_res[0][0].as<bool>()) {
+                auto whole_epoch = [](const pqxx::field& f) -> std::optional<int64_t> {
+                    if (f.is_null()) { return std::nullopt; }
+                    double v = f.as<double>();
+                    if (v != std::floor(v)) { return std::nullopt; }
+                    return static_cast<int64_t>(v);
+                };
+                auto start_epoch = whole_epoch(probe_res[0][1]);
+                auto end_epoch = whole_epoch(probe_res[0][2]);
+                bool bounds_ok = (start_time.empty() || start_epoch) && (end_time.empty() || end_epoch);
+                auto resolution = bounds_ok ? telemetry::rollup::ChooseResolution(bucket_seconds, start_epoch, end_epoch,
+                                                                                  !anomaly_type.empty())
+                                            : std::nullopt;
+                if (resolution) {
+                    out = GetTimeSeriesFromRollups(W, run_id, metrics, aggs, bucket_seconds, *resolution, region,
+                                                   is_anomaly, start_time, end_time);
+                    W.commit();
+                    return out;
+                }
             }
         }
-        select += ", COUNT(*) AS bucket_count";
 
-        std::string query = "SELECT " + select + " FROM host_telemetry_archival WHERE run_id = " + W.quote(run_id);
-        if (!region.empty()) {
-            query += " AND region = " + W.quote(region);
-        }
-        if (!is_anomaly.empty()) {
-            query += " AND is_anomaly = " + W.quote(is_anomaly == "true");
-        }
-        if (!anomaly_type.empty()) {
-            query += " AND anomaly_type = " + W.quote(anomaly_type);
-        }
-        if (!start_time.empty()) {
-            query += " AND metric_timestamp >= " + W.quote(start_time);
-        }
-        if (!end_time.empty()) {
-            query += " AND metric_timestamp <= " + W.quote(end_time);
-        }
-        query += " GROUP BY bucket_ts ORDER BY bucket_ts ASC";
-        auto res = W.exec(query);
-        for (const auto& row : res) {
-            nlohmann::json j;
-            j["ts"] = row[0].as<std::string>();
-            int col_idx = 1;
-            for (const auto& metric : metrics) {
-                for (const auto& agg : aggs) {
-                    std::string key = metric;
-                    key += "_";
-                    key += agg;
-                    j[key] = row[col_idx].is_null() ? 0.0 : row[col_idx].as<double>();
-                    col_idx++;
-                }
-            }
-            j["count"] = row[col_idx].as<long>();
-            out.push_back(j);
+        auto queries = telemetry::db::BuildRawTimeSeriesQueries(run_id, metrics, aggs, bucket_seconds, approx, region,
+                                                                is_anomaly, anomaly_type, start_time, end_time);
+        out = telemetry::db::TimeSeriesRowsToJson(ExecShaped(W, queries.rows), metrics, aggs);
+        for (const auto& [metric, bins_q] : queries.sketch_bins) {
+            telemetry::db::ApplySketchBins(out, ExecShaped(W, bins_q), metric, aggs);
         }
         W.commit();
     } catch (const std::exception& e) {
@@ -1391,6 +1864,116 @@ auto DbClient::GetTimeSeries(const std::string& run_id,
     return out;
 }
 
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+auto DbClient::GetTimeSeriesFromRollups(pqxx::work& W,
+                                        const std::string& run_id,
+                                        const std::vector<std::string>& metrics,
+                                        const std::vector<std::string>& aggs,
+                                        int bucket_seconds,
+                                        int resolution,
+                                        const std::string& region,
+                                        const std::string& is_anomaly,
+                                        const std::string& start_time,
+                                        const std::string& end_time) -> nlohmann::json { // NOLINTEND(bugprone-easily-swappable-parameters)
+    using telemetry::rollup::Stats;
+    bool want_sketch = std::find(aggs.begin(), aggs.end(), "p50") != aggs.end() ||
+                       std::find(aggs.begin(), aggs.end(), "p95") != aggs.end();
+
+    std::string metric_list;
+    for (const auto& metric : metrics) {
+        if (!metric_list.empty()) { metric_list += ", "; }
+        metric_list += W.quote(metric);
+    }
+    // Metric names are allowlisted and part of the shape; values are bound.
+    ShapedQuery q;
+    std::string run_param = q.Bind(run_id, "uuid");
+    std::string bucket_param = q.Bind(std::to_string(bucket_seconds), "integer");
+    std::string filters;
+    if (!region.empty()) { filters += " AND region = " + q.Bind(region, "text"); }
+    if (!is_anomaly.empty()) { filters += " AND is_anomaly = " + q.Bind(is_anomaly == "true" ? "true" : "false", "boolean"); }
+    std::string end_param = end_time.empty() ? std::string() : q.Bind(end_time, "timestamptz");
+
+    // Output bucket epoch -> (timestamp text, per requested metric stats)
+    std::map<int64_t, std::pair<std::string, std::vector<Stats>>> buckets;
+    auto slot = [&](int64_t epoch, const std::string& ts) -> std::vector<Stats>& {
+        auto& entry = buckets[epoch];
+        if (entry.second.empty()) {
+            entry.first = ts;
+            entry.second.resize(metrics.size());
+        }
+        return entry.second;
+    };
+    auto metric_index = [&](const std::string& name) -> size_t {
+        return static_cast<size_t>(std::find(metrics.begin(), metrics.end(), name) - metrics.begin());
+    };
+
+    ShapedQuery rollup_q = q;
+    std::string out_epoch = "(floor(extract(epoch from bucket_ts) / " + bucket_param + ") * " + bucket_param + ")";
+    rollup_q.sql = "SELECT " + out_epoch + "::bigint, to_timestamp(" + out_epoch + "), metric, "
+                   "SUM(count), SUM(sum), SUM(sumsq), MIN(min), MAX(max)" +
+                   std::string(want_sketch ? ", rollup_sketch_sum(sketch)" : "") +
+                   " FROM telemetry_rollups WHERE run_id = " + run_param +
+                   " AND resolution_seconds = " + rollup_q.Bind(std::to_string(resolution), "integer") +
+                   " AND metric IN (" + metric_list + ")" + filters;
+    if (!start_time.empty()) { rollup_q.sql += " AND bucket_ts >= " + rollup_q.Bind(start_time, "timestamptz"); }
+    // end is aligned to the resolution, so the bucket starting at end holds
+    // only rows after it -- except rows exactly at end, folded in below.
+    if (!end_time.empty()) { rollup_q.sql += " AND bucket_ts < " + end_param; }
+    rollup_q.sql += " GROUP BY 1, 2, metric";
+    for (const auto& row : ExecShaped(W, rollup_q)) {
+        auto& stats = slot(row[0].as<int64_t>(), row[1].as<std::string>());
+        Stats cell;
+        cell.count = row[3].as<long>();
+        cell.sum = row[4].as<double>();
+        cell.sumsq = row[5].as<double>();
+        cell.min = row[6].as<double>();
+        cell.max = row[7].as<double>();
+        if (want_sketch && !row[8].is_null()) {
+            cell.sketch = telemetry::rollup::QuantileSketch::FromPgArray(row[8].as<std::string>());
+        }
+        stats[metric_index(row[2].as<std::string>())].Merge(cell);
+    }
+
+    if (!end_time.empty()) {
+        ShapedQuery edge = q;
+        std::string raw_epoch = "(floor(extract(epoch from metric_timestamp) / " + bucket_param + ") * " + bucket_param + ")";
+        edge.sql = "SELECT " + raw_epoch + "::bigint, to_timestamp(" + raw_epoch + ")";
+        for (const auto& metric : metrics) { edge.sql += ", " + metric; }
+        edge.sql += " FROM host_telemetry_archival WHERE run_id = " + run_param +
+                    " AND metric_timestamp = " + end_param + filters;
+        for (const auto& row : ExecShaped(W, edge)) {
+            auto& stats = slot(row[0].as<int64_t>(), row[1].as<std::string>());
+            for (size_t m = 0; m < metrics.size(); ++m) {
+                stats[m].Add(row[static_cast<int>(m) + 2].as<double>());
+            }
+        }
+    }
+
+    nlohmann::json out = nlohmann::json::array();
+    for (const auto& [epoch, entry] : buckets) {
+        const auto& [ts, stats] = entry;
+        nlohmann::json j;
+        j["ts"] = ts;
+        for (size_t m = 0; m < metrics.size(); ++m) {
+            const auto& st = stats[m];
+            for (const auto& agg : aggs) {
+                double value = 0.0;
+                if (st.count > 0) {
+                    if (agg == "mean") { value = st.sum / static_cast<double>(st.count); }
+                    else if (agg == "min") { value = st.min; }
+                    else if (agg == "max") { value = st.max; }
+                    else if (agg == "p50") { value = st.sketch.Quantile(0.5); }
+                    else if (agg == "p95") { value = st.sketch.Quantile(0.95); }
+                }
+                j[metrics[m] + "_" + agg] = value;
+            }
+        }
+        j["count"] = stats.empty() ? 0L : stats.front().count;
+        out.push_back(j);
+    }
+    return out;
+}
+
 // NOLINTBEGIN(bugprone-easily-swappable-parameters)
 auto DbClient::GetHistogram(const std::string& run_id,
                                    const std::string& metric,
@@ -1414,14 +1997,24 @@ auto DbClient::GetHistogram(const std::string& run_id,
     out["edges"] = nlohmann::json::array();
     out["counts"] = nlohmann::json::array();
     try {
-        auto C_ptr = manager_->GetConnection(); pqxx::connection& C = *C_ptr;
+        auto C_ptr = AnalyticsConnection(); pqxx::connection& C = *C_ptr;
         pqxx::work W(C);
         if (max_val <= min_val) {
-            auto res = W.exec(
-                "SELECT MIN(" + metric + "), MAX(" + metric + ") FROM host_telemetry_archival WHERE run_id = " + W.quote(run_id));
-            if (!res.empty() && !res[0][0].is_null() && !res[0][1].is_null()) {
-                min_val = res[0][0].as<double>();
-                max_val = res[0][1].as<double>();
+            // The stats catalog carries the run-wide extremes without a scan;
+            // runs without one fall back to the raw table.
+            auto catalog = CatalogMetricMoments(W, run_id);
+            if (auto it = catalog.find(metric); it != catalog.end()) {
+                min_val = it->second.min;
+                max_val = it->second.max;
+            } else {
+                ShapedQuery bounds;
+                bounds.sql = "SELECT MIN(" + metric + "), MAX(" + metric + ") FROM host_telemetry_archival WHERE run_id = " +
+                             bounds.Bind(run_id, "uuid");
+                auto res = ExecShaped(W, bounds);
+                if (!res.empty() && !res[0][0].is_null() && !res[0][1].is_null()) {
+                    min_val = res[0][0].as<double>();
+                    max_val = res[0][1].as<double>();
+                }
             }
         }
         if (max_val <= min_val) {
@@ -1433,26 +2026,16 @@ auto DbClient::GetHistogram(const std::string& run_id,
             out["edges"].push_back(min_val + step * i);
         }
 
-        std::string query = "SELECT width_bucket(" + metric + ", " + std::to_string(min_val) + ", " +
-                            std::to_string(max_val) + ", " + std::to_string(bins) + ") AS b, COUNT(*) "
-                            "FROM host_telemetry_archival WHERE run_id = " + W.quote(run_id);
-        if (!region.empty()) {
-            query += " AND region = " + W.quote(region);
-        }
-        if (!is_anomaly.empty()) {
-            query += " AND is_anomaly = " + W.quote(is_anomaly == "true");
-        }
-        if (!anomaly_type.empty()) {
-            query += " AND anomaly_type = " + W.quote(anomaly_type);
-        }
-        if (!start_time.empty()) {
-            query += " AND metric_timestamp >= " + W.quote(start_time);
-        }
-        if (!end_time.empty()) {
-            query += " AND metric_timestamp <= " + W.quote(end_time);
-        }
-        query += " GROUP BY b ORDER BY b ASC";
-        auto res = W.exec(query);
+        // Bound at full precision so bins line up exactly with the edges above.
+        ShapedQuery q;
+        std::string lo = q.Bind(fmt::format("{:.17g}", min_val), "float8");
+        std::string hi = q.Bind(fmt::format("{:.17g}", max_val), "float8");
+        std::string n_bins = q.Bind(std::to_string(bins), "integer");
+        std::string query = "SELECT width_bucket(" + metric + ", " + lo + ", " + hi + ", " + n_bins + ") AS b, COUNT(*) "
+                            "FROM host_telemetry_archival WHERE run_id = " + q.Bind(run_id, "uuid");
+        AppendRawFilters(q, query, region, is_anomaly, anomaly_type, start_time, end_time);
+        q.sql = query + " GROUP BY b ORDER BY b ASC";
+        auto res = ExecShaped(W, q);
 
         std::vector<long> counts(static_cast<size_t>(bins), 0);
         for (const auto& row : res) {
@@ -1482,6 +2065,23 @@ auto DbClient::GetMetricStats(const std::string& run_id, const std::string& metr
     try {
         auto C_ptr = manager_->GetConnection(); pqxx::connection& C = *C_ptr;
         pqxx::work W(C);
+        auto catalog = CatalogMetricMoments(W, run_id);
+        if (auto it = catalog.find(metric); it != catalog.end()) {
+            // Moments come from the catalog; only the exact percentiles need the rows.
+            auto pct = W.exec(
+                "SELECT PERCENTILE_CONT(0.5) WITHIN GROUP (ORDER BY " + metric + "), "
+                "PERCENTILE_CONT(0.95) WITHIN GROUP (ORDER BY " + metric + ") "
+                "FROM host_telemetry_archival WHERE run_id = " + W.quote(run_id));
+            j["count"] = it->second.count;
+            j["min"] = it->second.min;
+            j["max"] = it->second.max;
+            j["mean"] = it->second.mean;
+            j["p50"] = pct.empty() || pct[0][0].is_null() ? 0.0 : pct[0][0].as<double>();
+            j["p95"] = pct.empty() || pct[0][1].is_null() ? 0.0 : pct[0][1].as<double>();
+            j["missing_count"] = 0;
+            W.commit();
+            return j;
+        }
         auto res = W.exec(
             "SELECT COUNT(*), MIN(" + metric + "), MAX(" + metric + "), AVG(" + metric + "), "
             "PERCENTILE_CONT(0.5) WITHIN GROUP (ORDER BY " + metric + "), "
@@ -1512,6 +2112,25 @@ auto DbClient::GetDatasetMetricsSummary(const std::string& run_id) -> nlohmann::
     try {
         auto C_ptr = manager_->GetConnection(); pqxx::connection& C = *C_ptr;
         pqxx::work W(C);
+        auto catalog = CatalogMetricMoments(W, run_id);
+        if (!catalog.empty()) {
+            std::vector<std::pair<std::string, double>> stddevs;
+            for (const auto& m : kMetrics) {
+                auto it = catalog.find(m);
+                stddevs.emplace_back(m, it == catalog.end() ? 0.0 : it->second.StdDev().value_or(0.0));
+            }
+            std::sort(stddevs.begin(), stddevs.end(), [](const auto& a, const auto& b) {
+                return a.second > b.second;
+            });
+            nlohmann::json high_variance = nlohmann::json::array();
+            for (const auto& p : stddevs) {
+                high_variance.push_back({{"key", p.first}, {"stddev", p.second}});
+            }
+            out["high_variance"] = high_variance;
+            out["high_missingness"] = nlohmann::json::array();
+            W.commit();
+            return out;
+        }
         std::string select;
         for (size_t i = 0; i < kMetrics.size(); ++i) {
             select += "STDDEV(" + kMetrics[i] + ") AS " + kMetrics[i] + "_stddev";
@@ -1570,7 +2189,23 @@ auto DbClient::UpdateScoreJob(const std::string& job_id,
                         long total_rows,
                         long processed_rows,
                         long last_record_id,
-                        const std::string& error) -> void {    try {
+                        const std::string& error) -> void {
+    if (control_writes_) {
+        std::vector<std::optional<std::string>> params = {status, std::to_string(total_rows),
+                                                          std::to_string(processed_rows), std::to_string(last_record_id)};
+        std::string stmt = "update_score_job_status";
+        if (status == "COMPLETED") {
+            stmt = "update_score_job_completed";
+        } else if (!error.empty()) {
+            stmt = "update_score_job_error";
+            params.emplace_back(error);
+        }
+        params.emplace_back(job_id);
+        auto result = WriteControl({stmt, std::move(params)});
+        if (!result.ok) { spdlog::error("Failed to update score job {}: {}", job_id, result.error); }
+        return;
+    }
+    try {
         auto C_ptr = manager_->GetConnection(); pqxx::connection& C = *C_ptr;
         pqxx::work W(C);
         if (status == "COMPLETED") {
@@ -1616,6 +2251,24 @@ auto DbClient::GetScoreJob(const std::string& job_id) -> nlohmann::json {
     return j;
 }
 
+auto DbClient::GetAnalyticsLatestScoreJob(const std::string& dataset_id, const std::string& model_run_id)
+    -> nlohmann::json { // NOLINT(bugprone-easily-swappable-parameters)
+    nlohmann::json j = nlohmann::json::object();
+    try {
+        auto C_ptr = AnalyticsConnection(); pqxx::connection& C = *C_ptr;
+        pqxx::nontransaction N(C);
+        auto res = PQXX_EXEC_PREPPED(N, "get_latest_score_job", dataset_id, model_run_id);
+        if (!res.empty()) {
+            j["job_id"] = res[0][0].as<std::string>();
+            j["status"] = res[0][1].as<std::string>();
+            j["processed_rows"] = res[0][2].as<long>();
+        }
+    } catch (const std::exception& e) {
+        spdlog::error("Failed to get latest score job for {}/{}: {}", dataset_id, model_run_id, e.what());
+    }
+    return j;
+}
+
 // NOLINTBEGIN(bugprone-easily-swappable-parameters)
 auto DbClient::ListScoreJobs(int limit,
                                        int offset,
@@ -1687,6 +2340,9 @@ auto DbClient::FetchScoringRowsAfterRecord(const std::string& dataset_id,
             r.disk = row[4].as<double>();
             r.rx = row[5].as<double>();
             r.tx = row[6].as<double>();
+            r.region = row[7].as<std::string>();
+            r.project_id = row[8].as<std::string>();
+            r.anomaly_type = row[9].as<std::string>();
             rows.push_back(r);
         }
     } catch (const std::exception& e) {
@@ -1696,6 +2352,39 @@ auto DbClient::FetchScoringRowsAfterRecord(const std::string& dataset_id,
     return rows;
 }
 
+auto DbClient::LoadColumnarDataset(const std::string& run_id) -> std::shared_ptr<telemetry::api::ColumnarDataset> {
+    auto dataset = std::make_shared<telemetry::api::ColumnarDataset>(run_id);
+    auto start = std::chrono::steady_clock::now();
+    try {
+        auto C_ptr = manager_->GetConnection(); pqxx::connection& C = *C_ptr;
+        pqxx::nontransaction N(C);
+        std::string query =
+            "SELECT (extract(epoch FROM metric_timestamp) * 1000000)::bigint, host_id, project_id, region, "
+            "cpu_usage, memory_usage, disk_utilization, network_rx_rate, network_tx_rate, is_anomaly, anomaly_type "
+            "FROM host_telemetry_archival WHERE run_id = " + N.quote(run_id);
+#if defined(PQXX_VERSION_MAJOR) && (PQXX_VERSION_MAJOR >= 7)
+        auto stream = pqxx::stream_from::query(N, query);
+#else
+        pqxx::stream_from stream(N, pqxx::from_query, query);
+#endif
+        std::tuple<int64_t, std::string, std::string, std::string,
+                   double, double, double, double, double, bool, std::optional<std::string>> row;
+        while (stream >> row) {
+            const auto& [ts_us, host_id, project_id, region, cpu, mem, disk, rx, tx, is_anomaly, anomaly_type] = row;
+            dataset->Append(ts_us, host_id, project_id, region, {cpu, mem, disk, rx, tx}, is_anomaly, anomaly_type);
+        }
+        stream.complete();
+    } catch (const std::exception& e) {
+        spdlog::error("Failed to load columnar dataset {}: {}", run_id, e.what());
+        throw;
+    }
+    dataset->Finish();
+    double duration_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    telemetry::obs::EmitHistogram("columnar_load_duration_ms", duration_ms, "ms", "db",
+                                  {{"dataset_id", run_id}}, {{"rows", dataset->Size()}, {"bytes", dataset->Bytes()}});
+    return dataset;
+}
+
 auto DbClient::InsertDatasetScores(const std::string& dataset_id,
                                    const std::string& model_run_id,
                                    const std::vector<std::pair<long, std::pair<double, bool>>>& scores) -> void {
@@ -1703,25 +2392,25 @@ auto DbClient::InsertDatasetScores(const std::string& dataset_id,
     auto start = std::chrono::steady_clock::now();
     try {
         auto C_ptr = manager_->GetConnection(); pqxx::connection& C = *C_ptr;
+        // Rows carry the pair's 4-byte score set id rather than two UUIDs.
+        long score_set_id = EnsureScoreSet(C, dataset_id, model_run_id);
         pqxx::work W(C);
         const std::vector<std::string> columns = {
-            "dataset_id",
-            "model_run_id",
             "record_id",
             "reconstruction_error",
+            "score_set_id",
             "predicted_is_anomaly"};
 #if defined(PQXX_VERSION_MAJOR) && (PQXX_VERSION_MAJOR >= 7)
-        auto stream = pqxx::stream_to::table(W, pqxx::table_path{"dataset_scores"}, 
-            {std::string_view("dataset_id"),
-             std::string_view("model_run_id"),
-             std::string_view("record_id"),
+        auto stream = pqxx::stream_to::table(W, pqxx::table_path{"dataset_scores"},
+            {std::string_view("record_id"),
              std::string_view("reconstruction_error"),
+             std::string_view("score_set_id"),
              std::string_view("predicted_is_anomaly")});
 #else
         pqxx::stream_to stream(W, "dataset_scores", columns);
 #endif
         for (const auto& entry : scores) {
-            stream << std::make_tuple(dataset_id, model_run_id, entry.first, entry.second.first, entry.second.second);
+            stream << std::make_tuple(entry.first, entry.second.first, score_set_id, entry.second.second);
         }
         stream.complete();
         W.commit();
@@ -1750,6 +2439,112 @@ auto DbClient::InsertDatasetScores(const std::string& dataset_id,
     }
 }
 
+auto DbClient::EnsureScoreSet(pqxx::connection& C,
+                              const std::string& dataset_id,
+                              const std::string& model_run_id) -> long {
+    long score_set_id = 0;
+    {
+        pqxx::work W(C);
+        score_set_id = PQXX_EXEC_PREPPED(W, "ensure_score_set", dataset_id, model_run_id)[0][0].as<long>();
+        W.commit();
+    }
+    if (!partition_policy_.score_set_partitions) { return score_set_id; }
+    {
+        std::lock_guard<std::mutex> lock(g_partition_mutex);
+        if (g_ensured_score_partitions.count(score_set_id) > 0) { return score_set_id; }
+    }
+    // Created in its own transaction so the parent's lock is not held for
+    // the whole COPY.
+    auto part_name = telemetry::partitions::ScoreSetPartitionName(score_set_id);
+    try {
+        pqxx::work W(C);
+        W.exec(fmt::format("CREATE TABLE IF NOT EXISTS {} PARTITION OF dataset_scores FOR VALUES IN ({})",
+                           part_name, score_set_id));
+        W.commit();
+    } catch (const std::exception& e) {
+        // The set already has rows in the default partition (it was first
+        // scored with SCORE_SET_PARTITIONS off); it stays there.
+        spdlog::warn("Score set {} stays in dataset_scores_default: {}", score_set_id, e.what());
+    }
+    std::lock_guard<std::mutex> lock(g_partition_mutex);
+    g_ensured_score_partitions.insert(score_set_id);
+    return score_set_id;
+}
+
+auto DbClient::ResetDatasetScores(const std::string& dataset_id,
+                                  const std::string& model_run_id) -> void {
+    try {
+        auto C_ptr = manager_->GetConnection(); pqxx::connection& C = *C_ptr;
+        pqxx::work W(C);
+        DropScoreSets(W, PQXX_EXEC_PREPPED(W, "lock_score_set", dataset_id, model_run_id));
+        W.commit();
+    } catch (const std::exception& e) {
+        spdlog::error("Failed to reset scores for {}/{}: {}", dataset_id, model_run_id, e.what());
+        throw;
+    }
+}
+
+auto DbClient::TruncateDatasetScores(const std::string& dataset_id,
+                                     const std::string& model_run_id,
+                                     long last_record_id) -> void {
+    try {
+        auto C_ptr = manager_->GetConnection(); pqxx::connection& C = *C_ptr;
+        pqxx::work W(C);
+        for (const auto& row : PQXX_EXEC_PREPPED(W, "lock_score_set", dataset_id, model_run_id)) {
+            auto removed = PQXX_EXEC_PREPPED(W, "truncate_score_set", row[0].as<long>(), last_record_id);
+            if (removed.affected_rows() > 0) {
+                spdlog::info("Dropped {} scores of {}/{} past checkpoint record {}.",
+                             removed.affected_rows(), dataset_id, model_run_id, last_record_id);
+            }
+        }
+        W.commit();
+    } catch (const std::exception& e) {
+        spdlog::error("Failed to truncate scores for {}/{}: {}", dataset_id, model_run_id, e.what());
+        throw;
+    }
+}
+
+auto DbClient::SaveEvalAggregates(const std::string& dataset_id,
+                                  const std::string& model_run_id,
+                                  const nlohmann::json& aggregates) -> void {
+    try {
+        auto C_ptr = manager_->GetConnection(); pqxx::connection& C = *C_ptr;
+        pqxx::work W(C);
+        long samples = telemetry::stats::EvalAggregates::FromJson(aggregates).Samples();
+        PQXX_EXEC_PREPPED(W, "upsert_eval_aggregates", dataset_id, model_run_id, samples, aggregates.dump());
+        W.commit();
+    } catch (const std::exception& e) {
+        spdlog::error("Failed to save eval aggregates for {}/{}: {}", dataset_id, model_run_id, e.what());
+        throw;
+    }
+}
+
+auto DbClient::DeleteEvalAggregates(const std::string& dataset_id,
+                                    const std::string& model_run_id) -> void {
+    try {
+        auto C_ptr = manager_->GetConnection(); pqxx::connection& C = *C_ptr;
+        pqxx::work W(C);
+        PQXX_EXEC_PREPPED(W, "delete_eval_aggregates", dataset_id, model_run_id);
+        W.commit();
+    } catch (const std::exception& e) {
+        spdlog::error("Failed to delete eval aggregates for {}/{}: {}", dataset_id, model_run_id, e.what());
+        throw;
+    }
+}
+
+auto DbClient::LoadEvalAggregates(pqxx::transaction_base& T,
+                                  const std::string& dataset_id,
+                                  const std::string& model_run_id) -> std::optional<telemetry::stats::EvalAggregates> {
+    auto res = PQXX_EXEC_PREPPED(T, "get_eval_aggregates", dataset_id, model_run_id);
+    if (res.empty()) { return std::nullopt; }
+    try {
+        return telemetry::stats::EvalAggregates::FromJson(nlohmann::json::parse(res[0][0].as<std::string>()));
+    } catch (const nlohmann::json::exception& e) {
+        spdlog::warn("Ignoring malformed eval aggregates for {}/{}: {}", dataset_id, model_run_id, e.what());
+        return std::nullopt;
+    }
+}
+
 auto DbClient::GetDatasetRecordCount(const std::string& dataset_id) -> long {
     try {
         auto C_ptr = manager_->GetConnection(); pqxx::connection& C = *C_ptr;
@@ -1770,13 +2565,34 @@ auto DbClient::GetScores(const std::string& dataset_id,
                              bool only_anomalies,
                              double min_score,
                              double max_score) -> nlohmann::json {
-    nlohmann::json out = nlohmann::json::object();
-    out["items"] = nlohmann::json::array();
+    try {
+        return telemetry::api::CollectJsonObject(
+            QueryScores(dataset_id, model_run_id, limit, offset, only_anomalies, min_score, max_score));
+    } catch (const std::exception&) {
+        return {{"items", nlohmann::json::array()}};
+    }
+}
+
+// NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
+auto DbClient::QueryScores(const std::string& dataset_id,
+                           const std::string& model_run_id,
+                           int limit,
+                           int offset,
+                           bool only_anomalies,
+                           double min_score,
+                           double max_score) -> telemetry::api::JsonFieldsWriter {
     auto start = std::chrono::steady_clock::now();
+    pqxx::result page;
+    std::string scored_at;
+    nlohmann::json model_run;
+    long total = 0;
+    std::optional<std::pair<double, double>> range;
     try {
         auto C_ptr = manager_->GetConnection(); pqxx::connection& C = *C_ptr;
         pqxx::nontransaction N(C);
-        std::string where = "WHERE s.dataset_id = " + N.quote(dataset_id) + " AND s.model_run_id = " + N.quote(model_run_id);
+        auto score_set = FindScoreSet(N, dataset_id, model_run_id);
+        scored_at = score_set->scored_at;
+        std::string where = "WHERE " + ScoreSetFilter(score_set);
         if (only_anomalies) {
             where += " AND s.predicted_is_anomaly = true";
         }
@@ -1788,44 +2604,23 @@ auto DbClient::GetScores(const std::string& dataset_id,
         }
 
         std::string query =
-            "SELECT s.score_id, s.record_id, s.reconstruction_error, s.predicted_is_anomaly, s.scored_at, "
+            "SELECT s.record_id, s.reconstruction_error, s.predicted_is_anomaly, "
             "h.metric_timestamp, h.host_id, h.is_anomaly as label "
             "FROM dataset_scores s JOIN host_telemetry_archival h ON s.record_id = h.record_id "
-            + where + " ORDER BY s.reconstruction_error DESC, s.score_id DESC LIMIT $1 OFFSET $2";
-        
-        auto res = PQXX_EXEC_PARAMS(N, query, limit, offset);
-        for (const auto& row : res) {
-            nlohmann::json j;
-            j["score_id"] = row[0].as<long>();
-            j["record_id"] = row[1].as<long>();
-            j["score"] = row[2].as<double>();
-            j["is_anomaly"] = row[3].as<bool>();
-            j["scored_at"] = row[4].as<std::string>();
-            j["timestamp"] = row[5].as<std::string>();
-            j["host_id"] = row[6].as<std::string>();
-            j["label"] = row[7].as<bool>();
-            out["items"].push_back(j);
-        }
+            + where + " ORDER BY s.reconstruction_error DESC, s.record_id DESC LIMIT $1 OFFSET $2";
+        page = PQXX_EXEC_PARAMS(N, query, limit, offset);
 
         // Include metadata in results response
-        auto model_run = GetModelRun(model_run_id);
-        if (!model_run.empty()) {
-            out["training_config"] = model_run.value("training_config", nlohmann::json::object());
-            out["hpo_config"] = model_run.value("hpo_config", nlohmann::json());
-            out["parent_run_id"] = model_run.value("parent_run_id", nlohmann::json());
-            out["trial_index"] = model_run.value("trial_index", nlohmann::json());
-            out["trial_params"] = model_run.value("trial_params", nlohmann::json());
-        }
+        model_run = GetModelRun(model_run_id);
 
         auto count_res = N.exec("SELECT COUNT(*) FROM dataset_scores s " + where);
-        out["total"] = count_res.empty() ? 0 : count_res[0][0].as<long>();
+        total = count_res.empty() ? 0 : count_res[0][0].as<long>();
 
         // Orphan detection: scores where record_id is missing from host_telemetry_archival
         std::string orphan_query = 
             "SELECT COUNT(*) FROM dataset_scores s "
             "LEFT JOIN host_telemetry_archival h ON s.record_id = h.record_id "
-            "WHERE s.dataset_id = " + N.quote(dataset_id) + " AND s.model_run_id = " + N.quote(model_run_id) +
-            " AND h.record_id IS NULL";
+            "WHERE " + ScoreSetFilter(score_set) + " AND h.record_id IS NULL";
         auto orphan_res = N.exec(orphan_query);
         long orphan_count = orphan_res.empty() ? 0 : orphan_res[0][0].as<long>();
         if (orphan_count > 0) {
@@ -1835,42 +2630,69 @@ auto DbClient::GetScores(const std::string& dataset_id,
         }
         
         // Fetch global min/max for the dataset+model (ignoring filters) to drive UI sliders
-        std::string range_query = "SELECT MIN(reconstruction_error), MAX(reconstruction_error) FROM dataset_scores WHERE dataset_id = " + N.quote(dataset_id) + " AND model_run_id = " + N.quote(model_run_id);
+        std::string range_query = "SELECT MIN(s.reconstruction_error), MAX(s.reconstruction_error) FROM dataset_scores s WHERE " + ScoreSetFilter(score_set);
         auto range_res = N.exec(range_query);
         if (!range_res.empty() && !range_res[0][0].is_null()) {
-             out["min_score"] = range_res[0][0].as<double>();
-             out["max_score"] = range_res[0][1].as<double>();
-        } else {
-             out["min_score"] = 0.0;
-             out["max_score"] = 10.0; // Default fallback
+            range.emplace(range_res[0][0].as<double>(), range_res[0][1].as<double>());
         }
-
-        out["limit"] = limit;
-        out["offset"] = offset;
-        long total = out["total"].get<long>();
-        int returned = static_cast<int>(out["items"].size());
-        out["returned"] = returned;
-        out["has_more"] = telemetry::api::HasMore(limit, offset, returned, total);
-
     } catch (const std::exception& e) {
         spdlog::error("Failed to get scores: {}", e.what());
+        throw;
     }
     auto end = std::chrono::steady_clock::now();
     double duration_ms = std::chrono::duration<double, std::milli>(end - start).count();
+    int returned = static_cast<int>(page.size());
     telemetry::obs::EmitHistogram("scores_query_duration_ms", duration_ms, "ms", "db",
                                   {{"dataset_id", dataset_id}, {"model_run_id", model_run_id}});
     nlohmann::json fields = {
         {"dataset_id", dataset_id},
         {"model_run_id", model_run_id},
         {"duration_ms", duration_ms},
-        {"rows", out["items"].size()}
+        {"rows", returned}
     };
     if (telemetry::obs::HasContext()) {
         const auto& ctx = telemetry::obs::GetContext();
         if (!ctx.request_id.empty()) { fields["request_id"] = ctx.request_id; }
     }
     telemetry::obs::LogEvent(telemetry::obs::LogLevel::Info, "db_query", "db", fields);
-    return out;
+
+    // Rows are written from the result one at a time; the page never
+    // exists as a JSON DOM or a whole body string.
+    return [page = std::move(page), scored_at = std::move(scored_at), model_run = std::move(model_run), total, range,
+            limit, offset, returned](telemetry::api::JsonStreamWriter& out) {
+        out.Key("items").BeginArray();
+        for (const auto& row : page) {
+            out.BeginObject()
+                .Key("record_id").Int(row[0].as<long>())
+                .Key("score").Double(row[1].as<double>())
+                .Key("is_anomaly").Bool(row[2].as<bool>())
+                .Key("scored_at").String(scored_at)
+                .Key("timestamp").String(row[3].c_str())
+                .Key("host_id").String(row[4].c_str())
+                .Key("label").Bool(row[5].as<bool>())
+                .EndObject();
+        }
+        out.EndArray();
+        if (!model_run.empty()) {
+            out.Key("training_config").Value(model_run.value("training_config", nlohmann::json::object()));
+            out.Key("hpo_config").Value(model_run.value("hpo_config", nlohmann::json()));
+            out.Key("parent_run_id").Value(model_run.value("parent_run_id", nlohmann::json()));
+            out.Key("trial_index").Value(model_run.value("trial_index", nlohmann::json()));
+            out.Key("trial_params").Value(model_run.value("trial_params", nlohmann::json()));
+        }
+        out.Key("total").Int(total);
+        if (range.has_value()) {
+            out.Key("min_score").Double(range->first);
+            out.Key("max_score").Double(range->second);
+        } else {
+            out.Key("min_score").Double(0.0);
+            out.Key("max_score").Double(10.0); // Default fallback
+        }
+        out.Key("limit").Int(limit);
+        out.Key("offset").Int(offset);
+        out.Key("returned").Int(returned);
+        out.Key("has_more").Bool(telemetry::api::HasMore(limit, offset, returned, total));
+    };
 }
 
 // NOLINTBEGIN(bugprone-easily-swappable-parameters)
@@ -1880,62 +2702,44 @@ auto DbClient::GetEvalMetrics(const std::string& dataset_id,
                                   int max_samples) -> nlohmann::json {
     nlohmann::json out;
     try {
-        auto C_ptr = manager_->GetConnection(); pqxx::connection& C = *C_ptr;
+        auto C_ptr = AnalyticsConnection(); pqxx::connection& C = *C_ptr;
         pqxx::nontransaction N(C);
-        auto res = PQXX_EXEC_PREPPED(N, "get_eval_metrics",
-             dataset_id, model_run_id);
-        struct EvalRow { double err; bool pred; bool label; };
-        std::vector<EvalRow> samples;
-        samples.reserve(static_cast<size_t>(res.size()));
-        for (const auto& row : res) {
-            samples.push_back({row[0].as<double>(), row[1].as<bool>(), row[2].as<bool>()});
-            if (max_samples > 0 && static_cast<int>(samples.size()) >= max_samples) { break; }
-        }
-
-        long tp = 0, fp = 0, tn = 0, fn = 0;
-        for (const auto& s : samples) {
-            if (s.pred && s.label) { tp++; }
-            else if (s.pred && !s.label) { fp++; }
-            else if (!s.pred && !s.label) { tn++; }
-            else { fn++; }
-        }
-        out["confusion"] = {{"tp", tp}, {"fp", fp}, {"tn", tn}, {"fn", fn}};
-
-        std::sort(samples.begin(), samples.end(),
-                  [](const auto& a, const auto& b) { return a.err > b.err; });
-        int n_points = points > 0 ? points : 50;
-        n_points = std::min(n_points, 200);
-        n_points = std::max(n_points, 10);
-
-        long positives = 0;
-        long negatives = 0;
-        for (const auto& s : samples) {
-            if (s.label) { positives++; }
-            else { negatives++; }
-        }
-
-        nlohmann::json roc = nlohmann::json::array();
-        nlohmann::json pr = nlohmann::json::array();
-        if (!samples.empty()) {
-            for (int i = 0; i < n_points; ++i) {
-                auto idx = static_cast<size_t>((static_cast<double>(i) / (n_points - 1)) * static_cast<double>(samples.size() - 1));
-                double threshold = samples[idx].err;
-                long ttp = 0, tfp = 0;
-                for (const auto& s : samples) {
-                    bool pred = s.err >= threshold;
-                    if (pred && s.label) { ttp++; }
-                    else if (pred && !s.label) { tfp++; }
-                }
-                double tpr = positives > 0 ? static_cast<double>(ttp) / static_cast<double>(positives) : 0.0;
-                double fpr = negatives > 0 ? static_cast<double>(tfp) / static_cast<double>(negatives) : 0.0;
-                double precision = (ttp + tfp) > 0 ? static_cast<double>(ttp) / static_cast<double>(ttp + tfp) : 0.0;
-                double recall = tpr;
-                roc.push_back({{"fpr", fpr}, {"tpr", tpr}, {"threshold", threshold}});
-                pr.push_back({{"precision", precision}, {"recall", recall}, {"threshold", threshold}});
+        if (auto aggregates = LoadEvalAggregates(N, dataset_id, model_run_id)) {
+            // Saved by the score job over every row, so max_samples (which
+            // only bounded the scan) does not apply.
+            out = aggregates->Eval(points);
+            out["source"] = "aggregates";
+            out["samples"] = aggregates->Samples();
+        } else {
+            // Postgres sorts (and caps at max_samples); the client only keeps
+            // running counts, so memory stays O(points) however many rows stream.
+            std::string limit = max_samples > 0 ? std::to_string(max_samples) : "ALL";
+            std::string query =
+                "SELECT err, pred, label, COUNT(*) OVER () FROM ("
+                "SELECT s.reconstruction_error AS err, s.predicted_is_anomaly AS pred, h.is_anomaly AS label "
+                "FROM dataset_scores s JOIN host_telemetry_archival h ON s.record_id = h.record_id "
+                "WHERE " + ScoreSetFilter(FindScoreSet(N, dataset_id, model_run_id)) +
+                " LIMIT " + limit + ") t ORDER BY err DESC";
+#if defined(PQXX_VERSION_MAJOR) && (PQXX_VERSION_MAJOR >= 7)
+            auto stream = pqxx::stream_from::query(N, query);
+#else
+            pqxx::stream_from stream(N, pqxx::from_query, query);
+#endif
+            std::optional<telemetry::api::EvalCurveBuilder> curve;
+            std::tuple<double, bool, bool, long> row;
+            long samples = 0;
+            while (stream >> row) {
+                const auto& [err, pred, label, total] = row;
+                if (!curve) { curve.emplace(total, points); }
+                curve->Add(err, pred, label);
+                samples++;
             }
+            stream.complete();
+            if (!curve) { curve.emplace(0, points); }
+            out = curve->Finish();
+            out["source"] = "scores";
+            out["samples"] = samples;
         }
-        out["roc"] = roc;
-        out["pr"] = pr;
 
         // Include metadata in results response
         auto model_run = GetModelRun(model_run_id);
@@ -1964,6 +2768,9 @@ auto DbClient::GetErrorDistribution(const std::string& dataset_id,
     try {
         auto C_ptr = manager_->GetConnection(); pqxx::connection& C = *C_ptr;
         pqxx::work W(C);
+        if (auto aggregates = LoadEvalAggregates(W, dataset_id, model_run_id)) {
+            if (auto dist = aggregates->ErrorDistribution(group_by)) { return *dist; }
+        }
         const std::string& col = group_by;
         std::string query =
             "SELECT " + col + ", "
@@ -1971,7 +2778,7 @@ auto DbClient::GetErrorDistribution(const std::string& dataset_id,
             "PERCENTILE_CONT(0.5) WITHIN GROUP (ORDER BY s.reconstruction_error), "
             "PERCENTILE_CONT(0.95) WITHIN GROUP (ORDER BY s.reconstruction_error) "
             "FROM dataset_scores s JOIN host_telemetry_archival h ON s.record_id = h.record_id "
-            "WHERE s.dataset_id = " + W.quote(dataset_id) + " AND s.model_run_id = " + W.quote(model_run_id) +
+            "WHERE " + ScoreSetFilter(FindScoreSet(W, dataset_id, model_run_id)) +
             " GROUP BY " + col + " ORDER BY COUNT(*) DESC";
         auto res = W.exec(query);
         for (const auto& row : res) {
@@ -1997,14 +2804,39 @@ auto DbClient::DeleteDatasetWithScores(const std::string& dataset_id) -> void {
         auto C_ptr = manager_->GetConnection(); pqxx::connection& C = *C_ptr;
         pqxx::work W(C);
 
-        // 1. Delete scores
-        PQXX_EXEC_PREPPED(W, "delete_dataset_scores", dataset_id);
+        // 1. Delete scores: one partition drop per score set
+        DropScoreSets(W, PQXX_EXEC_PREPPED(W, "lock_dataset_score_sets", dataset_id));
+        PQXX_EXEC_PREPPED(W, "delete_dataset_eval_aggregates", dataset_id);
         
         // 2. Delete score jobs
         PQXX_EXEC_PREPPED(W, "delete_dataset_score_jobs", dataset_id);
         
-        // 3. Delete telemetry (archival)
-        PQXX_EXEC_PREPPED(W, "delete_host_telemetry", dataset_id);
+        // 3. Delete telemetry (archival), its rollups and stats catalog.
+        // Leaf partitions holding only this dataset are truncated outright;
+        // with run_id hash sub-partitions that is the common case. Shared
+        // leaves fall back to a row delete confined to that leaf. The leaf
+        // is locked before the shared check: TRUNCATE is not MVCC-safe, so
+        // another run's in-flight COPY must finish (and be seen) first, and
+        // none may commit between the check and the TRUNCATE.
+        std::string quoted_id = W.quote(dataset_id);
+        auto leaves = W.exec("SELECT relid::regclass::text FROM pg_partition_tree('host_telemetry_archival') WHERE isleaf");
+        for (const auto& leaf_row : leaves) {
+            auto leaf = leaf_row[0].as<std::string>();
+            auto mine = W.exec("SELECT EXISTS (SELECT 1 FROM " + leaf + " WHERE run_id = " + quoted_id + ")");
+            if (!mine[0][0].as<bool>()) { continue; }
+            W.exec("LOCK TABLE " + leaf + " IN ACCESS EXCLUSIVE MODE");
+            auto shared = W.exec("SELECT EXISTS (SELECT 1 FROM " + leaf + " WHERE run_id < " + quoted_id +
+                                 " OR run_id > " + quoted_id + ")");
+            if (shared[0][0].as<bool>()) {
+                W.exec("DELETE FROM " + leaf + " WHERE run_id = " + quoted_id);
+            } else {
+                W.exec("TRUNCATE " + leaf);
+            }
+        }
+        PQXX_EXEC_PREPPED(W, "delete_telemetry_rollups", dataset_id);
+        PQXX_EXEC_PREPPED(W, "delete_dataset_stats", dataset_id);
+        PQXX_EXEC_PREPPED(W, "delete_dataset_metric_stats", dataset_id);
+        PQXX_EXEC_PREPPED(W, "delete_dataset_anomaly_type_counts", dataset_id);
         
         // 4. Delete alerts
         PQXX_EXEC_PREPPED(W, "delete_alerts", dataset_id);
@@ -2034,90 +2866,111 @@ auto DbClient::SearchDatasetRecords(const std::string& run_id,
                                         const std::string& region,
                                         const std::string& sort_by,
                                         const std::string& sort_order,
-                                        const std::string& anchor_time) -> nlohmann::json { // NOLINT(bugprone-easily-swappable-parameters)
-    nlohmann::json out = nlohmann::json::object();
-    out["items"] = nlohmann::json::array();
+                                        const std::string& anchor_time,
+                                        const std::string& cursor,
+                                        bool exact_count) -> nlohmann::json { // NOLINT(bugprone-easily-swappable-parameters)
+    return telemetry::api::CollectJsonObject(QueryDatasetRecords(run_id, limit, offset, start_time, end_time, is_anomaly,
+                                                                 anomaly_type, host_id, region, sort_by, sort_order,
+                                                                 anchor_time, cursor, exact_count));
+}
+
+auto DbClient::QueryDatasetRecords(const std::string& run_id,
+                                   int limit,
+                                   int offset,
+                                   const std::string& start_time,
+                                   const std::string& end_time,
+                                   const std::string& is_anomaly,
+                                   const std::string& anomaly_type,
+                                   const std::string& host_id,
+                                   const std::string& region,
+                                   const std::string& sort_by,
+                                   const std::string& sort_order,
+                                   const std::string& anchor_time,
+                                   const std::string& cursor,
+                                   bool exact_count) -> telemetry::api::JsonFieldsWriter { // NOLINT(bugprone-easily-swappable-parameters)
     try {
-        auto C_ptr = manager_->GetConnection(); pqxx::connection& C = *C_ptr;
+        auto C_ptr = AnalyticsConnection(); pqxx::connection& C = *C_ptr;
         pqxx::nontransaction N(C);
         
-        std::string sort_column = "metric_timestamp";
-        if (!sort_by.empty() && sort_by != "metric_timestamp") {
-            throw std::invalid_argument("Invalid sort_by: " + sort_by);
-        }
-        std::string sort_dir = "desc";
-        if (!sort_order.empty()) {
-            std::string lower = sort_order;
-            std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
-            if (lower != "asc" && lower != "desc") {
-                throw std::invalid_argument("Invalid sort_order: " + sort_order);
+        auto sort = telemetry::db::ResolveSearchSort(sort_by, sort_order, cursor, offset);
+        const std::string& sort_column = sort.column;
+        const std::string& sort_dir = sort.dir;
+        const auto& after = sort.after;
+
+        auto queries = telemetry::db::BuildSearchQueries(run_id, limit, offset, start_time, end_time, is_anomaly,
+                                                         anomaly_type, host_id, region, anchor_time, sort);
+
+        // One row past the page tells us whether another page exists.
+        auto page = ExecShaped(N, queries.page);
+        bool has_more = static_cast<int>(page.size()) > limit;
+        int returned = std::min(static_cast<int>(page.size()), limit);
+        std::optional<std::string> next_cursor;
+        if (has_more && returned > 0) {
+            const auto& row = page[returned - 1];
+            next_cursor = telemetry::api::EncodeSearchCursor({row[13].as<int64_t>(), row[0].as<long>(), sort_dir});
+        }
+
+        // Totals: COUNT(*) only on request. Otherwise the stats catalog
+        // answers unfiltered and is_anomaly-only searches exactly, and the
+        // planner's row estimate covers the rest.
+        std::optional<long> total;
+        std::string count_source = "exact";
+        if (exact_count) {
+            auto count_res = ExecShaped(N, queries.exact_count);
+            total = count_res.empty() ? 0 : count_res[0][0].as<long>();
+        } else if (queries.catalog_shape) {
+            auto catalog = PQXX_EXEC_PREPPED(N, "get_dataset_catalog", run_id);
+            if (!catalog.empty()) {
+                total = telemetry::db::CatalogSearchTotal(catalog[0][0].as<long>(), catalog[0][1].as<long>(), is_anomaly);
+                count_source = "catalog";
             }
-            sort_dir = lower;
         }
-
-        std::string where = "WHERE run_id = " + N.quote(run_id);
-        if (!start_time.empty()) { where += " AND metric_timestamp >= " + N.quote(start_time); }
-        if (!end_time.empty()) { where += " AND metric_timestamp <= " + N.quote(end_time); }
-        if (!anchor_time.empty()) {
-            if (sort_dir == "asc") {
-                where += " AND metric_timestamp >= " + N.quote(anchor_time);
+        if (!total.has_value()) {
+            auto plan = ExecShaped(N, queries.estimate);
+            total = plan.empty() ? 0 : telemetry::db::PlanRowsEstimate(plan[0][0].c_str());
+            count_source = "estimate";
+        }
+
+        // Rows are written from the result one at a time.
+        return [page = std::move(page), returned, has_more, next_cursor = std::move(next_cursor), total = *total,
+                count_source, limit, offset = after.has_value() ? 0 : offset, sort_column, sort_dir,
+                anchor_time](telemetry::api::JsonStreamWriter& out) {
+            out.Key("items").BeginArray();
+            for (int i = 0; i < returned; ++i) { telemetry::db::WriteSearchRow(out, page[i]); }
+            out.EndArray();
+            out.Key("total").Int(total);
+            out.Key("total_is_estimate").Bool(count_source == "estimate");
+            out.Key("count_source").String(count_source);
+            out.Key("limit").Int(limit);
+            out.Key("offset").Int(offset);
+            out.Key("returned").Int(returned);
+            out.Key("has_more").Bool(has_more);
+            out.Key("next_cursor");
+            if (next_cursor.has_value()) {
+                out.String(*next_cursor);
             } else {
-                where += " AND metric_timestamp <= " + N.quote(anchor_time);
+                out.Null();
             }
-        }
-        if (!is_anomaly.empty()) { where += " AND is_anomaly = " + N.quote(is_anomaly == "true"); }
-        if (!anomaly_type.empty()) { where += " AND anomaly_type = " + N.quote(anomaly_type); }
-        if (!host_id.empty()) { where += " AND host_id = " + N.quote(host_id); }
-        if (!region.empty()) { where += " AND region = " + N.quote(region); }
-
-        std::string query =
-            "SELECT record_id, host_id, metric_timestamp, cpu_usage, memory_usage, disk_utilization, "
-            "network_rx_rate, network_tx_rate, is_anomaly, anomaly_type, region, project_id, labels "
-            "FROM host_telemetry_archival " + where + " ORDER BY " + sort_column + " " + sort_dir + " LIMIT $1 OFFSET $2";
-            
-        auto res = PQXX_EXEC_PARAMS(N, query, limit, offset);
-        for (const auto& row : res) {
-            nlohmann::json j;
-            j["record_id"] = row[0].as<long>();
-            j["host_id"] = row[1].as<std::string>();
-            j["timestamp"] = row[2].as<std::string>();
-            j["cpu_usage"] = row[3].as<double>();
-            j["memory_usage"] = row[4].as<double>();
-            j["disk_utilization"] = row[5].as<double>();
-            j["network_rx_rate"] = row[6].as<double>();
-            j["network_tx_rate"] = row[7].as<double>();
-            j["is_anomaly"] = row[8].as<bool>();
-            j["anomaly_type"] = row[9].is_null() ? "" : row[9].as<std::string>();
-            j["region"] = row[10].as<std::string>();
-            j["project_id"] = row[11].as<std::string>();
-            j["labels"] = row[12].is_null() ? nlohmann::json::object() : nlohmann::json::parse(row[12].c_str());
-            out["items"].push_back(j);
-        }
-        
-        auto count_res = N.exec("SELECT COUNT(*) FROM host_telemetry_archival " + where);
-        long total = count_res.empty() ? 0 : count_res[0][0].as<long>();
-        int returned = static_cast<int>(out["items"].size());
-        out["total"] = total;
-        out["limit"] = limit;
-        out["offset"] = offset;
-        out["returned"] = returned;
-        out["has_more"] = telemetry::api::HasMore(limit, offset, returned, total);
-        out["sort_by"] = sort_column;
-        out["sort_order"] = sort_dir;
-        if (!anchor_time.empty()) {
-            out["anchor_time"] = anchor_time;
-        }
-
+            out.Key("sort_by").String(sort_column);
+            out.Key("sort_order").String(sort_dir);
+            if (!anchor_time.empty()) {
+                out.Key("anchor_time").String(anchor_time);
+            }
+        };
     } catch (const std::exception& e) {
         spdlog::error("Failed to search dataset records: {}", e.what());
         throw;
     }
-    return out;
 }
 
 auto DbClient::TryTransitionModelRunStatus(const std::string& model_run_id,
                                            const std::string& expected_current,
                                            const std::string& next_status) -> bool { // NOLINT(bugprone-easily-swappable-parameters)
+    if (control_writes_) {
+        auto result = WriteControl({"transition_model_run_status", {next_status, model_run_id, expected_current}});
+        if (!result.ok) { spdlog::error("Failed to transition model run status: {}", result.error); }
+        return result.ok && result.affected_rows > 0;
+    }
     try {
         auto C_ptr = manager_->GetConnection(); pqxx::connection& C = *C_ptr;
         pqxx::work W(C);
@@ -2134,6 +2987,11 @@ auto DbClient::TryTransitionModelRunStatus(const std::string& model_run_id,
 auto DbClient::TryTransitionScoreJobStatus(const std::string& job_id,
                                            const std::string& expected_current,
                                            const std::string& next_status) -> bool { // NOLINT(bugprone-easily-swappable-parameters)
+    if (control_writes_) {
+        auto result = WriteControl({"transition_score_job_status", {next_status, job_id, expected_current}});
+        if (!result.ok) { spdlog::error("Failed to transition score job status: {}", result.error); }
+        return result.ok && result.affected_rows > 0;
+    }
     try {
         auto C_ptr = manager_->GetConnection(); pqxx::connection& C = *C_ptr;
         pqxx::work W(C);
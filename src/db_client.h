@@ -1,11 +1,22 @@
 #pragma once
 #include "idb_client.h"
 #include "db_connection_manager.h"
+#include "rollup.h"
+#include "dataset_stats.h"
+#include "eval_aggregates.h"
+#include "partition_manager.h"
+#include "control_write_channel.h"
 #include <pqxx/pqxx>
 #include <optional>
 #include <string>
 #include <vector>
 
+/**
+ * @brief Postgres-backed IDbClient. Every method checks connections out of
+ * the primary except the analytics reads tagged below, which ask for a
+ * DbAccess::Read connection that a ReadReplicaDbConnectionManager may
+ * serve from a replica.
+ */
 class DbClient : public IDbClient {
 public:
     DbClient(const std::string& connection_string);
@@ -24,8 +35,12 @@ public:
     // Validates that an aggregation function is allowed.
     static auto IsValidAggregation(const std::string& agg) -> bool;
 
-    // Prepares named statements for a connection.
-    static auto PrepareStatements(pqxx::connection& C) -> void;
+    // Registers the named statement catalog once per process. Statements
+    // are prepared per connection on first use (see StatementRegistry).
+    static auto RegisterStatements() -> void;
+
+    // Connection initializer: starts lazy-prepare tracking for C.
+    static auto AttachConnection(pqxx::connection& C) -> void;
 
     // Marks any 'RUNNING' or 'PENDING' jobs as 'FAILED' if they are stale.
     auto ReconcileStaleJobs(std::optional<std::chrono::seconds> stale_ttl = std::nullopt) -> void override;
@@ -34,12 +49,17 @@ public:
         return manager_;
     }
 
-    // Runs the retention cleanup procedure.
+    // Drops month partitions entirely older than retention_days (and their
+    // scores); rows in the DEFAULT partition are deleted individually.
     auto RunRetentionCleanup(int retention_days) -> void;
 
-    // Ensures a partition exists for the given timestamp.
+    // Ensures the month partition for the given timestamp exists, split by
+    // HASH(run_id) when the policy asks for it.
     auto EnsurePartition(std::chrono::system_clock::time_point tp) -> void override;
 
+    // Pre-creates the current and upcoming months, then applies retention.
+    auto MaintainPartitions() -> void;
+
     auto DeleteDatasetWithScores(const std::string& dataset_id) -> void;
 
     auto CreateRun(const std::string& run_id, 
@@ -57,6 +77,8 @@ public:
     auto Heartbeat(JobType type, const std::string& job_id) -> void override;
     
     auto GetRunStatus(const std::string& run_id) -> telemetry::RunStatus override;
+    auto GetAnalyticsRunStatus(const std::string& run_id) -> telemetry::RunStatus override;
+    auto PinAnalyticsReads() -> std::shared_ptr<void> override;
 
     auto CreateModelRun(const std::string& dataset_id, 
                                const std::string& name,
@@ -102,6 +124,11 @@ public:
                                           int anomaly_count, 
                                           const nlohmann::json& details = {},
                                           double latency_ms = 0.0) -> void override;
+    auto UpdateInferenceRunStatusRaw(const std::string& inference_id,
+                                     const std::string& status,
+                                     int anomaly_count,
+                                     const std::string& details_json,
+                                     double latency_ms) -> void override;
 
     auto UpdateTrialEligibility(const std::string& model_run_id,
                                 bool is_eligible,
@@ -121,6 +148,7 @@ public:
                                       const std::string& created_to = "") -> nlohmann::json override;
     auto GetDatasetDetail(const std::string& run_id) -> nlohmann::json override;
     auto GetDatasetSamples(const std::string& run_id, int limit) -> nlohmann::json override;
+    // Read-tagged: may be served by a read replica (see AnalyticsRead in db_client.cpp).
     auto SearchDatasetRecords(const std::string& run_id,
                                         int limit,
                                         int offset,
@@ -132,7 +160,25 @@ public:
                                         const std::string& region,
                                         const std::string& sort_by,
                                         const std::string& sort_order,
-                                        const std::string& anchor_time) -> nlohmann::json override;
+                                        const std::string& anchor_time,
+                                        const std::string& cursor = "",
+                                        bool exact_count = false) -> nlohmann::json override;
+    // Read-tagged, as SearchDatasetRecords; the writer emits rows straight
+    // from the fetched result.
+    auto QueryDatasetRecords(const std::string& run_id,
+                             int limit,
+                             int offset,
+                             const std::string& start_time,
+                             const std::string& end_time,
+                             const std::string& is_anomaly,
+                             const std::string& anomaly_type,
+                             const std::string& host_id,
+                             const std::string& region,
+                             const std::string& sort_by,
+                             const std::string& sort_order,
+                             const std::string& anchor_time,
+                             const std::string& cursor = "",
+                             bool exact_count = false) -> telemetry::api::JsonFieldsWriter override;
     auto GetDatasetRecord(const std::string& run_id, long record_id) -> nlohmann::json override;
     auto ListModelRuns(int limit,
                                  int offset,
@@ -153,6 +199,8 @@ public:
     auto GetScoredDatasetsForModel(const std::string& model_run_id) -> nlohmann::json override;
 
     auto GetDatasetSummary(const std::string& run_id, int topk) -> nlohmann::json override;
+    // Read-tagged, like GetTimeSeries and GetHistogram: may be served by a
+    // read replica (see AnalyticsRead in db_client.cpp).
     auto GetTopK(const std::string& run_id,
                            const std::string& column,
                            int k,
@@ -170,7 +218,8 @@ public:
                                  const std::string& is_anomaly,
                                  const std::string& anomaly_type,
                                  const std::string& start_time,
-                                 const std::string& end_time) -> nlohmann::json override;
+                                 const std::string& end_time,
+                                 const std::string& percentile_mode = "exact") -> nlohmann::json override;
     auto GetHistogram(const std::string& run_id,
                                 const std::string& metric,
                                 int bins,
@@ -199,6 +248,8 @@ public:
                                      const std::string& next_status) -> bool override;
 
     auto GetScoreJob(const std::string& job_id) -> nlohmann::json override;
+    auto GetAnalyticsLatestScoreJob(const std::string& dataset_id, const std::string& model_run_id)
+        -> nlohmann::json override;
     auto ListScoreJobs(int limit,
                                  int offset,
                                  const std::string& status = "",
@@ -210,9 +261,20 @@ public:
     auto FetchScoringRowsAfterRecord(const std::string& dataset_id,
                                                         long last_record_id,
                                                         int limit) -> std::vector<IDbClient::ScoringRow> override;
+    auto LoadColumnarDataset(const std::string& run_id) -> std::shared_ptr<telemetry::api::ColumnarDataset> override;
     auto InsertDatasetScores(const std::string& dataset_id,
                              const std::string& model_run_id,
                              const std::vector<std::pair<long, std::pair<double, bool>>>& scores) -> void override;
+    auto ResetDatasetScores(const std::string& dataset_id,
+                            const std::string& model_run_id) -> void override;
+    auto TruncateDatasetScores(const std::string& dataset_id,
+                               const std::string& model_run_id,
+                               long last_record_id) -> void override;
+    auto SaveEvalAggregates(const std::string& dataset_id,
+                            const std::string& model_run_id,
+                            const nlohmann::json& aggregates) -> void override;
+    auto DeleteEvalAggregates(const std::string& dataset_id,
+                              const std::string& model_run_id) -> void override;
 
     auto GetDatasetRecordCount(const std::string& dataset_id) -> long override;
 
@@ -223,7 +285,15 @@ public:
                              bool only_anomalies,
                              double min_score,
                              double max_score) -> nlohmann::json override;
+    auto QueryScores(const std::string& dataset_id,
+                     const std::string& model_run_id,
+                     int limit,
+                     int offset,
+                     bool only_anomalies,
+                     double min_score,
+                     double max_score) -> telemetry::api::JsonFieldsWriter override;
 
+    // Read-tagged: may be served by a read replica (see AnalyticsRead in db_client.cpp).
     auto GetEvalMetrics(const std::string& dataset_id,
                                   const std::string& model_run_id,
                                   int points,
@@ -233,5 +303,43 @@ public:
                                         const std::string& group_by) -> nlohmann::json override;
 
 private:
+    // Connection for a read-tagged analytics read; honours PinAnalyticsReads().
+    auto AnalyticsConnection() -> DbConnectionPtr;
+    // Merges a batch's rollup cells into telemetry_rollups inside W.
+    static auto UpsertRollups(pqxx::work& W, const telemetry::rollup::BatchAccumulator& rollups) -> void;
+    // Folds a batch's moments, bounds and type counts into the dataset stats catalog.
+    static auto UpsertDatasetStats(pqxx::work& W, const telemetry::stats::DatasetStatsAccumulator& catalog) -> void;
+    // Per-metric catalog moments; empty when the run has no catalog.
+    static auto CatalogMetricMoments(pqxx::work& W, const std::string& run_id)
+        -> std::map<std::string, telemetry::stats::Moments>;
+    // Aggregates saved by the last completed score job; nullopt when none.
+    static auto LoadEvalAggregates(pqxx::transaction_base& T,
+                                   const std::string& dataset_id,
+                                   const std::string& model_run_id) -> std::optional<telemetry::stats::EvalAggregates>;
+    auto GetTimeSeriesFromRollups(pqxx::work& W,
+                                  const std::string& run_id,
+                                  const std::vector<std::string>& metrics,
+                                  const std::vector<std::string>& aggs,
+                                  int bucket_seconds,
+                                  int resolution,
+                                  const std::string& region,
+                                  const std::string& is_anomaly,
+                                  const std::string& start_time,
+                                  const std::string& end_time) -> nlohmann::json;
+
+    auto EnsureMonthPartition(const telemetry::partitions::MonthPartition& month) -> void;
+    // Upserts the pair's score set (bumping scored_at) and creates its
+    // dataset_scores partition the first time; returns score_set_id.
+    auto EnsureScoreSet(pqxx::connection& C,
+                        const std::string& dataset_id,
+                        const std::string& model_run_id) -> long;
+
+    // Runs write through the shared control channel and waits for it.
+    auto WriteControl(telemetry::db::ControlWrite write) -> telemetry::db::ControlWriteResult;
+
     std::shared_ptr<DbConnectionManager> manager_;
+    // Batches heartbeats and status/transition writes from every DbClient on
+    // manager_; null when CONTROL_WRITE_PIPELINE=0.
+    std::shared_ptr<telemetry::db::ControlWriteChannel> control_writes_;
+    telemetry::partitions::PartitionPolicy partition_policy_ = telemetry::partitions::PartitionPolicy::FromEnv();
 };
\ No newline at end of file
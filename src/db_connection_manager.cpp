@@ -1,40 +1,194 @@
 #include "db_connection_manager.h"
 #include <spdlog/spdlog.h>
+#include <cmath>
+#include <cstdlib>
+#include <map>
+#include <algorithm>
+#include <vector>
 #include "obs/metrics.h"
 
+namespace {
+
+// Closed connections take their prepared statements with them.
+auto ForgetStatements(const pqxx::connection* conn) -> void {
+    telemetry::db::StatementRegistry::Instance().Forget(conn);
+}
+
+auto Ping(pqxx::connection& conn) -> bool {
+    try {
+        pqxx::nontransaction N(conn);
+        N.exec("SELECT 1");
+        return true;
+    } catch (const std::exception& e) {
+        spdlog::warn("DB pool health check failed: {}", e.what());
+        return false;
+    }
+}
+
+auto EnvMillis(const char* name, std::chrono::milliseconds& out) -> void {
+    if (const char* value = std::getenv(name)) {
+        try { out = std::chrono::milliseconds(std::stol(value)); } catch (...) {}
+    }
+}
+
+auto EnvSize(const char* name, size_t& out) -> void {
+    if (const char* value = std::getenv(name)) {
+        try { out = std::stoul(value); } catch (...) {}
+    }
+}
+
+} // namespace
+
+auto DbLaneName(DbLane lane) -> const char* {
+    switch (lane) {
+        case DbLane::Interactive: return "interactive";
+        case DbLane::Maintenance: return "maintenance";
+        case DbLane::Batch: return "batch";
+    }
+    return "unknown";
+}
+
+auto DbPoolElasticArgs::FromEnv(DbPoolElasticArgs defaults) -> DbPoolElasticArgs {
+    DbPoolElasticArgs args = defaults;
+    EnvSize("DB_POOL_MIN_IDLE", args.min_idle);
+    EnvMillis("DB_POOL_IDLE_TIMEOUT_MS", args.idle_timeout);
+    EnvMillis("DB_POOL_HEALTH_CHECK_MS", args.health_check_interval);
+    EnvMillis("DB_POOL_MAX_LIFETIME_MS", args.max_lifetime);
+    return args;
+}
+
+auto DbPoolLaneArgs::FromEnv(DbPoolLaneArgs defaults) -> DbPoolLaneArgs {
+    DbPoolLaneArgs args = defaults;
+    EnvSize("DB_POOL_INTERACTIVE_RESERVED", args.interactive_reserved);
+    EnvSize("DB_POOL_MAINTENANCE_MAX", args.maintenance_max);
+    EnvSize("DB_POOL_BATCH_MAX", args.batch_max);
+    EnvMillis("DB_POOL_BATCH_TIMEOUT_MS", args.batch_timeout);
+    return args;
+}
+
 // NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
-PooledDbConnectionManager::PooledDbConnectionManager(std::string conn_str, 
-                                                     size_t pool_size, 
+PooledDbConnectionManager::PooledDbConnectionManager(std::string conn_str,
+                                                     size_t pool_size,
                                                      std::chrono::milliseconds acquire_timeout,
-                                                     ConnectionInitializer initializer)
-    : conn_str_(std::move(conn_str)), 
-      pool_size_(pool_size), 
+                                                     ConnectionInitializer initializer,
+                                                     ElasticArgs elastic,
+                                                     LaneArgs lanes)
+    : conn_str_(std::move(conn_str)),
+      pool_size_(pool_size),
       acquire_timeout_(acquire_timeout),
-      initializer_(std::move(initializer)) {    
-    spdlog::info("Initializing DB connection pool with size {}", pool_size_);
+      initializer_(std::move(initializer)),
+      elastic_(elastic),
+      lane_args_(lanes) {
+    spdlog::info("Initializing DB connection pool with size {} (min_idle={}, idle_timeout={}ms, "
+                 "interactive_reserved={}, maintenance_max={}, batch_max={})",
+                 pool_size_, elastic_.min_idle, elastic_.idle_timeout.count(),
+                 lane_args_.interactive_reserved, lane_args_.maintenance_max, lane_args_.batch_max);
+    for (auto& lane : lanes_) { lane.waits_ms.reserve(kWaitSamples); }
+    if (elastic_.min_idle > 0 || elastic_.idle_timeout.count() > 0 ||
+        elastic_.health_check_interval.count() > 0 || elastic_.max_lifetime.count() > 0) {
+        maintenance_thread_ = std::thread([this]() {
+            std::unique_lock<std::mutex> lock(mutex_);
+            while (!shutdown_) {
+                lock.unlock();
+                RunMaintenance();
+                lock.lock();
+                maintenance_cv_.wait_for(lock, elastic_.maintenance_interval, [this]() { return shutdown_; });
+            }
+        });
+    }
 }
 
 PooledDbConnectionManager::~PooledDbConnectionManager() {
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        shutdown_ = true;
+    }
+    maintenance_cv_.notify_all();
+    cv_.notify_all();
+    if (maintenance_thread_.joinable()) {
+        maintenance_thread_.join();
+    }
     std::unique_lock<std::mutex> lock(mutex_);
-    shutdown_ = true;
-    while (!pool_.empty()) {
-        pool_.pop();
+    for (const auto& idle : pool_) { ForgetStatements(idle.conn.get()); }
+    pool_.clear();
+}
+
+auto PooledDbConnectionManager::OpenConnection() -> std::unique_ptr<pqxx::connection> {
+    auto conn = std::make_unique<pqxx::connection>(conn_str_);
+    if (initializer_) {
+        initializer_(*conn);
     }
+    return conn;
+}
+
+auto PooledDbConnectionManager::LaneLimitLocked(DbLane lane) const -> size_t {
+    if (lane == DbLane::Interactive) { return pool_size_; }
+    // Always leave the shared lanes at least one slot.
+    size_t reserve = std::min(lane_args_.interactive_reserved, pool_size_ > 0 ? pool_size_ - 1 : 0);
+    size_t shared = pool_size_ - reserve;
+    size_t cap = lane == DbLane::Maintenance ? lane_args_.maintenance_max : lane_args_.batch_max;
+    return cap > 0 ? std::min(cap, shared) : shared;
+}
+
+auto PooledDbConnectionManager::LaneFitsLocked(DbLane lane) const -> bool {
+    if (pool_.empty() && OpenLocked() >= pool_size_) { return false; }
+    if (lane == DbLane::Interactive) { return true; }
+    if (lanes_[static_cast<size_t>(lane)].held >= LaneLimitLocked(lane)) { return false; }
+    size_t shared_held = lanes_[static_cast<size_t>(DbLane::Maintenance)].held +
+                         lanes_[static_cast<size_t>(DbLane::Batch)].held;
+    size_t reserve = std::min(lane_args_.interactive_reserved, pool_size_ > 0 ? pool_size_ - 1 : 0);
+    return shared_held < pool_size_ - reserve;
+}
+
+auto PooledDbConnectionManager::CanAdmitLocked(DbLane lane) const -> bool {
+    if (!LaneFitsLocked(lane)) { return false; }
+    // Yield to a higher-priority waiter that could take this slot.
+    for (size_t higher = 0; higher < static_cast<size_t>(lane); ++higher) {
+        if (lanes_[higher].waiting > 0 && LaneFitsLocked(static_cast<DbLane>(higher))) { return false; }
+    }
+    return true;
+}
+
+auto PooledDbConnectionManager::TimeoutFor(DbLane lane) const -> std::chrono::milliseconds {
+    std::chrono::milliseconds timeout{0};
+    if (lane == DbLane::Maintenance) { timeout = lane_args_.maintenance_timeout; }
+    if (lane == DbLane::Batch) { timeout = lane_args_.batch_timeout; }
+    return timeout.count() > 0 ? timeout : acquire_timeout_;
+}
+
+auto PooledDbConnectionManager::RecordWaitLocked(Lane& lane, double wait_ms) -> void {
+    if (lane.waits_ms.size() < kWaitSamples) {
+        lane.waits_ms.push_back(wait_ms);
+    } else {
+        lane.waits_ms[lane.next_wait] = wait_ms;
+    }
+    lane.next_wait = (lane.next_wait + 1) % kWaitSamples;
 }
 
 auto PooledDbConnectionManager::GetConnection() -> DbConnectionPtr {
+    return GetConnection(CurrentDbLane());
+}
+
+auto PooledDbConnectionManager::GetConnection(DbLane lane) -> DbConnectionPtr {
     std::unique_lock<std::mutex> lock(mutex_);
-    
-    auto start = std::chrono::steady_clock::now();
-    
-    // Wait for a connection to be available or for space to create a new one
-    if (!cv_.wait_for(lock, acquire_timeout_, [this]() {
-        return !pool_.empty() || in_use_count_ < pool_size_ || shutdown_;
-    })) {
+
+    auto start = Clock::now();
+    auto& state = lanes_[static_cast<size_t>(lane)];
+    const std::map<std::string, std::string> labels = {{"lane", DbLaneName(lane)}};
+
+    // Wait for a connection (or space to open one) this lane may take
+    state.waiting++;
+    bool admitted = cv_.wait_for(lock, TimeoutFor(lane), [this, lane]() {
+        return shutdown_ || CanAdmitLocked(lane);
+    });
+    state.waiting--;
+    if (!admitted) {
         total_timeouts_++;
-        telemetry::obs::EmitCounter("db_pool_timeouts_total", 1, "timeouts", "db_pool");
-        spdlog::error("Timeout acquiring DB connection after {}ms. Pool size: {}, In-use: {}", 
-                     acquire_timeout_.count(), pool_size_, in_use_count_);
+        state.timeouts++;
+        cv_.notify_all(); // lower lanes may have been yielding to this waiter
+        telemetry::obs::EmitCounter("db_pool_timeouts_total", 1, "timeouts", "db_pool", labels);
+        spdlog::error("Timeout acquiring {} DB connection after {}ms. Pool size: {}, In-use: {}, Lane in-use: {}",
+                     DbLaneName(lane), TimeoutFor(lane).count(), pool_size_, in_use_count_, state.held);
         throw std::runtime_error("DB connection acquisition timeout");
     }
 
@@ -42,71 +196,357 @@ auto PooledDbConnectionManager::GetConnection() -> DbConnectionPtr {
         throw std::runtime_error("DB Connection Manager is shutting down");
     }
 
+    state.held++;
     std::unique_ptr<pqxx::connection> conn;
+    Clock::time_point created_at;
     if (!pool_.empty()) {
-        conn = std::move(pool_.front());
-        pool_.pop();
+        // Most recently returned first, so surplus connections age out at the front.
+        conn = std::move(pool_.back().conn);
+        created_at = pool_.back().created_at;
+        pool_.pop_back();
     } else {
-        // Create new connection if pool is not full
+        // Create new connection if pool is not full. The slot is reserved
+        // so other acquirers can proceed while this one connects.
+        opening_count_++;
+        lock.unlock();
         try {
-            conn = std::make_unique<pqxx::connection>(conn_str_);
-            if (initializer_) {
-                initializer_(*conn);
-            }
+            conn = OpenConnection();
         } catch (const std::exception& e) {
             spdlog::error("Failed to create new DB connection: {}", e.what());
-            // If we fail here, we don't increment in_use_count_
-            cv_.notify_one(); // Wake up anyone waiting for space
+            lock.lock();
+            opening_count_--;
+            state.held--;
+            cv_.notify_all(); // Wake up anyone waiting for space
             throw;
         }
+        lock.lock();
+        opening_count_--;
+        total_created_++;
+        created_at = Clock::now();
+        telemetry::obs::EmitCounter("db_pool_connections_created", 1, "connections", "db_pool");
     }
 
     in_use_count_++;
     total_acquires_++;
-    
-    auto end = std::chrono::steady_clock::now();
+    state.acquires++;
+
+    auto end = Clock::now();
     auto wait_ms = std::chrono::duration<double, std::milli>(end - start).count();
     total_wait_ms_ += wait_ms;
-    
+    RecordWaitLocked(state, wait_ms);
+    if (std::any_of(lanes_.begin(), lanes_.end(), [](const Lane& l) { return l.waiting > 0; })) {
+        cv_.notify_all(); // waiters behind this one may now be admissible
+    }
+
     telemetry::obs::EmitGauge("db_pool_size", static_cast<double>(pool_size_), "connections", "db_pool");
     telemetry::obs::EmitGauge("db_pool_in_use", static_cast<double>(in_use_count_), "connections", "db_pool");
-    telemetry::obs::EmitHistogram("db_pool_wait_time_ms", wait_ms, "ms", "db_pool");
+    telemetry::obs::EmitHistogram("db_pool_wait_time_ms", wait_ms, "ms", "db_pool", labels);
 
     if (wait_ms > 100.0) {
-        spdlog::warn("DB connection acquisition took {}ms. Stats: Size={}, InUse={}, Available={}", 
-                     wait_ms, pool_size_, in_use_count_, pool_.size());
+        spdlog::warn("{} DB connection acquisition took {}ms. Stats: Size={}, InUse={}, Available={}",
+                     DbLaneName(lane), wait_ms, pool_size_, in_use_count_, pool_.size());
     }
 
     // Return with custom deleter that returns to pool
-    return {conn.release(), [this](pqxx::connection* c) {
-        this->ReleaseConnection(c);
+    return {conn.release(), [this, lane, created_at](pqxx::connection* c) {
+        this->ReleaseConnection(c, lane, created_at);
     }};
 }
 
-auto PooledDbConnectionManager::ReleaseConnection(pqxx::connection* conn) -> void {
+auto PooledDbConnectionManager::ReleaseConnection(pqxx::connection* conn, DbLane lane, Clock::time_point created_at) -> void {
     std::unique_lock<std::mutex> lock(mutex_);
     in_use_count_--;
+    lanes_[static_cast<size_t>(lane)].held--;
 
-    if (shutdown_ || !conn || !conn->is_open()) {
+    auto now = Clock::now();
+    bool expired = elastic_.max_lifetime.count() > 0 && now - created_at >= elastic_.max_lifetime;
+    if (shutdown_ || !conn || !conn->is_open() || expired) {
         if (conn && !conn->is_open()) {
             spdlog::warn("Dropping closed/broken DB connection");
+            total_broken_++;
+        } else if (conn && expired && !shutdown_) {
+            total_recycled_++;
         }
+        ForgetStatements(conn);
         delete conn;
+        cv_.notify_all(); // a slot opened up
         return;
     }
 
-    pool_.push(std::unique_ptr<pqxx::connection>(conn));
-    cv_.notify_one();
+    pool_.push_back({std::unique_ptr<pqxx::connection>(conn), now, created_at, now});
+    cv_.notify_all();
+}
+
+auto PooledDbConnectionManager::RunMaintenance() -> void {
+    std::vector<std::unique_ptr<pqxx::connection>> reaped;
+    size_t recycled = 0;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (shutdown_) { return; }
+        auto now = Clock::now();
+        if (elastic_.idle_timeout.count() > 0) {
+            while (pool_.size() > elastic_.min_idle && now - pool_.front().idle_since >= elastic_.idle_timeout) {
+                reaped.push_back(std::move(pool_.front().conn));
+                pool_.pop_front();
+            }
+            total_reaped_ += static_cast<long long>(reaped.size());
+        }
+        if (elastic_.max_lifetime.count() > 0) {
+            // Prewarm below replaces these, so min_idle does not hold them back.
+            for (auto it = pool_.begin(); it != pool_.end();) {
+                if (now - it->created_at >= elastic_.max_lifetime) {
+                    reaped.push_back(std::move(it->conn));
+                    it = pool_.erase(it);
+                    recycled++;
+                } else {
+                    ++it;
+                }
+            }
+            total_recycled_ += static_cast<long long>(recycled);
+        }
+    }
+    if (!reaped.empty()) {
+        spdlog::debug("Closing {} idle DB connections ({} past max lifetime)", reaped.size(), recycled);
+        if (reaped.size() > recycled) {
+            telemetry::obs::EmitCounter("db_pool_connections_reaped", static_cast<long>(reaped.size() - recycled), "connections", "db_pool");
+        }
+        if (recycled > 0) {
+            telemetry::obs::EmitCounter("db_pool_connections_recycled", static_cast<long>(recycled), "connections", "db_pool");
+        }
+        for (const auto& conn : reaped) { ForgetStatements(conn.get()); }
+        reaped.clear(); // disconnect outside the lock
+    }
+
+    CheckIdleConnections();
+
+    size_t to_open = 0;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (shutdown_) { return; }
+        size_t idle = pool_.size() + opening_count_;
+        size_t target = std::min(elastic_.min_idle, pool_size_);
+        if (idle < target && OpenLocked() < pool_size_) {
+            to_open = std::min(target - idle, pool_size_ - OpenLocked());
+            opening_count_ += to_open;
+        }
+    }
+
+    // Prewarm one connection at a time; a failure releases the remaining
+    // reservations and the next pass retries.
+    for (size_t i = 0; i < to_open; ++i) {
+        std::unique_ptr<pqxx::connection> conn;
+        try {
+            conn = OpenConnection();
+        } catch (const std::exception& e) {
+            spdlog::warn("DB pool prewarm failed: {}", e.what());
+            std::unique_lock<std::mutex> lock(mutex_);
+            opening_count_ -= to_open - i;
+            cv_.notify_all();
+            return;
+        }
+        std::unique_lock<std::mutex> lock(mutex_);
+        opening_count_--;
+        total_created_++;
+        telemetry::obs::EmitCounter("db_pool_connections_created", 1, "connections", "db_pool");
+        if (shutdown_) { // conn closes on scope exit
+            ForgetStatements(conn.get());
+            continue;
+        }
+        auto now = Clock::now();
+        pool_.push_back({std::move(conn), now, now, now});
+        cv_.notify_all();
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    telemetry::obs::EmitGauge("db_pool_idle", static_cast<double>(pool_.size()), "connections", "db_pool");
+}
+
+auto PooledDbConnectionManager::CheckIdleConnections() -> void {
+    if (elastic_.health_check_interval.count() <= 0) { return; }
+    std::vector<IdleConnection> checking;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (shutdown_) { return; }
+        auto now = Clock::now();
+        for (auto it = pool_.begin(); it != pool_.end();) {
+            if (now - it->checked_at >= elastic_.health_check_interval) {
+                checking.push_back(std::move(*it));
+                it = pool_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        checking_count_ += checking.size();
+    }
+    if (checking.empty()) { return; }
+
+    // Ping outside the lock; the slots stay counted in checking_count_.
+    std::vector<bool> healthy;
+    healthy.reserve(checking.size());
+    for (auto& idle : checking) { healthy.push_back(Ping(*idle.conn)); }
+
+    std::vector<std::unique_ptr<pqxx::connection>> broken;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        checking_count_ -= checking.size();
+        auto now = Clock::now();
+        for (size_t i = 0; i < checking.size(); ++i) {
+            if (!healthy[i] || shutdown_) {
+                if (!healthy[i]) { total_broken_++; }
+                ForgetStatements(checking[i].conn.get());
+                broken.push_back(std::move(checking[i].conn));
+                continue;
+            }
+            checking[i].checked_at = now;
+            // Keep the deque ordered by idle_since so reaping stays front-first.
+            auto pos = std::find_if(pool_.begin(), pool_.end(), [&](const IdleConnection& other) {
+                return other.idle_since > checking[i].idle_since;
+            });
+            pool_.insert(pos, std::move(checking[i]));
+        }
+        cv_.notify_all();
+    }
+    size_t dropped = static_cast<size_t>(std::count(healthy.begin(), healthy.end(), false));
+    if (dropped > 0) {
+        spdlog::warn("Dropped {} DB connections that failed a health check", dropped);
+        telemetry::obs::EmitCounter("db_pool_connections_broken", static_cast<long>(dropped), "connections", "db_pool");
+    }
 }
 
 auto PooledDbConnectionManager::GetStats() const -> PoolStats {
     std::unique_lock<std::mutex> lock(mutex_);
-    return {
+    PoolStats stats{
         pool_size_,
         in_use_count_,
         pool_.size(),
         total_acquires_,
         total_timeouts_,
-        total_wait_ms_
+        total_wait_ms_,
+        total_created_,
+        total_reaped_,
+        total_recycled_,
+        total_broken_,
+        {}
     };
-}
\ No newline at end of file
+    for (size_t i = 0; i < kDbLaneCount; ++i) {
+        const auto& lane = lanes_[i];
+        std::vector<double> waits = lane.waits_ms;
+        std::sort(waits.begin(), waits.end());
+        auto pct = [&waits](double q) {
+            if (waits.empty()) { return 0.0; }
+            auto rank = static_cast<size_t>(std::ceil(q * static_cast<double>(waits.size())));
+            return waits[std::clamp<size_t>(rank, 1, waits.size()) - 1];
+        };
+        stats.lanes[i] = {lane.held, lane.waiting, LaneLimitLocked(static_cast<DbLane>(i)),
+                          lane.acquires, lane.timeouts, pct(0.50), pct(0.95), pct(0.99)};
+    }
+    return stats;
+}
+
+auto DbReplicaArgs::FromEnv(DbReplicaArgs defaults) -> DbReplicaArgs {
+    DbReplicaArgs args = defaults;
+    EnvMillis("DB_READ_LAG_CHECK_MS", args.lag_check_interval);
+    EnvMillis("DB_READ_RETRY_MS", args.retry_after);
+    return args;
+}
+
+ReadReplicaDbConnectionManager::ReadReplicaDbConnectionManager(std::shared_ptr<DbConnectionManager> primary,
+                                                               std::shared_ptr<DbConnectionManager> replica,
+                                                               DbReplicaArgs args,
+                                                               LagProbe probe)
+    : primary_(std::move(primary)),
+      replica_(std::move(replica)),
+      args_(args),
+      probe_(probe ? std::move(probe) : LagProbe(&ReadReplicaDbConnectionManager::QueryReplicationLagMs)) {}
+
+auto ReadReplicaDbConnectionManager::QueryReplicationLagMs(pqxx::connection& conn) -> double {
+    // pg_last_xact_replay_timestamp() stops advancing while the primary is
+    // idle, so a standby that has replayed everything it received counts as
+    // current rather than as old as the last commit.
+    pqxx::nontransaction N(conn);
+    auto res = N.exec(
+        "SELECT CASE WHEN NOT pg_is_in_recovery() OR pg_last_wal_receive_lsn() = pg_last_wal_replay_lsn() THEN 0 "
+        "ELSE COALESCE(EXTRACT(EPOCH FROM now() - pg_last_xact_replay_timestamp()) * 1000, 0) END::float8");
+    return res.empty() ? 0.0 : res[0][0].as<double>();
+}
+
+auto ReadReplicaDbConnectionManager::GetConnectionFor(DbAccess access) -> DbConnectionPtr {
+    if (auto conn = GetReplicaConnectionFor(access)) { return conn; }
+    return primary_->GetConnection();
+}
+
+auto ReadReplicaDbConnectionManager::GetReplicaConnectionFor(DbAccess access) -> DbConnectionPtr {
+    if (!access.read_only || access.max_staleness.count() <= 0) { return nullptr; }
+    auto max_lag_ms = static_cast<double>(access.max_staleness.count());
+
+    // Routing is decided under the lock; connections are acquired outside it.
+    bool sample = false;
+    bool down = false;
+    bool stale = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto now = Clock::now();
+        if (now < replica_down_until_) {
+            down = true;
+            stats_.error_fallbacks++;
+        } else if (lag_ms_ < 0 || now - lag_sampled_at_ >= args_.lag_check_interval) {
+            sample = true;
+            lag_sampled_at_ = now; // one sampler per interval; the rest use the last value
+        } else if (lag_ms_ > max_lag_ms) {
+            stale = true;
+            stats_.stale_fallbacks++;
+        }
+    }
+    if (down || stale) {
+        NoteFallback(stale);
+        return nullptr;
+    }
+
+    DbConnectionPtr conn;
+    double lag = 0.0;
+    try {
+        conn = replica_->GetConnection();
+        if (sample) { lag = probe_(*conn); }
+    } catch (const std::exception& e) {
+        spdlog::warn("Read replica unavailable, reading from the primary for {} ms: {}",
+                     args_.retry_after.count(), e.what());
+        conn.reset();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            replica_down_until_ = Clock::now() + args_.retry_after;
+            stats_.error_fallbacks++;
+        }
+        NoteFallback(false);
+        return nullptr;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (sample) {
+            lag_ms_ = lag;
+            stats_.last_lag_ms = lag;
+        }
+        stale = lag_ms_ > max_lag_ms;
+        if (stale) {
+            stats_.stale_fallbacks++;
+        } else {
+            stats_.replica_reads++;
+        }
+    }
+    if (sample) { telemetry::obs::EmitGauge("db_replica_lag_ms", lag, "ms", "db_pool"); }
+    if (stale) {
+        NoteFallback(true);
+        return nullptr;
+    }
+    telemetry::obs::EmitCounter("db_read_routes_total", 1, "reads", "db_pool", {{"target", "replica"}});
+    return conn;
+}
+
+auto ReadReplicaDbConnectionManager::NoteFallback(bool stale) -> void {
+    telemetry::obs::EmitCounter("db_read_routes_total", 1, "reads", "db_pool",
+                                {{"target", "primary"}, {"reason", stale ? "stale" : "replica_error"}});
+}
+
+auto ReadReplicaDbConnectionManager::GetStats() const -> Stats {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
@@ -1,19 +1,36 @@
 #pragma once
 
 #include <pqxx/pqxx>
+#include <array>
 #include <memory>
 #include <string>
-#include <queue>
+#include <deque>
 #include <mutex>
 #include <condition_variable>
 #include <chrono>
 #include <functional>
+#include <thread>
+#include <vector>
+#include "statement_registry.h"
 
 /**
  * @brief Smart pointer for database connections that handles returning to pool.
  */
 using DbConnectionPtr = std::unique_ptr<pqxx::connection, std::function<void(pqxx::connection*)>>;
 
+/**
+ * @brief What a checkout will do with its connection. Writes, and reads
+ * that must observe the caller's own writes, need the primary; other reads
+ * may be served by a replica at most max_staleness behind it.
+ */
+struct DbAccess {
+    bool read_only = false;
+    std::chrono::milliseconds max_staleness{0}; // 0 = must be current
+
+    static auto Write() -> DbAccess { return {}; }
+    static auto Read(std::chrono::milliseconds max_staleness) -> DbAccess { return {true, max_staleness}; }
+};
+
 /**
  * @brief Manages database connections and provides an abstraction for pooling.
  */
@@ -26,6 +43,18 @@ public:
      */
     virtual auto GetConnection() -> DbConnectionPtr = 0;
 
+    /**
+     * @brief Acquires a connection suitable for access. Managers without a
+     * replica serve everything from GetConnection().
+     */
+    virtual auto GetConnectionFor(DbAccess /*access*/) -> DbConnectionPtr { return GetConnection(); }
+
+    /**
+     * @brief Acquires a replica connection when access would be routed to
+     * one, otherwise returns null. Managers without a replica always return null.
+     */
+    virtual auto GetReplicaConnectionFor(DbAccess /*access*/) -> DbConnectionPtr { return nullptr; }
+
     /**
      * @brief Returns the connection string used by the manager.
      */
@@ -48,7 +77,10 @@ public:
             initializer_(*conn);
         }
         return {conn, 
-                [](pqxx::connection* c) { delete c; }};
+                [](pqxx::connection* c) {
+                    telemetry::db::StatementRegistry::Instance().Forget(c);
+                    delete c;
+                }};
     }
 
     [[nodiscard]] auto GetConnectionString() const -> std::string override {
@@ -60,22 +92,117 @@ private:
     ConnectionInitializer initializer_;
 };
 
+/**
+ * @brief Capacity class a pooled connection is acquired for, highest
+ * priority first. Interactive is request/response traffic; Maintenance is
+ * partition upkeep, retention and reconciliation; Batch is scoring,
+ * training and generation.
+ */
+enum class DbLane : size_t { Interactive = 0, Maintenance = 1, Batch = 2 };
+inline constexpr size_t kDbLaneCount = 3;
+
+auto DbLaneName(DbLane lane) -> const char*;
+
+namespace db_lane_detail {
+inline thread_local DbLane current = DbLane::Interactive;
+} // namespace db_lane_detail
+
+// Lane for connections acquired on the calling thread: Interactive unless
+// a DbLaneScope is active.
+inline auto CurrentDbLane() -> DbLane { return db_lane_detail::current; }
+
+/**
+ * @brief Routes this thread's connection acquisitions to a lane until
+ * destroyed. Background job threads open one at the top of their body.
+ */
+class DbLaneScope {
+public:
+    explicit DbLaneScope(DbLane lane) : previous_(db_lane_detail::current) { db_lane_detail::current = lane; }
+    ~DbLaneScope() { db_lane_detail::current = previous_; }
+    DbLaneScope(const DbLaneScope&) = delete;
+    auto operator=(const DbLaneScope&) -> DbLaneScope& = delete;
+    DbLaneScope(DbLaneScope&&) = delete;
+    auto operator=(DbLaneScope&&) -> DbLaneScope& = delete;
+
+private:
+    DbLane previous_;
+};
+
+/**
+ * @brief Prewarm/reap/health settings for PooledDbConnectionManager.
+ */
+struct DbPoolElasticArgs {
+    size_t min_idle = 0;                       // connections kept open (prewarmed) when idle
+    std::chrono::milliseconds idle_timeout{0}; // 0 = never reap idle connections
+    std::chrono::milliseconds maintenance_interval{5000};
+    std::chrono::milliseconds health_check_interval{0}; // ping connections idle this long; 0 = off
+    std::chrono::milliseconds max_lifetime{0};          // recycle connections this old; 0 = never
+
+    // DB_POOL_MIN_IDLE, DB_POOL_IDLE_TIMEOUT_MS, DB_POOL_HEALTH_CHECK_MS,
+    // DB_POOL_MAX_LIFETIME_MS override the given defaults
+    static auto FromEnv(DbPoolElasticArgs defaults) -> DbPoolElasticArgs;
+    static auto FromEnv() -> DbPoolElasticArgs { return FromEnv(DbPoolElasticArgs{}); }
+};
+
+/**
+ * @brief Per-lane limits for PooledDbConnectionManager. The defaults keep
+ * the single shared pool: no reserve, no caps, one timeout.
+ */
+struct DbPoolLaneArgs {
+    size_t interactive_reserved = 0; // slots Maintenance and Batch may never hold
+    size_t maintenance_max = 0;      // 0 = no lane cap
+    size_t batch_max = 0;            // 0 = no lane cap
+    std::chrono::milliseconds maintenance_timeout{0}; // 0 = the pool's acquire_timeout
+    std::chrono::milliseconds batch_timeout{0};       // 0 = the pool's acquire_timeout
+
+    // DB_POOL_INTERACTIVE_RESERVED, DB_POOL_MAINTENANCE_MAX, DB_POOL_BATCH_MAX,
+    // DB_POOL_BATCH_TIMEOUT_MS override the given defaults
+    static auto FromEnv(DbPoolLaneArgs defaults) -> DbPoolLaneArgs;
+    static auto FromEnv() -> DbPoolLaneArgs { return FromEnv(DbPoolLaneArgs{}); }
+};
+
 /**
  * @brief Bounded connection pool for PostgreSQL connections.
+ *
+ * Grows on demand up to pool_size. Acquisitions are admitted by lane
+ * (see DbLane): a lane waits while a higher-priority lane that could take
+ * the slot is waiting, and Maintenance/Batch together never hold the
+ * interactive reserve. With ElasticArgs a background maintenance thread
+ * keeps min_idle connections open ahead of demand, closes connections idle
+ * past idle_timeout or older than max_lifetime, and pings idle connections
+ * so broken ones are dropped before a caller gets them.
  */
 class PooledDbConnectionManager : public DbConnectionManager {
 public:
     using ConnectionInitializer = std::function<void(pqxx::connection&)>;
 
+    using ElasticArgs = DbPoolElasticArgs;
+    using LaneArgs = DbPoolLaneArgs;
+
     PooledDbConnectionManager(std::string conn_str, 
                                size_t pool_size, 
                                std::chrono::milliseconds acquire_timeout = std::chrono::milliseconds(5000),
-                               ConnectionInitializer initializer = nullptr);
+                               ConnectionInitializer initializer = nullptr,
+                               ElasticArgs elastic = {},
+                               LaneArgs lanes = {});
     ~PooledDbConnectionManager() override;
 
+    // Acquires for CurrentDbLane().
     auto GetConnection() -> DbConnectionPtr override;
+    auto GetConnection(DbLane lane) -> DbConnectionPtr;
     auto GetConnectionString() const -> std::string override { return conn_str_; }
 
+    struct LaneStats {
+        size_t in_use;  // held or connecting
+        size_t waiting;
+        size_t limit;   // most this lane may hold at once
+        long long total_acquires;
+        long long total_timeouts;
+        double wait_p50_ms; // over the last kWaitSamples acquisitions
+        double wait_p95_ms;
+        double wait_p99_ms;
+    };
+
     struct PoolStats {
         size_t size;
         size_t in_use;
@@ -83,25 +210,139 @@ public:
         long long total_acquires;
         long long total_timeouts;
         double total_wait_ms;
+        long long total_created;  // physical connections opened
+        long long total_reaped;   // idle connections closed by maintenance
+        long long total_recycled; // closed for exceeding max_lifetime
+        long long total_broken;   // dropped after a failed ping or on release
+        std::array<LaneStats, kDbLaneCount> lanes; // indexed by DbLane
     };
     auto GetStats() const -> PoolStats;
 
+    // One maintenance pass (reap, health check, then prewarm); normally run
+    // by the background thread.
+    auto RunMaintenance() -> void;
+
+    static constexpr size_t kWaitSamples = 512;
+
 private:
-    auto ReleaseConnection(pqxx::connection* conn) -> void;
+    using Clock = std::chrono::steady_clock;
+
+    struct IdleConnection {
+        std::unique_ptr<pqxx::connection> conn;
+        Clock::time_point idle_since;
+        Clock::time_point created_at;
+        Clock::time_point checked_at; // last ping or use
+    };
+
+    struct Lane {
+        size_t held = 0; // in use or connecting
+        size_t waiting = 0;
+        long long acquires = 0;
+        long long timeouts = 0;
+        std::vector<double> waits_ms; // ring of the last kWaitSamples waits
+        size_t next_wait = 0;
+    };
+
+    auto ReleaseConnection(pqxx::connection* conn, DbLane lane, Clock::time_point created_at) -> void;
+    auto OpenConnection() -> std::unique_ptr<pqxx::connection>;
+    auto OpenLocked() const -> size_t { return in_use_count_ + pool_.size() + opening_count_ + checking_count_; }
+    auto LaneLimitLocked(DbLane lane) const -> size_t;
+    auto LaneFitsLocked(DbLane lane) const -> bool;   // capacity and lane limits only
+    auto CanAdmitLocked(DbLane lane) const -> bool;   // plus priority
+    auto TimeoutFor(DbLane lane) const -> std::chrono::milliseconds;
+    auto RecordWaitLocked(Lane& lane, double wait_ms) -> void;
+    auto CheckIdleConnections() -> void;
 
     std::string conn_str_;
     size_t pool_size_;
     std::chrono::milliseconds acquire_timeout_;
     ConnectionInitializer initializer_;
+    ElasticArgs elastic_;
+    LaneArgs lane_args_;
 
     mutable std::mutex mutex_;
-    std::condition_variable cv_;
-    std::queue<std::unique_ptr<pqxx::connection>> pool_;
+    std::condition_variable cv_;             // acquirers waiting for a connection
+    std::condition_variable maintenance_cv_; // wakes the maintenance thread on shutdown
+    std::deque<IdleConnection> pool_; // oldest idle first; reuse takes the newest
     size_t in_use_count_ = 0;
+    size_t opening_count_ = 0;        // connects in progress outside the lock
+    size_t checking_count_ = 0;       // idle connections out for a ping
+    std::array<Lane, kDbLaneCount> lanes_;
     
     long long total_acquires_ = 0;
     long long total_timeouts_ = 0;
     double total_wait_ms_ = 0.0;
+    long long total_created_ = 0;
+    long long total_reaped_ = 0;
+    long long total_recycled_ = 0;
+    long long total_broken_ = 0;
 
     bool shutdown_ = false;
-};
\ No newline at end of file
+    std::thread maintenance_thread_;
+};
+
+/**
+ * @brief Settings for ReadReplicaDbConnectionManager.
+ */
+struct DbReplicaArgs {
+    std::chrono::milliseconds lag_check_interval{1000}; // how old a lag sample may get
+    std::chrono::milliseconds retry_after{5000};        // primary-only period after a replica error
+
+    // DB_READ_LAG_CHECK_MS, DB_READ_RETRY_MS override the given defaults
+    static auto FromEnv(DbReplicaArgs defaults) -> DbReplicaArgs;
+    static auto FromEnv() -> DbReplicaArgs { return FromEnv(DbReplicaArgs{}); }
+};
+
+/**
+ * @brief Routes tagged reads to a read replica and everything else to the
+ * primary. A read goes to the replica when the replica's last sampled
+ * replication lag is within the read's max_staleness; the sample is taken
+ * on a replica connection at most every lag_check_interval. A replica that
+ * fails to connect or to report its lag is skipped for retry_after, so
+ * reads degrade to the primary instead of failing.
+ */
+class ReadReplicaDbConnectionManager : public DbConnectionManager {
+public:
+    // Replication lag in ms as reported by conn. Replaceable for tests.
+    using LagProbe = std::function<double(pqxx::connection&)>;
+
+    ReadReplicaDbConnectionManager(std::shared_ptr<DbConnectionManager> primary,
+                                   std::shared_ptr<DbConnectionManager> replica,
+                                   DbReplicaArgs args = {},
+                                   LagProbe probe = nullptr);
+
+    auto GetConnection() -> DbConnectionPtr override { return primary_->GetConnection(); }
+    auto GetConnectionFor(DbAccess access) -> DbConnectionPtr override;
+    auto GetReplicaConnectionFor(DbAccess access) -> DbConnectionPtr override;
+    [[nodiscard]] auto GetConnectionString() const -> std::string override { return primary_->GetConnectionString(); }
+
+    [[nodiscard]] auto Primary() const -> const std::shared_ptr<DbConnectionManager>& { return primary_; }
+    [[nodiscard]] auto Replica() const -> const std::shared_ptr<DbConnectionManager>& { return replica_; }
+
+    struct Stats {
+        long long replica_reads = 0;
+        long long stale_fallbacks = 0; // replica too far behind for the read
+        long long error_fallbacks = 0; // replica unreachable or backing off
+        double last_lag_ms = -1.0;     // -1 until sampled
+    };
+    [[nodiscard]] auto GetStats() const -> Stats;
+
+    // Lag query used by default: 0 on a primary or a caught-up standby.
+    static auto QueryReplicationLagMs(pqxx::connection& conn) -> double;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    auto NoteFallback(bool stale) -> void;
+
+    std::shared_ptr<DbConnectionManager> primary_;
+    std::shared_ptr<DbConnectionManager> replica_;
+    DbReplicaArgs args_;
+    LagProbe probe_;
+
+    mutable std::mutex mutex_;
+    double lag_ms_ = -1.0;
+    Clock::time_point lag_sampled_at_{};
+    Clock::time_point replica_down_until_{};
+    Stats stats_;
+};
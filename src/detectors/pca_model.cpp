@@ -1,5 +1,6 @@
 #include "pca_model.h"
 
+#include <array>
 #include <fstream>
 #include <sstream>
 #include <stdexcept>
@@ -154,6 +155,50 @@ auto PcaModel::Score(const FeatureVector& vec) const -> PcaScore {
     return result;
 }
 
+auto PcaModel::ScoreBatch(const FeatureVector* rows, size_t n, double* errors, uint8_t* flags) const -> size_t {
+    constexpr size_t d = FeatureVector::kSize;
+    const size_t k = components_.rows;
+    if (!loaded_ || k > d || pca_mean_.size() != d) {
+        size_t anomalies = 0;
+        for (size_t i = 0; i < n; ++i) {
+            auto score = Score(rows[i]);
+            errors[i] = score.reconstruction_error;
+            flags[i] = score.is_anomaly ? 1 : 0;
+            anomalies += flags[i];
+        }
+        return anomalies;
+    }
+
+    const double* comp = components_.data.data(); // row-major k x d
+    size_t anomalies = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const auto& x = rows[i].data;
+        std::array<double, d> scaled{};
+        std::array<double, d> centered{};
+        for (size_t j = 0; j < d; ++j) {
+            scaled[j] = (x[j] - cur_mean_[j]) / cur_scale_[j];
+            centered[j] = scaled[j] - pca_mean_[j];
+        }
+        std::array<double, d> proj{};
+        for (size_t r = 0; r < k; ++r) {
+            double sum = 0.0;
+            for (size_t j = 0; j < d; ++j) { sum += comp[r * d + j] * centered[j]; }
+            proj[r] = sum;
+        }
+        double sq = 0.0;
+        for (size_t j = 0; j < d; ++j) {
+            double recon = 0.0;
+            for (size_t r = 0; r < k; ++r) { recon += comp[r * d + j] * proj[r]; }
+            double diff = scaled[j] - (recon + pca_mean_[j]);
+            sq += diff * diff;
+        }
+        errors[i] = std::sqrt(sq);
+        flags[i] = errors[i] > threshold_ ? 1 : 0;
+        anomalies += flags[i];
+    }
+    return anomalies;
+}
+
 auto PcaModel::EstimateMemoryUsage() const -> size_t {
     size_t usage = sizeof(PcaModel);
     usage += cur_mean_.size() * sizeof(double);
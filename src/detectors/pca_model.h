@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <vector>
 #include "linalg/matrix.h"
@@ -24,6 +26,15 @@ public:
     // Score a vector
     [[nodiscard]] auto Score(const FeatureVector& vec) const -> PcaScore;
 
+    /**
+     * @brief Scores n rows into errors[i] / flags[i] (1 = anomaly) and
+     * returns the anomaly count.
+     *
+     * Same arithmetic as Score(), in the same order, so the errors match it,
+     * but without per-row allocations, residuals or details.
+     */
+    auto ScoreBatch(const FeatureVector* rows, size_t n, double* errors, uint8_t* flags) const -> size_t;
+
     // Accessors for testing
     [[nodiscard]] auto GetThreshold() const -> double { return threshold_; }
     [[nodiscard]] auto IsLoaded() const -> bool { return loaded_; }
@@ -0,0 +1,192 @@
+#include "eval_aggregates.h"
+#include "eval_curve.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <vector>
+
+namespace telemetry::stats {
+
+namespace {
+
+constexpr int kNonPositiveBucket = INT_MIN;
+
+auto BucketIndex(double err) -> int {
+    if (!(err > 0.0)) { return kNonPositiveBucket; }
+    double idx = std::floor(std::log(err) / std::log1p(ErrorHistogram::kRelativeWidth));
+    return static_cast<int>(std::clamp(idx, static_cast<double>(INT_MIN + 1), static_cast<double>(INT_MAX)));
+}
+
+} // namespace
+
+auto ErrorHistogram::Add(double err, bool label) -> void {
+    auto [it, inserted] = buckets_.try_emplace(BucketIndex(err));
+    auto& b = it->second;
+    if (inserted) {
+        b.min = err;
+        b.max = err;
+    } else {
+        b.min = std::min(b.min, err);
+        b.max = std::max(b.max, err);
+    }
+    if (label) { b.positives++; }
+    else { b.negatives++; }
+    count_++;
+}
+
+auto ErrorHistogram::ValueAtRank(long rank) const -> double {
+    long seen = 0;
+    for (const auto& [idx, b] : buckets_) {
+        long n = b.Count();
+        if (rank < seen + n) {
+            if (n == 1) { return b.min; }
+            double frac = static_cast<double>(rank - seen) / static_cast<double>(n - 1);
+            return b.min + frac * (b.max - b.min);
+        }
+        seen += n;
+    }
+    return buckets_.empty() ? 0.0 : buckets_.rbegin()->second.max;
+}
+
+auto ErrorHistogram::Percentile(double q) const -> double {
+    if (count_ == 0) { return 0.0; }
+    double pos = std::clamp(q, 0.0, 1.0) * static_cast<double>(count_ - 1);
+    auto lo = static_cast<long>(std::floor(pos));
+    double lo_value = ValueAtRank(lo);
+    if (lo + 1 >= count_) { return lo_value; }
+    return lo_value + (pos - static_cast<double>(lo)) * (ValueAtRank(lo + 1) - lo_value);
+}
+
+auto ErrorHistogram::ToJson() const -> nlohmann::json {
+    nlohmann::json out = nlohmann::json::array();
+    for (const auto& [idx, b] : buckets_) {
+        out.push_back({idx, b.positives, b.negatives, b.min, b.max});
+    }
+    return out;
+}
+
+auto ErrorHistogram::FromJson(const nlohmann::json& j) -> ErrorHistogram {
+    ErrorHistogram h;
+    for (const auto& row : j) {
+        Bucket b{row.at(1).get<long>(), row.at(2).get<long>(), row.at(3).get<double>(), row.at(4).get<double>()};
+        h.count_ += b.Count();
+        h.buckets_[row.at(0).get<int>()] = b;
+    }
+    return h;
+}
+
+auto EvalAggregates::Add(double err, bool predicted, bool label, const std::array<std::string, 3>& dims) -> void {
+    if (predicted && label) { tp_++; }
+    else if (predicted && !label) { fp_++; }
+    else if (!predicted && !label) { tn_++; }
+    else { fn_++; }
+    errors_.Add(err, label);
+    for (size_t d = 0; d < kDimensions.size(); ++d) {
+        auto& g = groups_[d][dims[d]];
+        g.sum += err;
+        g.errors.Add(err, label);
+    }
+}
+
+auto EvalAggregates::Eval(int points) const -> nlohmann::json {
+    nlohmann::json out;
+    out["confusion"] = {{"tp", tp_}, {"fp", fp_}, {"tn", tn_}, {"fn", fn_}};
+    nlohmann::json roc = nlohmann::json::array();
+    nlohmann::json pr = nlohmann::json::array();
+    long total = errors_.Count();
+    long positives = 0;
+    long negatives = 0;
+    for (const auto& [idx, b] : errors_.Buckets()) {
+        positives += b.positives;
+        negatives += b.negatives;
+    }
+
+    // Same evenly spaced ranks as the scan, walked from the highest error
+    // down. Each point snaps to the min of the bucket holding its rank.
+    int n_points = telemetry::api::EvalCurveBuilder::ClampPoints(points);
+    int next_point = 0;
+    long seen = 0;
+    long cum_tp = 0;
+    long cum_fp = 0;
+    const auto& buckets = errors_.Buckets();
+    for (auto it = buckets.rbegin(); it != buckets.rend() && next_point < n_points; ++it) {
+        const auto& b = it->second;
+        seen += b.Count();
+        cum_tp += b.positives;
+        cum_fp += b.negatives;
+        while (next_point < n_points) {
+            auto rank = static_cast<long>((static_cast<double>(next_point) / (n_points - 1)) *
+                                          static_cast<double>(total - 1));
+            if (rank >= seen) { break; }
+            double tpr = positives > 0 ? static_cast<double>(cum_tp) / static_cast<double>(positives) : 0.0;
+            double fpr = negatives > 0 ? static_cast<double>(cum_fp) / static_cast<double>(negatives) : 0.0;
+            double precision = (cum_tp + cum_fp) > 0 ? static_cast<double>(cum_tp) / static_cast<double>(cum_tp + cum_fp) : 0.0;
+            roc.push_back({{"fpr", fpr}, {"tpr", tpr}, {"threshold", b.min}});
+            pr.push_back({{"precision", precision}, {"recall", tpr}, {"threshold", b.min}});
+            next_point++;
+        }
+    }
+    out["roc"] = roc;
+    out["pr"] = pr;
+    return out;
+}
+
+auto EvalAggregates::ErrorDistribution(const std::string& group_by) const -> std::optional<nlohmann::json> {
+    const auto* dim = std::find_if(kDimensions.begin(), kDimensions.end(),
+                                   [&](const char* d) { return group_by == d || group_by == std::string("h.") + d; });
+    if (dim == kDimensions.end()) { return std::nullopt; }
+    const auto& groups = groups_[static_cast<size_t>(dim - kDimensions.begin())];
+
+    std::vector<std::pair<std::string, const Group*>> ordered;
+    ordered.reserve(groups.size());
+    for (const auto& [label, g] : groups) { ordered.emplace_back(label, &g); }
+    std::stable_sort(ordered.begin(), ordered.end(), [](const auto& a, const auto& b) {
+        return a.second->errors.Count() > b.second->errors.Count();
+    });
+
+    nlohmann::json out = nlohmann::json::array();
+    for (const auto& [label, g] : ordered) {
+        long count = g->errors.Count();
+        out.push_back({{"label", label},
+                       {"count", count},
+                       {"mean", count > 0 ? g->sum / static_cast<double>(count) : 0.0},
+                       {"p50", g->errors.Percentile(0.5)},
+                       {"p95", g->errors.Percentile(0.95)}});
+    }
+    return out;
+}
+
+auto EvalAggregates::ToJson() const -> nlohmann::json {
+    nlohmann::json out;
+    out["confusion"] = {{"tp", tp_}, {"fp", fp_}, {"tn", tn_}, {"fn", fn_}};
+    out["errors"] = errors_.ToJson();
+    nlohmann::json groups = nlohmann::json::object();
+    for (size_t d = 0; d < kDimensions.size(); ++d) {
+        nlohmann::json dim = nlohmann::json::object();
+        for (const auto& [label, g] : groups_[d]) {
+            dim[label] = {{"sum", g.sum}, {"errors", g.errors.ToJson()}};
+        }
+        groups[kDimensions[d]] = dim;
+    }
+    out["groups"] = groups;
+    return out;
+}
+
+auto EvalAggregates::FromJson(const nlohmann::json& j) -> EvalAggregates {
+    EvalAggregates agg;
+    const auto& confusion = j.at("confusion");
+    agg.tp_ = confusion.at("tp").get<long>();
+    agg.fp_ = confusion.at("fp").get<long>();
+    agg.tn_ = confusion.at("tn").get<long>();
+    agg.fn_ = confusion.at("fn").get<long>();
+    agg.errors_ = ErrorHistogram::FromJson(j.at("errors"));
+    const auto& groups = j.at("groups");
+    for (size_t d = 0; d < kDimensions.size(); ++d) {
+        for (const auto& [label, g] : groups.at(kDimensions[d]).items()) {
+            agg.groups_[d][label] = {g.at("sum").get<double>(), ErrorHistogram::FromJson(g.at("errors"))};
+        }
+    }
+    return agg;
+}
+
+} // namespace telemetry::stats
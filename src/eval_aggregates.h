@@ -0,0 +1,83 @@
+#pragma once
+
+#include <array>
+#include <map>
+#include <optional>
+#include <string>
+#include <nlohmann/json.hpp>
+
+namespace telemetry::stats {
+
+/**
+ * @brief Log-bucketed reconstruction-error histogram split by label.
+ *
+ * Bucket i holds errors in [(1+w)^i, (1+w)^(i+1)) for w = kRelativeWidth;
+ * errors <= 0 share one bucket below all others. Each bucket keeps its
+ * exact min/max, so a curve point placed at a bucket's min is an exact
+ * (threshold, TP, FP) triple and percentiles are off by less than w.
+ */
+class ErrorHistogram {
+public:
+    static constexpr double kRelativeWidth = 0.01;
+
+    struct Bucket {
+        long positives = 0; // ground-truth anomalies
+        long negatives = 0;
+        double min = 0.0;
+        double max = 0.0;
+
+        auto Count() const -> long { return positives + negatives; }
+    };
+
+    auto Add(double err, bool label) -> void;
+    auto Count() const -> long { return count_; }
+    auto Buckets() const -> const std::map<int, Bucket>& { return buckets_; }
+
+    // PERCENTILE_CONT(q), interpolating linearly inside a bucket.
+    auto Percentile(double q) const -> double;
+
+    auto ToJson() const -> nlohmann::json; // [[index, positives, negatives, min, max], ...]
+    static auto FromJson(const nlohmann::json& j) -> ErrorHistogram;
+
+private:
+    auto ValueAtRank(long rank) const -> double;
+
+    std::map<int, Bucket> buckets_;
+    long count_ = 0;
+};
+
+/**
+ * @brief Everything /eval and /error_distribution need for one
+ * (dataset, model) pair, accumulated by the score job as it scores and
+ * persisted once at completion.
+ */
+class EvalAggregates {
+public:
+    // Dimensions /error_distribution can answer without a scan.
+    static constexpr std::array<const char*, 3> kDimensions = {"region", "project_id", "anomaly_type"};
+
+    struct Group {
+        double sum = 0.0;
+        ErrorHistogram errors;
+    };
+
+    // dims are the row's values in kDimensions order ("" for NULL).
+    auto Add(double err, bool predicted, bool label, const std::array<std::string, 3>& dims) -> void;
+    auto Samples() const -> long { return errors_.Count(); }
+
+    // {"confusion", "roc", "pr"} in the shape DbClient::GetEvalMetrics returns.
+    auto Eval(int points) const -> nlohmann::json;
+    // Rows shaped like DbClient::GetErrorDistribution; nullopt for an untracked dimension.
+    auto ErrorDistribution(const std::string& group_by) const -> std::optional<nlohmann::json>;
+
+    auto ToJson() const -> nlohmann::json;
+    // Throws nlohmann::json::exception on a malformed document.
+    static auto FromJson(const nlohmann::json& j) -> EvalAggregates;
+
+private:
+    long tp_ = 0, fp_ = 0, tn_ = 0, fn_ = 0;
+    ErrorHistogram errors_;
+    std::array<std::map<std::string, Group>, 3> groups_; // indexed like kDimensions
+};
+
+} // namespace telemetry::stats
@@ -0,0 +1,65 @@
+#include "eval_curve.h"
+#include <algorithm>
+
+namespace telemetry::api {
+
+EvalCurveBuilder::EvalCurveBuilder(long total_samples, int points)
+    : total_(std::max(0L, total_samples)), n_points_(ClampPoints(points)) {
+    curve_.reserve(static_cast<size_t>(n_points_));
+}
+
+auto EvalCurveBuilder::ClampPoints(int points) -> int {
+    int n_points = points > 0 ? points : 50;
+    n_points = std::min(n_points, 200);
+    return std::max(n_points, 10);
+}
+
+auto EvalCurveBuilder::Add(double err, bool predicted, bool label) -> void {
+    // A new (lower) error closes the tie group the pending thresholds belong to.
+    if (!pending_.empty() && err < pending_.front()) { FlushPending(); }
+
+    if (predicted && label) { tp_++; }
+    else if (predicted && !label) { fp_++; }
+    else if (!predicted && !label) { tn_++; }
+    else { fn_++; }
+    if (label) { positives_++; }
+    else { negatives_++; }
+
+    // Point i sits at rank floor(i / (n - 1) * (total - 1)); several points
+    // share a rank when there are fewer samples than points.
+    long rank = seen_++;
+    while (next_point_ < n_points_ && rank < total_) {
+        auto target = static_cast<long>((static_cast<double>(next_point_) / (n_points_ - 1)) *
+                                        static_cast<double>(total_ - 1));
+        if (target != rank) { break; }
+        pending_.push_back(err);
+        next_point_++;
+    }
+}
+
+auto EvalCurveBuilder::FlushPending() -> void {
+    for (double threshold : pending_) {
+        curve_.push_back({threshold, positives_, negatives_});
+    }
+    pending_.clear();
+}
+
+auto EvalCurveBuilder::Finish() -> nlohmann::json {
+    FlushPending();
+    nlohmann::json out;
+    out["confusion"] = {{"tp", tp_}, {"fp", fp_}, {"tn", tn_}, {"fn", fn_}};
+    nlohmann::json roc = nlohmann::json::array();
+    nlohmann::json pr = nlohmann::json::array();
+    for (const auto& p : curve_) {
+        double tpr = positives_ > 0 ? static_cast<double>(p.tp) / static_cast<double>(positives_) : 0.0;
+        double fpr = negatives_ > 0 ? static_cast<double>(p.fp) / static_cast<double>(negatives_) : 0.0;
+        double precision = (p.tp + p.fp) > 0 ? static_cast<double>(p.tp) / static_cast<double>(p.tp + p.fp) : 0.0;
+        roc.push_back({{"fpr", fpr}, {"tpr", tpr}, {"threshold", p.threshold}});
+        pr.push_back({{"precision", precision}, {"recall", tpr}, {"threshold", p.threshold}});
+    }
+    out["roc"] = roc;
+    out["pr"] = pr;
+    return out;
+}
+
+} // namespace telemetry::api
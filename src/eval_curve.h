@@ -0,0 +1,50 @@
+#pragma once
+
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace telemetry::api {
+
+/**
+ * @brief Builds the confusion matrix and ROC/PR curves for a model's scores
+ * in one pass over samples streamed in descending reconstruction-error order.
+ *
+ * Curve points sit at evenly spaced ranks of the sorted errors; a sample is
+ * predicted positive at a point when its error is >= that point's threshold,
+ * so ties at the threshold are counted in full. Memory is O(points).
+ */
+class EvalCurveBuilder {
+public:
+    // total_samples is the number of samples that will be Add()ed.
+    EvalCurveBuilder(long total_samples, int points);
+
+    // Samples must arrive with non-increasing err.
+    auto Add(double err, bool predicted, bool label) -> void;
+
+    // {"confusion", "roc", "pr"}; call once after the last Add().
+    auto Finish() -> nlohmann::json;
+
+    // Requested points clamped to [10, 200], 50 when unset.
+    static auto ClampPoints(int points) -> int;
+
+private:
+    struct CurvePoint {
+        double threshold;
+        long tp; // cumulative counts at err >= threshold
+        long fp;
+    };
+
+    auto FlushPending() -> void;
+
+    long total_;
+    int n_points_;
+    long seen_ = 0;
+    int next_point_ = 0;
+    long tp_ = 0, fp_ = 0, tn_ = 0, fn_ = 0;
+    long positives_ = 0; // labels seen so far; also the cumulative TP/FP
+    long negatives_ = 0; // of every threshold at or above the current err
+    std::vector<double> pending_; // thresholds waiting for their tie group to end
+    std::vector<CurvePoint> curve_;
+};
+
+} // namespace telemetry::api
@@ -0,0 +1,70 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include <spdlog/spdlog.h>
+#include "generator.h"
+
+// Offline dataset generation: runs the generator with the file sink and no
+// database, for benchmarks and training runs that should not need Postgres.
+auto main(int argc, char** argv) -> int {
+    telemetry::GenerateRequest req;
+    req.set_tier("BENCH");
+    req.set_host_count(100);
+    req.set_start_time_iso("2025-01-01T00:00:00Z");
+    req.set_end_time_iso("2025-01-02T00:00:00Z");
+    req.set_interval_seconds(60);
+    req.set_output_dir("data/segments");
+    std::string run_id = "offline-run";
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) { break; }
+        if (arg == "--run_id") {
+            run_id = argv[++i];
+        } else if (arg == "--output_dir") {
+            req.set_output_dir(argv[++i]);
+        } else if (arg == "--tier") {
+            req.set_tier(argv[++i]);
+        } else if (arg == "--host_count") {
+            req.set_host_count(std::stoi(argv[++i]));
+        } else if (arg == "--start") {
+            req.set_start_time_iso(argv[++i]);
+        } else if (arg == "--end") {
+            req.set_end_time_iso(argv[++i]);
+        } else if (arg == "--interval_seconds") {
+            req.set_interval_seconds(std::stoi(argv[++i]));
+        } else if (arg == "--seed") {
+            req.set_seed(std::stoll(argv[++i]));
+        } else if (arg == "--point_rate") {
+            req.mutable_anomaly_config()->set_point_rate(std::stod(argv[++i]));
+        } else if (arg == "--collective_rate") {
+            req.mutable_anomaly_config()->set_collective_rate(std::stod(argv[++i]));
+        } else if (arg == "--correlation_break_rate") {
+            req.mutable_anomaly_config()->set_correlation_break_rate(std::stod(argv[++i]));
+        } else if (arg == "--contextual_rate") {
+            req.mutable_anomaly_config()->set_contextual_rate(std::stod(argv[++i]));
+        }
+    }
+    req.set_sink("file");
+
+    auto progress = std::make_shared<telemetry::RunProgress>(run_id, "");
+    auto start = std::chrono::steady_clock::now();
+    {
+        Generator gen(req, run_id, nullptr);
+        gen.SetProgress(progress);
+        gen.Run();
+        auto snap = progress->Snapshot();
+        if (snap.status != "SUCCEEDED") {
+            std::cerr << "Generation failed: " << snap.error << std::endl;
+            return 1;
+        }
+        std::chrono::duration<double> secs = std::chrono::steady_clock::now() - start;
+        std::cout << "Rows: " << snap.inserted_rows << std::endl;
+        std::cout << "Segments: " << gen.SegmentPaths().size() << std::endl;
+        std::cout << "Generation time (s): " << secs.count() << std::endl;
+        std::cout << "Rows/s: " << static_cast<double>(snap.inserted_rows) / secs.count() << std::endl;
+        std::cout << "Output: " << req.output_dir() << "/" << run_id << std::endl;
+    }
+    return 0;
+}
@@ -4,6 +4,8 @@
 #include "obs/context.h"
 #include "obs/error_codes.h"
 #include "obs/logging.h"
+#include "progress_reporter.h"
+#include "partition_manager.h"
 #include <cmath>
 #include <random>
 #include <fmt/chrono.h>
@@ -11,6 +13,7 @@
 #include <ctime>
 #include <iomanip>
 #include <sstream>
+#include <stdexcept>
 
 // Helper to parse ISO string
 auto ParseTime(const std::string& iso) -> std::chrono::system_clock::time_point {
@@ -33,24 +36,74 @@ Generator::Generator(const telemetry::GenerateRequest& request,
 }
 
 Generator::~Generator() {
-    writer_running_ = false;
+    StopWriter();
+}
+
+auto Generator::StartWriter() -> void {
+    writer_running_ = true;
+    // The writer inserts on behalf of this run, so it shares its lane.
+    writer_thread_ = std::make_unique<std::thread>([this, lane = CurrentDbLane()]() {
+        DbLaneScope scope(lane);
+        WriterLoop();
+    });
+}
+
+auto Generator::StopWriter() -> void {
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        writer_running_ = false;
+    }
     queue_cv_.notify_all();
+    queue_space_cv_.notify_all();
     if (writer_thread_ && writer_thread_->joinable()) {
         writer_thread_->join();
     }
 }
 
+auto Generator::OpenSink() -> void {
+    std::string sink = config_.sink();
+    if (sink.empty()) {
+        const char* env_sink = std::getenv("GENERATOR_SINK");
+        sink = env_sink ? env_sink : "postgres";
+    }
+    if (sink == "postgres") {
+        if (!db_) { throw std::runtime_error("Postgres sink selected but no database client is configured"); }
+        return;
+    }
+    if (sink != "file") { throw std::invalid_argument("Unknown generator sink: " + sink); }
+
+    std::string dir = config_.output_dir();
+    if (dir.empty()) {
+        const char* env_dir = std::getenv("GENERATOR_OUTPUT_DIR");
+        dir = env_dir ? env_dir : "data/segments";
+    }
+    file_sink_ = std::make_unique<telemetry::SegmentWriter>(dir, run_id_, telemetry::SegmentOptions::FromEnv());
+    spdlog::info("Generation run {} writing segment files to {}", run_id_, file_sink_->RunDirectory());
+}
+
+auto Generator::SegmentPaths() const -> std::vector<std::string> {
+    return file_sink_ ? file_sink_->SegmentPaths() : std::vector<std::string>{};
+}
+
 auto Generator::EnqueueBatch(std::vector<TelemetryRecord> batch) -> void {
     std::unique_lock<std::mutex> lock(queue_mutex_);
-    if (write_queue_.size() >= max_queue_size_) {
-        telemetry::obs::EmitCounter("generator_dropped_batches", 1, "batches", "generator");
-        spdlog::warn("Generator write queue full ({} batches). Dropping batch.", write_queue_.size());
-        return;
+    if (write_queue_.size() >= max_queue_size_ && writer_running_) {
+        auto wait_start = std::chrono::steady_clock::now();
+        queue_space_cv_.wait(lock, [this]() { return write_queue_.size() < max_queue_size_ || !writer_running_; });
+        telemetry::obs::EmitHistogram("generator_enqueue_wait_ms",
+                                      std::chrono::duration<double, std::milli>(
+                                          std::chrono::steady_clock::now() - wait_start).count(),
+                                      "ms", "generator", {{"dataset_id", run_id_}});
     }
     write_queue_.push(std::move(batch));
     queue_cv_.notify_one();
 }
 
+auto Generator::ReportStatus(const std::string& status, long inserted_rows, const std::string& error) -> void {
+    if (db_) { db_->UpdateRunStatus(run_id_, status, inserted_rows, error); }
+    if (progress_) { progress_->Update(status, inserted_rows, error); }
+}
+
 auto Generator::WriterLoop() -> void {
     spdlog::info("Generator writer thread started for run {}", run_id_);
     while (writer_running_) {
@@ -63,12 +116,22 @@ auto Generator::WriterLoop() -> void {
             batch = std::move(write_queue_.front());
             write_queue_.pop();
         }
+        queue_space_cv_.notify_one();
         
         try {
-            db_->BatchInsertTelemetry(batch);
+            if (file_sink_) {
+                file_sink_->Append(batch);
+            } else {
+                db_->BatchInsertTelemetry(batch);
+            }
             telemetry::obs::EmitGauge("generator_write_queue_size", static_cast<double>(write_queue_.size()), "batches", "generator");
         } catch (const std::exception& e) {
-            spdlog::error("Async DB write failed for run {}: {}", run_id_, e.what());
+            spdlog::error("Async {} write failed for run {}: {}", file_sink_ ? "segment" : "DB", run_id_, e.what());
+            if (file_sink_) {
+                // Local disk errors do not heal; fail the run instead of dropping rows.
+                std::lock_guard<std::mutex> lock(writer_error_mutex_);
+                if (writer_error_.empty()) { writer_error_ = e.what(); }
+            }
         }
     }
     spdlog::info("Generator writer thread stopped for run {}", run_id_);
@@ -98,138 +161,59 @@ auto Generator::InitializeHosts() -> void {
     }
 }
 
-auto Generator::GenerateRecord(const HostProfile& host, 
-                                          std::chrono::system_clock::time_point timestamp) -> TelemetryRecord {
-    // Mutable host state requires passing by non-const reference or managing state elsewhere.
-    // Since we are iterating, let's cast away constness or update the vector in the loop.
-    // For MVP, we'll do the latter in the calling loop or just accept the const_cast for state updates 
-    // (dirty but keeps signature simple for now).
-    auto& mutable_host = const_cast<HostProfile&>(host);
+auto Generator::KernelConfig() const -> telemetry::GeneratorKernelConfig {
+    telemetry::GeneratorKernelConfig k;
+    k.seed = static_cast<uint64_t>(config_.seed());
+    if (config_.has_anomaly_config()) {
+        const auto& a = config_.anomaly_config();
+        k.anomalies_enabled = true;
+        k.point_rate = a.point_rate();
+        k.collective_rate = a.collective_rate();
+        k.correlation_break_rate = a.correlation_break_rate();
+        k.contextual_rate = a.contextual_rate();
+        k.burst_duration_points = a.burst_duration_points();
+    }
+    // Use fixed lag from config or default 2000ms; jitter (0-500ms) is added per record.
+    k.lag_ms = config_.timing_config().fixed_lag_ms();
+    if (k.lag_ms == 0) { k.lag_ms = 2000; }
+    return k;
+}
 
-    TelemetryRecord r;
+auto Generator::AppendSlice(const telemetry::HostSlice& slice, size_t index, const HostProfile& host,
+                            std::chrono::system_clock::time_point timestamp,
+                            std::vector<TelemetryRecord>& out) -> void {
+    TelemetryRecord& r = out.emplace_back();
     r.metric_timestamp = timestamp;
     r.run_id = run_id_;
     r.host_id = host.host_id;
     r.project_id = host.project_id;
     r.region = host.region;
     r.labels_json = host.labels_json;
-    
-    // Time since epoch in hours for seasonality
-    auto duration = timestamp.time_since_epoch();
-    double hours = static_cast<double>(std::chrono::duration_cast<std::chrono::seconds>(duration).count()) / 3600.0;
-    
-    // Seasonality
-    double daily = 10.0 * std::sin((2 * M_PI * hours / 24.0) + host.phase_shift);
-    double weekly = 5.0 * std::sin((2 * M_PI * hours / 168.0));
-    
-    std::uniform_real_distribution<double> noise_dist(-10.0, 10.0);
-    double noise = noise_dist(rng_);
-
-    
-    double cpu = host.cpu_base + daily + weekly + noise;
-    
-    // Anomaly Probability Checks
-    std::uniform_real_distribution<double> prob_dist(0.0, 1.0);
-    double p = prob_dist(rng_);
-    bool is_anomaly = false;
-    std::string type;
-
-    // 1. Collective / Burst Anomaly (Stateful)
-    // If not already in burst, check start probability
-    if (mutable_host.burst_remaining > 0) {
-        mutable_host.burst_remaining--;
-        cpu += 40.0; // Sustained load
-        is_anomaly = true;
-        type = "COLLECTIVE_BURST";
-    } else if (config_.has_anomaly_config() && p < config_.anomaly_config().collective_rate()) {
-        mutable_host.burst_remaining = config_.anomaly_config().burst_duration_points();
-        if (mutable_host.burst_remaining == 0) { mutable_host.burst_remaining = 5; } // default
-        cpu += 40.0;
-        is_anomaly = true;
-        type = "COLLECTIVE_BURST";
-    }
-
-    // 2. Correlation Break (Stateful)
-    if (mutable_host.correlation_break_remaining > 0) {
-        mutable_host.correlation_break_remaining--;
-        mutable_host.correlation_broken = true;
-        is_anomaly = true;
-        type = "CORRELATION_BREAK";
-    } else if (config_.has_anomaly_config() && p < config_.anomaly_config().correlation_break_rate()) {
-         mutable_host.correlation_break_remaining = 5;
-         mutable_host.correlation_broken = true;
-         is_anomaly = true;
-         type = "CORRELATION_BREAK";
-    } else {
-        mutable_host.correlation_broken = false;
-    }
-
-    // 3. Contextual Anomaly (Time based: 1AM-5AM UTC)
-    // Simple check: hours mod 24. Assuming simplified UTC.
-    int hour_of_day = static_cast<int>(static_cast<long>(hours) % 24);
-    // Check constraint if provided in config, otherwise default 1-5am logic check only if rate > 0
-    if (config_.has_anomaly_config() && config_.anomaly_config().contextual_rate() > 0) {
-        // Only trigger if random check passes AND we are in the window
-        double p_ctx = prob_dist(rng_);
-        if (hour_of_day >= 1 && hour_of_day <= 5 && p_ctx < config_.anomaly_config().contextual_rate()) {
-             std::uniform_real_distribution<double> spike_dist(0.0, 10.0);
-             cpu = 90.0 + spike_dist(rng_); // Pin high
-             is_anomaly = true;
-             type = (type.empty() ? "CONTEXTUAL" : type + ",CONTEXTUAL");
-        }
-    }
-
-    // 4. Point Spike (Transient)
-    if (config_.has_anomaly_config() && p < config_.anomaly_config().point_rate()) {
-        cpu += 50.0;
-        is_anomaly = true;
-        type = (type.empty() ? "POINT_SPIKE" : type + ",POINT_SPIKE");
-    }
-
-    // Clamp CPU
-    r.cpu_usage = std::max(0.0, std::min(100.0, cpu));
-    
-    // Derived Metrics
-    // Memory follows CPU unless Correlation Break
-    if (mutable_host.correlation_broken) {
-        // Inverse or decoupled
-        r.memory_usage = std::max(0.0, std::min(100.0, 100.0 - r.cpu_usage + noise));
-    } else {
-         std::uniform_real_distribution<double> mem_noise(-2.5, 2.5);
-         r.memory_usage = std::max(0.0, std::min(100.0, r.cpu_usage * 0.7 + 20.0 + mem_noise(rng_)));
-    }
-    
-    std::uniform_real_distribution<double> disk_noise(-5.0, 5.0);
-    r.disk_utilization = 30.0 + disk_noise(rng_); 
-    
-    // RX/TX
-    std::uniform_real_distribution<double> net_node(0.0, 10.0);
-    r.network_rx_rate = std::max(0.0, 10.0 + (daily/2.0) + net_node(rng_));
-    // Correlation break could also affect Network
-    if (mutable_host.correlation_broken) {
-         r.network_tx_rate = 1.0; // Data sink (high RX, low TX)
-         r.network_rx_rate += 50.0; // DDoS simulation
-    } else {
-         std::uniform_real_distribution<double> net_jitter(0.0, 5.0);
-         r.network_tx_rate = r.network_rx_rate * 0.8 + net_jitter(rng_);
-    }
-    
-    r.is_anomaly = is_anomaly;
-    r.anomaly_type = type;
+    r.cpu_usage = slice.cpu_usage[index];
+    r.memory_usage = slice.memory_usage[index];
+    r.disk_utilization = slice.disk_utilization[index];
+    r.network_rx_rate = slice.network_rx_rate[index];
+    r.network_tx_rate = slice.network_tx_rate[index];
+    r.is_anomaly = slice.is_anomaly[index] != 0;
+    r.anomaly_type = telemetry::GeneratorKernel::AnomalyTypeName(slice.anomaly_code[index]);
+    r.ingestion_time = timestamp + std::chrono::milliseconds(slice.lag_ms[index]);
+}
 
-    // Ingestion Lag
-    // Use fixed lag from config or default 2000ms
-    int lag_ms = config_.timing_config().fixed_lag_ms();
-    if (lag_ms == 0) { lag_ms = 2000; }
-    
-    // Add jitter (simple uniform for MVP, lognormal in full impl)
-    std::uniform_int_distribution<int> jitter_dist(0, 500);
-    int jitter = jitter_dist(rng_);
+auto Generator::GenerateRecord(const HostProfile& host, 
+                                          std::chrono::system_clock::time_point timestamp) -> TelemetryRecord {
+    // Anomaly state lives on the host profile, so write it back after the kernel advances it.
+    auto& mutable_host = const_cast<HostProfile&>(host);
+    std::vector<HostProfile> one = {host};
+    telemetry::GeneratorKernel kernel(KernelConfig(), one);
+    telemetry::HostSlice slice;
+    kernel.Fill(timestamp, one, slice);
+    mutable_host.burst_remaining = one[0].burst_remaining;
+    mutable_host.correlation_broken = one[0].correlation_broken;
+    mutable_host.correlation_break_remaining = one[0].correlation_break_remaining;
 
-    
-    r.ingestion_time = timestamp + std::chrono::milliseconds(lag_ms + jitter);
-    
-    return r;
+    std::vector<TelemetryRecord> out;
+    AppendSlice(slice, 0, host, timestamp, out);
+    return std::move(out.front());
 }
 
 
@@ -243,43 +227,69 @@ auto Generator::Run() -> void {
     telemetry::obs::ScopedContext scope(ctx);
     telemetry::obs::LogEvent(telemetry::obs::LogLevel::Info, "generation_start", "generator",
                              {{"request_id", config_.request_id()}, {"dataset_id", run_id_}});
+    // Row counts and liveness are coalesced off the generation thread.
+    telemetry::ProgressReporter reporter(
+        [this](const telemetry::ProgressSnapshot& p) {
+            if (db_) { db_->UpdateRunStatus(run_id_, "RUNNING", p.rows); }
+        },
+        [this]() {
+            if (db_) { db_->Heartbeat(IDbClient::JobType::Generation, run_id_); }
+        });
     try {
-        db_->CreateRun(run_id_, config_, "RUNNING", config_.request_id());
+        OpenSink();
+        if (db_) { db_->CreateRun(run_id_, config_, "RUNNING", config_.request_id()); }
+        if (progress_) { progress_->Update("RUNNING", 0); }
+        reporter.Start();
         
-        writer_running_ = true;
-        writer_thread_ = std::make_unique<std::thread>(&Generator::WriterLoop, this);
+        StartWriter();
 
         InitializeHosts();
         
         auto start = ParseTime(config_.start_time_iso());
         auto end = ParseTime(config_.end_time_iso());
+        if (db_) {
+            // ingestion_time trails metric time by the configured lag; make
+            // sure every month it can land in has a real partition rather
+            // than the DEFAULT one.
+            for (const auto& month : telemetry::partitions::MonthsCovering(start, end + std::chrono::hours(1))) {
+                db_->EnsurePartition(month.Begin());
+            }
+        }
         auto duration = std::chrono::seconds(config_.interval_seconds());
         if (duration.count() == 0) { duration = std::chrono::seconds(600); } // default 10m
         
         long total_rows = 0;
         std::vector<TelemetryRecord> batch;
         const int BATCH_SIZE = 5000;
+        batch.reserve(BATCH_SIZE);
+        telemetry::GeneratorKernel kernel(KernelConfig(), hosts_);
+        telemetry::HostSlice slice;
         
         for (auto t = start; t < end; t += duration) {
-            db_->Heartbeat(IDbClient::JobType::Generation, run_id_);
+            reporter.Beat();
             if (stop_flag_ && stop_flag_->load()) {
                 spdlog::info("Generation run {} cancelled by request.", run_id_);
-                db_->UpdateRunStatus(run_id_, "CANCELLED", total_rows);
+                reporter.Stop();
+                ReportStatus("CANCELLED", total_rows);
                 return;
             }
-            for (const auto& host : hosts_) {
-                batch.push_back(GenerateRecord(host, t));
+            kernel.Fill(t, hosts_, slice);
+            for (size_t i = 0; i < hosts_.size(); ++i) {
+                AppendSlice(slice, i, hosts_[i], t, batch);
                 if (batch.size() >= BATCH_SIZE) {
                     EnqueueBatch(std::move(batch));
                     batch.clear();
+                    batch.reserve(BATCH_SIZE);
                     
                     write_batches += 1;
                     total_rows += BATCH_SIZE;
-                    db_->UpdateRunStatus(run_id_, "RUNNING", total_rows);
+                    reporter.Update(total_rows);
+                    if (progress_) { progress_->Update("RUNNING", total_rows); }
                     
                     if (stop_flag_ && stop_flag_->load()) {
                         spdlog::info("Generation run {} cancelled by request.", run_id_);
-                        db_->UpdateRunStatus(run_id_, "CANCELLED", total_rows);
+                        reporter.Stop();
+                        ReportStatus("CANCELLED", total_rows);
                         return;
                     }
                 }
@@ -301,9 +311,21 @@ auto Generator::Run() -> void {
             }
             std::this_thread::sleep_for(std::chrono::milliseconds(100));
         }
+        // The last popped batch may still be in flight; join before finishing.
+        StopWriter();
+        if (file_sink_) {
+            {
+                std::lock_guard<std::mutex> lock(writer_error_mutex_);
+                if (!writer_error_.empty()) { throw std::runtime_error("Segment write failed: " + writer_error_); }
+            }
+            file_sink_->Finish();
+            telemetry::obs::EmitCounter("generation_bytes_written", file_sink_->BytesWritten(), "bytes", "generator",
+                                        {{"dataset_id", run_id_}});
+        }
 
         spdlog::info("Generation run {} complete. Total rows: {}", run_id_, total_rows);
-        db_->UpdateRunStatus(run_id_, "SUCCEEDED", total_rows);
+        reporter.Stop();
+        ReportStatus("SUCCEEDED", total_rows);
         auto end_time = std::chrono::steady_clock::now();
         double duration_ms = std::chrono::duration<double, std::milli>(end_time - start_time).count();
         telemetry::obs::EmitHistogram("generation_duration_ms", duration_ms, "ms", "generator",
@@ -320,7 +342,8 @@ auto Generator::Run() -> void {
         
     } catch (const std::exception& e) {
         spdlog::error("Generation run {} failed: {}", run_id_, e.what());
-        db_->UpdateRunStatus(run_id_, "FAILED", 0, e.what());
+        reporter.Stop();
+        ReportStatus("FAILED", 0, e.what());
         auto end_time = std::chrono::steady_clock::now();
         double duration_ms = std::chrono::duration<double, std::milli>(end_time - start_time).count();
         telemetry::obs::EmitHistogram("generation_duration_ms", duration_ms, "ms", "generator",
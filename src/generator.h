@@ -1,7 +1,10 @@
 #pragma once
 
 #include "types.h"
+#include "generator_kernel.h"
+#include "segment_file.h"
 #include "idb_client.h"
+#include "run_progress.h"
 #include "telemetry.grpc.pb.h"
 #include <atomic>
 #include <memory>
@@ -14,6 +17,8 @@
 
 class Generator {
 public:
+    // db_client may be null when the file sink is selected; run status is
+    // then only tracked in memory (SetProgress) and logs.
     Generator(const telemetry::GenerateRequest& request, 
               std::string run_id, 
               std::shared_ptr<IDbClient> db_client);
@@ -21,32 +26,54 @@ public:
 
     auto Run() -> void;
     auto SetStopFlag(const std::atomic<bool>* stop_flag) -> void { stop_flag_ = stop_flag; }
+    // Mirrors every status write into in-memory progress for WatchRun.
+    auto SetProgress(std::shared_ptr<telemetry::RunProgress> progress) -> void { progress_ = std::move(progress); }
+    // Segment files written by the file sink (empty for the Postgres sink).
+    auto SegmentPaths() const -> std::vector<std::string>;
 
 protected:
     telemetry::GenerateRequest config_;
     std::string run_id_;
     std::shared_ptr<IDbClient> db_;
     const std::atomic<bool>* stop_flag_ = nullptr;
+    std::shared_ptr<telemetry::RunProgress> progress_;
 
     
     std::vector<HostProfile> hosts_;
     
     auto InitializeHosts() -> void;
+    auto KernelConfig() const -> telemetry::GeneratorKernelConfig;
+    // Single-record path over the batch kernel (host index 0); Run() uses
+    // GeneratorKernel::Fill for whole host slices.
     auto GenerateRecord(const HostProfile& host, 
                                    std::chrono::system_clock::time_point timestamp) -> TelemetryRecord;
+    auto AppendSlice(const telemetry::HostSlice& slice, size_t index, const HostProfile& host,
+                     std::chrono::system_clock::time_point timestamp, std::vector<TelemetryRecord>& out) -> void;
     
+    auto ReportStatus(const std::string& status, long inserted_rows, const std::string& error = "") -> void;
     auto WriterLoop() -> void;
+    auto StartWriter() -> void;
+    auto StopWriter() -> void;
+    auto OpenSink() -> void;
+    // Blocks while the write queue is full, so a slow sink slows generation
+    // down instead of losing rows.
     auto EnqueueBatch(std::vector<TelemetryRecord> batch) -> void;
 
-    std::mt19937_64 rng_;
+    std::mt19937_64 rng_; // host baselines only; per-record draws come from the kernel
 
     // Bounded Queue
     std::queue<std::vector<TelemetryRecord>> write_queue_;
     std::mutex queue_mutex_;
     std::condition_variable queue_cv_;
+    std::condition_variable queue_space_cv_;
     size_t max_queue_size_ = 100; // batches
     std::atomic<bool> writer_running_{false};
     std::unique_ptr<std::thread> writer_thread_;
+
+    // File sink; when set, WriterLoop appends here instead of COPY.
+    std::unique_ptr<telemetry::SegmentWriter> file_sink_;
+    std::mutex writer_error_mutex_;
+    std::string writer_error_;
 };
 
 auto ParseTime(const std::string& iso) -> std::chrono::system_clock::time_point;
\ No newline at end of file
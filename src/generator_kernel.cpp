@@ -0,0 +1,206 @@
+#include "generator_kernel.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace telemetry {
+
+namespace {
+
+constexpr uint32_t kPhiloxM0 = 0xD2511F53;
+constexpr uint32_t kPhiloxM1 = 0xCD9E8D57;
+constexpr uint32_t kPhiloxW0 = 0x9E3779B9;
+constexpr uint32_t kPhiloxW1 = 0xBB67AE85;
+
+inline auto MulHiLo(uint32_t a, uint32_t b, uint32_t& hi) -> uint32_t {
+    uint64_t product = static_cast<uint64_t>(a) * b;
+    hi = static_cast<uint32_t>(product >> 32);
+    return static_cast<uint32_t>(product);
+}
+
+inline auto Clamp100(double v) -> double { return std::max(0.0, std::min(100.0, v)); }
+
+auto BuildAnomalyNames() -> std::array<std::string, 16> {
+    std::array<std::string, 16> names;
+    for (uint8_t code = 0; code < names.size(); ++code) {
+        std::string type;
+        if ((code & 3) == GeneratorKernel::kBurst) { type = "COLLECTIVE_BURST"; }
+        if ((code & 3) == GeneratorKernel::kCorrelationBreak) { type = "CORRELATION_BREAK"; }
+        if ((code & GeneratorKernel::kContextualBit) != 0) {
+            type = type.empty() ? "CONTEXTUAL" : type + ",CONTEXTUAL";
+        }
+        if ((code & GeneratorKernel::kPointBit) != 0) {
+            type = type.empty() ? "POINT_SPIKE" : type + ",POINT_SPIKE";
+        }
+        names[code] = type;
+    }
+    return names;
+}
+
+} // namespace
+
+auto Philox4x32::Generate(Block counter, Key key) -> Block {
+    for (int round = 0; round < 10; ++round) {
+        if (round > 0) {
+            key[0] += kPhiloxW0;
+            key[1] += kPhiloxW1;
+        }
+        uint32_t hi0 = 0;
+        uint32_t hi1 = 0;
+        uint32_t lo0 = MulHiLo(kPhiloxM0, counter[0], hi0);
+        uint32_t lo1 = MulHiLo(kPhiloxM1, counter[2], hi1);
+        counter = {hi1 ^ counter[1] ^ key[0], lo1, hi0 ^ counter[3] ^ key[1], lo0};
+    }
+    return counter;
+}
+
+auto HostSlice::Resize(size_t n) -> void {
+    cpu_usage.resize(n);
+    memory_usage.resize(n);
+    disk_utilization.resize(n);
+    network_rx_rate.resize(n);
+    network_tx_rate.resize(n);
+    is_anomaly.resize(n);
+    anomaly_code.resize(n);
+    lag_ms.resize(n);
+}
+
+GeneratorKernel::GeneratorKernel(const GeneratorKernelConfig& config, const std::vector<HostProfile>& hosts)
+    : config_(config),
+      key_{static_cast<uint32_t>(config.seed), static_cast<uint32_t>(config.seed >> 32)},
+      host_count_(hosts.size()),
+      uniforms_(kSlotCount * hosts.size()),
+      daily_(hosts.size()) {
+    if (config_.burst_duration_points <= 0) { config_.burst_duration_points = 5; }
+    phase_sin_.reserve(host_count_);
+    phase_cos_.reserve(host_count_);
+    for (const auto& host : hosts) {
+        phase_sin_.push_back(std::sin(host.phase_shift));
+        phase_cos_.push_back(std::cos(host.phase_shift));
+    }
+}
+
+auto GeneratorKernel::AnomalyTypeName(uint8_t code) -> const std::string& {
+    static const auto kNames = BuildAnomalyNames();
+    return kNames[code & 15];
+}
+
+auto GeneratorKernel::DrawUniforms(uint64_t timestamp_ms, size_t hosts) -> void {
+    // Counter = (timestamp lo, timestamp hi, host index, block); one Philox
+    // block yields four slots, written column-major so the arithmetic below
+    // walks contiguous memory.
+    for (size_t h = 0; h < hosts; ++h) {
+        for (size_t b = 0; b < kBlocksPerHost; ++b) {
+            Philox4x32::Block ctr = {static_cast<uint32_t>(timestamp_ms), static_cast<uint32_t>(timestamp_ms >> 32),
+                                     static_cast<uint32_t>(h), static_cast<uint32_t>(b)};
+            auto out = Philox4x32::Generate(ctr, key_);
+            for (size_t lane = 0; lane < 4; ++lane) {
+                size_t slot = b * 4 + lane;
+                if (slot >= kSlotCount) { break; }
+                uniforms_[slot * host_count_ + h] = Philox4x32::ToUnit(out[lane]);
+            }
+        }
+    }
+}
+
+auto GeneratorKernel::Fill(std::chrono::system_clock::time_point t, std::vector<HostProfile>& hosts,
+                           HostSlice& out) -> void {
+    if (hosts.size() != host_count_) {
+        throw std::invalid_argument("GeneratorKernel::Fill: host count changed since construction");
+    }
+    const size_t n = host_count_;
+    out.Resize(n);
+
+    auto seconds = std::chrono::duration_cast<std::chrono::seconds>(t.time_since_epoch()).count();
+    auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(t.time_since_epoch()).count();
+    DrawUniforms(static_cast<uint64_t>(millis), n);
+
+    // Seasonality, once per timestamp: sin(a + phase) = sin a cos phase + cos a sin phase.
+    double hours = static_cast<double>(seconds) / 3600.0;
+    double day_angle = 2 * M_PI * hours / 24.0;
+    double day_sin = std::sin(day_angle);
+    double day_cos = std::cos(day_angle);
+    double weekly = 5.0 * std::sin(2 * M_PI * hours / 168.0);
+    int hour_of_day = static_cast<int>(static_cast<long>(hours) % 24);
+    bool contextual_window = hour_of_day >= 1 && hour_of_day <= 5;
+
+    const double* noise_u = Column(kNoise);
+    const double* p_u = Column(kAnomalyP);
+    const double* ctx_u = Column(kContextualP);
+    const double* spike_u = Column(kSpike);
+    const double* mem_u = Column(kMemNoise);
+    const double* disk_u = Column(kDiskNoise);
+    const double* rx_u = Column(kNetRx);
+    const double* jitter_u = Column(kNetJitter);
+    const double* lag_u = Column(kLagJitter);
+
+    double* cpu = out.cpu_usage.data();
+    for (size_t i = 0; i < n; ++i) {
+        daily_[i] = 10.0 * (day_sin * phase_cos_[i] + day_cos * phase_sin_[i]);
+        cpu[i] = hosts[i].cpu_base + daily_[i] + weekly + (-10.0 + 20.0 * noise_u[i]);
+    }
+
+    // Stateful anomaly pass; same precedence as the per-record generator:
+    // burst, then correlation break (overrides the type), then contextual
+    // (pins CPU), then point spike.
+    for (size_t i = 0; i < n; ++i) {
+        auto& host = hosts[i];
+        double p = p_u[i];
+        uint8_t code = 0;
+
+        if (host.burst_remaining > 0) {
+            host.burst_remaining--;
+            cpu[i] += 40.0;
+            code = kBurst;
+        } else if (config_.anomalies_enabled && p < config_.collective_rate) {
+            host.burst_remaining = config_.burst_duration_points;
+            cpu[i] += 40.0;
+            code = kBurst;
+        }
+
+        if (host.correlation_break_remaining > 0) {
+            host.correlation_break_remaining--;
+            host.correlation_broken = true;
+            code = kCorrelationBreak;
+        } else if (config_.anomalies_enabled && p < config_.correlation_break_rate) {
+            host.correlation_break_remaining = 5;
+            host.correlation_broken = true;
+            code = kCorrelationBreak;
+        } else {
+            host.correlation_broken = false;
+        }
+
+        bool anomaly = code != 0;
+        if (config_.anomalies_enabled && config_.contextual_rate > 0 && contextual_window &&
+            ctx_u[i] < config_.contextual_rate) {
+            cpu[i] = 90.0 + 10.0 * spike_u[i];
+            code |= kContextualBit;
+            anomaly = true;
+        }
+        if (config_.anomalies_enabled && p < config_.point_rate) {
+            cpu[i] += 50.0;
+            code |= kPointBit;
+            anomaly = true;
+        }
+        out.anomaly_code[i] = code;
+        out.is_anomaly[i] = anomaly ? 1 : 0;
+    }
+
+    double* mem = out.memory_usage.data();
+    double* disk = out.disk_utilization.data();
+    double* rx = out.network_rx_rate.data();
+    double* tx = out.network_tx_rate.data();
+    for (size_t i = 0; i < n; ++i) {
+        cpu[i] = Clamp100(cpu[i]);
+        double noise = -10.0 + 20.0 * noise_u[i];
+        bool broken = hosts[i].correlation_broken;
+        mem[i] = broken ? Clamp100(100.0 - cpu[i] + noise) : Clamp100(cpu[i] * 0.7 + 20.0 + (-2.5 + 5.0 * mem_u[i]));
+        disk[i] = 30.0 + (-5.0 + 10.0 * disk_u[i]);
+        rx[i] = std::max(0.0, 10.0 + (daily_[i] / 2.0) + 10.0 * rx_u[i]);
+        tx[i] = broken ? 1.0 : rx[i] * 0.8 + 5.0 * jitter_u[i];
+        if (broken) { rx[i] += 50.0; }
+        out.lag_ms[i] = config_.lag_ms + static_cast<int>(lag_u[i] * 501.0);
+    }
+}
+
+} // namespace telemetry
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "types.h"
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace telemetry {
+
+/**
+ * @brief Philox4x32-10 counter-based generator.
+ *
+ * Output is a pure function of (counter, key), so a record's draws depend
+ * only on the seed, its timestamp and its host index, never on how many
+ * draws came before it.
+ */
+struct Philox4x32 {
+    using Block = std::array<uint32_t, 4>;
+    using Key = std::array<uint32_t, 2>;
+
+    static auto Generate(Block counter, Key key) -> Block;
+
+    // Maps a 32-bit draw to [0, 1).
+    static auto ToUnit(uint32_t x) -> double { return static_cast<double>(x) * 0x1.0p-32; }
+};
+
+struct GeneratorKernelConfig {
+    uint64_t seed = 0;
+    bool anomalies_enabled = false;
+    double point_rate = 0.0;
+    double collective_rate = 0.0;
+    double correlation_break_rate = 0.0;
+    double contextual_rate = 0.0;
+    int burst_duration_points = 5;
+    int lag_ms = 2000;
+};
+
+/**
+ * @brief Columnar output for one timestamp, indexed by host position.
+ */
+struct HostSlice {
+    std::vector<double> cpu_usage;
+    std::vector<double> memory_usage;
+    std::vector<double> disk_utilization;
+    std::vector<double> network_rx_rate;
+    std::vector<double> network_tx_rate;
+    std::vector<uint8_t> is_anomaly;
+    std::vector<uint8_t> anomaly_code; // see GeneratorKernel::AnomalyTypeName
+    std::vector<int> lag_ms;
+
+    auto Resize(size_t n) -> void;
+    auto Size() const -> size_t { return cpu_usage.size(); }
+};
+
+/**
+ * @brief Batch generation kernel: produces every host's metrics for one
+ * timestamp in a single pass.
+ *
+ * Seasonality is evaluated once per timestamp (the daily term is expanded
+ * with per-host phase sin/cos cached at construction), uniforms for the whole
+ * slice are drawn up front from Philox, and the arithmetic runs as flat loops
+ * over the columns. Only the stateful anomaly pass is per-host scalar code.
+ */
+class GeneratorKernel {
+public:
+    GeneratorKernel(const GeneratorKernelConfig& config, const std::vector<HostProfile>& hosts);
+
+    // Fills @p out for timestamp @p t and advances each host's anomaly state.
+    // @p hosts must be the vector the kernel was built from (same order).
+    auto Fill(std::chrono::system_clock::time_point t, std::vector<HostProfile>& hosts, HostSlice& out) -> void;
+
+    // Anomaly codes: low two bits are the stateful type (0 none,
+    // 1 COLLECTIVE_BURST, 2 CORRELATION_BREAK); kContextualBit and kPointBit
+    // append ",CONTEXTUAL" / ",POINT_SPIKE".
+    static constexpr uint8_t kBurst = 1;
+    static constexpr uint8_t kCorrelationBreak = 2;
+    static constexpr uint8_t kContextualBit = 4;
+    static constexpr uint8_t kPointBit = 8;
+    static auto AnomalyTypeName(uint8_t code) -> const std::string&;
+
+private:
+    enum Slot : size_t {
+        kNoise = 0,
+        kAnomalyP,
+        kContextualP,
+        kSpike,
+        kMemNoise,
+        kDiskNoise,
+        kNetRx,
+        kNetJitter,
+        kLagJitter,
+        kSlotCount
+    };
+    static constexpr size_t kBlocksPerHost = (kSlotCount + 3) / 4;
+
+    auto DrawUniforms(uint64_t timestamp_ms, size_t hosts) -> void;
+    auto Column(Slot slot) -> double* { return uniforms_.data() + static_cast<size_t>(slot) * host_count_; }
+
+    GeneratorKernelConfig config_;
+    Philox4x32::Key key_;
+    size_t host_count_;
+    std::vector<double> phase_sin_;
+    std::vector<double> phase_cos_;
+    std::vector<double> uniforms_; // kSlotCount columns of host_count_ draws
+    std::vector<double> daily_;
+};
+
+} // namespace telemetry
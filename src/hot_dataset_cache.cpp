@@ -0,0 +1,144 @@
+#include "hot_dataset_cache.h"
+#include <spdlog/spdlog.h>
+#include <chrono>
+#include <cstdlib>
+#include "obs/metrics.h"
+
+namespace telemetry::api {
+
+auto HotDatasetCache::HotDatasetCacheArgs::FromEnv() -> HotDatasetCacheArgs {
+    HotDatasetCacheArgs args;
+    if (const char* env_bytes = std::getenv("HOT_DATASET_CACHE_MAX_BYTES")) {
+        try { args.max_bytes = std::stoul(env_bytes); } catch (...) {}
+    }
+    return args;
+}
+
+HotDatasetCache::HotDatasetCache(HotDatasetCacheArgs args, Loader loader)
+    : max_bytes_(args.max_bytes), loader_(std::move(loader)) {
+    if (max_bytes_ > 0) {
+        worker_ = std::thread([this] { WorkerLoop(); });
+    }
+    spdlog::info("Initialized HotDatasetCache with max_bytes={}", max_bytes_);
+}
+
+HotDatasetCache::~HotDatasetCache() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        queue_.clear();
+    }
+    cv_.notify_all();
+    if (worker_.joinable()) { worker_.join(); }
+}
+
+auto HotDatasetCache::Acquire(const std::string& run_id, long expected_rows)
+    -> std::shared_ptr<const ColumnarDataset> {
+    if (max_bytes_ == 0) { return nullptr; }
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (auto it = index_.find(run_id); it != index_.end()) {
+        if (it->second->expected_rows == expected_rows) {
+            lru_.splice(lru_.begin(), lru_, it->second);
+            hits_++;
+            telemetry::obs::EmitCounter("hot_dataset_cache_hits", 1, "hits", "hot_dataset_cache");
+            return it->second->dataset;
+        }
+        EraseLocked(it->second); // loaded for another version of the run
+    }
+    misses_++;
+    telemetry::obs::EmitCounter("hot_dataset_cache_misses", 1, "misses", "hot_dataset_cache");
+    bool fits = expected_rows > 0 && static_cast<size_t>(expected_rows) * kEstimatedRowBytes <= max_bytes_;
+    if (fits && !stopping_ && pending_.emplace(run_id, false).second) {
+        queue_.push_back({run_id, expected_rows});
+        cv_.notify_one();
+    }
+    return nullptr;
+}
+
+auto HotDatasetCache::Invalidate(const std::string& run_id) -> void {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (auto p = pending_.find(run_id); p != pending_.end()) { p->second = true; }
+    if (auto it = index_.find(run_id); it != index_.end()) { EraseLocked(it->second); }
+    telemetry::obs::EmitGauge("hot_dataset_cache_bytes_used", static_cast<double>(current_bytes_), "bytes", "hot_dataset_cache");
+}
+
+auto HotDatasetCache::Clear() -> void {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& [run_id, invalidated] : pending_) { invalidated = true; }
+    lru_.clear();
+    index_.clear();
+    current_bytes_ = 0;
+    telemetry::obs::EmitGauge("hot_dataset_cache_bytes_used", 0.0, "bytes", "hot_dataset_cache");
+}
+
+auto HotDatasetCache::GetStats() const -> HotDatasetCache::CacheStats {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return {lru_.size(), current_bytes_, max_bytes_, hits_, misses_, loads_, load_failures_, evictions_};
+}
+
+auto HotDatasetCache::WorkerLoop() -> void {
+    while (true) {
+        LoadJob job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+            if (stopping_) { return; }
+            job = std::move(queue_.front());
+            queue_.pop_front();
+            if (auto p = pending_.find(job.run_id); p != pending_.end() && p->second) {
+                pending_.erase(p); // invalidated while queued
+                continue;
+            }
+        }
+
+        std::shared_ptr<ColumnarDataset> dataset;
+        auto started = std::chrono::steady_clock::now();
+        try {
+            dataset = loader_(job.run_id);
+        } catch (const std::exception& e) {
+            spdlog::warn("HotDatasetCache: loading {} failed: {}", job.run_id, e.what());
+            dataset.reset();
+        }
+        double elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        bool invalidated = false;
+        if (auto p = pending_.find(job.run_id); p != pending_.end()) {
+            invalidated = p->second;
+            pending_.erase(p);
+        }
+        if (!dataset) {
+            load_failures_++;
+            continue;
+        }
+        loads_++;
+        telemetry::obs::EmitHistogram("hot_dataset_load_ms", elapsed_ms, "ms", "hot_dataset_cache");
+        if (invalidated) { continue; }
+        spdlog::info("HotDatasetCache: loaded {} ({} rows, {} bytes) in {:.1f}ms",
+                     job.run_id, dataset->Size(), dataset->Bytes(), elapsed_ms);
+        InsertLocked(job.run_id, job.expected_rows, std::move(dataset));
+    }
+}
+
+auto HotDatasetCache::InsertLocked(const std::string& run_id, long expected_rows,
+                                   std::shared_ptr<const ColumnarDataset> dataset) -> void {
+    if (auto it = index_.find(run_id); it != index_.end()) { EraseLocked(it->second); }
+    if (dataset->Bytes() > max_bytes_) { return; }
+    while (!lru_.empty() && current_bytes_ + dataset->Bytes() > max_bytes_) {
+        EraseLocked(std::prev(lru_.end()));
+        evictions_++;
+        telemetry::obs::EmitCounter("hot_dataset_cache_evictions", 1, "evictions", "hot_dataset_cache");
+    }
+    current_bytes_ += dataset->Bytes();
+    lru_.push_front({run_id, expected_rows, std::move(dataset)});
+    index_[run_id] = lru_.begin();
+    telemetry::obs::EmitGauge("hot_dataset_cache_bytes_used", static_cast<double>(current_bytes_), "bytes", "hot_dataset_cache");
+}
+
+void HotDatasetCache::EraseLocked(EntryList::iterator it) {
+    current_bytes_ -= it->dataset->Bytes();
+    index_.erase(it->run_id);
+    lru_.erase(it);
+}
+
+} // namespace telemetry::api
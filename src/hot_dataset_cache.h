@@ -0,0 +1,110 @@
+#pragma once
+
+#include "columnar_dataset.h"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+namespace telemetry::api {
+
+/**
+ * @brief Keeps recently queried, finished datasets resident as
+ * ColumnarDataset objects under a byte budget.
+ *
+ * Acquire() never blocks on the database: a miss queues a load on a single
+ * background thread and returns nullptr so the caller answers from SQL;
+ * later requests for the same dataset are then served from memory. Least
+ * recently used datasets are evicted to stay under the budget.
+ */
+class HotDatasetCache {
+public:
+    struct HotDatasetCacheArgs {
+        size_t max_bytes = 256ULL * 1024ULL * 1024ULL; // 0 disables the cache
+
+        // HOT_DATASET_CACHE_MAX_BYTES
+        static auto FromEnv() -> HotDatasetCacheArgs;
+    };
+
+    // Rough resident size of one row, used to skip loads that cannot fit.
+    static constexpr size_t kEstimatedRowBytes = 65;
+
+    // Returns the run's dataset with Finish() already called.
+    using Loader = std::function<std::shared_ptr<ColumnarDataset>(const std::string& run_id)>;
+
+    HotDatasetCache(HotDatasetCacheArgs args, Loader loader);
+    ~HotDatasetCache();
+
+    HotDatasetCache(const HotDatasetCache&) = delete;
+    auto operator=(const HotDatasetCache&) -> HotDatasetCache& = delete;
+
+    /**
+     * @brief Returns the resident dataset, or nullptr after scheduling a
+     * background load (unless one is already queued or expected_rows cannot
+     * fit the budget). A dataset loaded for a different expected_rows (the
+     * run's row count changed, e.g. under retention) counts as a miss.
+     */
+    auto Acquire(const std::string& run_id, long expected_rows) -> std::shared_ptr<const ColumnarDataset>;
+
+    // Drops a dataset and discards any load of it already queued or in
+    // flight; loads of other runs are unaffected.
+    auto Invalidate(const std::string& run_id) -> void;
+    auto Clear() -> void;
+
+    struct CacheStats {
+        size_t size;
+        size_t bytes_used;
+        size_t max_bytes;
+        long long hits;
+        long long misses;
+        long long loads;
+        long long load_failures;
+        long long evictions;
+    };
+    auto GetStats() const -> CacheStats;
+
+private:
+    struct Entry {
+        std::string run_id;
+        long expected_rows;
+        std::shared_ptr<const ColumnarDataset> dataset;
+    };
+    using EntryList = std::list<Entry>;
+
+    struct LoadJob {
+        std::string run_id;
+        long expected_rows;
+    };
+
+    auto WorkerLoop() -> void;
+    auto InsertLocked(const std::string& run_id, long expected_rows,
+                      std::shared_ptr<const ColumnarDataset> dataset) -> void;
+    void EraseLocked(EntryList::iterator it);
+
+    size_t max_bytes_;
+    Loader loader_;
+    size_t current_bytes_ = 0;
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    EntryList lru_; // most recently used first
+    std::unordered_map<std::string, EntryList::iterator> index_;
+    std::deque<LoadJob> queue_;
+    // Runs queued or loading; set to true by Invalidate/Clear so that load
+    // is not published.
+    std::unordered_map<std::string, bool> pending_;
+    bool stopping_ = false;
+    std::thread worker_;
+
+    long long hits_ = 0;
+    long long misses_ = 0;
+    long long loads_ = 0;
+    long long load_failures_ = 0;
+    long long evictions_ = 0;
+};
+
+} // namespace telemetry::api
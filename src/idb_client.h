@@ -1,12 +1,18 @@
 #pragma once
 #include "types.h"
 #include "db_connection_manager.h"
+#include <memory>
 #include <vector>
 #include <string>
 #include <optional>
 #include <nlohmann/json.hpp>
+#include "json_stream.h"
 #include "telemetry.grpc.pb.h"
 
+namespace telemetry::api {
+class ColumnarDataset;
+}
+
 class IDbClient {
 public:
     virtual ~IDbClient() = default;
@@ -40,6 +46,14 @@ public:
     virtual auto Heartbeat(JobType type, const std::string& job_id) -> void = 0;
 
     virtual auto GetRunStatus(const std::string& run_id) -> telemetry::RunStatus = 0;
+    // GetRunStatus read from wherever the analytics reads go, so a cache
+    // version taken here never runs ahead of the data read after it.
+    virtual auto GetAnalyticsRunStatus(const std::string& run_id) -> telemetry::RunStatus {
+        return GetRunStatus(run_id);
+    }
+    // Keeps this thread's read-tagged analytics reads on one server (one
+    // replica connection, or the primary) until the handle is released.
+    virtual auto PinAnalyticsReads() -> std::shared_ptr<void> { return nullptr; }
 
     virtual auto CreateModelRun(const std::string& dataset_id, 
                                        const std::string& name,
@@ -85,6 +99,15 @@ public:
                                           int anomaly_count, 
                                           const nlohmann::json& details = {},
                                           double latency_ms = 0.0) -> void = 0;
+    // Same, with details already serialized (e.g. by JsonStreamWriter). The
+    // default parses it back; DbClient binds the text as is.
+    virtual auto UpdateInferenceRunStatusRaw(const std::string& inference_id,
+                                             const std::string& status,
+                                             int anomaly_count,
+                                             const std::string& details_json,
+                                             double latency_ms) -> void {
+        UpdateInferenceRunStatus(inference_id, status, anomaly_count, nlohmann::json::parse(details_json), latency_ms);
+    }
     
     virtual auto UpdateTrialEligibility(const std::string& model_run_id,
                                         bool is_eligible,
@@ -98,6 +121,24 @@ public:
     virtual auto InsertDatasetScores(const std::string& dataset_id,
                                      const std::string& model_run_id,
                                      const std::vector<std::pair<long, std::pair<double, bool>>>& scores) -> void = 0;
+    // Drops every score of the pair (its dataset_scores partition) so a
+    // rescore starts empty.
+    virtual auto ResetDatasetScores(const std::string& dataset_id,
+                                    const std::string& model_run_id) -> void = 0;
+    // Drops the pair's scores past a resume checkpoint: batches inserted
+    // after the last checkpoint was written would otherwise be scored twice.
+    virtual auto TruncateDatasetScores(const std::string& dataset_id,
+                                       const std::string& model_run_id,
+                                       long last_record_id) -> void = 0;
+
+    // Confusion counts, error histogram and per-dimension error stats a score
+    // job accumulated (telemetry::stats::EvalAggregates::ToJson()); /eval and
+    // /error_distribution read them instead of scanning dataset_scores.
+    virtual auto SaveEvalAggregates(const std::string& dataset_id,
+                                    const std::string& model_run_id,
+                                    const nlohmann::json& aggregates) -> void = 0;
+    virtual auto DeleteEvalAggregates(const std::string& dataset_id,
+                                      const std::string& model_run_id) -> void = 0;
 
     virtual auto GetDatasetRecordCount(const std::string& dataset_id) -> long = 0;
 
@@ -126,7 +167,8 @@ public:
                                          const std::string& is_anomaly,
                                          const std::string& anomaly_type,
                                          const std::string& start_time,
-                                         const std::string& end_time) -> nlohmann::json = 0;
+                                         const std::string& end_time,
+                                         const std::string& percentile_mode = "exact") -> nlohmann::json = 0;
     virtual auto GetHistogram(const std::string& run_id,
                                         const std::string& metric,
                                         int bins,
@@ -148,7 +190,31 @@ public:
                                                 const std::string& region,
                                                 const std::string& sort_by,
                                                 const std::string& sort_order,
-                                                const std::string& anchor_time) -> nlohmann::json = 0;
+                                                const std::string& anchor_time,
+                                                const std::string& cursor = "",
+                                                bool exact_count = false) -> nlohmann::json = 0;
+    // Streaming form of SearchDatasetRecords: runs the queries (and throws
+    // on failure) before returning, and the writer then emits the same
+    // fields into an open object. The default serializes the DOM; DbClient
+    // writes rows straight from the fetched result.
+    virtual auto QueryDatasetRecords(const std::string& run_id,
+                                     int limit,
+                                     int offset,
+                                     const std::string& start_time,
+                                     const std::string& end_time,
+                                     const std::string& is_anomaly,
+                                     const std::string& anomaly_type,
+                                     const std::string& host_id,
+                                     const std::string& region,
+                                     const std::string& sort_by,
+                                     const std::string& sort_order,
+                                     const std::string& anchor_time,
+                                     const std::string& cursor = "",
+                                     bool exact_count = false) -> telemetry::api::JsonFieldsWriter {
+        return [fields = SearchDatasetRecords(run_id, limit, offset, start_time, end_time, is_anomaly, anomaly_type,
+                                              host_id, region, sort_by, sort_order, anchor_time, cursor, exact_count)](
+                   telemetry::api::JsonStreamWriter& out) { out.Fields(fields); };
+    }
     virtual auto GetDatasetRecord(const std::string& run_id, long record_id) -> nlohmann::json = 0;
     virtual auto GetMetricStats(const std::string& run_id, const std::string& metric) -> nlohmann::json = 0;
     virtual auto GetDatasetMetricsSummary(const std::string& run_id) -> nlohmann::json = 0;
@@ -167,6 +233,17 @@ public:
                                      bool only_anomalies,
                                      double min_score,
                                      double max_score) -> nlohmann::json = 0;
+    // Streaming form of GetScores, as QueryDatasetRecords.
+    virtual auto QueryScores(const std::string& dataset_id,
+                             const std::string& model_run_id,
+                             int limit,
+                             int offset,
+                             bool only_anomalies,
+                             double min_score,
+                             double max_score) -> telemetry::api::JsonFieldsWriter {
+        return [fields = GetScores(dataset_id, model_run_id, limit, offset, only_anomalies, min_score, max_score)](
+                   telemetry::api::JsonStreamWriter& out) { out.Fields(fields); };
+    }
     virtual auto ListInferenceRuns(const std::string& dataset_id,
                                              const std::string& model_run_id,
                                              int limit,
@@ -199,6 +276,14 @@ public:
     
     virtual auto GetScoreJob(const std::string& job_id) -> nlohmann::json = 0;
     
+    // Newest score job for the pair (job_id, status, processed_rows), read
+    // like GetAnalyticsRunStatus; empty when there is none.
+    virtual auto GetAnalyticsLatestScoreJob(const std::string& dataset_id, const std::string& model_run_id)
+        -> nlohmann::json {
+        auto jobs = ListScoreJobs(1, 0, "", dataset_id, model_run_id);
+        return jobs.empty() ? nlohmann::json::object() : jobs[0];
+    }
+
     virtual auto ListScoreJobs(int limit,
                                          int offset,
                                          const std::string& status = "",
@@ -215,8 +300,15 @@ public:
         double disk = 0.0;
         double rx = 0.0;
         double tx = 0.0;
+        std::string region;
+        std::string project_id;
+        std::string anomaly_type; // "" when NULL
     };
     virtual auto FetchScoringRowsAfterRecord(const std::string& dataset_id,
                                                                 long last_record_id,
                                                                 int limit) -> std::vector<ScoringRow> = 0;
+
+    // Reads every row of a dataset into a finished columnar snapshot for the
+    // API server's hot-dataset cache; nullptr if the backend cannot.
+    virtual auto LoadColumnarDataset(const std::string& run_id) -> std::shared_ptr<telemetry::api::ColumnarDataset> = 0;
 };
\ No newline at end of file
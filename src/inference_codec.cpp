@@ -0,0 +1,365 @@
+#include "inference_codec.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+namespace telemetry::api {
+
+namespace {
+
+using telemetry::anomaly::FeatureVector;
+
+// Indexed like FeatureVector::data.
+constexpr std::array<std::string_view, FeatureVector::kSize> kFeatureKeys = {
+    "cpu_usage", "memory_usage", "disk_utilization", "network_rx_rate", "network_tx_rate"};
+
+// Skipped values may nest this deep before the body is rejected.
+constexpr int kMaxSkipDepth = 256;
+
+// Forward-only cursor over a JSON text. Strings come back as views into the
+// body unless they contain escapes, which are decoded into scratch.
+class JsonReader {
+public:
+    explicit JsonReader(std::string_view text) : p_(text.data()), end_(text.data() + text.size()), begin_(p_) {}
+
+    auto Peek() -> char {
+        SkipSpace();
+        if (p_ == end_) { Fail("unexpected end of input"); }
+        return *p_;
+    }
+
+    auto Consume(char c) -> bool {
+        if (Peek() != c) { return false; }
+        ++p_;
+        return true;
+    }
+
+    auto Expect(char c) -> void {
+        if (!Consume(c)) { Fail(std::string("expected '") + c + "'"); }
+    }
+
+    auto ExpectEnd() -> void {
+        SkipSpace();
+        if (p_ != end_) { Fail("unexpected trailing characters"); }
+    }
+
+    // Returns true and reads "null" if that is the next value.
+    auto ConsumeNull() -> bool {
+        if (Peek() != 'n') { return false; }
+        Literal("null");
+        return true;
+    }
+
+    auto String(std::string& scratch) -> std::string_view {
+        Expect('"');
+        const char* start = p_;
+        while (p_ != end_ && *p_ != '"' && *p_ != '\\') {
+            if (static_cast<unsigned char>(*p_) < 0x20) { Fail("control character in string"); }
+            ++p_;
+        }
+        if (p_ == end_) { Fail("unterminated string"); }
+        if (*p_ == '"') {
+            return {start, static_cast<size_t>(p_++ - start)};
+        }
+        scratch.assign(start, p_);
+        while (true) {
+            if (p_ == end_) { Fail("unterminated string"); }
+            char c = *p_++;
+            if (c == '"') { return scratch; }
+            if (static_cast<unsigned char>(c) < 0x20) { Fail("control character in string"); }
+            if (c != '\\') {
+                scratch += c;
+                continue;
+            }
+            if (p_ == end_) { Fail("unterminated string"); }
+            switch (*p_++) {
+                case '"': scratch += '"'; break;
+                case '\\': scratch += '\\'; break;
+                case '/': scratch += '/'; break;
+                case 'b': scratch += '\b'; break;
+                case 'f': scratch += '\f'; break;
+                case 'n': scratch += '\n'; break;
+                case 'r': scratch += '\r'; break;
+                case 't': scratch += '\t'; break;
+                case 'u': AppendCodePoint(scratch); break;
+                default: Fail("invalid escape");
+            }
+        }
+    }
+
+    auto Number() -> double {
+        SkipSpace();
+        const char* start = p_;
+        if (p_ != end_ && *p_ == '-') { ++p_; }
+        if (p_ == end_ || !IsDigit(*p_)) { Fail("invalid number"); }
+        if (*p_ == '0') {
+            ++p_;
+        } else {
+            Digits();
+        }
+        if (p_ != end_ && *p_ == '.') {
+            ++p_;
+            if (p_ == end_ || !IsDigit(*p_)) { Fail("invalid number"); }
+            Digits();
+        }
+        if (p_ != end_ && (*p_ == 'e' || *p_ == 'E')) {
+            ++p_;
+            if (p_ != end_ && (*p_ == '+' || *p_ == '-')) { ++p_; }
+            if (p_ == end_ || !IsDigit(*p_)) { Fail("invalid number"); }
+            Digits();
+        }
+        double value = 0.0;
+        auto [ptr, ec] = std::from_chars(start, p_, value);
+        if (ec != std::errc() || ptr != p_) { Fail("number out of range"); }
+        return value;
+    }
+
+    auto Skip(int depth = 0) -> void {
+        if (depth > kMaxSkipDepth) { Fail("nesting too deep"); }
+        switch (Peek()) {
+            case '{':
+                ++p_;
+                if (Consume('}')) { return; }
+                do {
+                    String(scratch_);
+                    Expect(':');
+                    Skip(depth + 1);
+                } while (Consume(','));
+                Expect('}');
+                return;
+            case '[':
+                ++p_;
+                if (Consume(']')) { return; }
+                do { Skip(depth + 1); } while (Consume(','));
+                Expect(']');
+                return;
+            case '"': String(scratch_); return;
+            case 't': Literal("true"); return;
+            case 'f': Literal("false"); return;
+            case 'n': Literal("null"); return;
+            default: Number(); return;
+        }
+    }
+
+    [[noreturn]] auto Fail(const std::string& what) const -> void {
+        throw JsonSyntaxError("JSON parse error at byte " + std::to_string(p_ - begin_) + ": " + what);
+    }
+
+private:
+    static auto IsDigit(char c) -> bool { return c >= '0' && c <= '9'; }
+
+    auto Digits() -> void {
+        while (p_ != end_ && IsDigit(*p_)) { ++p_; }
+    }
+
+    auto SkipSpace() -> void {
+        while (p_ != end_ && (*p_ == ' ' || *p_ == '\n' || *p_ == '\r' || *p_ == '\t')) { ++p_; }
+    }
+
+    auto Literal(std::string_view word) -> void {
+        if (static_cast<size_t>(end_ - p_) < word.size() || std::string_view(p_, word.size()) != word) {
+            Fail("invalid literal");
+        }
+        p_ += word.size();
+    }
+
+    auto Hex4() -> uint32_t {
+        if (end_ - p_ < 4) { Fail("invalid \\u escape"); }
+        uint32_t cp = 0;
+        for (int i = 0; i < 4; ++i) {
+            char c = *p_++;
+            cp <<= 4;
+            if (c >= '0' && c <= '9') { cp |= static_cast<uint32_t>(c - '0'); }
+            else if (c >= 'a' && c <= 'f') { cp |= static_cast<uint32_t>(c - 'a' + 10); }
+            else if (c >= 'A' && c <= 'F') { cp |= static_cast<uint32_t>(c - 'A' + 10); }
+            else { Fail("invalid \\u escape"); }
+        }
+        return cp;
+    }
+
+    auto AppendCodePoint(std::string& out) -> void {
+        uint32_t cp = Hex4();
+        if (cp >= 0xD800 && cp <= 0xDBFF) {
+            if (end_ - p_ < 2 || p_[0] != '\\' || p_[1] != 'u') { Fail("unpaired surrogate"); }
+            p_ += 2;
+            uint32_t low = Hex4();
+            if (low < 0xDC00 || low > 0xDFFF) { Fail("unpaired surrogate"); }
+            cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+        } else if (cp >= 0xDC00 && cp <= 0xDFFF) {
+            Fail("unpaired surrogate");
+        }
+        if (cp < 0x80) {
+            out += static_cast<char>(cp);
+        } else if (cp < 0x800) {
+            out += static_cast<char>(0xC0 | (cp >> 6));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        } else if (cp < 0x10000) {
+            out += static_cast<char>(0xE0 | (cp >> 12));
+            out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        } else {
+            out += static_cast<char>(0xF0 | (cp >> 18));
+            out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        }
+    }
+
+    const char* p_;
+    const char* end_;
+    const char* begin_;
+    std::string scratch_;
+};
+
+auto ByteSwap(uint64_t v) -> uint64_t {
+    v = ((v & 0x00FF00FF00FF00FFULL) << 8) | ((v >> 8) & 0x00FF00FF00FF00FFULL);
+    v = ((v & 0x0000FFFF0000FFFFULL) << 16) | ((v >> 16) & 0x0000FFFF0000FFFFULL);
+    return (v << 32) | (v >> 32);
+}
+
+// Reads one row of little-endian float64 values from 40 unaligned bytes.
+auto DecodeRow(const char* bytes) -> FeatureVector {
+    FeatureVector v;
+    std::memcpy(v.data.data(), bytes, kBatchRowBytes);
+    if constexpr (std::endian::native == std::endian::big) {
+        for (double& d : v.data) { d = std::bit_cast<double>(ByteSwap(std::bit_cast<uint64_t>(d))); }
+    }
+    return v;
+}
+
+auto FeatureIndex(std::string_view key) -> int {
+    for (size_t i = 0; i < kFeatureKeys.size(); ++i) {
+        if (kFeatureKeys[i] == key) { return static_cast<int>(i); }
+    }
+    return -1;
+}
+
+auto ParseSample(JsonReader& in, std::string& scratch, size_t index) -> FeatureVector {
+    if (in.Peek() != '{') {
+        throw std::invalid_argument("samples[" + std::to_string(index) + "] must be an object");
+    }
+    FeatureVector v{};
+    in.Expect('{');
+    if (in.Consume('}')) { return v; }
+    do {
+        int feature = FeatureIndex(in.String(scratch));
+        in.Expect(':');
+        if (feature < 0) {
+            in.Skip();
+            continue;
+        }
+        char c = in.Peek();
+        if (c != '-' && (c < '0' || c > '9')) {
+            throw std::invalid_argument("samples[" + std::to_string(index) + "]." +
+                                        std::string(kFeatureKeys[static_cast<size_t>(feature)]) +
+                                        " must be a number");
+        }
+        v.data[static_cast<size_t>(feature)] = in.Number();
+    } while (in.Consume(','));
+    in.Expect('}');
+    return v;
+}
+
+auto ParseSamples(JsonReader& in, std::string& scratch, size_t max_samples) -> std::vector<FeatureVector> {
+    std::vector<FeatureVector> samples;
+    if (in.ConsumeNull()) { return samples; }
+    if (in.Peek() != '[') { throw std::invalid_argument("samples must be an array"); }
+    in.Expect('[');
+    if (in.Consume(']')) { return samples; }
+    do {
+        if (samples.size() >= max_samples) {
+            throw std::invalid_argument("Too many samples (max " + std::to_string(max_samples) + ")");
+        }
+        samples.push_back(ParseSample(in, scratch, samples.size()));
+    } while (in.Consume(','));
+    in.Expect(']');
+    return samples;
+}
+
+} // namespace
+
+auto ParseInferenceRequest(std::string_view body, size_t max_samples) -> InferenceRequest {
+    JsonReader in(body);
+    std::string scratch;
+    InferenceRequest out;
+    bool has_model = false;
+    bool has_samples = false;
+
+    if (in.Peek() != '{') { throw std::invalid_argument("request body must be a JSON object"); }
+    in.Expect('{');
+    if (!in.Consume('}')) {
+        do {
+            std::string key(in.String(scratch));
+            in.Expect(':');
+            if (key == "model_run_id") {
+                if (in.Peek() != '"') { throw std::invalid_argument("model_run_id must be a string"); }
+                out.model_run_id = std::string(in.String(scratch));
+                has_model = true;
+            } else if (key == "samples") {
+                out.samples = ParseSamples(in, scratch, max_samples);
+                has_samples = true;
+            } else {
+                in.Skip();
+            }
+        } while (in.Consume(','));
+        in.Expect('}');
+    }
+    in.ExpectEnd();
+
+    if (!has_model) { throw JsonMissingField("missing required field 'model_run_id'"); }
+    if (!has_samples) { throw JsonMissingField("missing required field 'samples'"); }
+    return out;
+}
+
+BatchRowDecoder::BatchRowDecoder(RowsFn on_rows, size_t batch_rows)
+    : on_rows_(std::move(on_rows)), batch_rows_(std::max<size_t>(1, batch_rows)) {
+    batch_.reserve(batch_rows_);
+}
+
+auto BatchRowDecoder::Feed(const char* data, size_t len) -> void {
+    if (partial_len_ > 0) {
+        size_t take = std::min(len, kBatchRowBytes - partial_len_);
+        std::memcpy(partial_.data() + partial_len_, data, take);
+        partial_len_ += take;
+        data += take;
+        len -= take;
+        if (partial_len_ < kBatchRowBytes) { return; }
+        batch_.push_back(DecodeRow(partial_.data()));
+        partial_len_ = 0;
+        if (batch_.size() == batch_rows_) { Emit(); }
+    }
+    while (len >= kBatchRowBytes) {
+        batch_.push_back(DecodeRow(data));
+        data += kBatchRowBytes;
+        len -= kBatchRowBytes;
+        if (batch_.size() == batch_rows_) { Emit(); }
+    }
+    std::memcpy(partial_.data(), data, len);
+    partial_len_ = len;
+}
+
+auto BatchRowDecoder::Finish() -> void {
+    if (partial_len_ > 0) {
+        throw std::invalid_argument("body length must be a multiple of " + std::to_string(kBatchRowBytes) +
+                                    " bytes (rows of 5 float64)");
+    }
+    if (!batch_.empty()) { Emit(); }
+}
+
+auto BatchRowDecoder::Emit() -> void {
+    on_rows_(batch_.data(), batch_.size());
+    rows_ += batch_.size();
+    batch_.clear();
+}
+
+auto StoreFloat64LE(std::vector<double>& values) -> void {
+    if constexpr (std::endian::native == std::endian::big) {
+        for (double& d : values) { d = std::bit_cast<double>(ByteSwap(std::bit_cast<uint64_t>(d))); }
+    }
+}
+
+} // namespace telemetry::api
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "contract.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace telemetry::api {
+
+// Body is not valid JSON (maps to E_HTTP_JSON_PARSE_ERROR).
+class JsonSyntaxError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+// A required member is absent (maps to E_HTTP_MISSING_FIELD).
+class JsonMissingField : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+struct InferenceRequest {
+    std::string model_run_id;
+    std::vector<telemetry::anomaly::FeatureVector> samples;
+};
+
+/**
+ * @brief Parses a POST /inference body in one pass, straight into feature
+ * vectors, without building a json DOM.
+ *
+ * Accepts the same bodies as the old nlohmann path: members in any order,
+ * unknown members skipped, missing features default to 0.0 and a null
+ * `samples` means no samples. Throws JsonSyntaxError for malformed JSON,
+ * JsonMissingField when `model_run_id` or `samples` is absent and
+ * std::invalid_argument for wrong types or more than max_samples samples.
+ */
+auto ParseInferenceRequest(std::string_view body, size_t max_samples) -> InferenceRequest;
+
+// One row of a POST /inference/batch body: the five features as
+// little-endian float64, in FeatureVector order.
+constexpr size_t kBatchRowBytes = telemetry::anomaly::FeatureVector::kSize * sizeof(double);
+
+/**
+ * @brief Turns a packed row-major float64 matrix, fed in chunks of any
+ * size, into batches of feature vectors.
+ *
+ * Rows split across chunks are carried over, and at most batch_rows rows
+ * are buffered, so memory does not grow with the body.
+ */
+class BatchRowDecoder {
+public:
+    using RowsFn = std::function<void(const telemetry::anomaly::FeatureVector* rows, size_t n)>;
+
+    static constexpr size_t kDefaultBatchRows = 4096;
+
+    explicit BatchRowDecoder(RowsFn on_rows, size_t batch_rows = kDefaultBatchRows);
+
+    auto Feed(const char* data, size_t len) -> void;
+    // Hands over the buffered rows; throws std::invalid_argument when the
+    // body ended inside a row.
+    auto Finish() -> void;
+
+    auto Rows() const -> size_t { return rows_; }
+
+private:
+    auto Emit() -> void;
+
+    RowsFn on_rows_;
+    std::vector<telemetry::anomaly::FeatureVector> batch_;
+    size_t batch_rows_;
+    std::array<char, kBatchRowBytes> partial_{};
+    size_t partial_len_ = 0;
+    size_t rows_ = 0;
+};
+
+// Puts each value's bytes in little-endian order, in place, so the vector
+// can be sent as a packed float64 array. A no-op on little-endian hosts.
+auto StoreFloat64LE(std::vector<double>& values) -> void;
+
+} // namespace telemetry::api
@@ -0,0 +1,199 @@
+#include "ingest.h"
+
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+
+#include <spdlog/spdlog.h>
+
+#include "obs/metrics.h"
+
+namespace telemetry::ingest {
+
+auto IngestDecoder::Decode(const TelemetryBatch& batch, std::vector<TelemetryRecord>& out) -> DecodeResult {
+    for (const auto& h : batch.hosts()) {
+        if (h.host_id().empty()) {
+            throw std::invalid_argument("IngestHost.host_id must not be empty");
+        }
+        hosts_.push_back(h);
+    }
+    for (const auto& t : batch.anomaly_types()) {
+        anomaly_types_.push_back(t);
+    }
+
+    const int n = batch.host_index_size();
+    if (batch.metric_timestamp_ms_size() != n ||
+        batch.cpu_usage_size() != n ||
+        batch.memory_usage_size() != n ||
+        batch.disk_utilization_size() != n ||
+        batch.network_rx_rate_size() != n ||
+        batch.network_tx_rate_size() != n) {
+        throw std::invalid_argument("TelemetryBatch metric columns must match host_index length");
+    }
+    if (batch.is_anomaly_size() != 0 && batch.is_anomaly_size() != n) {
+        throw std::invalid_argument("TelemetryBatch.is_anomaly must be empty or match host_index length");
+    }
+    if (batch.anomaly_type_index_size() != 0 && batch.anomaly_type_index_size() != n) {
+        throw std::invalid_argument("TelemetryBatch.anomaly_type_index must be empty or match host_index length");
+    }
+
+    DecodeResult result;
+    if (n == 0) { return result; }
+
+    const auto ingestion_time = std::chrono::system_clock::now();
+    const bool has_flags = batch.is_anomaly_size() == n;
+    const bool has_types = batch.anomaly_type_index_size() == n;
+    out.reserve(out.size() + static_cast<size_t>(n));
+
+    for (int i = 0; i < n; ++i) {
+        const uint32_t hi = batch.host_index(i);
+        if (hi >= hosts_.size()) {
+            throw std::invalid_argument("TelemetryBatch.host_index out of range: " + std::to_string(hi));
+        }
+        uint32_t ti = has_types ? batch.anomaly_type_index(i) : 0;
+        if (ti > anomaly_types_.size()) {
+            throw std::invalid_argument("TelemetryBatch.anomaly_type_index out of range: " + std::to_string(ti));
+        }
+
+        const double cpu = batch.cpu_usage(i);
+        const double mem = batch.memory_usage(i);
+        const double disk = batch.disk_utilization(i);
+        const double rx = batch.network_rx_rate(i);
+        const double tx = batch.network_tx_rate(i);
+        if (!std::isfinite(cpu) || !std::isfinite(mem) || !std::isfinite(disk) ||
+            !std::isfinite(rx) || !std::isfinite(tx)) {
+            result.rejected++;
+            continue;
+        }
+
+        const auto& host = hosts_[hi];
+        TelemetryRecord r;
+        r.metric_timestamp = std::chrono::system_clock::time_point(
+            std::chrono::milliseconds(batch.metric_timestamp_ms(i)));
+        r.ingestion_time = ingestion_time;
+        r.host_id = host.host_id();
+        r.project_id = host.project_id();
+        r.region = host.region();
+        r.labels_json = host.labels_json().empty() ? "{}" : host.labels_json();
+        r.cpu_usage = cpu;
+        r.memory_usage = mem;
+        r.disk_utilization = disk;
+        r.network_rx_rate = rx;
+        r.network_tx_rate = tx;
+        r.run_id = run_id_;
+        if (ti > 0) { r.anomaly_type = anomaly_types_[ti - 1]; }
+        r.is_anomaly = has_flags ? batch.is_anomaly(i) : ti > 0;
+        out.push_back(std::move(r));
+        result.accepted++;
+    }
+    return result;
+}
+
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+IngestSession::IngestSession(std::shared_ptr<IDbClient> db,
+                             std::shared_ptr<RunProgressRegistry> registry,
+                             Observer observer,
+                             size_t flush_rows)
+    : db_(std::move(db)),
+      registry_(std::move(registry)),
+      observer_(std::move(observer)),
+      flush_rows_(flush_rows > 0 ? flush_rows : 1) {}
+// NOLINTEND(bugprone-easily-swappable-parameters)
+
+auto IngestSession::Begin(const TelemetryBatch& first, const std::string& default_run_id) -> void {
+    start_time_ = std::chrono::steady_clock::now();
+    run_id_ = first.run_id().empty() ? default_run_id : first.run_id();
+    request_id_ = first.request_id();
+    if (!first.fan_out()) { observer_ = nullptr; }
+    decoder_ = std::make_unique<IngestDecoder>(run_id_);
+    pending_.reserve(flush_rows_);
+
+    spdlog::info("Received IngestTelemetry stream. RunID: {}, FanOut: {}", run_id_, observer_ != nullptr);
+
+    GenerateRequest run_config;
+    run_config.set_tier("INGEST");
+    run_config.set_request_id(request_id_);
+    db_->CreateRun(run_id_, run_config, "RUNNING", request_id_);
+    progress_ = registry_->Register(run_id_, request_id_);
+    progress_->Update("RUNNING", 0);
+}
+
+auto IngestSession::Append(const TelemetryBatch& batch) -> bool {
+    auto result = decoder_->Decode(batch, pending_);
+    accepted_rows_ += static_cast<long>(result.accepted);
+    rejected_rows_ += static_cast<long>(result.rejected);
+    batches_++;
+    return pending_.size() >= flush_rows_;
+}
+
+auto IngestSession::FlushAsync(std::function<void()> on_done) -> void {
+    if (in_flight_.valid()) {
+        throw std::logic_error("IngestSession::FlushAsync called with a chunk in flight");
+    }
+    auto chunk = std::make_shared<std::vector<TelemetryRecord>>(std::move(pending_));
+    pending_ = {};
+    pending_.reserve(flush_rows_);
+    in_flight_rows_ = static_cast<long>(chunk->size());
+    in_flight_ = std::async(std::launch::async, [db = db_, chunk, observer = observer_, on_done = std::move(on_done)]() {
+        struct Notify {
+            const std::function<void()>& fn;
+            ~Notify() { if (fn) { fn(); } }
+        } notify{on_done};
+        db->BatchInsertTelemetry(*chunk);
+        if (observer) { observer(*chunk); }
+    });
+    flushes_++;
+}
+
+auto IngestSession::CollectInFlight() -> void {
+    if (!in_flight_.valid()) { return; }
+    auto rows = in_flight_rows_;
+    in_flight_rows_ = 0;
+    in_flight_.get();
+    committed_rows_ += rows;
+    db_->Heartbeat(IDbClient::JobType::Generation, run_id_);
+    db_->UpdateRunStatus(run_id_, "RUNNING", committed_rows_);
+    progress_->Update("RUNNING", committed_rows_);
+}
+
+auto IngestSession::Complete(IngestResponse* response) -> void {
+    db_->UpdateRunStatus(run_id_, "SUCCEEDED", committed_rows_);
+    progress_->Update("SUCCEEDED", committed_rows_);
+
+    double duration_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start_time_).count();
+    telemetry::obs::EmitHistogram("ingest_duration_ms", duration_ms, "ms", "ingest",
+                                  {{"dataset_id", run_id_}});
+    EmitCounters();
+    FillResponse(response);
+}
+
+auto IngestSession::FillResponse(IngestResponse* response) const -> void {
+    response->set_run_id(run_id_);
+    response->set_accepted_rows(accepted_rows_);
+    response->set_rejected_rows(rejected_rows_);
+    response->set_batches(batches_);
+    response->set_flushes(flushes_);
+}
+
+auto IngestSession::Fail(const std::string& message) -> void {
+    if (in_flight_.valid()) {
+        try { in_flight_.get(); } catch (...) {} // NOLINT(bugprone-empty-catch)
+    }
+    spdlog::error("IngestTelemetry for run {} failed: {}", run_id_, message);
+    if (!progress_) { return; } // Begin() never ran
+    db_->UpdateRunStatus(run_id_, "FAILED", committed_rows_, message);
+    progress_->Update("FAILED", committed_rows_, message);
+    EmitCounters();
+}
+
+auto IngestSession::EmitCounters() -> void {
+    telemetry::obs::EmitCounter("ingest_rows_written", committed_rows_, "rows", "ingest",
+                                {{"dataset_id", run_id_}});
+    telemetry::obs::EmitCounter("ingest_rows_rejected", rejected_rows_, "rows", "ingest",
+                                {{"dataset_id", run_id_}});
+    telemetry::obs::EmitCounter("ingest_db_write_count", flushes_, "batches", "ingest",
+                                {{"dataset_id", run_id_}});
+}
+
+} // namespace telemetry::ingest
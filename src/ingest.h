@@ -0,0 +1,118 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "idb_client.h"
+#include "run_progress.h"
+#include "telemetry.pb.h"
+#include "types.h"
+
+namespace telemetry::ingest {
+
+struct DecodeResult {
+    size_t accepted = 0;
+    size_t rejected = 0;
+};
+
+/**
+ * @brief Converts columnar TelemetryBatch messages into TelemetryRecords.
+ *
+ * Host and anomaly-type dictionaries are accumulated across the batches of a
+ * single stream, so one decoder must be used per IngestTelemetry call.
+ */
+class IngestDecoder {
+public:
+    explicit IngestDecoder(std::string run_id) : run_id_(std::move(run_id)) {}
+
+    /**
+     * @brief Appends the rows of @p batch to @p out.
+     *
+     * Rows with non-finite metrics are counted as rejected and skipped.
+     * Throws std::invalid_argument when column lengths disagree or an index
+     * references a dictionary entry that has not been sent yet.
+     */
+    auto Decode(const TelemetryBatch& batch, std::vector<TelemetryRecord>& out) -> DecodeResult;
+
+    auto HostCount() const -> size_t { return hosts_.size(); }
+
+private:
+    std::string run_id_;
+    std::vector<IngestHost> hosts_;
+    std::vector<std::string> anomaly_types_;
+};
+
+/**
+ * @brief Write side of one IngestTelemetry stream, shared by the synchronous
+ * and completion-queue servers.
+ *
+ * Decoded rows accumulate until flush_rows, then go to BatchInsertTelemetry on
+ * a worker. Only one chunk may be in flight; callers stop reading from the
+ * stream until CollectInFlight() returns, which is what applies backpressure.
+ */
+class IngestSession {
+public:
+    using Observer = std::function<void(const std::vector<TelemetryRecord>&)>;
+
+    // NOLINTBEGIN(bugprone-easily-swappable-parameters)
+    IngestSession(std::shared_ptr<IDbClient> db,
+                  std::shared_ptr<RunProgressRegistry> registry,
+                  Observer observer,
+                  size_t flush_rows);
+    // NOLINTEND(bugprone-easily-swappable-parameters)
+
+    // Creates the run from the first batch of the stream.
+    auto Begin(const TelemetryBatch& first, const std::string& default_run_id) -> void;
+
+    // Decodes a batch. Returns true when a full chunk is ready to flush.
+    auto Append(const TelemetryBatch& batch) -> bool;
+
+    // Starts writing pending rows. @p on_done runs on the worker after the
+    // write finishes (successfully or not). Requires !HasInFlight().
+    auto FlushAsync(std::function<void()> on_done = nullptr) -> void;
+
+    // Waits for the outstanding chunk, rethrows its error, and checkpoints
+    // run status and heartbeat.
+    auto CollectInFlight() -> void;
+
+    auto Complete(IngestResponse* response) -> void;
+    // Writes the stream's counters into @p response without touching the run.
+    auto FillResponse(IngestResponse* response) const -> void;
+    auto Fail(const std::string& message) -> void;
+
+    auto HasInFlight() const -> bool { return in_flight_.valid(); }
+    auto HasPending() const -> bool { return !pending_.empty(); }
+    auto RunId() const -> const std::string& { return run_id_; }
+    auto RequestId() const -> const std::string& { return request_id_; }
+
+private:
+    auto EmitCounters() -> void;
+
+    std::shared_ptr<IDbClient> db_;
+    std::shared_ptr<RunProgressRegistry> registry_;
+    Observer observer_;
+    size_t flush_rows_;
+
+    std::string run_id_;
+    std::string request_id_;
+    std::unique_ptr<IngestDecoder> decoder_;
+    std::shared_ptr<RunProgress> progress_;
+    std::chrono::steady_clock::time_point start_time_;
+
+    std::vector<TelemetryRecord> pending_;
+    std::future<void> in_flight_;
+    long in_flight_rows_ = 0;
+    long committed_rows_ = 0;
+    long accepted_rows_ = 0;
+    long rejected_rows_ = 0;
+    long batches_ = 0;
+    long flushes_ = 0;
+};
+
+} // namespace telemetry::ingest
@@ -1,5 +1,6 @@
 #include "job_manager.h"
 #include "metrics.h"
+#include "db_connection_manager.h"
 #include <spdlog/spdlog.h>
 
 namespace telemetry {
@@ -56,6 +57,9 @@ auto JobManager::StartJob(const std::string& job_id, const std::string& request_
     telemetry::metrics::MetricsRegistry::Instance().SetGauge("job_active_count", static_cast<double>(current_jobs_));
 
     threads_[job_id] = std::thread([this, job_id, request_id, work, stop_flag]() {
+        // Jobs draw pooled connections from the batch lane, so they cannot
+        // starve interactive requests.
+        DbLaneScope lane(DbLane::Batch);
         try {
             spdlog::info("DEBUG: Starting job wrapper for {}", job_id);
             work(stop_flag.get());
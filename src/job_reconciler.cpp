@@ -1,5 +1,6 @@
 #include "job_reconciler.h"
 #include <spdlog/spdlog.h>
+#include "db_connection_manager.h"
 
 namespace telemetry {
 
@@ -20,6 +21,7 @@ auto JobReconciler::Start(std::chrono::milliseconds interval) -> void {
     if (running_) { return; }
     running_ = true;
     sweeper_thread_ = std::make_unique<std::thread>([this, interval]() {
+        DbLaneScope lane(DbLane::Maintenance);
         spdlog::info("JobReconciler periodic sweeper started (interval={}ms, TTL={}s).", 
                      interval.count(), stale_ttl_.count());
         while (running_) {
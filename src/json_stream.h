@@ -0,0 +1,241 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace telemetry::api {
+
+// Thrown by JsonStreamWriter when its sink refuses a chunk (client gone).
+class JsonStreamAborted : public std::runtime_error {
+public:
+    JsonStreamAborted() : std::runtime_error("JSON stream aborted by sink") {}
+};
+
+/**
+ * @brief Serializes JSON straight into one reusable buffer and hands it to
+ * a sink each time it passes flush_bytes.
+ *
+ * Large responses go out row by row without a DOM or a full body string,
+ * so memory stays at about one chunk. Text matches nlohmann::json::dump():
+ * floats always carry a '.' or exponent, and NaN/inf become null. The
+ * writer does not check nesting; it only inserts the commas.
+ */
+class JsonStreamWriter {
+public:
+    // Receives each chunk; returns false to abort (e.g. client disconnected).
+    using Sink = std::function<bool(std::string_view)>;
+
+    static constexpr size_t kDefaultFlushBytes = 64 * 1024;
+
+    explicit JsonStreamWriter(Sink sink, size_t flush_bytes = kDefaultFlushBytes)
+        : sink_(std::move(sink)), flush_bytes_(flush_bytes) {
+        buf_.reserve(flush_bytes_ + 1024);
+    }
+
+    auto BeginObject() -> JsonStreamWriter& { return Open('{'); }
+    auto EndObject() -> JsonStreamWriter& { return Close('}'); }
+    auto BeginArray() -> JsonStreamWriter& { return Open('['); }
+    auto EndArray() -> JsonStreamWriter& { return Close(']'); }
+
+    auto Key(std::string_view key) -> JsonStreamWriter& {
+        Separate();
+        AppendString(key);
+        buf_ += ':';
+        after_key_ = true;
+        return *this;
+    }
+
+    auto String(std::string_view value) -> JsonStreamWriter& {
+        Separate();
+        AppendString(value);
+        return Done();
+    }
+
+    auto Int(int64_t value) -> JsonStreamWriter& {
+        Separate();
+        AppendChars(value);
+        return Done();
+    }
+
+    auto Unsigned(uint64_t value) -> JsonStreamWriter& {
+        Separate();
+        AppendChars(value);
+        return Done();
+    }
+
+    auto Double(double value) -> JsonStreamWriter& {
+        Separate();
+        if (!std::isfinite(value)) {
+            buf_ += "null";
+            return Done();
+        }
+        char tmp[32];
+        auto [end, ec] = std::to_chars(tmp, tmp + sizeof(tmp), value);
+        std::string_view text(tmp, static_cast<size_t>(end - tmp));
+        buf_ += text;
+        if (text.find_first_of(".e") == std::string_view::npos) { buf_ += ".0"; }
+        return Done();
+    }
+
+    auto Bool(bool value) -> JsonStreamWriter& {
+        Separate();
+        buf_ += value ? "true" : "false";
+        return Done();
+    }
+
+    auto Null() -> JsonStreamWriter& {
+        Separate();
+        buf_ += "null";
+        return Done();
+    }
+
+    // An already-serialized JSON value, e.g. a jsonb column's text.
+    auto Raw(std::string_view json) -> JsonStreamWriter& {
+        Separate();
+        buf_ += json;
+        return Done();
+    }
+
+    auto Value(const nlohmann::json& j) -> JsonStreamWriter& {
+        switch (j.type()) {
+            case nlohmann::json::value_t::object:
+                BeginObject();
+                Fields(j);
+                return EndObject();
+            case nlohmann::json::value_t::array:
+                BeginArray();
+                for (const auto& item : j) { Value(item); }
+                return EndArray();
+            case nlohmann::json::value_t::string:
+                return String(j.get_ref<const std::string&>());
+            case nlohmann::json::value_t::boolean:
+                return Bool(j.get<bool>());
+            case nlohmann::json::value_t::number_integer:
+                return Int(j.get<int64_t>());
+            case nlohmann::json::value_t::number_unsigned:
+                return Unsigned(j.get<uint64_t>());
+            case nlohmann::json::value_t::number_float:
+                return Double(j.get<double>());
+            case nlohmann::json::value_t::null:
+                return Null();
+            default:
+                return Raw(j.dump());
+        }
+    }
+
+    // Writes each member of object into the currently open object.
+    auto Fields(const nlohmann::json& object) -> JsonStreamWriter& {
+        for (const auto& [key, value] : object.items()) {
+            Key(key);
+            Value(value);
+        }
+        return *this;
+    }
+
+    // Hands whatever is buffered to the sink; the buffer keeps its capacity.
+    auto Flush() -> void {
+        if (buf_.empty()) { return; }
+        if (!sink_(buf_)) { throw JsonStreamAborted(); }
+        bytes_flushed_ += buf_.size();
+        buf_.clear();
+    }
+
+    auto BytesWritten() const -> size_t { return bytes_flushed_ + buf_.size(); }
+
+private:
+    auto Open(char c) -> JsonStreamWriter& {
+        Separate();
+        buf_ += c;
+        first_.push_back(true);
+        return *this;
+    }
+
+    auto Close(char c) -> JsonStreamWriter& {
+        first_.pop_back();
+        buf_ += c;
+        return Done();
+    }
+
+    auto Separate() -> void {
+        if (after_key_) {
+            after_key_ = false;
+            return;
+        }
+        if (first_.empty()) { return; }
+        if (!first_.back()) { buf_ += ','; }
+        first_.back() = false;
+    }
+
+    auto Done() -> JsonStreamWriter& {
+        if (buf_.size() >= flush_bytes_) { Flush(); }
+        return *this;
+    }
+
+    template <typename T>
+    auto AppendChars(T value) -> void {
+        char tmp[24];
+        auto [end, ec] = std::to_chars(tmp, tmp + sizeof(tmp), value);
+        buf_.append(tmp, static_cast<size_t>(end - tmp));
+    }
+
+    auto AppendString(std::string_view s) -> void {
+        static constexpr char kHex[] = "0123456789abcdef";
+        buf_ += '"';
+        for (char ch : s) {
+            auto c = static_cast<unsigned char>(ch);
+            switch (c) {
+                case '"': buf_ += "\\\""; break;
+                case '\\': buf_ += "\\\\"; break;
+                case '\b': buf_ += "\\b"; break;
+                case '\f': buf_ += "\\f"; break;
+                case '\n': buf_ += "\\n"; break;
+                case '\r': buf_ += "\\r"; break;
+                case '\t': buf_ += "\\t"; break;
+                default:
+                    if (c < 0x20) {
+                        buf_ += "\\u00";
+                        buf_ += kHex[c >> 4];
+                        buf_ += kHex[c & 0xF];
+                    } else {
+                        buf_ += ch;
+                    }
+            }
+        }
+        buf_ += '"';
+    }
+
+    Sink sink_;
+    size_t flush_bytes_;
+    std::string buf_;
+    std::vector<bool> first_; // per open container: no member written yet
+    bool after_key_ = false;
+    size_t bytes_flushed_ = 0;
+};
+
+// Writes the members of an already fetched result into an open object.
+using JsonFieldsWriter = std::function<void(JsonStreamWriter&)>;
+
+// Runs write_fields inside an object on an in-memory writer and parses the
+// text, for callers that still want a DOM.
+inline auto CollectJsonObject(const std::function<void(JsonStreamWriter&)>& write_fields) -> nlohmann::json {
+    std::string text;
+    JsonStreamWriter out([&text](std::string_view chunk) {
+        text.append(chunk);
+        return true;
+    });
+    out.BeginObject();
+    write_fields(out);
+    out.EndObject();
+    out.Flush();
+    return nlohmann::json::parse(text);
+}
+
+} // namespace telemetry::api
@@ -1,8 +1,14 @@
 #include <iostream>
 #include <string>
+#include <algorithm>
+#include <chrono>
+#include <thread>
 #include <spdlog/spdlog.h>
 #include <grpcpp/grpcpp.h>
+#include "async_server.h"
 #include "server.h"
+#include "db_client.h"
+#include "partition_manager.h"
 
 void RunServer() {
     std::string server_address("0.0.0.0:50051");
@@ -12,14 +18,52 @@ void RunServer() {
     
     TelemetryServiceImpl service(db_conn_str);
 
-    grpc::ServerBuilder builder;
+    if (const char* watch_env = std::getenv("WATCH_RUN_INTERVAL_MS")) {
+        try {
+            service.SetWatchInterval(std::chrono::milliseconds(std::stoul(watch_env)));
+        } catch (...) {
+            spdlog::warn("Invalid WATCH_RUN_INTERVAL_MS: {}. Using default.", watch_env);
+        }
+    }
+    if (const char* flush_env = std::getenv("INGEST_FLUSH_ROWS")) {
+        try {
+            service.SetIngestFlushRows(std::stoul(flush_env));
+        } catch (...) {
+            spdlog::warn("Invalid INGEST_FLUSH_ROWS: {}. Using default.", flush_env);
+        }
+    }
+
+    size_t polling_threads = std::max(2U, std::thread::hardware_concurrency());
+    if (const char* pollers_env = std::getenv("GRPC_POLLING_THREADS")) {
+        try {
+            polling_threads = std::stoul(pollers_env);
+        } catch (...) {
+            spdlog::warn("Invalid GRPC_POLLING_THREADS: {}. Using default: {}", pollers_env, polling_threads);
+        }
+    }
+
+    size_t blocking_threads = AsyncTelemetryServer::kDefaultBlockingThreads;
+    if (const char* blocking_env = std::getenv("GRPC_BLOCKING_THREADS")) {
+        try {
+            blocking_threads = std::stoul(blocking_env);
+        } catch (...) {
+            spdlog::warn("Invalid GRPC_BLOCKING_THREADS: {}. Using default: {}", blocking_env, blocking_threads);
+        }
+    }
+
+    // Pre-create upcoming month partitions and apply retention hourly.
+    auto partition_db = service.NewDbClient();
+    telemetry::partitions::PartitionMaintainer partitions([partition_db]() {
+        DbLaneScope lane(DbLane::Maintenance);
+        partition_db->MaintainPartitions();
+    });
+    partitions.Start();
 
-    builder.AddListeningPort(server_address, grpc::InsecureServerCredentials());
-    builder.RegisterService(&service);
-    std::unique_ptr<grpc::Server> server(builder.BuildAndStart());
+    AsyncTelemetryServer server(service, polling_threads, blocking_threads);
+    server.Start(server_address);
     
     spdlog::info("Server listening on {}", server_address);
-    server->Wait();
+    server.Wait();
 }
 
 auto main() -> int {
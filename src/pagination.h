@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstdint>
 #include <optional>
+#include <string>
 
 namespace telemetry::api {
 
@@ -11,4 +13,75 @@ inline auto HasMore(int limit, int offset, int returned, std::optional<long> tot
     return returned >= limit;
 }
 
-}  // namespace telemetry::api
\ No newline at end of file
+// Keyset position after the last row of a record search page: its
+// metric_timestamp (epoch microseconds) and record_id, plus the sort
+// direction the page was read in.
+struct SearchCursor {
+    int64_t ts_us = 0;
+    long record_id = 0;
+    std::string sort_order = "desc";
+};
+
+namespace detail {
+constexpr const char* kCursorAlphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+}
+
+// Opaque to clients: unpadded base64url of "v1:<ts_us>:<record_id>:<asc|desc>".
+inline auto EncodeSearchCursor(const SearchCursor& cursor) -> std::string {
+    std::string raw = "v1:" + std::to_string(cursor.ts_us) + ":" + std::to_string(cursor.record_id) + ":" + cursor.sort_order;
+    std::string out;
+    uint32_t acc = 0;
+    int bits = 0;
+    for (unsigned char c : raw) {
+        acc = (acc << 8) | c;
+        bits += 8;
+        while (bits >= 6) {
+            bits -= 6;
+            out += detail::kCursorAlphabet[(acc >> bits) & 0x3F];
+        }
+    }
+    if (bits > 0) { out += detail::kCursorAlphabet[(acc << (6 - bits)) & 0x3F]; }
+    return out;
+}
+
+inline auto DecodeSearchCursor(const std::string& token) -> std::optional<SearchCursor> {
+    std::string raw;
+    uint32_t acc = 0;
+    int bits = 0;
+    for (char c : token) {
+        int v = -1;
+        if (c >= 'A' && c <= 'Z') { v = c - 'A'; }
+        else if (c >= 'a' && c <= 'z') { v = c - 'a' + 26; }
+        else if (c >= '0' && c <= '9') { v = c - '0' + 52; }
+        else if (c == '-') { v = 62; }
+        else if (c == '_') { v = 63; }
+        else { return std::nullopt; }
+        acc = (acc << 6) | static_cast<uint32_t>(v);
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            raw += static_cast<char>((acc >> bits) & 0xFF);
+        }
+    }
+    if (raw.rfind("v1:", 0) != 0) { return std::nullopt; }
+    auto p1 = raw.find(':', 3);
+    auto p2 = p1 == std::string::npos ? p1 : raw.find(':', p1 + 1);
+    if (p2 == std::string::npos) { return std::nullopt; }
+    SearchCursor cursor;
+    try {
+        size_t used = 0;
+        std::string ts = raw.substr(3, p1 - 3);
+        cursor.ts_us = std::stoll(ts, &used);
+        if (used != ts.size()) { return std::nullopt; }
+        std::string id = raw.substr(p1 + 1, p2 - p1 - 1);
+        cursor.record_id = std::stol(id, &used);
+        if (used != id.size()) { return std::nullopt; }
+    } catch (...) {
+        return std::nullopt;
+    }
+    cursor.sort_order = raw.substr(p2 + 1);
+    if (cursor.sort_order != "asc" && cursor.sort_order != "desc") { return std::nullopt; }
+    return cursor;
+}
+
+}  // namespace telemetry::api
@@ -0,0 +1,149 @@
+#include "partition_manager.h"
+#include <spdlog/spdlog.h>
+#include <fmt/format.h>
+#include <algorithm>
+#include <cstdlib>
+#include <ctime>
+#include <regex>
+
+namespace telemetry::partitions {
+
+namespace {
+
+constexpr const char* kParent = "host_telemetry_archival";
+
+} // namespace
+
+auto PartitionPolicy::FromEnv() -> PartitionPolicy {
+    PartitionPolicy policy;
+    if (const char* env = std::getenv("PARTITION_PREMAKE_MONTHS")) {
+        try { policy.premake_months = std::max(0, std::stoi(env)); } catch (...) {}
+    }
+    if (const char* env = std::getenv("PARTITION_HASH_MODULUS")) {
+        try { policy.hash_modulus = std::max(0, std::stoi(env)); } catch (...) {}
+    }
+    if (const char* env = std::getenv("TELEMETRY_RETENTION_DAYS")) {
+        try { policy.retention_days = std::max(0, std::stoi(env)); } catch (...) {}
+    }
+    if (const char* env = std::getenv("SCORE_SET_PARTITIONS")) {
+        std::string value(env);
+        policy.score_set_partitions = value != "0" && value != "false";
+    }
+    return policy;
+}
+
+auto MonthPartition::Name() const -> std::string {
+    return fmt::format("{}_{:04d}_{:02d}", kParent, year, month);
+}
+
+auto MonthPartition::From() const -> std::string {
+    return fmt::format("{:04d}-{:02d}-01", year, month);
+}
+
+auto MonthPartition::To() const -> std::string {
+    return Next().From();
+}
+
+auto MonthPartition::Next() const -> MonthPartition {
+    return month == 12 ? MonthPartition{year + 1, 1} : MonthPartition{year, month + 1};
+}
+
+auto MonthPartition::Begin() const -> std::chrono::system_clock::time_point {
+    std::tm tm{};
+    tm.tm_year = year - 1900;
+    tm.tm_mon = month - 1;
+    tm.tm_mday = 1;
+    return std::chrono::system_clock::from_time_t(timegm(&tm));
+}
+
+auto MonthPartition::End() const -> std::chrono::system_clock::time_point {
+    return Next().Begin();
+}
+
+auto MonthPartition::LeafName(int remainder) const -> std::string {
+    return fmt::format("{}_p{}", Name(), remainder);
+}
+
+auto MonthOf(std::chrono::system_clock::time_point tp) -> MonthPartition {
+    auto tt = std::chrono::system_clock::to_time_t(tp);
+    std::tm tm{};
+    gmtime_r(&tt, &tm);
+    return {tm.tm_year + 1900, tm.tm_mon + 1};
+}
+
+auto MonthsCovering(std::chrono::system_clock::time_point start,
+                    std::chrono::system_clock::time_point end) -> std::vector<MonthPartition> {
+    std::vector<MonthPartition> months;
+    if (end < start) { return months; }
+    auto last = MonthOf(end);
+    for (auto m = MonthOf(start);; m = m.Next()) {
+        months.push_back(m);
+        if (m == last) { break; }
+    }
+    return months;
+}
+
+auto ParseMonthPartition(const std::string& name) -> std::optional<MonthPartition> {
+    static const std::regex kPattern(std::string(kParent) + "_(\\d{4})_(\\d{2})");
+    std::smatch match;
+    if (!std::regex_match(name, match, kPattern)) { return std::nullopt; }
+    MonthPartition m{std::stoi(match[1].str()), std::stoi(match[2].str())};
+    if (m.month < 1 || m.month > 12) { return std::nullopt; }
+    return m;
+}
+
+auto ExpiredMonths(const std::vector<std::string>& partition_names,
+                   std::chrono::system_clock::time_point cutoff) -> std::vector<MonthPartition> {
+    std::vector<MonthPartition> expired;
+    for (const auto& name : partition_names) {
+        auto m = ParseMonthPartition(name);
+        if (m && m->End() <= cutoff) { expired.push_back(*m); }
+    }
+    return expired;
+}
+
+auto ScoreSetPartitionName(long score_set_id) -> std::string {
+    return fmt::format("dataset_scores_{}", score_set_id);
+}
+
+PartitionMaintainer::PartitionMaintainer(std::function<void()> sweep) : sweep_(std::move(sweep)) {}
+
+PartitionMaintainer::~PartitionMaintainer() {
+    Stop();
+}
+
+void PartitionMaintainer::Start(std::chrono::milliseconds interval) {
+    if (running_) { return; }
+    running_ = true;
+    sweeper_thread_ = std::make_unique<std::thread>([this, interval]() {
+        spdlog::info("PartitionMaintainer started (interval={}ms).", interval.count());
+        RunSweep();
+        while (running_) {
+            std::unique_lock<std::mutex> lock(cv_m_);
+            if (cv_.wait_for(lock, interval, [this]() { return !running_.load(); })) {
+                break;
+            }
+            RunSweep();
+        }
+        spdlog::info("PartitionMaintainer stopped.");
+    });
+}
+
+void PartitionMaintainer::Stop() {
+    running_ = false;
+    cv_.notify_all();
+    if (sweeper_thread_ && sweeper_thread_->joinable()) {
+        sweeper_thread_->join();
+    }
+    sweeper_thread_.reset();
+}
+
+void PartitionMaintainer::RunSweep() {
+    try {
+        sweep_();
+    } catch (const std::exception& e) {
+        spdlog::error("Partition maintenance failed: {}", e.what());
+    }
+}
+
+} // namespace telemetry::partitions
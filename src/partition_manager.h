@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace telemetry::partitions {
+
+/**
+ * @brief Lifecycle settings for host_telemetry_archival partitions.
+ *
+ * Monthly range partitions on ingestion_time are created ahead of time;
+ * with hash_modulus > 0 each month is further split by HASH(run_id) so
+ * per-dataset queries and deletes touch one leaf per month. Retention
+ * drops whole months instead of deleting rows.
+ *
+ * dataset_scores is list-partitioned by score set; with
+ * score_set_partitions off every set shares dataset_scores_default.
+ */
+struct PartitionPolicy {
+    int premake_months = 2;  // months created ahead of the current one
+    int hash_modulus = 0;    // 0 = no run_id sub-partitions
+    int retention_days = 0;  // 0 = keep everything
+    bool score_set_partitions = true; // one dataset_scores partition per score set
+
+    // PARTITION_PREMAKE_MONTHS, PARTITION_HASH_MODULUS, TELEMETRY_RETENTION_DAYS,
+    // SCORE_SET_PARTITIONS ("0"/"false" to disable)
+    static auto FromEnv() -> PartitionPolicy;
+};
+
+// One month partition: host_telemetry_archival_YYYY_MM covering [From, To).
+struct MonthPartition {
+    int year = 1970;
+    int month = 1; // 1-12
+
+    auto Name() const -> std::string;
+    auto From() const -> std::string; // "YYYY-MM-01"
+    auto To() const -> std::string;
+    auto Next() const -> MonthPartition;
+    auto Begin() const -> std::chrono::system_clock::time_point;
+    auto End() const -> std::chrono::system_clock::time_point;
+    auto LeafName(int remainder) const -> std::string;
+
+    auto operator==(const MonthPartition& other) const -> bool = default;
+};
+
+auto MonthOf(std::chrono::system_clock::time_point tp) -> MonthPartition;
+
+// Every month overlapping [start, end], in order.
+auto MonthsCovering(std::chrono::system_clock::time_point start,
+                    std::chrono::system_clock::time_point end) -> std::vector<MonthPartition>;
+
+// Inverse of MonthPartition::Name(); nullopt for the default partition,
+// hash leaves and anything else not created by EnsurePartition.
+auto ParseMonthPartition(const std::string& name) -> std::optional<MonthPartition>;
+
+// Month partitions (by name) whose whole range is older than cutoff.
+auto ExpiredMonths(const std::vector<std::string>& partition_names,
+                   std::chrono::system_clock::time_point cutoff) -> std::vector<MonthPartition>;
+
+// dataset_scores partition holding one score set: dataset_scores_<id>.
+auto ScoreSetPartitionName(long score_set_id) -> std::string;
+
+/**
+ * @brief Runs a partition maintenance sweep once at Start() and then on a
+ * fixed interval on a background thread.
+ */
+class PartitionMaintainer {
+public:
+    explicit PartitionMaintainer(std::function<void()> sweep);
+    ~PartitionMaintainer();
+
+    void Start(std::chrono::milliseconds interval = std::chrono::hours(1));
+    void Stop();
+
+private:
+    void RunSweep();
+
+    std::function<void()> sweep_;
+    std::atomic<bool> running_{false};
+    std::mutex cv_m_;
+    std::condition_variable cv_;
+    std::unique_ptr<std::thread> sweeper_thread_;
+};
+
+} // namespace telemetry::partitions
@@ -0,0 +1,94 @@
+#include "progress_reporter.h"
+
+#include <cstdlib>
+#include <string>
+
+#include <spdlog/spdlog.h>
+
+namespace telemetry {
+
+ProgressReporter::ProgressReporter(FlushFn flush, HeartbeatFn heartbeat, std::chrono::milliseconds interval)
+    : flush_(std::move(flush)), heartbeat_(std::move(heartbeat)),
+      interval_(interval.count() > 0 ? interval : std::chrono::milliseconds(1)) {}
+
+ProgressReporter::~ProgressReporter() {
+    Stop();
+}
+
+auto ProgressReporter::DefaultInterval() -> std::chrono::milliseconds {
+    long ms = 1000;
+    const char* env_interval = std::getenv("PROGRESS_FLUSH_INTERVAL_MS");
+    if (env_interval) {
+        try { ms = std::stol(env_interval); } catch (...) {}
+    }
+    return std::chrono::milliseconds(ms > 0 ? ms : 1000);
+}
+
+auto ProgressReporter::Start() -> void {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_) { return; }
+    running_ = true;
+    thread_ = std::thread(&ProgressReporter::Loop, this);
+}
+
+auto ProgressReporter::Stop() -> void {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) { return; }
+        running_ = false;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) { thread_.join(); }
+}
+
+auto ProgressReporter::Update(long rows, long cursor) -> void {
+    std::lock_guard<std::mutex> lock(progress_mutex_);
+    progress_ = {rows, cursor};
+    version_++;
+}
+
+auto ProgressReporter::Snapshot() const -> ProgressSnapshot {
+    std::lock_guard<std::mutex> lock(progress_mutex_);
+    return progress_;
+}
+
+auto ProgressReporter::FlushNow() -> void {
+    FlushPending();
+}
+
+auto ProgressReporter::FlushPending() -> void {
+    std::lock_guard<std::mutex> lock(flush_mutex_);
+    ProgressSnapshot snapshot;
+    unsigned long version = 0;
+    {
+        std::lock_guard<std::mutex> progress_lock(progress_mutex_);
+        snapshot = progress_;
+        version = version_;
+    }
+    bool beat = beat_.exchange(false, std::memory_order_relaxed);
+    try {
+        if (version != flushed_version_) {
+            flushed_version_ = version;
+            if (flush_) { flush_(snapshot); }
+            flush_count_++;
+        } else if (beat) {
+            if (heartbeat_) { heartbeat_(); }
+            heartbeat_count_++;
+        }
+    } catch (const std::exception& e) {
+        spdlog::warn("Progress flush failed: {}", e.what());
+    }
+}
+
+auto ProgressReporter::Loop() -> void {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_) {
+        cv_.wait_for(lock, interval_, [this]() { return !running_; });
+        if (!running_) { break; }
+        lock.unlock();
+        FlushPending();
+        lock.lock();
+    }
+}
+
+} // namespace telemetry
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace telemetry {
+
+struct ProgressSnapshot {
+    long rows = 0;
+    long cursor = 0; // caller-defined checkpoint, e.g. last scored record_id
+};
+
+/**
+ * @brief Coalesces progress and liveness signals from a hot loop and writes
+ * them from a background thread at most once per interval.
+ *
+ * Update() (one short uncontended lock) and Beat() (lock-free) are safe to
+ * call per row or per tick. On
+ * each interval the flush thread calls @p flush when progress moved, or
+ * @p heartbeat when the loop only signalled liveness. Nothing is written for
+ * an interval with no signal, so a wedged loop still goes stale.
+ *
+ * Terminal status writes stay with the caller: call Stop() first so a late
+ * RUNNING flush cannot land after them.
+ */
+class ProgressReporter {
+public:
+    using FlushFn = std::function<void(const ProgressSnapshot&)>;
+    using HeartbeatFn = std::function<void()>;
+
+    ProgressReporter(FlushFn flush, HeartbeatFn heartbeat,
+                     std::chrono::milliseconds interval = DefaultInterval());
+    ~ProgressReporter();
+    ProgressReporter(const ProgressReporter&) = delete;
+    auto operator=(const ProgressReporter&) -> ProgressReporter& = delete;
+
+    auto Start() -> void;
+    auto Stop() -> void;
+
+    auto Update(long rows, long cursor = 0) -> void;
+    auto Beat() -> void { beat_.store(true, std::memory_order_relaxed); }
+
+    // Writes pending progress on the calling thread.
+    auto FlushNow() -> void;
+
+    auto Snapshot() const -> ProgressSnapshot;
+    auto FlushCount() const -> long { return flush_count_.load(); }
+    auto HeartbeatCount() const -> long { return heartbeat_count_.load(); }
+
+    // PROGRESS_FLUSH_INTERVAL_MS, default 1000.
+    static auto DefaultInterval() -> std::chrono::milliseconds;
+
+private:
+    auto Loop() -> void;
+    auto FlushPending() -> void;
+
+    FlushFn flush_;
+    HeartbeatFn heartbeat_;
+    std::chrono::milliseconds interval_;
+
+    // rows and cursor form one resume checkpoint, so they are only read and
+    // written together. Never held across flush_.
+    mutable std::mutex progress_mutex_;
+    ProgressSnapshot progress_;
+    unsigned long version_ = 0;
+    std::atomic<bool> beat_{false};
+
+    std::mutex flush_mutex_; // serializes FlushNow() with the timer thread
+    unsigned long flushed_version_ = 0;
+    std::atomic<long> flush_count_{0};
+    std::atomic<long> heartbeat_count_{0};
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool running_ = false;
+    std::thread thread_;
+};
+
+} // namespace telemetry
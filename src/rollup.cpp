@@ -0,0 +1,156 @@
+#include "rollup.h"
+#include <fmt/format.h>
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <stdexcept>
+
+namespace telemetry::rollup {
+
+namespace {
+
+const double kGamma = (1.0 + QuantileSketch::kRelativeAccuracy) / (1.0 - QuantileSketch::kRelativeAccuracy);
+const double kLogGamma = std::log(kGamma);
+
+} // namespace
+
+auto QuantileSketch::BinIndex(double value) -> size_t {
+    if (!(value > kMinValue)) { return 0; } // also catches NaN
+    return 1 + static_cast<size_t>(std::floor(std::log(value / kMinValue) / kLogGamma));
+}
+
+auto QuantileSketch::BinValue(size_t index) -> double {
+    if (index == 0) { return 0.0; }
+    // Midpoint (in relative terms) of (min * g^(k-1), min * g^k].
+    return kMinValue * 2.0 * std::pow(kGamma, static_cast<double>(index)) / (1.0 + kGamma);
+}
+
+auto QuantileSketch::BinIndexSql(const std::string& column) -> std::string {
+    return fmt::format("(CASE WHEN {0} > {1:.17g} THEN 1 + floor(ln({0} / {1:.17g}) / {2:.17g})::int ELSE 0 END)",
+                       column, kMinValue, kLogGamma);
+}
+
+auto QuantileSketch::Add(double value, long count) -> void {
+    AddBin(BinIndex(value), count);
+}
+
+auto QuantileSketch::AddBin(size_t index, long count) -> void {
+    if (index >= bins_.size()) { bins_.resize(index + 1, 0); }
+    bins_[index] += count;
+    count_ += count;
+}
+
+auto QuantileSketch::Merge(const QuantileSketch& other) -> void {
+    if (other.bins_.size() > bins_.size()) { bins_.resize(other.bins_.size(), 0); }
+    for (size_t i = 0; i < other.bins_.size(); ++i) { bins_[i] += other.bins_[i]; }
+    count_ += other.count_;
+}
+
+auto QuantileSketch::Quantile(double q) const -> double {
+    if (count_ == 0) { return 0.0; }
+    q = std::clamp(q, 0.0, 1.0);
+    // Same rank convention as PERCENTILE_DISC: first bin whose cumulative
+    // count reaches ceil(q * n).
+    auto rank = std::max<long>(1, static_cast<long>(std::ceil(q * static_cast<double>(count_))));
+    long seen = 0;
+    for (size_t i = 0; i < bins_.size(); ++i) {
+        seen += bins_[i];
+        if (seen >= rank) { return BinValue(i); }
+    }
+    return BinValue(bins_.size() - 1);
+}
+
+auto QuantileSketch::ToPgArray() const -> std::string {
+    std::string out = "{";
+    for (size_t i = 0; i < bins_.size(); ++i) {
+        if (i > 0) { out += ','; }
+        out += std::to_string(bins_[i]);
+    }
+    out += '}';
+    return out;
+}
+
+auto QuantileSketch::FromPgArray(std::string_view text) -> QuantileSketch {
+    QuantileSketch sketch;
+    if (text.size() < 2 || text.front() != '{' || text.back() != '}') {
+        throw std::invalid_argument("Malformed sketch array");
+    }
+    text = text.substr(1, text.size() - 2);
+    while (!text.empty()) {
+        auto comma = text.find(',');
+        auto token = text.substr(0, comma);
+        long value = 0;
+        if (token != "NULL") {
+            auto [ptr, ec] = std::from_chars(token.data(), token.data() + token.size(), value);
+            if (ec != std::errc() || ptr != token.data() + token.size()) {
+                throw std::invalid_argument("Malformed sketch array");
+            }
+        }
+        sketch.bins_.push_back(value);
+        sketch.count_ += value;
+        if (comma == std::string_view::npos) { break; }
+        text.remove_prefix(comma + 1);
+    }
+    return sketch;
+}
+
+auto Stats::Add(double value) -> void {
+    if (count == 0) {
+        min = value;
+        max = value;
+    } else {
+        min = std::min(min, value);
+        max = std::max(max, value);
+    }
+    count += 1;
+    sum += value;
+    sumsq += value * value;
+    sketch.Add(value);
+}
+
+auto Stats::Merge(const Stats& other) -> void {
+    if (other.count == 0) { return; }
+    if (count == 0) {
+        min = other.min;
+        max = other.max;
+    } else {
+        min = std::min(min, other.min);
+        max = std::max(max, other.max);
+    }
+    count += other.count;
+    sum += other.sum;
+    sumsq += other.sumsq;
+    sketch.Merge(other.sketch);
+}
+
+auto BatchAccumulator::Add(const TelemetryRecord& record) -> void {
+    auto epoch = std::chrono::duration_cast<std::chrono::seconds>(record.metric_timestamp.time_since_epoch()).count();
+    const std::array<double, kMetrics.size()> values = {record.cpu_usage, record.memory_usage,
+                                                         record.disk_utilization, record.network_rx_rate,
+                                                         record.network_tx_rate};
+    auto& run_cells = cells_[record.run_id];
+    for (int resolution : kResolutions) {
+        // floor, not truncation, for pre-1970 timestamps
+        int64_t bucket = (epoch >= 0 ? epoch / resolution : (epoch - resolution + 1) / resolution) * resolution;
+        for (size_t m = 0; m < values.size(); ++m) {
+            run_cells[CellKey{resolution, bucket, record.region, record.is_anomaly, m}].Add(values[m]);
+        }
+    }
+}
+
+auto ChooseResolution(int bucket_seconds,
+                      std::optional<int64_t> start_epoch,
+                      std::optional<int64_t> end_epoch,
+                      bool has_anomaly_type_filter) -> std::optional<int> {
+    if (has_anomaly_type_filter || bucket_seconds <= 0) { return std::nullopt; }
+    for (auto it = kResolutions.rbegin(); it != kResolutions.rend(); ++it) {
+        int resolution = *it;
+        if (bucket_seconds % resolution != 0) { continue; }
+        if (start_epoch && *start_epoch % resolution != 0) { continue; }
+        if (end_epoch && *end_epoch % resolution != 0) { continue; }
+        return resolution;
+    }
+    return std::nullopt;
+}
+
+} // namespace telemetry::rollup
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "types.h"
+#include <array>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+namespace telemetry::rollup {
+
+// Rollup resolutions maintained for every run, finest first.
+constexpr std::array<int, 4> kResolutions = {60, 300, 3600, 86400};
+
+// Metric columns rolled up (same allowlist as DbClient::IsValidMetric).
+constexpr std::array<const char*, 5> kMetrics = {
+    "cpu_usage", "memory_usage", "disk_utilization", "network_rx_rate", "network_tx_rate"};
+
+/**
+ * @brief Mergeable log-bucketed quantile sketch (DDSketch layout).
+ *
+ * Bin 0 holds values <= kMinValue; bin k >= 1 holds (kMinValue * g^(k-1),
+ * kMinValue * g^k] with g = (1 + a) / (1 - a), so any quantile is returned
+ * within relative error a of a sample value. Bins have a fixed origin, so
+ * two sketches merge by adding counts index-wise; that is what
+ * rollup_sketch_merge() does in SQL on upsert.
+ */
+class QuantileSketch {
+public:
+    static constexpr double kRelativeAccuracy = 0.02;
+    static constexpr double kMinValue = 1e-3;
+
+    auto Add(double value, long count = 1) -> void;
+    auto AddBin(size_t index, long count) -> void;
+    auto Merge(const QuantileSketch& other) -> void;
+    // q in [0, 1]. Returns 0 for an empty sketch.
+    auto Quantile(double q) const -> double;
+    auto Count() const -> long { return count_; }
+    auto Bins() const -> const std::vector<long>& { return bins_; }
+
+    // Postgres BIGINT[] text form ("{0,3,1}") and back.
+    auto ToPgArray() const -> std::string;
+    static auto FromPgArray(std::string_view text) -> QuantileSketch;
+
+    static auto BinIndex(double value) -> size_t;
+    static auto BinValue(size_t index) -> double;
+    // SQL expression computing BinIndex() of a column server-side, so a
+    // GROUP BY bin replaces sorting the rows for a percentile.
+    static auto BinIndexSql(const std::string& column) -> std::string;
+
+private:
+    std::vector<long> bins_;
+    long count_ = 0;
+};
+
+struct Stats {
+    long count = 0;
+    double sum = 0.0;
+    double sumsq = 0.0;
+    double min = 0.0;
+    double max = 0.0;
+    QuantileSketch sketch;
+
+    auto Add(double value) -> void;
+    auto Merge(const Stats& other) -> void;
+};
+
+// (resolution_seconds, bucket epoch seconds, region, is_anomaly, metric index)
+using CellKey = std::tuple<int, int64_t, std::string, bool, size_t>;
+
+/**
+ * @brief Folds a batch of records into rollup cells for every resolution,
+ * ready to be upserted (one row per cell) in the batch's transaction.
+ */
+class BatchAccumulator {
+public:
+    auto Add(const TelemetryRecord& record) -> void;
+    auto Cells() const -> const std::map<std::string, std::map<CellKey, Stats>>& { return cells_; }
+    auto Empty() const -> bool { return cells_.empty(); }
+
+private:
+    std::map<std::string, std::map<CellKey, Stats>> cells_; // by run_id
+};
+
+/**
+ * @brief Picks the coarsest rollup resolution that can answer a
+ * GetTimeSeries request exactly (sketch quantiles aside).
+ *
+ * The resolution must divide the requested bucket, and start/end bounds (epoch
+ * seconds, when given) must fall on resolution boundaries. Filters on
+ * anomaly_type are not rolled up, so they always go to the raw table.
+ */
+auto ChooseResolution(int bucket_seconds,
+                      std::optional<int64_t> start_epoch,
+                      std::optional<int64_t> end_epoch,
+                      bool has_anomaly_type_filter) -> std::optional<int>;
+
+} // namespace telemetry::rollup
@@ -19,6 +19,7 @@ const std::vector<RouteSpec> kRequiredRoutes = {
     {"GET", "/models/([a-zA-Z0-9-]+)/datasets/scored", "GetModelScoredDatasets"},
     {"GET", "/scores", "GetScores"},
     {"POST", "/inference", "RunInference"},
+    {"POST", "/inference/batch", "RunInferenceBatch"},
     {"GET", "/inference_runs", "ListInferenceRuns"},
     {"GET", "/inference_runs/([a-zA-Z0-9-]+)", "GetInferenceRun"},
     {"POST", "/jobs/score_dataset", "CreateScoreJob"},
@@ -30,6 +31,7 @@ const std::vector<RouteSpec> kRequiredRoutes = {
     {"GET", "/healthz", "HealthCheck"},
     {"GET", "/readyz", "ReadyCheck"},
     {"GET", "/metrics", "Metrics"},
+    {"GET", "/debug/db_pool", "GetDbPoolStats"},
     {"GET", "/schema/metrics", "GetMetricsSchema"},
     {"POST", "/train", "StartTrain"},
     {"GET", "/train/([a-zA-Z0-9-]+)", "GetTrainStatus"},
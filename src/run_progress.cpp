@@ -0,0 +1,80 @@
+#include "run_progress.h"
+
+namespace telemetry {
+
+RunProgress::RunProgress(std::string run_id, std::string request_id) {
+    state_.run_id = std::move(run_id);
+    state_.request_id = std::move(request_id);
+    state_.status = "PENDING";
+}
+
+auto RunProgress::Update(const std::string& status, long inserted_rows, const std::string& error) -> void {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        state_.status = status;
+        state_.inserted_rows = inserted_rows;
+        if (!error.empty()) { state_.error = error; }
+        state_.version++;
+        if (IsTerminalStatus(status) && finished_at_ == std::chrono::steady_clock::time_point{}) {
+            finished_at_ = std::chrono::steady_clock::now();
+        }
+    }
+    cv_.notify_all();
+}
+
+auto RunProgress::Snapshot() const -> RunProgressSnapshot {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return state_;
+}
+
+auto RunProgress::WaitForChange(uint64_t seen_version, std::chrono::milliseconds timeout) const -> bool {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return cv_.wait_for(lock, timeout, [&]() { return state_.version != seen_version; });
+}
+
+auto RunProgress::IsTerminal() const -> bool {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return IsTerminalStatus(state_.status);
+}
+
+auto RunProgress::FinishedAt() const -> std::chrono::steady_clock::time_point {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return finished_at_;
+}
+
+auto RunProgress::IsTerminalStatus(const std::string& status) -> bool {
+    return status == "SUCCEEDED" || status == "FAILED" || status == "CANCELLED";
+}
+
+auto RunProgressRegistry::Register(const std::string& run_id, const std::string& request_id)
+    -> std::shared_ptr<RunProgress> {
+    std::lock_guard<std::mutex> lock(mutex_);
+    PruneLocked();
+    auto progress = std::make_shared<RunProgress>(run_id, request_id);
+    runs_[run_id] = progress;
+    return progress;
+}
+
+auto RunProgressRegistry::Find(const std::string& run_id) const -> std::shared_ptr<RunProgress> {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = runs_.find(run_id);
+    return it == runs_.end() ? nullptr : it->second;
+}
+
+auto RunProgressRegistry::Size() const -> size_t {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return runs_.size();
+}
+
+auto RunProgressRegistry::PruneLocked() -> void {
+    auto now = std::chrono::steady_clock::now();
+    for (auto it = runs_.begin(); it != runs_.end();) {
+        if (it->second->IsTerminal() && now - it->second->FinishedAt() > retention_) {
+            it = runs_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+} // namespace telemetry
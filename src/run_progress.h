@@ -0,0 +1,74 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace telemetry {
+
+struct RunProgressSnapshot {
+    std::string run_id;
+    std::string request_id;
+    std::string status;
+    long inserted_rows = 0;
+    std::string error;
+    uint64_t version = 0;
+};
+
+/**
+ * @brief In-memory progress of a single run, published by the producer
+ * (Generator or IngestTelemetry) and read by WatchRun streams.
+ */
+class RunProgress {
+public:
+    RunProgress(std::string run_id, std::string request_id);
+
+    auto Update(const std::string& status, long inserted_rows, const std::string& error = "") -> void;
+    auto Snapshot() const -> RunProgressSnapshot;
+
+    /**
+     * @brief Blocks until the version moves past @p seen_version or the
+     * timeout elapses. Returns true when a newer version is available.
+     */
+    auto WaitForChange(uint64_t seen_version, std::chrono::milliseconds timeout) const -> bool;
+
+    auto IsTerminal() const -> bool;
+    auto FinishedAt() const -> std::chrono::steady_clock::time_point;
+
+    static auto IsTerminalStatus(const std::string& status) -> bool;
+
+private:
+    mutable std::mutex mutex_;
+    mutable std::condition_variable cv_;
+    RunProgressSnapshot state_;
+    std::chrono::steady_clock::time_point finished_at_{};
+};
+
+/**
+ * @brief Process-wide table of runs owned by this generator service.
+ *
+ * Terminal entries are kept for @p retention so that watchers attaching just
+ * after completion still read from memory; older ones are pruned on Register.
+ */
+class RunProgressRegistry {
+public:
+    explicit RunProgressRegistry(std::chrono::seconds retention = std::chrono::seconds(60))
+        : retention_(retention) {}
+
+    auto Register(const std::string& run_id, const std::string& request_id) -> std::shared_ptr<RunProgress>;
+    auto Find(const std::string& run_id) const -> std::shared_ptr<RunProgress>;
+    auto Size() const -> size_t;
+
+private:
+    auto PruneLocked() -> void;
+
+    std::chrono::seconds retention_;
+    mutable std::mutex mutex_;
+    std::map<std::string, std::shared_ptr<RunProgress>> runs_;
+};
+
+} // namespace telemetry
@@ -14,6 +14,7 @@
 #include "detectors/pca_model.h"
 #include "alert_manager.h"
 #include "metrics.h"
+#include "segment_file.h"
 
 using namespace telemetry;
 using namespace telemetry::anomaly;
@@ -27,10 +28,14 @@ auto main(int argc, char** argv) -> int {
     // Argument Parsing (Simple)
     int shard_id = 0;
     int num_shards = 1;
+    std::string segments_dir; // optional run directory of segment files
     if (argc >= 3) {
         shard_id = std::stoi(argv[1]);
         num_shards = std::stoi(argv[2]);
     }
+    if (argc >= 4) {
+        segments_dir = argv[3];
+    }
     spdlog::info("Sharding Config: Shard {} of {}", shard_id, num_shards);
 
     // Default Config
@@ -64,6 +69,121 @@ auto main(int argc, char** argv) -> int {
     config.gating.enable_gating = true;
     config.gating.period_ms = 10000; // 10s for test visibility
 
+    auto in_shard = [&](const std::string& host) {
+        size_t h = std::hash<std::string>{}(host);
+        return (h % static_cast<size_t>(num_shards)) == static_cast<size_t>(shard_id);
+    };
+
+    auto score_record = [&](const TelemetryRecord& r, long step) {
+        // 1. Vectorize
+        FeatureVector vec = FeatureVector::FromRecord(r);
+
+        // 2. Preprocess
+        preprocessor.Apply(vec);
+
+        // 3. Detect A
+        bool flag_a = false;
+        double score_a = 0.0;
+        std::string details_a;
+
+        // Ensure detector exists (lazy init or pre-init)
+        if (detectors_a.find(r.host_id) == detectors_a.end()) {
+             detectors_a.emplace(r.host_id, DetectorA(config.window, config.outliers));
+        }
+
+        // Detect A Latency
+        auto t_a_start = std::chrono::high_resolution_clock::now();
+        auto& detector = detectors_a.at(r.host_id);
+        AnomalyScore score = detector.Update(vec);
+        auto t_a_end = std::chrono::high_resolution_clock::now();
+        telemetry::metrics::MetricsRegistry::Instance().RecordLatency("detector_a_latency_ms", {}, std::chrono::duration<double, std::milli>(t_a_end - t_a_start).count());
+
+        if (score.is_anomaly) {
+            flag_a = true;
+            score_a = score.max_z_score;
+            details_a = score.details;
+            spdlog::info("[DETECTOR A] Host: {} Step: {} Z: {:.2f} Details: {}", r.host_id, step, score_a, details_a);
+            telemetry::metrics::MetricsRegistry::Instance().Increment("detector_a_anomalies_total", {});
+        }
+        
+        // 4. Detect B (Gated)
+        bool flag_b = false;
+        double score_b = 0.0;
+        std::string details_b;
+        bool run_b = true; // Default true if no gating
+
+        if (config.gating.enable_gating) {
+            auto& h_state = host_states[r.host_id];
+            bool triggered = flag_a; // Trigger if A saw anomaly
+            
+            auto ms_since = std::chrono::duration_cast<std::chrono::milliseconds>(r.metric_timestamp - h_state.last_b_run).count();
+            bool scheduled = ms_since >= config.gating.period_ms;
+
+            if (!triggered && !scheduled) {
+                run_b = false;
+            } else {
+                // Update last run if we run it due to schedule (or even trigger? usually yes)
+                h_state.last_b_run = r.metric_timestamp;
+            }
+        }
+
+        if (run_b) {
+            telemetry::metrics::MetricsRegistry::Instance().Increment("detector_b_evaluations_total", {});
+            auto t_b_start = std::chrono::high_resolution_clock::now();
+            PcaScore pca_res = pca_model.Score(vec);
+            auto t_b_end = std::chrono::high_resolution_clock::now();
+            telemetry::metrics::MetricsRegistry::Instance().RecordLatency("detector_b_latency_ms", {}, std::chrono::duration<double, std::milli>(t_b_end - t_b_start).count());
+
+            if (pca_res.is_anomaly) {
+                flag_b = true;
+                score_b = pca_res.reconstruction_error;
+                details_b = pca_res.details;
+                spdlog::info("[DETECTOR B] Host: {} Step: {} ReconErr: {:.2f} Details: {}", r.host_id, step, score_b, details_b);
+                telemetry::metrics::MetricsRegistry::Instance().Increment("detector_b_anomalies_total", {});
+            }
+        } else {
+            // Not evaluated
+            score_b = -1.0; 
+        }
+
+        // 4. Fuse & Alert
+        std::string combined_details;
+        if (flag_a) { combined_details += "[A:" + details_a + "] "; }
+        if (run_b && flag_b) { combined_details += "[B:" + details_b + "] "; }
+        if (!run_b) { combined_details += "[B:SKIPPED] "; }
+
+        std::vector<Alert> alerts = alert_manager.Evaluate(
+            r.host_id, r.run_id, r.metric_timestamp,
+            flag_a, score_a, 
+            flag_b, score_b, 
+            combined_details
+        );
+
+        for (const auto& alert : alerts) {
+            telemetry::metrics::MetricsRegistry::Instance().Increment("alerts_total", {});
+            spdlog::error(">>> [ALERT GENERATED] Host: {} Severity: {} Source: {} Score: {:.2f}", 
+                alert.host_id, alert.severity, alert.source, alert.score);
+        }
+    };
+
+    if (!segments_dir.empty()) {
+        // Offline: replay a generated run from its segment files.
+        spdlog::info("Starting scoring loop over segments in {}...", segments_dir);
+        long step = 0;
+        for (const auto& path : SegmentReader::ListSegments(segments_dir)) {
+            auto data = SegmentReader::Read(path);
+            for (size_t i = 0; i < data.Size(); ++i) {
+                telemetry::metrics::MetricsRegistry::Instance().Increment("telemetry_records_total", {});
+                TelemetryRecord r = data.Record(i);
+                if (!in_shard(r.host_id)) { continue; }
+                score_record(r, step++);
+            }
+        }
+        spdlog::info("Metrics Summary:\n{}", telemetry::metrics::MetricsRegistry::Instance().ToPrometheus());
+        spdlog::info("Scored {} records from segments.", step);
+        return 0;
+    }
+
     // Simulation Loop
     spdlog::info("Starting scoring loop (Simulation)...");
     
@@ -83,9 +203,7 @@ auto main(int argc, char** argv) -> int {
         std::vector<std::string> hosts = {"host-1", "host-2"};
         
         for (const auto& host : hosts) {
-            // Sharding Check
-            size_t h = std::hash<std::string>{}(host);
-            if ((h % static_cast<size_t>(num_shards)) != static_cast<size_t>(shard_id)) {
+            if (!in_shard(host)) {
                 continue; // Not my shard
             }
 
@@ -124,95 +242,7 @@ auto main(int argc, char** argv) -> int {
                 spdlog::warn("[{}] Injecting Correlation anomaly at i=70", host);
             }
 
-            // 1. Vectorize
-            FeatureVector vec = FeatureVector::FromRecord(r);
-
-            // 2. Preprocess
-            preprocessor.Apply(vec);
-
-            // 3. Detect A
-            bool flag_a = false;
-            double score_a = 0.0;
-            std::string details_a;
-
-            // Ensure detector exists (lazy init or pre-init)
-            if (detectors_a.find(r.host_id) == detectors_a.end()) {
-                 detectors_a.emplace(r.host_id, DetectorA(config.window, config.outliers));
-            }
-
-            // Detect A Latency
-            auto t_a_start = std::chrono::high_resolution_clock::now();
-            auto& detector = detectors_a.at(r.host_id);
-            AnomalyScore score = detector.Update(vec);
-            auto t_a_end = std::chrono::high_resolution_clock::now();
-            telemetry::metrics::MetricsRegistry::Instance().RecordLatency("detector_a_latency_ms", {}, std::chrono::duration<double, std::milli>(t_a_end - t_a_start).count());
-
-            if (score.is_anomaly) {
-                flag_a = true;
-                score_a = score.max_z_score;
-                details_a = score.details;
-                spdlog::info("[DETECTOR A] Host: {} Step: {} Z: {:.2f} Details: {}", r.host_id, i, score_a, details_a);
-                telemetry::metrics::MetricsRegistry::Instance().Increment("detector_a_anomalies_total", {});
-            }
-            
-            // 4. Detect B (Gated)
-            bool flag_b = false;
-            double score_b = 0.0;
-            std::string details_b;
-            bool run_b = true; // Default true if no gating
-
-            if (config.gating.enable_gating) {
-                auto& h_state = host_states[host];
-                bool triggered = flag_a; // Trigger if A saw anomaly
-                
-                auto ms_since = std::chrono::duration_cast<std::chrono::milliseconds>(current_time - h_state.last_b_run).count();
-                bool scheduled = ms_since >= config.gating.period_ms;
-
-                if (!triggered && !scheduled) {
-                    run_b = false;
-                } else {
-                    // Update last run if we run it due to schedule (or even trigger? usually yes)
-                    h_state.last_b_run = current_time;
-                }
-            }
-
-            if (run_b) {
-                telemetry::metrics::MetricsRegistry::Instance().Increment("detector_b_evaluations_total", {});
-                auto t_b_start = std::chrono::high_resolution_clock::now();
-                PcaScore pca_res = pca_model.Score(vec);
-                auto t_b_end = std::chrono::high_resolution_clock::now();
-                telemetry::metrics::MetricsRegistry::Instance().RecordLatency("detector_b_latency_ms", {}, std::chrono::duration<double, std::milli>(t_b_end - t_b_start).count());
-
-                if (pca_res.is_anomaly) {
-                    flag_b = true;
-                    score_b = pca_res.reconstruction_error;
-                    details_b = pca_res.details;
-                    spdlog::info("[DETECTOR B] Host: {} Step: {} ReconErr: {:.2f} Details: {}", r.host_id, i, score_b, details_b);
-                    telemetry::metrics::MetricsRegistry::Instance().Increment("detector_b_anomalies_total", {});
-                }
-            } else {
-                // Not evaluated
-                score_b = -1.0; 
-            }
-
-            // 4. Fuse & Alert
-            std::string combined_details;
-            if (flag_a) { combined_details += "[A:" + details_a + "] "; }
-            if (run_b && flag_b) { combined_details += "[B:" + details_b + "] "; }
-            if (!run_b) { combined_details += "[B:SKIPPED] "; }
-
-            std::vector<Alert> alerts = alert_manager.Evaluate(
-                r.host_id, r.run_id, r.metric_timestamp,
-                flag_a, score_a, 
-                flag_b, score_b, 
-                combined_details
-            );
-
-            for (const auto& alert : alerts) {
-                telemetry::metrics::MetricsRegistry::Instance().Increment("alerts_total", {});
-                spdlog::error(">>> [ALERT GENERATED] Host: {} Severity: {} Source: {} Score: {:.2f}", 
-                    alert.host_id, alert.severity, alert.source, alert.score);
-            }
+            score_record(r, i);
         } // End host loop
     } // End time loop
     
@@ -0,0 +1,382 @@
+#include "segment_file.h"
+#include <zlib.h>
+#include <algorithm>
+#include <bit>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <fmt/format.h>
+
+namespace telemetry {
+
+namespace {
+
+constexpr char kMagic[4] = {'T', 'S', 'E', 'G'};
+constexpr uint16_t kVersion = 1;
+constexpr const char* kSegmentExtension = ".tseg";
+
+// Fixed-width integers and doubles are written as their in-memory bytes.
+static_assert(std::endian::native == std::endian::little, "segment format is little-endian");
+static_assert(sizeof(double) == 8, "segment format assumes 64-bit IEEE doubles");
+
+class ByteWriter {
+public:
+    template <typename T>
+    auto Put(T value) -> void {
+        const auto* p = reinterpret_cast<const char*>(&value);
+        buf_.insert(buf_.end(), p, p + sizeof(T));
+    }
+    auto PutString(const std::string& s) -> void {
+        Put<uint32_t>(static_cast<uint32_t>(s.size()));
+        buf_.insert(buf_.end(), s.begin(), s.end());
+    }
+    auto PutBytes(const char* data, size_t n) -> void { buf_.insert(buf_.end(), data, data + n); }
+    auto Buffer() -> std::vector<char>& { return buf_; }
+
+private:
+    std::vector<char> buf_;
+};
+
+class ByteReader {
+public:
+    ByteReader(const std::vector<char>& buf, std::string path) : buf_(buf), path_(std::move(path)) {}
+
+    template <typename T>
+    auto Get() -> T {
+        Need(sizeof(T));
+        T value;
+        std::memcpy(&value, buf_.data() + pos_, sizeof(T));
+        pos_ += sizeof(T);
+        return value;
+    }
+    auto GetString() -> std::string {
+        auto n = Get<uint32_t>();
+        Need(n);
+        std::string s(buf_.data() + pos_, n);
+        pos_ += n;
+        return s;
+    }
+    auto GetBytes(size_t n) -> const char* {
+        Need(n);
+        const char* p = buf_.data() + pos_;
+        pos_ += n;
+        return p;
+    }
+
+private:
+    auto Need(size_t n) -> void {
+        if (buf_.size() - pos_ < n) {
+            throw std::runtime_error("Truncated segment file: " + path_);
+        }
+    }
+
+    const std::vector<char>& buf_;
+    std::string path_;
+    size_t pos_ = 0;
+};
+
+template <typename T>
+auto WriteColumn(ByteWriter& out, SegmentColumn id, const std::vector<T>& values, const SegmentOptions& options)
+    -> void {
+    const auto* raw = reinterpret_cast<const char*>(values.data());
+    size_t raw_bytes = values.size() * sizeof(T);
+    out.Put<uint8_t>(static_cast<uint8_t>(id));
+    out.Put<uint64_t>(raw_bytes);
+    if (options.codec == SegmentCodec::None || raw_bytes == 0) {
+        out.Put<uint64_t>(raw_bytes);
+        out.PutBytes(raw, raw_bytes);
+        return;
+    }
+    uLongf stored = compressBound(static_cast<uLong>(raw_bytes));
+    std::vector<char> compressed(stored);
+    int rc = compress2(reinterpret_cast<Bytef*>(compressed.data()), &stored, reinterpret_cast<const Bytef*>(raw),
+                       static_cast<uLong>(raw_bytes), options.compression_level);
+    if (rc != Z_OK) {
+        throw std::runtime_error(fmt::format("zlib compress failed for column {}: {}", static_cast<int>(id), rc));
+    }
+    out.Put<uint64_t>(stored);
+    out.PutBytes(compressed.data(), stored);
+}
+
+template <typename T>
+auto ReadColumn(const char* stored, size_t stored_bytes, size_t raw_bytes, SegmentCodec codec, size_t rows,
+                const std::string& path, std::vector<T>& out) -> void {
+    if (raw_bytes != rows * sizeof(T)) {
+        throw std::runtime_error("Segment column size does not match row count: " + path);
+    }
+    out.resize(rows);
+    if (codec == SegmentCodec::None || raw_bytes == 0) {
+        if (stored_bytes != raw_bytes) {
+            throw std::runtime_error("Segment column size mismatch: " + path);
+        }
+        std::memcpy(out.data(), stored, raw_bytes);
+        return;
+    }
+    uLongf dest_len = static_cast<uLongf>(raw_bytes);
+    int rc = uncompress(reinterpret_cast<Bytef*>(out.data()), &dest_len, reinterpret_cast<const Bytef*>(stored),
+                        static_cast<uLong>(stored_bytes));
+    if (rc != Z_OK || dest_len != raw_bytes) {
+        throw std::runtime_error(fmt::format("zlib uncompress failed ({}) for segment {}", rc, path));
+    }
+}
+
+auto ToMillis(std::chrono::system_clock::time_point tp) -> int64_t {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(tp.time_since_epoch()).count();
+}
+
+} // namespace
+
+auto SegmentOptions::FromEnv() -> SegmentOptions {
+    SegmentOptions options;
+    if (const char* rows = std::getenv("GENERATOR_SEGMENT_ROWS")) {
+        try {
+            options.rows_per_segment = std::max<size_t>(1, std::stoul(rows));
+        } catch (...) {}
+    }
+    if (const char* codec = std::getenv("GENERATOR_SEGMENT_CODEC")) {
+        std::string value = codec;
+        if (value == "none") { options.codec = SegmentCodec::None; }
+        if (value == "zlib") { options.codec = SegmentCodec::Zlib; }
+    }
+    return options;
+}
+
+auto SegmentData::Record(size_t i) const -> TelemetryRecord {
+    TelemetryRecord r;
+    const auto& host = hosts.at(host_index[i]);
+    r.run_id = run_id;
+    r.host_id = host.host_id;
+    r.project_id = host.project_id;
+    r.region = host.region;
+    r.labels_json = host.labels_json;
+    r.metric_timestamp = std::chrono::system_clock::time_point(std::chrono::milliseconds(metric_timestamp_ms[i]));
+    r.ingestion_time = std::chrono::system_clock::time_point(std::chrono::milliseconds(ingestion_timestamp_ms[i]));
+    r.cpu_usage = cpu_usage[i];
+    r.memory_usage = memory_usage[i];
+    r.disk_utilization = disk_utilization[i];
+    r.network_rx_rate = network_rx_rate[i];
+    r.network_tx_rate = network_tx_rate[i];
+    r.is_anomaly = is_anomaly[i] != 0;
+    r.anomaly_type = anomaly_types.at(anomaly_type_index[i]);
+    return r;
+}
+
+SegmentWriter::SegmentWriter(std::string directory, std::string run_id, SegmentOptions options)
+    : options_(options) {
+    run_dir_ = (std::filesystem::path(directory) / run_id).string();
+    pending_.run_id = std::move(run_id);
+    pending_.anomaly_types.emplace_back();
+    std::filesystem::create_directories(run_dir_);
+}
+
+auto SegmentWriter::HostIndex(const TelemetryRecord& r) -> uint32_t {
+    auto it = host_lookup_.find(r.host_id);
+    if (it != host_lookup_.end()) { return it->second; }
+    auto index = static_cast<uint32_t>(pending_.hosts.size());
+    pending_.hosts.push_back({r.host_id, r.project_id, r.region, r.labels_json});
+    host_lookup_.emplace(r.host_id, index);
+    return index;
+}
+
+auto SegmentWriter::AnomalyTypeIndex(const std::string& type) -> uint32_t {
+    if (type.empty()) { return 0; }
+    auto it = type_lookup_.find(type);
+    if (it != type_lookup_.end()) { return it->second; }
+    auto index = static_cast<uint32_t>(pending_.anomaly_types.size());
+    pending_.anomaly_types.push_back(type);
+    type_lookup_.emplace(type, index);
+    return index;
+}
+
+auto SegmentWriter::Append(const std::vector<TelemetryRecord>& records) -> void {
+    for (const auto& r : records) {
+        pending_.metric_timestamp_ms.push_back(ToMillis(r.metric_timestamp));
+        pending_.ingestion_timestamp_ms.push_back(ToMillis(r.ingestion_time));
+        pending_.host_index.push_back(HostIndex(r));
+        pending_.cpu_usage.push_back(r.cpu_usage);
+        pending_.memory_usage.push_back(r.memory_usage);
+        pending_.disk_utilization.push_back(r.disk_utilization);
+        pending_.network_rx_rate.push_back(r.network_rx_rate);
+        pending_.network_tx_rate.push_back(r.network_tx_rate);
+        pending_.is_anomaly.push_back(r.is_anomaly ? 1 : 0);
+        pending_.anomaly_type_index.push_back(AnomalyTypeIndex(r.anomaly_type));
+        if (pending_.Size() >= options_.rows_per_segment) { FlushSegment(); }
+    }
+}
+
+auto SegmentWriter::Finish() -> void {
+    if (pending_.Size() > 0) { FlushSegment(); }
+}
+
+auto SegmentWriter::FlushSegment() -> void {
+    ByteWriter out;
+    out.PutBytes(kMagic, sizeof(kMagic));
+    out.Put<uint16_t>(kVersion);
+    out.Put<uint16_t>(static_cast<uint16_t>(options_.codec));
+    out.Put<uint64_t>(pending_.Size());
+    out.PutString(pending_.run_id);
+    out.Put<uint32_t>(static_cast<uint32_t>(pending_.hosts.size()));
+    for (const auto& h : pending_.hosts) {
+        out.PutString(h.host_id);
+        out.PutString(h.project_id);
+        out.PutString(h.region);
+        out.PutString(h.labels_json);
+    }
+    out.Put<uint32_t>(static_cast<uint32_t>(pending_.anomaly_types.size()));
+    for (const auto& t : pending_.anomaly_types) { out.PutString(t); }
+
+    out.Put<uint32_t>(10);
+    WriteColumn(out, SegmentColumn::MetricTimestampMs, pending_.metric_timestamp_ms, options_);
+    WriteColumn(out, SegmentColumn::IngestionTimestampMs, pending_.ingestion_timestamp_ms, options_);
+    WriteColumn(out, SegmentColumn::HostIndex, pending_.host_index, options_);
+    WriteColumn(out, SegmentColumn::CpuUsage, pending_.cpu_usage, options_);
+    WriteColumn(out, SegmentColumn::MemoryUsage, pending_.memory_usage, options_);
+    WriteColumn(out, SegmentColumn::DiskUtilization, pending_.disk_utilization, options_);
+    WriteColumn(out, SegmentColumn::NetworkRxRate, pending_.network_rx_rate, options_);
+    WriteColumn(out, SegmentColumn::NetworkTxRate, pending_.network_tx_rate, options_);
+    WriteColumn(out, SegmentColumn::IsAnomaly, pending_.is_anomaly, options_);
+    WriteColumn(out, SegmentColumn::AnomalyTypeIndex, pending_.anomaly_type_index, options_);
+
+    auto path = (std::filesystem::path(run_dir_) / fmt::format("segment-{:06d}{}", paths_.size(), kSegmentExtension))
+                    .string();
+    // Write to a temp name and rename so readers never see a partial segment.
+    auto tmp_path = path + ".tmp";
+    {
+        std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            throw std::runtime_error("Failed to open segment file: " + tmp_path);
+        }
+        auto& buf = out.Buffer();
+        file.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+        if (!file) {
+            throw std::runtime_error("Failed to write segment file: " + tmp_path);
+        }
+    }
+    std::filesystem::rename(tmp_path, path);
+
+    rows_written_ += static_cast<long>(pending_.Size());
+    bytes_written_ += static_cast<long>(out.Buffer().size());
+    paths_.push_back(path);
+
+    std::string run_id = std::move(pending_.run_id);
+    pending_ = SegmentData{};
+    pending_.run_id = std::move(run_id);
+    pending_.anomaly_types.emplace_back();
+    host_lookup_.clear();
+    type_lookup_.clear();
+}
+
+auto SegmentReader::ListSegments(const std::string& run_directory) -> std::vector<std::string> {
+    std::vector<std::string> paths;
+    for (const auto& entry : std::filesystem::directory_iterator(run_directory)) {
+        if (entry.is_regular_file() && entry.path().extension() == kSegmentExtension) {
+            paths.push_back(entry.path().string());
+        }
+    }
+    // Zero-padded sequence numbers sort in write order.
+    std::sort(paths.begin(), paths.end());
+    return paths;
+}
+
+auto SegmentReader::Read(const std::string& path) -> SegmentData {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open segment file: " + path);
+    }
+    std::vector<char> buf(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(buf.data(), static_cast<std::streamsize>(buf.size()));
+    if (!file) {
+        throw std::runtime_error("Failed to read segment file: " + path);
+    }
+
+    ByteReader in(buf, path);
+    if (std::memcmp(in.GetBytes(sizeof(kMagic)), kMagic, sizeof(kMagic)) != 0) {
+        throw std::runtime_error("Not a telemetry segment file: " + path);
+    }
+    auto version = in.Get<uint16_t>();
+    if (version != kVersion) {
+        throw std::runtime_error(fmt::format("Unsupported segment version {}: {}", version, path));
+    }
+    auto codec = static_cast<SegmentCodec>(in.Get<uint16_t>());
+    if (codec != SegmentCodec::None && codec != SegmentCodec::Zlib) {
+        throw std::runtime_error("Unknown segment codec: " + path);
+    }
+    auto rows = static_cast<size_t>(in.Get<uint64_t>());
+
+    SegmentData data;
+    data.run_id = in.GetString();
+    auto host_count = in.Get<uint32_t>();
+    data.hosts.reserve(host_count);
+    for (uint32_t i = 0; i < host_count; ++i) {
+        SegmentHost h;
+        h.host_id = in.GetString();
+        h.project_id = in.GetString();
+        h.region = in.GetString();
+        h.labels_json = in.GetString();
+        data.hosts.push_back(std::move(h));
+    }
+    auto type_count = in.Get<uint32_t>();
+    for (uint32_t i = 0; i < type_count; ++i) { data.anomaly_types.push_back(in.GetString()); }
+
+    auto column_count = in.Get<uint32_t>();
+    for (uint32_t c = 0; c < column_count; ++c) {
+        auto id = static_cast<SegmentColumn>(in.Get<uint8_t>());
+        auto raw_bytes = static_cast<size_t>(in.Get<uint64_t>());
+        auto stored_bytes = static_cast<size_t>(in.Get<uint64_t>());
+        const char* stored = in.GetBytes(stored_bytes);
+        switch (id) {
+            case SegmentColumn::MetricTimestampMs:
+                ReadColumn(stored, stored_bytes, raw_bytes, codec, rows, path, data.metric_timestamp_ms);
+                break;
+            case SegmentColumn::IngestionTimestampMs:
+                ReadColumn(stored, stored_bytes, raw_bytes, codec, rows, path, data.ingestion_timestamp_ms);
+                break;
+            case SegmentColumn::HostIndex:
+                ReadColumn(stored, stored_bytes, raw_bytes, codec, rows, path, data.host_index);
+                break;
+            case SegmentColumn::CpuUsage:
+                ReadColumn(stored, stored_bytes, raw_bytes, codec, rows, path, data.cpu_usage);
+                break;
+            case SegmentColumn::MemoryUsage:
+                ReadColumn(stored, stored_bytes, raw_bytes, codec, rows, path, data.memory_usage);
+                break;
+            case SegmentColumn::DiskUtilization:
+                ReadColumn(stored, stored_bytes, raw_bytes, codec, rows, path, data.disk_utilization);
+                break;
+            case SegmentColumn::NetworkRxRate:
+                ReadColumn(stored, stored_bytes, raw_bytes, codec, rows, path, data.network_rx_rate);
+                break;
+            case SegmentColumn::NetworkTxRate:
+                ReadColumn(stored, stored_bytes, raw_bytes, codec, rows, path, data.network_tx_rate);
+                break;
+            case SegmentColumn::IsAnomaly:
+                ReadColumn(stored, stored_bytes, raw_bytes, codec, rows, path, data.is_anomaly);
+                break;
+            case SegmentColumn::AnomalyTypeIndex:
+                ReadColumn(stored, stored_bytes, raw_bytes, codec, rows, path, data.anomaly_type_index);
+                break;
+            default:
+                break; // newer writer; skip
+        }
+    }
+
+    // Every known column must be present so Record() stays in bounds.
+    if (data.cpu_usage.size() != rows || data.host_index.size() != rows ||
+        data.metric_timestamp_ms.size() != rows || data.ingestion_timestamp_ms.size() != rows ||
+        data.memory_usage.size() != rows || data.disk_utilization.size() != rows ||
+        data.network_rx_rate.size() != rows || data.network_tx_rate.size() != rows ||
+        data.is_anomaly.size() != rows || data.anomaly_type_index.size() != rows) {
+        throw std::runtime_error("Segment file is missing columns: " + path);
+    }
+    for (size_t i = 0; i < rows; ++i) {
+        if (data.host_index[i] >= data.hosts.size() || data.anomaly_type_index[i] >= data.anomaly_types.size()) {
+            throw std::runtime_error("Segment dictionary index out of range: " + path);
+        }
+    }
+    return data;
+}
+
+} // namespace telemetry
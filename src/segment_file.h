@@ -0,0 +1,131 @@
+#pragma once
+
+#include "types.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace telemetry {
+
+/**
+ * @brief Columnar telemetry segment files ("TSEG").
+ *
+ * A segment holds up to SegmentOptions::rows_per_segment rows of one run.
+ * All integers are little-endian:
+ *
+ *   char[4]  magic "TSEG"
+ *   u16      version (1)
+ *   u16      codec (0 = none, 1 = zlib), applies to every column
+ *   u64      row count
+ *   str      run_id                      (str = u32 length + bytes)
+ *   u32      host count, then per host: host_id, project_id, region, labels_json
+ *   u32      anomaly type count, then one str per type (entry 0 is "")
+ *   u32      column count, then per column:
+ *              u8 column id (SegmentColumn), u64 raw bytes, u64 stored bytes,
+ *              stored bytes of the (possibly compressed) packed array
+ *
+ * Timestamps are epoch milliseconds (i64), host and anomaly type columns are
+ * u32 indexes into the dictionaries, metrics are f64, is_anomaly is u8.
+ * Readers skip column ids they do not know.
+ */
+enum class SegmentColumn : uint8_t {
+    MetricTimestampMs = 1,
+    IngestionTimestampMs = 2,
+    HostIndex = 3,
+    CpuUsage = 4,
+    MemoryUsage = 5,
+    DiskUtilization = 6,
+    NetworkRxRate = 7,
+    NetworkTxRate = 8,
+    IsAnomaly = 9,
+    AnomalyTypeIndex = 10,
+};
+
+enum class SegmentCodec : uint16_t {
+    None = 0,
+    Zlib = 1,
+};
+
+struct SegmentOptions {
+    size_t rows_per_segment = 1000000;
+    SegmentCodec codec = SegmentCodec::Zlib;
+    int compression_level = 1; // zlib level; speed over ratio
+
+    // GENERATOR_SEGMENT_ROWS, GENERATOR_SEGMENT_CODEC ("zlib" | "none").
+    static auto FromEnv() -> SegmentOptions;
+};
+
+struct SegmentHost {
+    std::string host_id;
+    std::string project_id;
+    std::string region;
+    std::string labels_json;
+};
+
+/**
+ * @brief Decoded contents of one segment, kept columnar.
+ */
+struct SegmentData {
+    std::string run_id;
+    std::vector<SegmentHost> hosts;
+    std::vector<std::string> anomaly_types;
+
+    std::vector<int64_t> metric_timestamp_ms;
+    std::vector<int64_t> ingestion_timestamp_ms;
+    std::vector<uint32_t> host_index;
+    std::vector<double> cpu_usage;
+    std::vector<double> memory_usage;
+    std::vector<double> disk_utilization;
+    std::vector<double> network_rx_rate;
+    std::vector<double> network_tx_rate;
+    std::vector<uint8_t> is_anomaly;
+    std::vector<uint32_t> anomaly_type_index;
+
+    auto Size() const -> size_t { return cpu_usage.size(); }
+    auto Record(size_t i) const -> TelemetryRecord;
+};
+
+/**
+ * @brief Buffers records column-wise and writes a segment file every
+ * rows_per_segment rows under <directory>/<run_id>/.
+ *
+ * Not thread-safe; the generator drives it from its single writer thread.
+ */
+class SegmentWriter {
+public:
+    SegmentWriter(std::string directory, std::string run_id, SegmentOptions options = {});
+
+    auto Append(const std::vector<TelemetryRecord>& records) -> void;
+    // Writes any buffered rows. Safe to call more than once.
+    auto Finish() -> void;
+
+    auto RowsWritten() const -> long { return rows_written_; }
+    auto BytesWritten() const -> long { return bytes_written_; }
+    auto SegmentPaths() const -> const std::vector<std::string>& { return paths_; }
+    auto RunDirectory() const -> const std::string& { return run_dir_; }
+
+private:
+    auto FlushSegment() -> void;
+    auto HostIndex(const TelemetryRecord& r) -> uint32_t;
+    auto AnomalyTypeIndex(const std::string& type) -> uint32_t;
+
+    std::string run_dir_;
+    SegmentOptions options_;
+    SegmentData pending_;
+    std::unordered_map<std::string, uint32_t> host_lookup_; // per segment
+    std::unordered_map<std::string, uint32_t> type_lookup_;
+    std::vector<std::string> paths_;
+    long rows_written_ = 0;
+    long bytes_written_ = 0;
+};
+
+class SegmentReader {
+public:
+    // Segment files of a run directory in write order.
+    static auto ListSegments(const std::string& run_directory) -> std::vector<std::string>;
+    // Throws std::runtime_error on I/O errors or a malformed file.
+    static auto Read(const std::string& path) -> SegmentData;
+};
+
+} // namespace telemetry
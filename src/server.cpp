@@ -1,12 +1,15 @@
 #include "server.h"
 #include "generator.h"
 #include "db_client.h"
+#include "ingest.h"
 #include "obs/context.h"
 
 #include <uuid/uuid.h>
+#include <cstdlib>
 #include <thread>
 #include <chrono>
 #include <array>
+#include <algorithm>
 
 // Helper to generate UUID string
 auto GenerateUUID() -> std::string {
@@ -17,6 +20,16 @@ auto GenerateUUID() -> std::string {
     return {uuid.data()};
 }
 
+auto ToRunStatus(const telemetry::RunProgressSnapshot& snap) -> RunStatus {
+    RunStatus status;
+    status.set_run_id(snap.run_id);
+    status.set_status(snap.status);
+    status.set_inserted_rows(snap.inserted_rows);
+    status.set_error(snap.error);
+    status.set_request_id(snap.request_id);
+    return status;
+}
+
 auto TelemetryServiceImpl::GenerateTelemetry([[maybe_unused]] ServerContext* context, const GenerateRequest* request,
                                               GenerateResponse* response) -> Status {
     std::string run_id = GenerateUUID();
@@ -27,9 +40,10 @@ auto TelemetryServiceImpl::GenerateTelemetry([[maybe_unused]] ServerContext* con
     // Capture request by value to ensure valid lifetime
     GenerateRequest req_copy = *request;
     auto factory = db_factory_;
+    auto progress = progress_->Register(run_id, req_copy.request_id());
     
     try {
-        job_manager_->StartJob("gen-" + run_id, req_copy.request_id(), [run_id, req_copy, factory](const std::atomic<bool>* stop_flag) {
+        job_manager_->StartJob("gen-" + run_id, req_copy.request_id(), [run_id, req_copy, factory, progress](const std::atomic<bool>* stop_flag) {
             telemetry::obs::Context ctx;
             ctx.request_id = req_copy.request_id();
             ctx.dataset_id = run_id;
@@ -40,14 +54,17 @@ auto TelemetryServiceImpl::GenerateTelemetry([[maybe_unused]] ServerContext* con
                 auto db = factory();
                 Generator gen(req_copy, run_id, db);
                 gen.SetStopFlag(stop_flag);
+                gen.SetProgress(progress);
                 gen.Run();
             } catch (const std::exception& e) {
                  spdlog::error("Thread for run {} failed: {}", run_id, e.what());
+                 progress->Update("FAILED", progress->Snapshot().inserted_rows, e.what());
             }
             spdlog::info("Background generation for run {} finished.", run_id);
         });
     } catch (const std::exception& e) {
         spdlog::error("Failed to start generation job for run {}: {}", run_id, e.what());
+        progress->Update("FAILED", 0, e.what());
         return {grpc::StatusCode::RESOURCE_EXHAUSTED, e.what()};
     }
 
@@ -59,9 +76,163 @@ auto TelemetryServiceImpl::GenerateTelemetry([[maybe_unused]] ServerContext* con
 auto TelemetryServiceImpl::GetRun([[maybe_unused]] ServerContext* context, const GetRunRequest* request,
                                    RunStatus* response) -> Status {
     spdlog::info("Received GetRun request for RunID: {}", request->run_id());
+
+    if (auto progress = progress_->Find(request->run_id())) {
+        *response = ToRunStatus(progress->Snapshot());
+        return Status::OK;
+    }
     
     auto db = db_factory_();
     *response = db->GetRunStatus(request->run_id());
     
     return Status::OK;
-}
\ No newline at end of file
+}
+
+auto TelemetryServiceImpl::WatchRun(ServerContext* context, const WatchRunRequest* request,
+                                     grpc::ServerWriter<RunStatus>* writer) -> Status {
+    if (request->run_id().empty()) {
+        return {grpc::StatusCode::INVALID_ARGUMENT, "run_id is required"};
+    }
+    auto interval = ResolveWatchInterval(*request);
+    spdlog::info("Received WatchRun request for RunID: {} (interval {}ms)", request->run_id(), interval.count());
+
+    auto progress = progress_->Find(request->run_id());
+    if (!progress) {
+        // Not produced by this process (or long finished): poll the DB at the
+        // requested cadence until the run reaches a terminal state.
+        auto db = db_factory_();
+        std::string last_sent;
+        int error_polls = 0;
+        while (!context->IsCancelled()) {
+            RunStatus status = db->GetRunStatus(request->run_id());
+            if (status.status() == "ERROR") {
+                if (++error_polls >= kMaxWatchErrorPolls) {
+                    return {grpc::StatusCode::UNAVAILABLE, "run status unavailable: " + status.error()};
+                }
+                std::this_thread::sleep_for(interval);
+                continue;
+            }
+            error_polls = 0;
+            std::string encoded = status.SerializeAsString();
+            if (encoded != last_sent) {
+                if (!writer->Write(status)) { return Status::OK; }
+                last_sent = std::move(encoded);
+            }
+            if (status.status().empty() || telemetry::RunProgress::IsTerminalStatus(status.status())) {
+                return Status::OK;
+            }
+            std::this_thread::sleep_for(interval);
+        }
+        return {grpc::StatusCode::CANCELLED, "WatchRun cancelled by client"};
+    }
+
+    uint64_t sent_version = 0;
+    bool sent_any = false;
+    while (!context->IsCancelled()) {
+        auto snap = progress->Snapshot();
+        if (!sent_any || snap.version != sent_version) {
+            if (!writer->Write(ToRunStatus(snap))) { return Status::OK; }
+            sent_version = snap.version;
+            sent_any = true;
+        }
+        if (telemetry::RunProgress::IsTerminalStatus(snap.status)) {
+            return Status::OK;
+        }
+        // Coalesce: wait for the next change, then hold until the interval
+        // has elapsed so fast producers do not flood the stream.
+        auto next_send = std::chrono::steady_clock::now() + interval;
+        if (progress->WaitForChange(sent_version, interval)) {
+            std::this_thread::sleep_until(next_send);
+        }
+    }
+    return {grpc::StatusCode::CANCELLED, "WatchRun cancelled by client"};
+}
+
+auto TelemetryServiceImpl::IngestTelemetry(ServerContext* context,
+                                            grpc::ServerReader<TelemetryBatch>* reader,
+                                            IngestResponse* response) -> Status {
+    TelemetryBatch batch;
+    if (!reader->Read(&batch)) {
+        return {grpc::StatusCode::INVALID_ARGUMENT, "IngestTelemetry stream contained no batches"};
+    }
+
+    auto session = NewIngestSession();
+    try {
+        session->Begin(batch, GenerateUUID());
+
+        telemetry::obs::Context ctx;
+        ctx.request_id = session->RequestId();
+        ctx.dataset_id = session->RunId();
+        telemetry::obs::ScopedContext scope(ctx);
+
+        do {
+            if (context != nullptr && context->IsCancelled()) {
+                session->Fail("cancelled by client");
+                return {grpc::StatusCode::CANCELLED, "IngestTelemetry cancelled by client"};
+            }
+            if (session->Append(batch)) {
+                session->CollectInFlight();
+                session->FlushAsync();
+            }
+        } while (reader->Read(&batch));
+        // Read() also returns false when the client cancels mid-stream; a
+        // truncated stream must not be reported as a completed run.
+        if (context != nullptr && context->IsCancelled()) {
+            session->Fail("cancelled by client");
+            return {grpc::StatusCode::CANCELLED, "IngestTelemetry cancelled by client"};
+        }
+        session->CollectInFlight();
+        if (session->HasPending()) {
+            session->FlushAsync();
+            session->CollectInFlight();
+        }
+    } catch (const std::invalid_argument& e) {
+        session->Fail(e.what());
+        return {grpc::StatusCode::INVALID_ARGUMENT, e.what()};
+    } catch (const std::exception& e) {
+        session->Fail(e.what());
+        return {grpc::StatusCode::INTERNAL, e.what()};
+    }
+
+    session->Complete(response);
+    return Status::OK;
+}
+
+auto TelemetryServiceImpl::NewIngestSession() -> std::unique_ptr<telemetry::ingest::IngestSession> {
+    return std::make_unique<telemetry::ingest::IngestSession>(db_factory_(), progress_, ingest_observer_,
+                                                              ingest_flush_rows_);
+}
+
+auto TelemetryServiceImpl::MakeConnectionPool(const std::string& db_conn_str) -> std::shared_ptr<PooledDbConnectionManager> {
+    size_t pool_size = 8;
+    if (const char* env_pool_size = std::getenv("DB_POOL_SIZE")) {
+        try { pool_size = std::stoul(env_pool_size); } catch (...) {}
+    }
+    int timeout_ms = 5000;
+    if (const char* env_timeout = std::getenv("DB_ACQUIRE_TIMEOUT_MS")) {
+        try { timeout_ms = std::stoi(env_timeout); } catch (...) {}
+    }
+    PooledDbConnectionManager::ElasticArgs defaults;
+    defaults.min_idle = 2;
+    defaults.idle_timeout = std::chrono::milliseconds(60000);
+    defaults.health_check_interval = std::chrono::milliseconds(30000);
+    defaults.max_lifetime = std::chrono::minutes(30);
+    // Generation runs take the batch lane; GetRun/WatchRun keep two slots.
+    PooledDbConnectionManager::LaneArgs lanes;
+    lanes.interactive_reserved = 2;
+    lanes.maintenance_max = 1;
+    lanes.batch_timeout = std::chrono::milliseconds(60000);
+    lanes.maintenance_timeout = std::chrono::milliseconds(60000);
+    return std::make_shared<PooledDbConnectionManager>(
+        db_conn_str, pool_size, std::chrono::milliseconds(timeout_ms),
+        [](pqxx::connection& C) { DbClient::AttachConnection(C); },
+        PooledDbConnectionManager::ElasticArgs::FromEnv(defaults),
+        PooledDbConnectionManager::LaneArgs::FromEnv(lanes));
+}
+
+auto TelemetryServiceImpl::ResolveWatchInterval(const WatchRunRequest& request) const -> std::chrono::milliseconds {
+    if (request.interval_ms() > 0) {
+        return std::chrono::milliseconds(std::clamp(request.interval_ms(), 50, 60000));
+    }
+    return watch_interval_;
+}
@@ -1,13 +1,17 @@
 #pragma once
 
 #include <grpcpp/grpcpp.h>
+#include <chrono>
 #include <functional>
 #include <memory>
+#include <vector>
 #include "telemetry.grpc.pb.h"
 #include <spdlog/spdlog.h>
 #include "db_client.h"
 #include "idb_client.h"
+#include "ingest.h"
 #include "job_manager.h"
+#include "run_progress.h"
 
 using grpc::Server;
 using grpc::ServerBuilder;
@@ -18,16 +22,23 @@ using telemetry::GenerateRequest;
 using telemetry::GenerateResponse;
 using telemetry::GetRunRequest;
 using telemetry::RunStatus;
+using telemetry::WatchRunRequest;
+using telemetry::TelemetryBatch;
+using telemetry::IngestResponse;
 
 class TelemetryServiceImpl final : public ::telemetry::TelemetryService::Service {
 public:
     using DbFactory = std::function<std::shared_ptr<IDbClient>()>;
+    // Receives each committed ingest chunk when the stream requested fan_out.
+    using IngestObserver = telemetry::ingest::IngestSession::Observer;
 
+    // Every run and RPC shares one connection pool (see MakeConnectionPool).
     explicit TelemetryServiceImpl(std::string db_conn_str) 
-        : db_conn_str_(std::move(db_conn_str)) 
+        : db_conn_str_(std::move(db_conn_str)),
+          db_pool_(MakeConnectionPool(db_conn_str_))
     {
-        db_factory_ = [this]() {
-            return std::make_shared<DbClient>(db_conn_str_);
+        db_factory_ = [pool = db_pool_]() {
+            return std::make_shared<DbClient>(pool);
         };
         job_manager_ = std::make_unique<telemetry::JobManager>();
     }
@@ -44,11 +55,49 @@ public:
     auto GetRun(ServerContext* context, const GetRunRequest* request,
                   RunStatus* response) -> Status override;
 
+    // Pushes progress from in-memory run state, at most once per interval.
+    // Runs not owned by this process fall back to GetRunStatus on the DB;
+    // ERROR reads are retried, not streamed.
+    auto WatchRun(ServerContext* context, const WatchRunRequest* request,
+                  grpc::ServerWriter<RunStatus>* writer) -> Status override;
+
+    // Decodes streamed batches and writes them through BatchInsertTelemetry.
+    // At most one COPY is in flight while the next chunk is decoded, so a slow
+    // database stops Read() calls and gRPC flow control pushes back on the client.
+    auto IngestTelemetry(ServerContext* context, grpc::ServerReader<TelemetryBatch>* reader,
+                         IngestResponse* response) -> Status override;
+
+    // Shared with the completion-queue front end (async_server.h).
+    auto NewIngestSession() -> std::unique_ptr<telemetry::ingest::IngestSession>;
+    auto NewDbClient() -> std::shared_ptr<IDbClient> { return db_factory_(); }
+    auto Progress() -> std::shared_ptr<telemetry::RunProgressRegistry> { return progress_; }
+    auto ResolveWatchInterval(const WatchRunRequest& request) const -> std::chrono::milliseconds;
+    // WatchRun's DB fallback ends with UNAVAILABLE after this many
+    // consecutive polls that could not read the run (status "ERROR").
+    static constexpr int kMaxWatchErrorPolls = 5;
+
+    // Pool sized by DB_POOL_SIZE (default 8) and DB_ACQUIRE_TIMEOUT_MS, keeping
+    // DB_POOL_MIN_IDLE (default 2) connections warm and closing extras idle for
+    // DB_POOL_IDLE_TIMEOUT_MS (default 60000).
+    static auto MakeConnectionPool(const std::string& db_conn_str) -> std::shared_ptr<PooledDbConnectionManager>;
+    // nullptr when built from a DbFactory.
+    auto ConnectionPool() const -> std::shared_ptr<PooledDbConnectionManager> { return db_pool_; }
+
     void SetMaxConcurrentJobs(size_t n) { job_manager_->SetMaxConcurrentJobs(n); }
+    void SetWatchInterval(std::chrono::milliseconds interval) { watch_interval_ = interval; }
+    void SetIngestFlushRows(size_t n) { ingest_flush_rows_ = n > 0 ? n : 1; }
+    void SetIngestObserver(IngestObserver observer) { ingest_observer_ = std::move(observer); }
 
 private:
     std::string db_conn_str_;
+    std::shared_ptr<PooledDbConnectionManager> db_pool_;
     DbFactory db_factory_;
+    IngestObserver ingest_observer_;
+    std::shared_ptr<telemetry::RunProgressRegistry> progress_ = std::make_shared<telemetry::RunProgressRegistry>();
+    std::chrono::milliseconds watch_interval_{1000};
+    size_t ingest_flush_rows_ = 5000;
     std::unique_ptr<telemetry::JobManager> job_manager_;
 };
 
+auto GenerateUUID() -> std::string;
+auto ToRunStatus(const telemetry::RunProgressSnapshot& snap) -> RunStatus;
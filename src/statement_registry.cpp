@@ -0,0 +1,120 @@
+#include "statement_registry.h"
+#include <cstdint>
+#include <stdexcept>
+#include <fmt/format.h>
+#include "metrics.h"
+
+namespace telemetry::db {
+
+namespace {
+
+// FNV-1a: stable across builds, unlike std::hash, so shape names in
+// pg_prepared_statements and /metrics are recognizable between deploys.
+auto ShapeName(const std::string& sql) -> std::string {
+    uint64_t h = 14695981039346656037ULL;
+    for (unsigned char c : sql) {
+        h ^= c;
+        h *= 1099511628211ULL;
+    }
+    return fmt::format("shape_{:016x}", h);
+}
+
+} // namespace
+
+auto StatementRegistry::Instance() -> StatementRegistry& {
+    static StatementRegistry instance;
+    return instance;
+}
+
+auto StatementRegistry::Register(const std::string& name, const std::string& sql) -> void {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto [it, inserted] = statements_.try_emplace(name, Statement{sql, {}});
+    if (!inserted && it->second.sql != sql) {
+        throw std::invalid_argument("Prepared statement redefined: " + name);
+    }
+}
+
+auto StatementRegistry::IsRegistered(const std::string& name) const -> bool {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return statements_.count(name) > 0;
+}
+
+auto StatementRegistry::Sql(const std::string& name) const -> std::string {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = statements_.find(name);
+    if (it == statements_.end()) {
+        throw std::out_of_range("Unknown prepared statement: " + name);
+    }
+    return it->second.sql;
+}
+
+auto StatementRegistry::RegisterShape(const std::string& sql) -> std::optional<std::string> {
+    std::string name = ShapeName(sql);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (auto it = statements_.find(name); it != statements_.end()) {
+        if (it->second.sql != sql) { return std::nullopt; } // hash collision: run unnamed
+        return name;
+    }
+    if (shapes_ >= kMaxShapes) { return std::nullopt; }
+    statements_.emplace(name, Statement{sql, {}});
+    shapes_++;
+    return name;
+}
+
+auto StatementRegistry::Attach(const void* conn, int backend_pid) -> void {
+    std::lock_guard<std::mutex> lock(mutex_);
+    connections_[conn] = ConnectionState{backend_pid, {}};
+}
+
+auto StatementRegistry::Forget(const void* conn) -> void {
+    std::lock_guard<std::mutex> lock(mutex_);
+    connections_.erase(conn);
+}
+
+auto StatementRegistry::BeginUse(const void* conn, int backend_pid, const std::string& name) -> std::optional<std::string> {
+    std::optional<std::string> to_prepare;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = statements_.find(name);
+        if (it == statements_.end()) {
+            throw std::out_of_range("Unknown prepared statement: " + name);
+        }
+        it->second.stats.execs++;
+        auto& state = connections_[conn];
+        if (state.backend_pid != backend_pid) {
+            // Reconnected: the server session and its plans are gone.
+            state = ConnectionState{backend_pid, {}};
+        }
+        if (state.prepared.count(name) == 0) {
+            to_prepare = it->second.sql;
+        }
+    }
+    ::telemetry::metrics::MetricsRegistry::Instance().Increment("db_statement_execs_total", {{"statement", name}});
+    return to_prepare;
+}
+
+auto StatementRegistry::MarkPrepared(const void* conn, const std::string& name) -> void {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        connections_[conn].prepared.insert(name);
+        statements_[name].stats.prepares++;
+    }
+    ::telemetry::metrics::MetricsRegistry::Instance().Increment("db_statement_prepares_total", {{"statement", name}});
+}
+
+auto StatementRegistry::Stats() const -> std::map<std::string, StatementStats> {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::map<std::string, StatementStats> out;
+    for (const auto& [name, stmt] : statements_) {
+        out[name] = stmt.stats;
+    }
+    return out;
+}
+
+auto StatementRegistry::PreparedCount(const void* conn) const -> size_t {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = connections_.find(conn);
+    return it == connections_.end() ? 0 : it->second.prepared.size();
+}
+
+} // namespace telemetry::db
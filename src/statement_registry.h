@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace telemetry::db {
+
+/**
+ * @brief Process-wide catalog of named SQL statements, prepared lazily on
+ * each connection the first time that connection executes them.
+ *
+ * Connections are tracked by address together with their server backend
+ * PID, so a reconnected connection (or a new one allocated at a freed
+ * address) starts with nothing prepared and re-prepares on demand.
+ *
+ * Dynamic analytics queries register by shape: the parameterized SQL text
+ * names the statement, so every request with the same columns and filter
+ * combination reuses one plan. Shapes past kMaxShapes run unnamed.
+ */
+class StatementRegistry {
+public:
+    static constexpr size_t kMaxShapes = 512;
+
+    struct StatementStats {
+        long prepares = 0; // connections that prepared it
+        long execs = 0;
+    };
+
+    static auto Instance() -> StatementRegistry&;
+
+    // Idempotent for an identical definition; throws std::invalid_argument
+    // when a name is reused for different SQL.
+    auto Register(const std::string& name, const std::string& sql) -> void;
+    [[nodiscard]] auto IsRegistered(const std::string& name) const -> bool;
+    // Registered SQL text; throws std::out_of_range for an unknown name.
+    [[nodiscard]] auto Sql(const std::string& name) const -> std::string;
+
+    // Registers sql under a name derived from its text. Returns nullopt for
+    // a new shape once the shape budget is spent.
+    auto RegisterShape(const std::string& sql) -> std::optional<std::string>;
+
+    // Starts tracking a freshly opened connection / stops tracking a closed one.
+    auto Attach(const void* conn, int backend_pid) -> void;
+    auto Forget(const void* conn) -> void;
+
+    /**
+     * @brief Prepares name on C unless C already holds it, and counts one
+     * execution. Connection is pqxx::connection (or anything exposing
+     * prepare(name, sql) and backendpid()). Throws std::out_of_range for an
+     * unregistered name.
+     */
+    template <typename Connection>
+    auto UsePrepared(Connection& C, const std::string& name) -> void {
+        if (auto sql = BeginUse(&C, C.backendpid(), name)) {
+            C.prepare(name, *sql);
+            MarkPrepared(&C, name);
+        }
+    }
+
+    [[nodiscard]] auto Stats() const -> std::map<std::string, StatementStats>;
+    [[nodiscard]] auto PreparedCount(const void* conn) const -> size_t;
+
+private:
+    StatementRegistry() = default;
+
+    // Counts the exec; returns the SQL to prepare when conn lacks name.
+    auto BeginUse(const void* conn, int backend_pid, const std::string& name) -> std::optional<std::string>;
+    auto MarkPrepared(const void* conn, const std::string& name) -> void;
+
+    struct Statement {
+        std::string sql;
+        StatementStats stats;
+    };
+    struct ConnectionState {
+        int backend_pid = 0;
+        std::unordered_set<std::string> prepared;
+    };
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, Statement> statements_;
+    std::unordered_map<const void*, ConnectionState> connections_;
+    size_t shapes_ = 0;
+};
+
+} // namespace telemetry::db
@@ -74,6 +74,18 @@ inline auto SelectBucketSeconds(const std::string& start_time, const std::string
     return 604800;                             // 7d
 }
 
+// Buckets at least this wide default to approximate percentiles.
+constexpr int kApproxPercentileMinBucketSeconds = 3600;
+
+// "exact" | "approx" | "" / "auto" (approx for wide buckets); nullopt if invalid.
+inline auto ResolvePercentileMode(const std::string& requested, int bucket_seconds) -> std::optional<std::string> {
+    if (requested == "exact" || requested == "approx") { return requested; }
+    if (requested.empty() || requested == "auto") {
+        return bucket_seconds >= kApproxPercentileMinBucketSeconds ? "approx" : "exact";
+    }
+    return std::nullopt;
+}
+
 inline auto BucketLabel(int bucket_seconds) -> std::string {
     if (bucket_seconds == 300) { return "5m"; }
     if (bucket_seconds == 3600) { return "1h"; }
@@ -1,5 +1,6 @@
 #include "training/pca_trainer.h"
 #include "training/telemetry_iterator.h"
+#include "segment_file.h"
 #include <tuple>
 
 #include <algorithm>
@@ -224,9 +225,9 @@ auto TrainPcaFromDbBatched(std::shared_ptr<DbConnectionManager> manager,
         size_t batch_count = 0;
         while (iter.NextBatch(batch)) {
             batch_count++;
+            if (heartbeat) { heartbeat(); }
             if (batch_count % 10 == 0) {
                 spdlog::debug("Processed {} batches ({} rows)", batch_count, iter.TotalRowsProcessed());
-                if (heartbeat) { heartbeat(); }
             }
             for (const auto& v : batch) {
                 cb(v);
@@ -268,6 +269,44 @@ auto TrainPcaFromDb(std::shared_ptr<DbConnectionManager> manager,
 }
 // NOLINTEND(bugprone-easily-swappable-parameters)
 
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+auto TrainPcaFromSegments(const std::string& run_directory,
+                                 int n_components,
+                                 double percentile,
+                                 std::function<void()> heartbeat) -> PcaArtifact {
+    auto start = std::chrono::steady_clock::now();
+    auto paths = SegmentReader::ListSegments(run_directory);
+    if (paths.empty()) {
+        throw std::runtime_error("No segment files found in " + run_directory);
+    }
+
+    size_t rows_processed = 0;
+    auto for_each = [&](const std::function<void(const linalg::Vector&)>& cb) {
+        rows_processed = 0;
+        linalg::Vector v(5);
+        for (const auto& path : paths) {
+            auto data = SegmentReader::Read(path);
+            if (heartbeat) { heartbeat(); }
+            for (size_t i = 0; i < data.Size(); ++i) {
+                v[0] = data.cpu_usage[i];
+                v[1] = data.memory_usage[i];
+                v[2] = data.disk_utilization[i];
+                v[3] = data.network_rx_rate[i];
+                v[4] = data.network_tx_rate[i];
+                cb(v);
+            }
+            rows_processed += data.Size();
+        }
+    };
+
+    auto artifact = TrainPcaFromStream(for_each, telemetry::anomaly::FeatureVector::kSize, n_components, percentile);
+    double duration_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    spdlog::info("PCA training completed: segments={}, rows_processed={}, duration_ms={:.2f}",
+                 run_directory, rows_processed, duration_ms);
+    return artifact;
+}
+// NOLINTEND(bugprone-easily-swappable-parameters)
+
 // NOLINTBEGIN(bugprone-easily-swappable-parameters)
 auto TrainPcaFromSamples(const std::vector<linalg::Vector>& samples,
                                 int n_components,
@@ -67,6 +67,8 @@ struct PcaArtifact {
     int n_components = 0;
 };
 
+// `heartbeat` runs once per fetched batch on the training thread, so it should
+// be cheap (e.g. ProgressReporter::Beat) rather than a DB write.
 // NOLINTBEGIN(bugprone-easily-swappable-parameters)
 auto TrainPcaFromDb(std::shared_ptr<DbConnectionManager> manager,
                            const std::string& dataset_id,
@@ -81,6 +83,13 @@ auto TrainPcaFromDbBatched(std::shared_ptr<DbConnectionManager> manager,
                                   size_t batch_size,
                                   std::function<void()> heartbeat = nullptr) -> PcaArtifact;
 
+// Trains from the segment files of one run (SegmentWriter output) instead of
+// the database. `heartbeat` runs once per segment read.
+auto TrainPcaFromSegments(const std::string& run_directory,
+                                 int n_components,
+                                 double percentile,
+                                 std::function<void()> heartbeat = nullptr) -> PcaArtifact;
+
 auto TrainPcaFromSamples(const std::vector<linalg::Vector>& samples,
                                 int n_components,
                                 double percentile) -> PcaArtifact;
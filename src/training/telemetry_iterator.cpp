@@ -1,12 +1,14 @@
 #include "training/telemetry_iterator.h"
 #include <pqxx/pqxx>
 #include <spdlog/spdlog.h>
+#include "statement_registry.h"
 
-// Compatibility macro for libpqxx 6.x vs 7.x
+// Compatibility macro for libpqxx 6.x vs 7.x; prepares stmt on first use per connection.
+#define PQXX_USE_PREPARED(txn, stmt) telemetry::db::StatementRegistry::Instance().UsePrepared((txn).conn(), stmt)
 #if !defined(PQXX_VERSION_MAJOR) || (PQXX_VERSION_MAJOR < 7)
-#define PQXX_EXEC_PREPPED(txn, stmt, ...) (txn).exec_prepared(stmt, ##__VA_ARGS__) // NOLINT(clang-diagnostic-gnu-zero-variadic-macro-arguments)
+#define PQXX_EXEC_PREPPED(txn, stmt, ...) (PQXX_USE_PREPARED(txn, stmt), (txn).exec_prepared(stmt, ##__VA_ARGS__)) // NOLINT(clang-diagnostic-gnu-zero-variadic-macro-arguments)
 #else
-#define PQXX_EXEC_PREPPED(txn, stmt, ...) (txn).exec(pqxx::prepped{stmt}, pqxx::params{__VA_ARGS__}) // NOLINT(clang-diagnostic-gnu-zero-variadic-macro-arguments)
+#define PQXX_EXEC_PREPPED(txn, stmt, ...) (PQXX_USE_PREPARED(txn, stmt), (txn).exec(pqxx::prepped{stmt}, pqxx::params{__VA_ARGS__})) // NOLINT(clang-diagnostic-gnu-zero-variadic-macro-arguments)
 #endif
 
 namespace telemetry::training {
@@ -16,7 +18,16 @@ TelemetryBatchIterator::TelemetryBatchIterator(std::shared_ptr<DbConnectionManag
                                                size_t batch_size)
     : manager_(std::move(manager)),
       dataset_id_(std::move(dataset_id)),
-      batch_size_(batch_size) {}
+      batch_size_(batch_size) {
+    // Registered here rather than in DbClient's catalog so trainers that
+    // never construct a DbClient can still run it.
+    telemetry::db::StatementRegistry::Instance().Register("get_telemetry_batch",
+        "SELECT record_id, cpu_usage, memory_usage, disk_utilization, network_rx_rate, network_tx_rate "
+        "FROM host_telemetry_archival "
+        "WHERE run_id = $1 AND record_id > $2 "
+        "ORDER BY record_id "
+        "LIMIT $3");
+}
 
 auto TelemetryBatchIterator::NextBatch(std::vector<linalg::Vector>& out_batch) -> bool {
     out_batch.clear();
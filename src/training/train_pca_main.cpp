@@ -22,6 +22,7 @@ auto main(int argc, char** argv) -> int {
     std::string dataset_id;
     std::string output_dir = "artifacts/pca/default";
     std::string db_conn_str;
+    std::string segments_dir;
     int n_components = 3;
     double percentile = 99.5;
 
@@ -31,6 +32,8 @@ auto main(int argc, char** argv) -> int {
             dataset_id = argv[++i];
         } else if (arg == "--output_dir" && i + 1 < argc) {
             output_dir = argv[++i];
+        } else if (arg == "--segments_dir" && i + 1 < argc) {
+            segments_dir = argv[++i];
         } else if (arg == "--db_conn" && i + 1 < argc) {
             db_conn_str = argv[++i];
         } else if (arg == "--n_components" && i + 1 < argc) {
@@ -40,12 +43,35 @@ auto main(int argc, char** argv) -> int {
         }
     }
 
+    std::string output_path = output_dir + "/model.json";
+
+    if (!segments_dir.empty()) {
+        // Offline: train from segment files written by the generator's file sink.
+        try {
+            std::cout << "Training PCA from segments=" << segments_dir
+                      << " n_components=" << n_components
+                      << " percentile=" << percentile
+                      << std::endl;
+            auto train_start = std::chrono::steady_clock::now();
+            auto artifact = telemetry::training::TrainPcaFromSegments(segments_dir, n_components, percentile);
+            auto train_end = std::chrono::steady_clock::now();
+            telemetry::training::WriteArtifactJson(artifact, output_path);
+            std::chrono::duration<double> train_secs = train_end - train_start;
+            std::cout << "Training time (s): " << train_secs.count() << std::endl;
+            std::cout << "Artifact path: " << output_path << std::endl;
+        } catch (const std::exception& e) {
+            std::cerr << "Training failed: " << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
     if (db_conn_str.empty()) {
         db_conn_str = get_env("DATABASE_URL");
     }
 
     if (db_conn_str.empty()) {
-        std::cerr << "Missing DB connection string (use --db_conn or DATABASE_URL)." << std::endl;
+        std::cerr << "Missing DB connection string (use --db_conn, DATABASE_URL or --segments_dir)." << std::endl;
         return 1;
     }
 
@@ -54,8 +80,6 @@ auto main(int argc, char** argv) -> int {
         return 1;
     }
 
-    std::string output_path = output_dir + "/model.json";
-
     try {
         size_t row_count = 0;
         {
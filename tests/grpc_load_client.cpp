@@ -0,0 +1,132 @@
+#include <iostream>
+#include <string>
+#include <grpcpp/grpcpp.h>
+#include "telemetry.grpc.pb.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using grpc::Channel;
+using grpc::ClientContext;
+using grpc::Status;
+using telemetry::TelemetryService;
+using telemetry::GenerateRequest;
+using telemetry::GenerateResponse;
+using telemetry::GetRunRequest;
+using telemetry::RunStatus;
+using telemetry::WatchRunRequest;
+
+// Concurrency load test for the generator service. Each worker issues RPCs
+// back to back on its own channel and records per-call latency; the summary
+// reports throughput and latency percentiles across all workers.
+//
+// Usage: grpc_load_client [target] [concurrency] [requests_per_worker] [getrun|watch|generate]
+//   getrun   - GetRun against a run created up front (served from memory)
+//   watch    - open WatchRun and wait for the first update
+//   generate - GenerateTelemetry with a single host and 1 point (rejections past
+//              the JobManager concurrency limit count as failures)
+namespace {
+
+auto Percentile(const std::vector<double>& sorted, double p) -> double {
+    if (sorted.empty()) { return 0.0; }
+    auto idx = static_cast<size_t>(p / 100.0 * static_cast<double>(sorted.size() - 1));
+    return sorted[idx];
+}
+
+auto SmallGenerateRequest() -> GenerateRequest {
+    GenerateRequest request;
+    request.set_tier("LOADTEST");
+    request.set_host_count(1);
+    request.set_interval_seconds(60);
+    request.set_start_time_iso("2025-01-01T00:00:00Z");
+    request.set_end_time_iso("2025-01-01T00:01:00Z");
+    request.set_seed(999);
+    return request;
+}
+
+} // namespace
+
+auto main(int argc, char** argv) -> int {
+    std::string target = argc > 1 ? argv[1] : "localhost:52051";
+    int concurrency = argc > 2 ? std::stoi(argv[2]) : 32;
+    int per_worker = argc > 3 ? std::stoi(argv[3]) : 1000;
+    std::string rpc = argc > 4 ? argv[4] : "getrun";
+    if (concurrency <= 0 || per_worker <= 0) {
+        std::cerr << "concurrency and requests_per_worker must be positive" << std::endl;
+        return 1;
+    }
+
+    std::string run_id;
+    if (rpc != "generate") {
+        auto stub = TelemetryService::NewStub(grpc::CreateChannel(target, grpc::InsecureChannelCredentials()));
+        ClientContext context;
+        GenerateResponse response;
+        Status status = stub->GenerateTelemetry(&context, SmallGenerateRequest(), &response);
+        if (!status.ok()) {
+            std::cout << "Setup RPC failed: " << status.error_code() << ": " << status.error_message() << std::endl;
+            return 1;
+        }
+        run_id = response.run_id();
+    }
+
+    std::vector<std::vector<double>> latencies(static_cast<size_t>(concurrency));
+    std::atomic<long> failures{0};
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+
+    for (int w = 0; w < concurrency; ++w) {
+        workers.emplace_back([&, w]() {
+            // A channel per worker so calls are spread over separate connections.
+            grpc::ChannelArguments args;
+            args.SetInt("grpc.channel_id", w);
+            auto stub = TelemetryService::NewStub(
+                grpc::CreateCustomChannel(target, grpc::InsecureChannelCredentials(), args));
+            auto& samples = latencies[static_cast<size_t>(w)];
+            samples.reserve(static_cast<size_t>(per_worker));
+            for (int i = 0; i < per_worker; ++i) {
+                ClientContext context;
+                context.set_deadline(std::chrono::system_clock::now() + std::chrono::seconds(10));
+                auto t0 = std::chrono::steady_clock::now();
+                bool ok = false;
+                if (rpc == "generate") {
+                    GenerateResponse response;
+                    ok = stub->GenerateTelemetry(&context, SmallGenerateRequest(), &response).ok();
+                } else if (rpc == "watch") {
+                    WatchRunRequest request;
+                    request.set_run_id(run_id);
+                    auto reader = stub->WatchRun(&context, request);
+                    RunStatus update;
+                    ok = reader->Read(&update);
+                    context.TryCancel();
+                    (void)reader->Finish();
+                } else {
+                    GetRunRequest request;
+                    request.set_run_id(run_id);
+                    RunStatus response;
+                    ok = stub->GetRun(&context, request, &response).ok();
+                }
+                auto t1 = std::chrono::steady_clock::now();
+                if (!ok) { failures++; }
+                samples.push_back(std::chrono::duration<double, std::milli>(t1 - t0).count());
+            }
+        });
+    }
+    for (auto& t : workers) { t.join(); }
+    auto end = std::chrono::steady_clock::now();
+
+    std::vector<double> all;
+    for (const auto& v : latencies) { all.insert(all.end(), v.begin(), v.end()); }
+    std::sort(all.begin(), all.end());
+    double secs = std::chrono::duration<double>(end - start).count();
+
+    std::cout << "rpc=" << rpc << " concurrency=" << concurrency << " requests=" << all.size()
+              << " failures=" << failures.load() << std::endl;
+    std::cout << "Throughput (rpc/s): " << (secs > 0 ? static_cast<double>(all.size()) / secs : 0.0) << std::endl;
+    std::cout << "Latency ms p50=" << Percentile(all, 50.0)
+              << " p90=" << Percentile(all, 90.0)
+              << " p99=" << Percentile(all, 99.0)
+              << " max=" << (all.empty() ? 0.0 : all.back()) << std::endl;
+    return failures.load() == 0 ? 0 : 1;
+}
@@ -0,0 +1,107 @@
+#include <iostream>
+#include <string>
+#include <grpcpp/grpcpp.h>
+#include "telemetry.grpc.pb.h"
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cmath>
+
+using grpc::Channel;
+using grpc::ClientContext;
+using grpc::Status;
+using telemetry::TelemetryService;
+using telemetry::TelemetryBatch;
+using telemetry::IngestResponse;
+
+// Load generator for IngestTelemetry. Streams synthetic columnar batches as
+// fast as flow control allows and reports the sustained rows/sec.
+//
+// Usage: ingest_client [target] [total_rows] [rows_per_batch] [host_count]
+class IngestClient {
+public:
+    explicit IngestClient(std::shared_ptr<Channel> channel)
+        : stub_(TelemetryService::NewStub(std::move(channel))) {}
+
+    auto Run(long total_rows, int rows_per_batch, int host_count) -> bool {
+        ClientContext context;
+        IngestResponse response;
+        auto writer = stub_->IngestTelemetry(&context, &response);
+
+        std::mt19937_64 rng(999);
+        std::uniform_real_distribution<double> noise(-10.0, 10.0);
+        const int64_t base_ms = 1735689600000; // 2025-01-01T00:00:00Z
+
+        auto start = std::chrono::steady_clock::now();
+        long sent = 0;
+        bool first = true;
+        while (sent < total_rows) {
+            TelemetryBatch batch;
+            if (first) {
+                batch.set_request_id("ingest-load-client");
+                for (int h = 0; h < host_count; ++h) {
+                    auto* host = batch.add_hosts();
+                    host->set_host_id("host-" + std::to_string(h));
+                    host->set_project_id("proj-" + std::to_string(h % 5));
+                    host->set_region(h % 2 == 0 ? "us-east1" : "eu-west1");
+                }
+                batch.add_anomaly_types("point_spike");
+                first = false;
+            }
+            int n = static_cast<int>(std::min<long>(rows_per_batch, total_rows - sent));
+            for (int i = 0; i < n; ++i) {
+                long row = sent + i;
+                batch.add_host_index(static_cast<uint32_t>(row % host_count));
+                batch.add_metric_timestamp_ms(base_ms + (row / host_count) * 10000);
+                double cpu = 40.0 + noise(rng);
+                bool spike = row % 1000 == 0;
+                batch.add_cpu_usage(spike ? cpu + 50.0 : cpu);
+                batch.add_memory_usage(55.0 + noise(rng) / 4.0);
+                batch.add_disk_utilization(30.0 + noise(rng) / 2.0);
+                batch.add_network_rx_rate(10.0 + std::abs(noise(rng)));
+                batch.add_network_tx_rate(8.0 + std::abs(noise(rng)) / 2.0);
+                batch.add_anomaly_type_index(spike ? 1 : 0);
+            }
+            if (!writer->Write(batch)) {
+                std::cout << "Stream closed by server after " << sent << " rows" << std::endl;
+                break;
+            }
+            sent += n;
+        }
+        writer->WritesDone();
+        Status status = writer->Finish();
+        auto end = std::chrono::steady_clock::now();
+
+        if (!status.ok()) {
+            std::cout << "RPC failed: " << status.error_code() << ": " << status.error_message() << std::endl;
+            return false;
+        }
+        double secs = std::chrono::duration<double>(end - start).count();
+        std::cout << "Run ID: " << response.run_id()
+                  << " accepted=" << response.accepted_rows()
+                  << " rejected=" << response.rejected_rows()
+                  << " batches=" << response.batches()
+                  << " flushes=" << response.flushes() << std::endl;
+        std::cout << "Elapsed (s): " << secs
+                  << " rows/sec: " << (secs > 0 ? static_cast<double>(response.accepted_rows()) / secs : 0.0)
+                  << std::endl;
+        return true;
+    }
+
+private:
+    std::unique_ptr<TelemetryService::Stub> stub_;
+};
+
+auto main(int argc, char** argv) -> int {
+    std::string target = argc > 1 ? argv[1] : "localhost:52051";
+    long total_rows = argc > 2 ? std::stol(argv[2]) : 1000000;
+    int rows_per_batch = argc > 3 ? std::stoi(argv[3]) : 2000;
+    int host_count = argc > 4 ? std::stoi(argv[4]) : 100;
+    if (rows_per_batch <= 0 || host_count <= 0) {
+        std::cerr << "rows_per_batch and host_count must be positive" << std::endl;
+        return 1;
+    }
+
+    IngestClient client(grpc::CreateChannel(target, grpc::InsecureChannelCredentials()));
+    return client.Run(total_rows, rows_per_batch, host_count) ? 0 : 1;
+}
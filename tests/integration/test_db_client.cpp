@@ -349,6 +349,51 @@ TEST_F(DbClientTest, DeleteDatasetWithScores) {
     EXPECT_EQ(scores_after["total"], 0);
 }
 
+TEST_F(DbClientTest, ResetDatasetScoresStartsScoreSetOver) {
+    DbClient client(conn_str);
+    std::string run_id = GenerateUUID();
+
+    telemetry::GenerateRequest req;
+    req.set_tier("RESCORE_TEST");
+    req.set_start_time_iso("2025-01-01T00:00:00Z");
+    req.set_end_time_iso("2025-01-01T01:00:00Z");
+    req.set_interval_seconds(60);
+    req.set_host_count(1);
+    client.CreateRun(run_id, req, "SUCCEEDED");
+
+    TelemetryRecord rec;
+    rec.run_id = run_id;
+    rec.metric_timestamp = std::chrono::system_clock::now();
+    rec.ingestion_time = rec.metric_timestamp;
+    rec.host_id = "host-1";
+    rec.project_id = "proj-1";
+    rec.region = "us-test";
+    rec.labels_json = "{}";
+    client.BatchInsertTelemetry({rec, rec});
+    auto rows = client.FetchScoringRowsAfterRecord(run_id, 0, 10);
+    ASSERT_EQ(rows.size(), 2U);
+
+    std::string model_run_id = client.CreateModelRun(run_id, "test_rescore", {{"n_components", 3}});
+    client.InsertDatasetScores(run_id, model_run_id, {{rows[0].record_id, {0.5, false}}});
+    client.InsertDatasetScores(run_id, model_run_id, {{rows[1].record_id, {2.5, true}}});
+    auto scores = client.GetScores(run_id, model_run_id, 10, 0, false, 0, 0);
+    EXPECT_EQ(scores["total"], 2);
+    EXPECT_DOUBLE_EQ(scores["max_score"].get<double>(), 2.5);
+    EXPECT_EQ(client.GetScoredDatasetsForModel(model_run_id).size(), 1U);
+
+    ASSERT_NO_THROW(client.ResetDatasetScores(run_id, model_run_id));
+    EXPECT_EQ(client.GetScores(run_id, model_run_id, 10, 0, false, 0, 0)["total"], 0);
+    EXPECT_TRUE(client.GetScoredDatasetsForModel(model_run_id).empty());
+
+    client.InsertDatasetScores(run_id, model_run_id, {{rows[0].record_id, {0.7, false}}});
+    scores = client.GetScores(run_id, model_run_id, 10, 0, false, 0, 0);
+    EXPECT_EQ(scores["total"], 1);
+    ASSERT_EQ(scores["items"].size(), 1U);
+    EXPECT_EQ(scores["items"][0]["record_id"], rows[0].record_id);
+
+    ASSERT_NO_THROW(client.DeleteDatasetWithScores(run_id));
+}
+
 TEST_F(DbClientTest, GetTopKTruncation) {
     DbClient client(conn_str);
     std::string run_id = GenerateUUID();
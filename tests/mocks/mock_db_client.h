@@ -140,6 +140,32 @@ public:
         }
     }
 
+    void ResetDatasetScores(const std::string& /*dataset_id*/,
+                            const std::string& /*model_run_id*/) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        reset_scores_calls++;
+    }
+
+    void TruncateDatasetScores(const std::string& /*dataset_id*/,
+                               const std::string& /*model_run_id*/,
+                               long last_record_id) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        truncated_after.push_back(last_record_id);
+    }
+
+    void SaveEvalAggregates(const std::string& /*dataset_id*/,
+                            const std::string& /*model_run_id*/,
+                            const nlohmann::json& aggregates) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        saved_eval_aggregates = aggregates;
+    }
+
+    void DeleteEvalAggregates(const std::string& /*dataset_id*/,
+                              const std::string& /*model_run_id*/) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        saved_eval_aggregates = nullptr;
+    }
+
     long GetDatasetRecordCount(const std::string& /*dataset_id*/) override {
         return 100;
     }
@@ -164,7 +190,9 @@ public:
                                         const std::string& /*region*/,
                                         const std::string& /*sort_by*/,
                                         const std::string& /*sort_order*/,
-                                        const std::string& /*anchor_time*/) override {
+                                        const std::string& /*anchor_time*/,
+                                        const std::string& /*cursor*/ = "",
+                                        bool /*exact_count*/ = false) override {
         return nlohmann::json::array();
     }
     nlohmann::json GetDatasetRecord(const std::string& /*run_id*/, long /*record_id*/) override { return {}; }
@@ -187,7 +215,17 @@ public:
                              bool /*only_anomalies*/,
                              double /*min_score*/,
                              double /*max_score*/) override {
-        return nlohmann::json::array();
+        return scores_response;
+    }
+    telemetry::api::JsonFieldsWriter QueryScores(const std::string& dataset_id,
+                                                 const std::string& model_run_id,
+                                                 int limit,
+                                                 int offset,
+                                                 bool only_anomalies,
+                                                 double min_score,
+                                                 double max_score) override {
+        if (should_fail_scores_query) { throw std::runtime_error("Simulated scores query failure"); }
+        return IDbClient::QueryScores(dataset_id, model_run_id, limit, offset, only_anomalies, min_score, max_score);
     }
     nlohmann::json ListInferenceRuns(const std::string& /*dataset_id*/,
                                      const std::string& /*model_run_id*/,
@@ -203,7 +241,8 @@ public:
                                   const std::string& /*model_run_id*/,
                                   int /*points*/,
                                   int /*max_samples*/) override {
-        return {};
+        eval_calls++;
+        return eval_response;
     }
     nlohmann::json GetErrorDistribution(const std::string& /*dataset_id*/,
                                         const std::string& /*model_run_id*/,
@@ -231,7 +270,8 @@ public:
                                  const std::string& /*is_anomaly*/,
                                  const std::string& /*anomaly_type*/,
                                  const std::string& /*start_time*/,
-                                 const std::string& /*end_time*/) override {
+                                 const std::string& /*end_time*/,
+                                 const std::string& /*percentile_mode*/ = "exact") override {
         return {};
     }
     nlohmann::json GetHistogram(const std::string& /*run_id*/,
@@ -275,8 +315,8 @@ public:
         j["job_id"] = job_id;
         j["status"] = last_job_status.empty() ? "PENDING" : last_job_status;
         j["total_rows"] = 100;
-        j["processed_rows"] = 0;
-        j["last_record_id"] = 0;
+        j["processed_rows"] = resume_processed_rows;
+        j["last_record_id"] = resume_last_record_id;
         return j;
     }
 
@@ -291,11 +331,17 @@ public:
         for (int i = 0; i < std::min(limit, 10); ++i) {
             ScoringRow r;
             r.record_id = last_record_id + i + 1;
+            r.is_anomaly = r.record_id % 10 == 0;
+            r.region = r.record_id % 2 == 0 ? "us-east1" : "eu-west1";
             rows.push_back(r);
         }
         return rows;
     }
 
+    std::shared_ptr<telemetry::api::ColumnarDataset> LoadColumnarDataset(const std::string& /*run_id*/) override {
+        return nullptr;
+    }
+
     std::string CreateScoreJob(const std::string& /*dataset_id*/, 
                                const std::string& /*model_run_id*/,
                                const std::string& /*request_id*/ = "") override {
@@ -312,13 +358,28 @@ public:
         return nlohmann::json::array();
     }
 
+    nlohmann::json GetAnalyticsLatestScoreJob(const std::string& /*dataset_id*/,
+                                              const std::string& /*model_run_id*/) override {
+        return latest_score_job;
+    }
+
     // Inspection helpers
     bool should_fail_insert = false;
     bool should_fail_fetch = false;
+    bool should_fail_scores_query = false;
     std::string mock_artifact_path = "artifacts/pca/default/model.json";
     std::string last_job_id;
     std::string last_job_status;
     std::string last_job_error;
+    nlohmann::json saved_eval_aggregates;
+    int reset_scores_calls = 0;
+    std::vector<long> truncated_after;
+    long resume_processed_rows = 0; // checkpoint GetScoreJob reports
+    long resume_last_record_id = 0;
+    nlohmann::json eval_response = nlohmann::json::object();
+    int eval_calls = 0;
+    nlohmann::json latest_score_job = nlohmann::json::object();
+    nlohmann::json scores_response = {{"items", nlohmann::json::array()}, {"total", 0}};
     std::string last_model_run_id;
     std::string last_model_run_status;
     std::map<std::string, std::string> model_run_statuses; // Store status per ID
@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+#include "analytics_cache.h"
+#include <thread>
+
+namespace {
+
+using telemetry::api::AnalyticsCache;
+
+const AnalyticsCache::DatasetVersion kDone{true, 100};
+
+TEST(AnalyticsCacheTest, FingerprintIgnoresEmptyParamsAndOrder) {
+    auto a = AnalyticsCache::Fingerprint("topk", "ds-1", {{"k", "10"}, {"region", ""}, {"column", "region"}});
+    auto b = AnalyticsCache::Fingerprint("topk", "ds-1", {{"column", "region"}, {"k", "10"}});
+    EXPECT_EQ(a, b);
+    EXPECT_NE(a, AnalyticsCache::Fingerprint("topk", "ds-2", {{"column", "region"}, {"k", "10"}}));
+    EXPECT_NE(a, AnalyticsCache::Fingerprint("histogram", "ds-1", {{"column", "region"}, {"k", "10"}}));
+}
+
+TEST(AnalyticsCacheTest, FingerprintDoesNotCollideOnSeparatorsInValues) {
+    EXPECT_NE(AnalyticsCache::Fingerprint("topk", "ds-1", {{"a", "1&b=2"}}),
+              AnalyticsCache::Fingerprint("topk", "ds-1", {{"a", "1"}, {"b", "2"}}));
+    EXPECT_NE(AnalyticsCache::Fingerprint("topk", "ds|1", {{"k", "10"}}),
+              AnalyticsCache::Fingerprint("topk|ds", "1", {{"k", "10"}}));
+}
+
+TEST(AnalyticsCacheTest, HitAfterPutForCompletedDataset) {
+    AnalyticsCache cache;
+    EXPECT_FALSE(cache.Get("k1", kDone).has_value());
+    cache.Put("k1", "ds-1", kDone, {{"row_count", 100}});
+    auto hit = cache.Get("k1", kDone);
+    ASSERT_TRUE(hit.has_value());
+    EXPECT_EQ((*hit)["row_count"], 100);
+    auto stats = cache.GetStats();
+    EXPECT_EQ(stats.hits, 1);
+    EXPECT_EQ(stats.misses, 1);
+    EXPECT_EQ(stats.size, 1U);
+}
+
+TEST(AnalyticsCacheTest, CompletedEntryMissesAfterRetentionTrimsRows) {
+    AnalyticsCache cache;
+    cache.Put("k1", "ds-1", kDone, {{"row_count", 100}});
+    EXPECT_FALSE(cache.Get("k1", {true, 60}).has_value());
+    EXPECT_FALSE(cache.Get("k1", kDone).has_value()); // the stale entry was dropped
+}
+
+TEST(AnalyticsCacheTest, InProgressEntriesFollowRowCountAndTtl) {
+    AnalyticsCache cache(AnalyticsCache::AnalyticsCacheArgs{1024 * 1024, std::chrono::milliseconds(50)});
+    cache.Put("k1", "ds-1", {false, 10}, nlohmann::json::array());
+    EXPECT_TRUE(cache.Get("k1", {false, 10}).has_value());
+    EXPECT_FALSE(cache.Get("k1", {false, 20}).has_value()); // rows moved: dropped
+
+    cache.Put("k1", "ds-1", {false, 20}, nlohmann::json::array());
+    EXPECT_FALSE(cache.Get("k1", {true, 20}).has_value()); // finished since: recompute
+
+    cache.Put("k1", "ds-1", {false, 30}, nlohmann::json::array());
+    std::this_thread::sleep_for(std::chrono::milliseconds(80));
+    EXPECT_FALSE(cache.Get("k1", {false, 30}).has_value());
+    EXPECT_EQ(cache.GetStats().size, 0U);
+}
+
+TEST(AnalyticsCacheTest, EvictsLeastRecentlyUsedWithinByteBudget) {
+    nlohmann::json payload = {{"blob", std::string(300, 'x')}};
+    size_t entry_bytes = payload.dump().size() + 256; // key + overhead headroom
+    AnalyticsCache cache(AnalyticsCache::AnalyticsCacheArgs{entry_bytes * 2, std::chrono::milliseconds(1000)});
+    cache.Put("a", "ds-1", kDone, payload);
+    cache.Put("b", "ds-1", kDone, payload);
+    EXPECT_TRUE(cache.Get("a", kDone).has_value()); // "b" is now least recently used
+    cache.Put("c", "ds-1", kDone, payload);
+
+    EXPECT_TRUE(cache.Get("a", kDone).has_value());
+    EXPECT_FALSE(cache.Get("b", kDone).has_value());
+    EXPECT_TRUE(cache.Get("c", kDone).has_value());
+    auto stats = cache.GetStats();
+    EXPECT_EQ(stats.evictions, 1);
+    EXPECT_LE(stats.bytes_used, stats.max_bytes);
+
+    AnalyticsCache disabled(AnalyticsCache::AnalyticsCacheArgs{0, std::chrono::milliseconds(1000)});
+    disabled.Put("a", "ds-1", kDone, payload);
+    EXPECT_FALSE(disabled.Get("a", kDone).has_value());
+}
+
+TEST(AnalyticsCacheTest, InvalidateDatasetDropsOnlyThatDataset) {
+    AnalyticsCache cache;
+    cache.Put("a", "ds-1", kDone, 1);
+    cache.Put("b", "ds-1", kDone, 2);
+    cache.Put("c", "ds-2", kDone, 3);
+    cache.InvalidateDataset("ds-1");
+    EXPECT_FALSE(cache.Get("a", kDone).has_value());
+    EXPECT_FALSE(cache.Get("b", kDone).has_value());
+    EXPECT_TRUE(cache.Get("c", kDone).has_value());
+    EXPECT_EQ(cache.GetStats().size, 1U);
+}
+
+} // namespace
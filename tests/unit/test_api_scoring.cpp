@@ -4,7 +4,11 @@
 #include <httplib.h>
 #include <nlohmann/json.hpp>
 #include <thread>
+#include <algorithm>
 #include <chrono>
+#include <cstring>
+#include <regex>
+#include <vector>
 
 #ifndef TELEMETRY_SOURCE_DIR
 #define TELEMETRY_SOURCE_DIR "."
@@ -17,6 +21,16 @@ public:
     static void HandleScoreDatasetJob(ApiServer& server, const httplib::Request& req, httplib::Response& res) {
         server.HandleScoreDatasetJob(req, res);
     }
+    static void HandleGetScores(ApiServer& server, const httplib::Request& req, httplib::Response& res) {
+        server.HandleGetScores(req, res);
+    }
+    static void HandleModelEval(ApiServer& server, const httplib::Request& req, httplib::Response& res) {
+        server.HandleModelEval(req, res);
+    }
+    static void HandleInferenceBatch(ApiServer& server, const httplib::Request& req, httplib::Response& res,
+                                     const httplib::ContentReader& reader) {
+        server.HandleInferenceBatch(req, res, reader);
+    }
 };
 
 class ApiScoringTest : public ::testing::Test {
@@ -77,4 +91,205 @@ TEST_F(ApiScoringTest, ScoringJobFailsOnFetchError) {
     EXPECT_EQ(mock_db->last_job_error, "Simulated fetch failure");
 }
 
+TEST_F(ApiScoringTest, CompletedJobSavesEvalAggregates) {
+    httplib::Request req;
+    req.body = R"({"dataset_id": "ds-1", "model_run_id": "model-1"})";
+    httplib::Response res;
+
+    ApiServerTestPeer::HandleScoreDatasetJob(*server, req, res);
+    EXPECT_EQ(res.status, 202);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    ASSERT_EQ(mock_db->last_job_status, "COMPLETED");
+    nlohmann::json saved;
+    {
+        std::lock_guard<std::mutex> lock(mock_db->mutex_);
+        saved = mock_db->saved_eval_aggregates;
+        EXPECT_EQ(mock_db->reset_scores_calls, 1);
+    }
+    ASSERT_FALSE(saved.is_null());
+    auto aggregates = telemetry::stats::EvalAggregates::FromJson(saved);
+    EXPECT_EQ(aggregates.Samples(), 100);
+    auto confusion = aggregates.Eval(10)["confusion"];
+    EXPECT_EQ(confusion["tp"].get<long>() + confusion["fn"].get<long>(), 10);
+    auto regions = aggregates.ErrorDistribution("region");
+    ASSERT_TRUE(regions.has_value());
+    EXPECT_EQ(regions->size(), 2U);
+}
+
+TEST_F(ApiScoringTest, ResumedJobDropsScoresPastCheckpoint) {
+    mock_db->resume_processed_rows = 40;
+    mock_db->resume_last_record_id = 40;
+    httplib::Request req;
+    req.body = R"({"dataset_id": "ds-1", "model_run_id": "model-1"})";
+    httplib::Response res;
+
+    ApiServerTestPeer::HandleScoreDatasetJob(*server, req, res);
+    EXPECT_EQ(res.status, 202);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    ASSERT_EQ(mock_db->last_job_status, "COMPLETED");
+    std::lock_guard<std::mutex> lock(mock_db->mutex_);
+    EXPECT_EQ(mock_db->reset_scores_calls, 0);
+    EXPECT_EQ(mock_db->truncated_after, std::vector<long>{40});
+}
+
+TEST_F(ApiScoringTest, ScoresStreamAsChunkedJson) {
+    mock_db->scores_response = {{"items", {{{"record_id", 7}, {"score", 1.5}}}}, {"total", 1}};
+    httplib::Request req;
+    req.params.emplace("dataset_id", "ds-1");
+    req.params.emplace("model_run_id", "model-1");
+    req.headers.emplace("X-Request-ID", "req-stream");
+    httplib::Response res;
+
+    ApiServerTestPeer::HandleGetScores(*server, req, res);
+    ASSERT_TRUE(res.is_chunked_content_provider_);
+    EXPECT_TRUE(res.body.empty());
+
+    std::string body;
+    bool done = false;
+    httplib::DataSink sink;
+    sink.write = [&body](const char* data, size_t len) {
+        body.append(data, len);
+        return true;
+    };
+    sink.done = [&done]() { done = true; };
+    ASSERT_TRUE(res.content_provider_(0, 0, sink));
+    EXPECT_TRUE(done);
+
+    auto j = nlohmann::json::parse(body);
+    EXPECT_EQ(j["items"][0]["record_id"], 7);
+    EXPECT_EQ(j["total"], 1);
+    EXPECT_EQ(j["request_id"], "req-stream");
+}
+
+TEST_F(ApiScoringTest, ScoresQueryFailureIsA500BeforeStreaming) {
+    mock_db->should_fail_scores_query = true;
+    httplib::Request req;
+    req.params.emplace("dataset_id", "ds-1");
+    req.params.emplace("model_run_id", "model-1");
+    httplib::Response res;
+
+    ApiServerTestPeer::HandleGetScores(*server, req, res);
+    EXPECT_FALSE(res.is_chunked_content_provider_);
+    EXPECT_EQ(res.status, 500);
+    auto j = nlohmann::json::parse(res.body);
+    EXPECT_EQ(j["error"]["message"], "Simulated scores query failure");
+}
+
+TEST_F(ApiScoringTest, EvalIsCachedOnlyOnceTheScoreJobCompleted) {
+    telemetry::RunStatus done;
+    done.set_status("SUCCEEDED");
+    done.set_inserted_rows(100);
+    ON_CALL(*mock_db, GetRunStatus(::testing::_)).WillByDefault(::testing::Return(done));
+    EXPECT_CALL(*mock_db, GetRunStatus(::testing::_)).Times(::testing::AnyNumber());
+    mock_db->eval_response = {{"roc", nlohmann::json::array({{{"fpr", 0.0}, {"tpr", 0.5}}})}};
+
+    auto eval = [this]() {
+        httplib::Request req;
+        req.path = "/models/model-1/eval";
+        std::regex_match(req.path, req.matches, std::regex(R"(/models/([^/]+)/eval)"));
+        req.params.emplace("dataset_id", "ds-1");
+        httplib::Response res;
+        ApiServerTestPeer::HandleModelEval(*server, req, res);
+        EXPECT_EQ(res.status, 200);
+        return nlohmann::json::parse(res.body)["meta"]["cache_hit"].get<bool>();
+    };
+
+    // A scan that races a running job is served but never stored.
+    mock_db->latest_score_job = {{"job_id", "job-1"}, {"status", "RUNNING"}, {"processed_rows", 50}};
+    EXPECT_FALSE(eval());
+    EXPECT_FALSE(eval());
+    EXPECT_EQ(mock_db->eval_calls, 2);
+
+    mock_db->latest_score_job = {{"job_id", "job-1"}, {"status", "COMPLETED"}, {"processed_rows", 100}};
+    EXPECT_FALSE(eval());
+    EXPECT_TRUE(eval());
+    EXPECT_EQ(mock_db->eval_calls, 3);
+
+    // A rescore completing under a new job id misses the old entry.
+    mock_db->latest_score_job = {{"job_id", "job-2"}, {"status", "COMPLETED"}, {"processed_rows", 100}};
+    EXPECT_FALSE(eval());
+    EXPECT_EQ(mock_db->eval_calls, 4);
+}
+
+// Feeds body to the handler in uneven chunks, as a socket would.
+static auto ChunkedReader(const std::string& body, size_t chunk) -> httplib::ContentReader {
+    return httplib::ContentReader(
+        httplib::ContentReader::Reader([body, chunk](const httplib::ContentReceiver& receiver) {
+            for (size_t off = 0; off < body.size(); off += chunk) {
+                if (!receiver(body.data() + off, std::min(chunk, body.size() - off))) { return false; }
+            }
+            return true;
+        }),
+        nullptr);
+}
+
+TEST_F(ApiScoringTest, BatchInferenceScoresPackedRows) {
+    constexpr size_t kRows = 1000;
+    std::vector<double> values;
+    for (size_t i = 0; i < kRows; ++i) {
+        double spike = (i % 97 == 0) ? 50.0 : 0.0;
+        values.insert(values.end(), {0.1 * static_cast<double>(i % 10) + spike, 40.0 + static_cast<double>(i % 7),
+                                     55.0, 1000.0 + static_cast<double>(i), 800.0 - spike});
+    }
+    std::string body(values.size() * sizeof(double), '\0');
+    std::memcpy(body.data(), values.data(), body.size()); // little-endian host
+
+    httplib::Request req;
+    req.params.emplace("model_run_id", "model-1");
+    req.headers.emplace("Content-Type", "application/octet-stream");
+    req.headers.emplace("Content-Length", std::to_string(body.size()));
+    httplib::Response res;
+    ApiServerTestPeer::HandleInferenceBatch(*server, req, res, ChunkedReader(body, 37));
+
+    ASSERT_EQ(res.status, 200) << res.body;
+    EXPECT_EQ(res.get_header_value("X-Rows"), std::to_string(kRows));
+    ASSERT_EQ(res.content_length_, kRows * 9);
+    std::string out;
+    httplib::DataSink sink;
+    sink.write = [&out](const char* data, size_t len) {
+        out.append(data, len);
+        return true;
+    };
+    while (out.size() < res.content_length_) {
+        ASSERT_TRUE(res.content_provider_(out.size(), res.content_length_ - out.size(), sink));
+    }
+    ASSERT_EQ(out.size(), kRows * 9);
+
+    telemetry::anomaly::PcaModel model;
+    model.Load(mock_db->mock_artifact_path);
+    long anomalies = 0;
+    for (size_t i = 0; i < kRows; ++i) {
+        telemetry::anomaly::FeatureVector v;
+        std::memcpy(v.data.data(), values.data() + i * 5, sizeof(v.data));
+        auto expected = model.Score(v);
+        double error = 0.0;
+        std::memcpy(&error, out.data() + i * sizeof(double), sizeof(double));
+        EXPECT_DOUBLE_EQ(error, expected.reconstruction_error) << "row " << i;
+        EXPECT_EQ(out[kRows * sizeof(double) + i] != 0, expected.is_anomaly) << "row " << i;
+        anomalies += expected.is_anomaly ? 1 : 0;
+    }
+    EXPECT_EQ(res.get_header_value("X-Anomaly-Count"), std::to_string(anomalies));
+}
+
+TEST_F(ApiScoringTest, BatchInferenceRejectsPartialRows) {
+    std::string body(41, '\0');
+    httplib::Request req;
+    req.params.emplace("model_run_id", "model-1");
+    req.headers.emplace("Content-Type", "application/octet-stream");
+    httplib::Response res;
+    // No Content-Length (chunked upload): caught once the body ends mid-row.
+    ApiServerTestPeer::HandleInferenceBatch(*server, req, res, ChunkedReader(body, 16));
+    EXPECT_EQ(res.status, 400);
+    EXPECT_EQ(nlohmann::json::parse(res.body)["error"]["code"], "E_HTTP_INVALID_ARGUMENT");
+
+    req.headers.emplace("Content-Length", "41");
+    httplib::Response early;
+    ApiServerTestPeer::HandleInferenceBatch(*server, req, early, ChunkedReader(body, 16));
+    EXPECT_EQ(early.status, 400);
+}
+
 } // namespace telemetry::api
@@ -0,0 +1,291 @@
+#include <gtest/gtest.h>
+#include "async_server.h"
+#include "mocks/mock_db_client.h"
+#include <grpcpp/grpcpp.h>
+#include <future>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+auto MakeIngestBatch(int rows) -> telemetry::TelemetryBatch {
+    telemetry::TelemetryBatch batch;
+    for (int i = 0; i < rows; ++i) {
+        batch.add_host_index(0);
+        batch.add_metric_timestamp_ms(1735689600000 + i * 1000);
+        batch.add_cpu_usage(40.0);
+        batch.add_memory_usage(50.0);
+        batch.add_disk_utilization(30.0);
+        batch.add_network_rx_rate(10.0);
+        batch.add_network_tx_rate(8.0);
+    }
+    return batch;
+}
+
+} // namespace
+
+TEST(AsyncServerTest, ServesUnaryCallsConcurrently) {
+    auto mock_db = std::make_shared<MockDbClient>();
+    telemetry::RunStatus db_status;
+    db_status.set_run_id("db-run");
+    db_status.set_status("SUCCEEDED");
+    EXPECT_CALL(*mock_db, GetRunStatus("db-run")).WillRepeatedly(testing::Return(db_status));
+
+    TelemetryServiceImpl service([mock_db]() { return mock_db; });
+    AsyncTelemetryServer server(service, 2);
+    server.Start("");
+    auto stub = telemetry::TelemetryService::NewStub(server.InProcessChannel());
+
+    std::vector<std::thread> clients;
+    std::atomic<int> ok_count{0};
+    for (int c = 0; c < 8; ++c) {
+        clients.emplace_back([&]() {
+            for (int i = 0; i < 20; ++i) {
+                grpc::ClientContext context;
+                telemetry::GetRunRequest req;
+                req.set_run_id("db-run");
+                telemetry::RunStatus resp;
+                if (stub->GetRun(&context, req, &resp).ok() && resp.status() == "SUCCEEDED") { ok_count++; }
+            }
+        });
+    }
+    for (auto& t : clients) { t.join(); }
+    EXPECT_EQ(ok_count.load(), 160);
+    server.Shutdown();
+}
+
+TEST(AsyncServerTest, WatchRunFallsBackToDbForUnknownRuns) {
+    auto mock_db = std::make_shared<MockDbClient>();
+    telemetry::RunStatus db_status;
+    db_status.set_run_id("db-run");
+    db_status.set_status("SUCCEEDED");
+    db_status.set_inserted_rows(42);
+    EXPECT_CALL(*mock_db, GetRunStatus("db-run")).WillRepeatedly(testing::Return(db_status));
+
+    TelemetryServiceImpl service([mock_db]() { return mock_db; });
+    AsyncTelemetryServer server(service, 1);
+    server.Start("");
+    auto stub = telemetry::TelemetryService::NewStub(server.InProcessChannel());
+
+    grpc::ClientContext context;
+    telemetry::WatchRunRequest req;
+    req.set_run_id("db-run");
+    auto reader = stub->WatchRun(&context, req);
+    telemetry::RunStatus update;
+    ASSERT_TRUE(reader->Read(&update));
+    EXPECT_EQ(update.inserted_rows(), 42);
+    EXPECT_FALSE(reader->Read(&update));
+    EXPECT_TRUE(reader->Finish().ok());
+    server.Shutdown();
+}
+
+TEST(AsyncServerTest, WatchRunGivesUpWhenTheDbStaysDown) {
+    auto mock_db = std::make_shared<MockDbClient>();
+    telemetry::RunStatus db_error;
+    db_error.set_run_id("db-run");
+    db_error.set_status("ERROR");
+    db_error.set_error("connection refused");
+    telemetry::RunStatus db_status;
+    db_status.set_run_id("db-run");
+    db_status.set_status("SUCCEEDED");
+    {
+        testing::InSequence seq;
+        // A transient failure is retried without being streamed...
+        EXPECT_CALL(*mock_db, GetRunStatus("db-run")).WillOnce(testing::Return(db_error));
+        EXPECT_CALL(*mock_db, GetRunStatus("db-run")).WillOnce(testing::Return(db_status));
+        // ...but a DB that stays down ends the stream.
+        EXPECT_CALL(*mock_db, GetRunStatus("db-run"))
+            .Times(TelemetryServiceImpl::kMaxWatchErrorPolls)
+            .WillRepeatedly(testing::Return(db_error));
+    }
+
+    TelemetryServiceImpl service([mock_db]() { return mock_db; });
+    AsyncTelemetryServer server(service, 1);
+    server.Start("");
+    auto stub = telemetry::TelemetryService::NewStub(server.InProcessChannel());
+
+    telemetry::WatchRunRequest req;
+    req.set_run_id("db-run");
+    req.set_interval_ms(50);
+    {
+        grpc::ClientContext context;
+        auto reader = stub->WatchRun(&context, req);
+        telemetry::RunStatus update;
+        ASSERT_TRUE(reader->Read(&update));
+        EXPECT_EQ(update.status(), "SUCCEEDED");
+        EXPECT_FALSE(reader->Read(&update));
+        EXPECT_TRUE(reader->Finish().ok());
+    }
+    {
+        grpc::ClientContext context;
+        auto reader = stub->WatchRun(&context, req);
+        telemetry::RunStatus update;
+        EXPECT_FALSE(reader->Read(&update));
+        auto status = reader->Finish();
+        EXPECT_EQ(status.error_code(), grpc::StatusCode::UNAVAILABLE);
+        EXPECT_NE(status.error_message().find("connection refused"), std::string::npos);
+    }
+    server.Shutdown();
+}
+
+TEST(AsyncServerTest, IngestStreamsThroughSession) {
+    auto mock_db = std::make_shared<MockDbClient>();
+    std::mutex mu;
+    size_t inserted = 0;
+    EXPECT_CALL(*mock_db, CreateRun(testing::_, testing::_, testing::_, testing::_)).Times(1);
+    EXPECT_CALL(*mock_db, Heartbeat(testing::_, testing::_)).Times(testing::AtLeast(0));
+    EXPECT_CALL(*mock_db, UpdateRunStatus(testing::_, testing::_, testing::_, testing::_)).Times(testing::AtLeast(0));
+    EXPECT_CALL(*mock_db, BatchInsertTelemetry(testing::_))
+        .WillRepeatedly([&](const std::vector<TelemetryRecord>& records) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            std::lock_guard<std::mutex> lock(mu);
+            inserted += records.size();
+        });
+
+    TelemetryServiceImpl service([mock_db]() { return mock_db; });
+    service.SetIngestFlushRows(8);
+    AsyncTelemetryServer server(service, 2);
+    server.Start("");
+    auto stub = telemetry::TelemetryService::NewStub(server.InProcessChannel());
+
+    grpc::ClientContext context;
+    telemetry::IngestResponse response;
+    auto writer = stub->IngestTelemetry(&context, &response);
+    for (int b = 0; b < 10; ++b) {
+        auto batch = MakeIngestBatch(4);
+        if (b == 0) { batch.add_hosts()->set_host_id("host-a"); }
+        ASSERT_TRUE(writer->Write(batch));
+    }
+    writer->WritesDone();
+    auto status = writer->Finish();
+    server.Shutdown();
+
+    ASSERT_TRUE(status.ok()) << status.error_message();
+    EXPECT_EQ(response.accepted_rows(), 40);
+    EXPECT_EQ(response.flushes(), 5);
+    EXPECT_EQ(inserted, 40u);
+}
+
+TEST(AsyncServerTest, IngestRejectsMalformedBatch) {
+    auto mock_db = std::make_shared<MockDbClient>();
+    EXPECT_CALL(*mock_db, CreateRun(testing::_, testing::_, testing::_, testing::_)).Times(1);
+    EXPECT_CALL(*mock_db, UpdateRunStatus(testing::_, "FAILED", testing::_, testing::_)).Times(1);
+
+    TelemetryServiceImpl service([mock_db]() { return mock_db; });
+    AsyncTelemetryServer server(service, 1);
+    server.Start("");
+    auto stub = telemetry::TelemetryService::NewStub(server.InProcessChannel());
+
+    grpc::ClientContext context;
+    telemetry::IngestResponse response;
+    auto writer = stub->IngestTelemetry(&context, &response);
+    writer->Write(MakeIngestBatch(2)); // references host 0 before any host was sent
+    writer->WritesDone();
+    auto status = writer->Finish();
+    server.Shutdown();
+
+    EXPECT_EQ(status.error_code(), grpc::StatusCode::INVALID_ARGUMENT);
+}
+
+TEST(AsyncServerTest, SlowDbCallDoesNotStallPoller) {
+    auto mock_db = std::make_shared<MockDbClient>();
+    std::promise<void> release;
+    auto released = release.get_future().share();
+    telemetry::RunStatus db_status;
+    db_status.set_status("SUCCEEDED");
+    EXPECT_CALL(*mock_db, GetRunStatus("slow-run")).WillOnce([released, db_status](const std::string&) {
+        released.wait();
+        return db_status;
+    });
+    EXPECT_CALL(*mock_db, GetRunStatus("fast-run")).WillOnce(testing::Return(db_status));
+
+    TelemetryServiceImpl service([mock_db]() { return mock_db; });
+    AsyncTelemetryServer server(service, 1, 2);
+    server.Start("");
+    auto stub = telemetry::TelemetryService::NewStub(server.InProcessChannel());
+
+    std::thread slow([&]() {
+        grpc::ClientContext context;
+        telemetry::GetRunRequest req;
+        req.set_run_id("slow-run");
+        telemetry::RunStatus resp;
+        EXPECT_TRUE(stub->GetRun(&context, req, &resp).ok());
+    });
+    grpc::ClientContext context;
+    context.set_deadline(std::chrono::system_clock::now() + std::chrono::seconds(5));
+    telemetry::GetRunRequest req;
+    req.set_run_id("fast-run");
+    telemetry::RunStatus resp;
+    EXPECT_TRUE(stub->GetRun(&context, req, &resp).ok());
+    release.set_value();
+    slow.join();
+    server.Shutdown();
+}
+
+TEST(AsyncServerTest, SlowIngestRunCreationDoesNotStallPoller) {
+    auto mock_db = std::make_shared<MockDbClient>();
+    std::promise<void> release;
+    auto released = release.get_future().share();
+    telemetry::RunStatus db_status;
+    db_status.set_status("SUCCEEDED");
+    EXPECT_CALL(*mock_db, CreateRun(testing::_, testing::_, testing::_, testing::_))
+        .WillOnce([released](auto&&...) { released.wait(); });
+    EXPECT_CALL(*mock_db, Heartbeat(testing::_, testing::_)).Times(testing::AtLeast(0));
+    EXPECT_CALL(*mock_db, BatchInsertTelemetry(testing::_)).Times(testing::AtLeast(0));
+    EXPECT_CALL(*mock_db, UpdateRunStatus(testing::_, testing::_, testing::_, testing::_)).Times(testing::AtLeast(0));
+    EXPECT_CALL(*mock_db, GetRunStatus("fast-run")).WillOnce(testing::Return(db_status));
+
+    TelemetryServiceImpl service([mock_db]() { return mock_db; });
+    AsyncTelemetryServer server(service, 1, 2);
+    server.Start("");
+    auto stub = telemetry::TelemetryService::NewStub(server.InProcessChannel());
+
+    std::thread ingest([&]() {
+        grpc::ClientContext context;
+        telemetry::IngestResponse response;
+        auto writer = stub->IngestTelemetry(&context, &response);
+        auto batch = MakeIngestBatch(4);
+        batch.add_hosts()->set_host_id("host-a");
+        writer->Write(batch);
+        writer->WritesDone();
+        EXPECT_TRUE(writer->Finish().ok());
+    });
+    grpc::ClientContext context;
+    context.set_deadline(std::chrono::system_clock::now() + std::chrono::seconds(5));
+    telemetry::GetRunRequest req;
+    req.set_run_id("fast-run");
+    telemetry::RunStatus resp;
+    EXPECT_TRUE(stub->GetRun(&context, req, &resp).ok());
+    release.set_value();
+    ingest.join();
+    server.Shutdown();
+}
+
+TEST(AsyncServerTest, IngestCancelledMidStreamFailsTheRun) {
+    auto mock_db = std::make_shared<MockDbClient>();
+    std::promise<void> created;
+    EXPECT_CALL(*mock_db, CreateRun(testing::_, testing::_, testing::_, testing::_))
+        .WillOnce([&](auto&&...) { created.set_value(); });
+    EXPECT_CALL(*mock_db, Heartbeat(testing::_, testing::_)).Times(testing::AtLeast(0));
+    EXPECT_CALL(*mock_db, BatchInsertTelemetry(testing::_)).Times(testing::AtLeast(0));
+    EXPECT_CALL(*mock_db, UpdateRunStatus(testing::_, "SUCCEEDED", testing::_, testing::_)).Times(0);
+    EXPECT_CALL(*mock_db, UpdateRunStatus(testing::_, "FAILED", testing::_, testing::_)).Times(1);
+
+    TelemetryServiceImpl service([mock_db]() { return mock_db; });
+    AsyncTelemetryServer server(service, 1);
+    server.Start("");
+    auto stub = telemetry::TelemetryService::NewStub(server.InProcessChannel());
+
+    grpc::ClientContext context;
+    telemetry::IngestResponse response;
+    auto writer = stub->IngestTelemetry(&context, &response);
+    auto batch = MakeIngestBatch(4);
+    batch.add_hosts()->set_host_id("host-a");
+    ASSERT_TRUE(writer->Write(batch));
+    created.get_future().wait();
+    context.TryCancel();
+    auto status = writer->Finish();
+    server.Shutdown();
+
+    EXPECT_EQ(status.error_code(), grpc::StatusCode::CANCELLED);
+}
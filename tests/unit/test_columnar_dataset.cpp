@@ -0,0 +1,232 @@
+#include <gtest/gtest.h>
+#include "columnar_dataset.h"
+#include "hot_dataset_cache.h"
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+using telemetry::api::ColumnarDataset;
+using telemetry::api::HotDatasetCache;
+
+namespace {
+
+// 2026-02-03T00:00:00Z
+constexpr int64_t kBaseSeconds = 1770076800;
+
+auto MakeDataset() -> std::shared_ptr<ColumnarDataset> {
+    auto ds = std::make_shared<ColumnarDataset>("run-1");
+    // One row per 10 minutes over two hours; every third row is an anomaly.
+    for (int i = 0; i < 12; ++i) {
+        int64_t ts_us = (kBaseSeconds + 600LL * i) * 1000000;
+        std::string region = i % 2 == 0 ? "us-east1" : "eu-west1";
+        std::optional<std::string> type;
+        if (i % 3 == 0) { type = i % 2 == 0 ? "POINT_SPIKE" : "DRIFT"; }
+        ds->Append(ts_us, "host-" + std::to_string(i % 4), "proj-a", region,
+                   {static_cast<double>(i), 50.0, 10.0, 1.0, 2.0}, type.has_value(), type);
+    }
+    ds->Finish();
+    return ds;
+}
+
+auto WaitFor(const std::function<bool()>& done) -> bool {
+    for (int i = 0; i < 200 && !done(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return done();
+}
+
+} // namespace
+
+TEST(ColumnarDatasetTest, TopKOrdersByCountThenLabel) {
+    auto ds = MakeDataset();
+    auto out = ds->TopK("host_id", 2, {}, true);
+    ASSERT_TRUE(out.has_value());
+    ASSERT_EQ((*out)["items"].size(), 2U);
+    EXPECT_EQ((*out)["items"][0]["label"], "host-0");
+    EXPECT_EQ((*out)["items"][0]["count"], 3);
+    EXPECT_EQ((*out)["items"][1]["label"], "host-1");
+    EXPECT_TRUE((*out)["truncated"].get<bool>());
+    EXPECT_EQ((*out)["total_distinct"], 4);
+
+    // NULL anomaly types group under "" but are not counted as distinct.
+    auto types = ds->TopK("anomaly_type", 10, {}, true);
+    ASSERT_TRUE(types.has_value());
+    EXPECT_EQ((*types)["items"][0]["label"], "");
+    EXPECT_EQ((*types)["items"][0]["count"], 8);
+    EXPECT_EQ((*types)["total_distinct"], 2);
+    EXPECT_FALSE((*types)["truncated"].get<bool>());
+
+    EXPECT_FALSE(ds->TopK("labels", 5, {}, false).has_value());
+}
+
+TEST(ColumnarDatasetTest, FiltersMatchSqlPredicates) {
+    auto ds = MakeDataset();
+    ColumnarDataset::Filter f;
+    f.region = "us-east1";
+    f.is_anomaly = "true";
+    auto out = ds->TopK("anomaly_type", 10, f, false);
+    ASSERT_TRUE(out.has_value());
+    ASSERT_EQ((*out)["items"].size(), 1U);
+    EXPECT_EQ((*out)["items"][0]["label"], "POINT_SPIKE");
+    EXPECT_EQ((*out)["items"][0]["count"], 2);
+
+    // Both bounds are inclusive.
+    ColumnarDataset::Filter window;
+    window.start_time = "2026-02-03T00:10:00Z";
+    window.end_time = "2026-02-03T00:30:00";
+    auto windowed = ds->TopK("project_id", 5, window, false);
+    ASSERT_TRUE(windowed.has_value());
+    EXPECT_EQ((*windowed)["items"][0]["count"], 3);
+
+    ColumnarDataset::Filter unknown_region;
+    unknown_region.region = "ap-south1";
+    EXPECT_TRUE((*ds->TopK("region", 5, unknown_region, false))["items"].empty());
+
+    // Anything Postgres might read differently is left to SQL.
+    ColumnarDataset::Filter offset;
+    offset.start_time = "2026-02-03T00:10:00+01:00";
+    EXPECT_FALSE(ds->TopK("region", 5, offset, false).has_value());
+}
+
+TEST(ColumnarDatasetTest, HistogramUsesWidthBucketEdges) {
+    auto ds = MakeDataset();
+    auto out = ds->Histogram("cpu_usage", 4, 0.0, 8.0, {});
+    ASSERT_TRUE(out.has_value());
+    EXPECT_EQ((*out)["requested_bins"], 4);
+    EXPECT_EQ((*out)["edges"], nlohmann::json({0.0, 2.0, 4.0, 6.0, 8.0}));
+    // 8..11 are at or above the upper bound and fall outside every bin.
+    EXPECT_EQ((*out)["counts"], nlohmann::json({2, 2, 2, 2}));
+
+    auto auto_range = ds->Histogram("cpu_usage", 600, 0.0, 0.0, {});
+    ASSERT_TRUE(auto_range.has_value());
+    EXPECT_EQ((*auto_range)["requested_bins"], 600);
+    EXPECT_EQ((*auto_range)["counts"].size(), 500U);
+    EXPECT_DOUBLE_EQ((*auto_range)["edges"].back().get<double>(), 11.0);
+
+    auto flat = ds->Histogram("memory_usage", 10, 0.0, 0.0, {});
+    ASSERT_TRUE(flat.has_value());
+    EXPECT_TRUE((*flat)["counts"].empty());
+
+    EXPECT_FALSE(ds->Histogram("bogus", 10, 0.0, 1.0, {}).has_value());
+}
+
+TEST(ColumnarDatasetTest, HistogramKeepsSubMicroBounds) {
+    // Bounds that six-decimal formatting would turn into 0.000000 and 0.000001.
+    ColumnarDataset ds("run-1");
+    ds.Append(kBaseSeconds * 1000000, "h", "p", "r", {0.0000002, 0, 0, 0, 0}, false, std::nullopt);
+    ds.Append(kBaseSeconds * 1000000, "h", "p", "r", {0.00000048, 0, 0, 0, 0}, false, std::nullopt);
+    ds.Finish();
+    auto out = ds.Histogram("cpu_usage", 2, 0.0000001, 0.0000008, {});
+    ASSERT_TRUE(out.has_value());
+    EXPECT_EQ((*out)["counts"], nlohmann::json({1, 1}));
+}
+
+TEST(ColumnarDatasetTest, TimeSeriesBucketsAndExactPercentiles) {
+    auto ds = MakeDataset();
+    auto out = ds->TimeSeries({"cpu_usage"}, {"mean", "min", "max", "p50", "p95"}, 3600, {});
+    ASSERT_TRUE(out.has_value());
+    ASSERT_EQ(out->size(), 2U);
+    const auto& first = (*out)[0];
+    EXPECT_EQ(first["ts"], "2026-02-03 00:00:00+00");
+    EXPECT_EQ(first["count"], 6);
+    EXPECT_DOUBLE_EQ(first["cpu_usage_mean"].get<double>(), 2.5);
+    EXPECT_DOUBLE_EQ(first["cpu_usage_min"].get<double>(), 0.0);
+    EXPECT_DOUBLE_EQ(first["cpu_usage_max"].get<double>(), 5.0);
+    EXPECT_DOUBLE_EQ(first["cpu_usage_p50"].get<double>(), 2.5);
+    EXPECT_DOUBLE_EQ(first["cpu_usage_p95"].get<double>(), 4.75);
+    EXPECT_EQ((*out)[1]["ts"], "2026-02-03 01:00:00+00");
+
+    EXPECT_FALSE(ds->TimeSeries({"cpu_usage"}, {"median"}, 3600, {}).has_value());
+    EXPECT_FALSE(ds->TimeSeries({"labels"}, {"mean"}, 3600, {}).has_value());
+}
+
+TEST(HotDatasetCacheTest, LoadsInBackgroundThenServesFromMemory) {
+    std::atomic<int> loads{0};
+    HotDatasetCache cache({1ULL << 20}, [&](const std::string&) {
+        loads++;
+        return MakeDataset();
+    });
+    EXPECT_EQ(cache.Acquire("run-1", 12), nullptr);
+    ASSERT_TRUE(WaitFor([&] { return cache.GetStats().size == 1; }));
+    auto ds = cache.Acquire("run-1", 12);
+    ASSERT_NE(ds, nullptr);
+    EXPECT_EQ(ds->Size(), 12U);
+    EXPECT_EQ(loads.load(), 1);
+
+    cache.Invalidate("run-1");
+    EXPECT_EQ(cache.GetStats().bytes_used, 0U);
+
+    // Too large for the budget: never loaded.
+    EXPECT_EQ(cache.Acquire("run-2", 1L << 20), nullptr);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(loads.load(), 1);
+}
+
+TEST(HotDatasetCacheTest, ReloadsWhenRunRowCountChanges) {
+    std::atomic<int> loads{0};
+    HotDatasetCache cache({1ULL << 20}, [&](const std::string&) {
+        loads++;
+        return MakeDataset();
+    });
+    cache.Acquire("run-1", 12);
+    ASSERT_TRUE(WaitFor([&] { return cache.Acquire("run-1", 12) != nullptr; }));
+
+    // Retention trimmed the run: the resident copy is stale.
+    EXPECT_EQ(cache.Acquire("run-1", 8), nullptr);
+    ASSERT_TRUE(WaitFor([&] { return cache.Acquire("run-1", 8) != nullptr; }));
+    EXPECT_EQ(loads.load(), 2);
+    EXPECT_EQ(cache.GetStats().size, 1U);
+}
+
+TEST(HotDatasetCacheTest, InvalidateOnlyDiscardsLoadsOfThatRun) {
+    std::mutex gate;
+    std::unique_lock<std::mutex> hold(gate);
+    std::atomic<int> loads{0};
+    HotDatasetCache cache({1ULL << 20}, [&](const std::string&) {
+        loads++;
+        std::lock_guard<std::mutex> wait(gate);
+        return MakeDataset();
+    });
+
+    // run-1 is loading, run-2 is queued behind it.
+    cache.Acquire("run-1", 12);
+    cache.Acquire("run-2", 12);
+    ASSERT_TRUE(WaitFor([&] { return loads.load() == 1; }));
+    cache.Invalidate("other-run");
+    hold.unlock();
+    ASSERT_TRUE(WaitFor([&] { return cache.GetStats().size == 2; }));
+
+    // Invalidating the run being loaded does discard that load.
+    hold.lock();
+    cache.Acquire("run-3", 12);
+    ASSERT_TRUE(WaitFor([&] { return loads.load() == 3; }));
+    cache.Invalidate("run-3");
+    hold.unlock();
+    ASSERT_TRUE(WaitFor([&] { return cache.GetStats().loads == 3; }));
+    EXPECT_EQ(cache.GetStats().size, 2U);
+    EXPECT_EQ(cache.Acquire("run-3", 12), nullptr);
+}
+
+TEST(HotDatasetCacheTest, EvictsLeastRecentlyUsedAndSurvivesLoaderErrors) {
+    size_t one = MakeDataset()->Bytes();
+    HotDatasetCache cache({one * 2}, [](const std::string& run_id) -> std::shared_ptr<ColumnarDataset> {
+        if (run_id == "broken") { throw std::runtime_error("db down"); }
+        return MakeDataset();
+    });
+    for (const char* id : {"a", "b"}) {
+        cache.Acquire(id, 1);
+        ASSERT_TRUE(WaitFor([&] { return cache.Acquire(id, 1) != nullptr; }));
+    }
+    cache.Acquire("a", 1); // a is now most recent
+    cache.Acquire("c", 1);
+    ASSERT_TRUE(WaitFor([&] { return cache.GetStats().evictions == 1; }));
+    EXPECT_NE(cache.Acquire("a", 1), nullptr);
+    EXPECT_NE(cache.Acquire("c", 1), nullptr);
+
+    cache.Acquire("broken", 1);
+    ASSERT_TRUE(WaitFor([&] { return cache.GetStats().load_failures == 1; }));
+    EXPECT_EQ(cache.GetStats().size, 2U);
+
+    HotDatasetCache disabled({0}, [](const std::string&) { return MakeDataset(); });
+    EXPECT_EQ(disabled.Acquire("a", 1), nullptr);
+}
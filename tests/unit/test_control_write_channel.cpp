@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+#include "control_write_channel.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using telemetry::db::ControlBatchOutcome;
+using telemetry::db::ControlWrite;
+using telemetry::db::ControlWriteArgs;
+using telemetry::db::ControlWriteChannel;
+using telemetry::db::ControlWriteResult;
+
+namespace {
+
+// Records every batch; statements named "bad" fail the batch at their index.
+struct RecordingExecutor {
+    std::mutex mutex;
+    std::vector<std::vector<std::string>> batches;
+    std::mutex gate; // held by a test to stall the writer thread
+
+    auto operator()(const std::vector<ControlWrite>& writes) -> ControlBatchOutcome {
+        std::lock_guard<std::mutex> hold(gate);
+        ControlBatchOutcome outcome;
+        std::vector<std::string> names;
+        for (size_t i = 0; i < writes.size(); ++i) {
+            names.push_back(writes[i].statement);
+            if (writes[i].statement == "bad" && outcome.failed_at == ControlBatchOutcome::kNone) {
+                outcome.failed_at = i;
+                outcome.error = "constraint violated";
+            }
+            outcome.affected_rows.push_back(static_cast<long>(writes[i].params.size()));
+        }
+        if (outcome.failed_at != ControlBatchOutcome::kNone) { outcome.affected_rows.clear(); }
+        std::lock_guard<std::mutex> lock(mutex);
+        batches.push_back(names);
+        return outcome;
+    }
+};
+
+auto NoLinger() -> ControlWriteArgs {
+    ControlWriteArgs args;
+    args.linger = std::chrono::milliseconds(0);
+    return args;
+}
+
+} // namespace
+
+TEST(ControlWriteChannelTest, InlineParamsQuotesAndBindsNull) {
+    auto quote = [](const std::string& v) { return "'" + v + "'"; };
+    EXPECT_EQ(telemetry::db::InlineParams("UPDATE t SET a=$1, b=$2 WHERE id=$10",
+                                          {"x", std::nullopt, "3", "4", "5", "6", "7", "8", "9", "ten"}, quote),
+              "UPDATE t SET a='x', b=NULL WHERE id='ten'");
+    EXPECT_EQ(telemetry::db::InlineParams("SELECT '$' || $1", {"v"}, quote), "SELECT '$' || 'v'");
+    EXPECT_THROW(telemetry::db::InlineParams("SELECT $2", {"only"}, quote), std::out_of_range);
+}
+
+TEST(ControlWriteChannelTest, ExecuteReturnsAffectedRows) {
+    RecordingExecutor exec;
+    ControlWriteChannel channel([&exec](const auto& w) { return exec(w); }, NoLinger());
+    auto result = channel.Execute({"transition", {"RUNNING", "job", "PENDING"}});
+    EXPECT_TRUE(result.ok);
+    EXPECT_EQ(result.affected_rows, 3);
+    EXPECT_EQ(channel.GetStats().writes, 1);
+}
+
+TEST(ControlWriteChannelTest, CoalescesWritesQueuedBehindABatch) {
+    RecordingExecutor exec;
+    ControlWriteChannel channel([&exec](const auto& w) { return exec(w); }, NoLinger());
+
+    std::unique_lock<std::mutex> stall(exec.gate);
+    channel.Submit({"first", {}});
+    // Give the writer time to pick up "first" and block on the gate.
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    std::atomic<int> ok{0};
+    std::vector<std::thread> jobs;
+    for (int i = 0; i < 50; ++i) {
+        jobs.emplace_back([&channel, &ok, i]() {
+            if (channel.Execute({"heartbeat", {std::to_string(i)}}).ok) { ok++; }
+        });
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    stall.unlock();
+    for (auto& t : jobs) { t.join(); }
+
+    EXPECT_EQ(ok.load(), 50);
+    auto stats = channel.GetStats();
+    EXPECT_EQ(stats.writes, 51);
+    EXPECT_LE(stats.batches, 3); // "first", then the queued 50 together
+}
+
+TEST(ControlWriteChannelTest, FailingWriteDoesNotSinkItsBatch) {
+    RecordingExecutor exec;
+    ControlWriteArgs args;
+    args.linger = std::chrono::milliseconds(50);
+    ControlWriteChannel channel([&exec](const auto& w) { return exec(w); }, args);
+
+    std::vector<ControlWriteResult> results(3);
+    channel.Submit({"a", {}}, [&results](const ControlWriteResult& r) { results[0] = r; });
+    channel.Submit({"bad", {}}, [&results](const ControlWriteResult& r) { results[1] = r; });
+    channel.Submit({"c", {"x"}}, [&results](const ControlWriteResult& r) { results[2] = r; });
+    channel.Sync();
+
+    EXPECT_TRUE(results[0].ok);
+    EXPECT_FALSE(results[1].ok);
+    EXPECT_EQ(results[1].error, "constraint violated");
+    EXPECT_TRUE(results[2].ok);
+    EXPECT_EQ(results[2].affected_rows, 1);
+
+    // The first attempt rolled back; the retry resends both survivors in order.
+    ASSERT_EQ(exec.batches.size(), 2U);
+    EXPECT_EQ(exec.batches[0], (std::vector<std::string>{"a", "bad", "c"}));
+    EXPECT_EQ(exec.batches[1], (std::vector<std::string>{"a", "c"}));
+    EXPECT_EQ(channel.GetStats().failures, 1);
+}
+
+TEST(ControlWriteChannelTest, ExecutorErrorFailsWholeBatchAndShutdownDrains) {
+    std::atomic<int> calls{0};
+    std::vector<ControlWriteResult> results;
+    {
+        ControlWriteChannel channel([&calls](const std::vector<ControlWrite>&) -> ControlBatchOutcome {
+            if (calls++ == 0) { throw std::runtime_error("connection refused"); }
+            return {};
+        }, NoLinger());
+        auto failed = channel.Execute({"a", {}});
+        EXPECT_FALSE(failed.ok);
+        EXPECT_EQ(failed.error, "connection refused");
+
+        for (int i = 0; i < 5; ++i) {
+            channel.Submit({"later", {}}, [&results](const ControlWriteResult& r) { results.push_back(r); });
+        }
+    } // destructor settles everything still queued
+    ASSERT_EQ(results.size(), 5U);
+    for (const auto& r : results) { EXPECT_TRUE(r.ok); }
+}
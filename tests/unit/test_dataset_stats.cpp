@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+#include "dataset_stats.h"
+#include <cmath>
+#include <random>
+#include <vector>
+
+using telemetry::stats::DatasetStatsAccumulator;
+using telemetry::stats::Moments;
+
+TEST(DatasetStatsTest, MomentsMatchTwoPassStatistics) {
+    std::vector<double> values = {2.0, 4.0, 4.0, 4.0, 5.0, 5.0, 7.0, 9.0};
+    Moments m;
+    for (double v : values) { m.Add(v); }
+    EXPECT_EQ(m.count, 8);
+    EXPECT_DOUBLE_EQ(m.mean, 5.0);
+    EXPECT_DOUBLE_EQ(m.m2, 32.0);
+    EXPECT_DOUBLE_EQ(m.min, 2.0);
+    EXPECT_DOUBLE_EQ(m.max, 9.0);
+    ASSERT_TRUE(m.StdDev().has_value());
+    EXPECT_NEAR(*m.StdDev(), std::sqrt(32.0 / 7.0), 1e-12);
+
+    Moments single;
+    single.Add(1.0);
+    EXPECT_FALSE(single.StdDev().has_value());
+}
+
+TEST(DatasetStatsTest, MergeIsEquivalentToSinglePass) {
+    std::mt19937_64 rng(3);
+    std::normal_distribution<double> dist(50.0, 12.0);
+    Moments all;
+    std::vector<Moments> parts(4);
+    for (int i = 0; i < 4000; ++i) {
+        double v = dist(rng);
+        all.Add(v);
+        parts[static_cast<size_t>(i * 7 % 4)].Add(v);
+    }
+    Moments merged;
+    merged.Merge(Moments{}); // empty merges are no-ops
+    for (const auto& p : parts) { merged.Merge(p); }
+    EXPECT_EQ(merged.count, all.count);
+    EXPECT_NEAR(merged.mean, all.mean, 1e-9);
+    EXPECT_NEAR(merged.m2, all.m2, all.m2 * 1e-12);
+    EXPECT_DOUBLE_EQ(merged.min, all.min);
+    EXPECT_DOUBLE_EQ(merged.max, all.max);
+}
+
+TEST(DatasetStatsTest, AccumulatorTracksBoundsAndAnomalyTypes) {
+    DatasetStatsAccumulator acc;
+    auto base = std::chrono::system_clock::time_point(std::chrono::seconds(1700000000));
+    for (int i = 0; i < 5; ++i) {
+        TelemetryRecord r;
+        r.run_id = "run-1";
+        r.metric_timestamp = base + std::chrono::milliseconds(1500 * (4 - i));
+        r.cpu_usage = 10.0 * i;
+        r.memory_usage = 1.0;
+        r.disk_utilization = 2.0;
+        r.network_rx_rate = 3.0;
+        r.network_tx_rate = 4.0;
+        r.is_anomaly = i >= 3;
+        r.anomaly_type = i == 4 ? "POINT_SPIKE" : "";
+        acc.Add(r);
+    }
+    const auto& run = acc.Runs().at("run-1");
+    EXPECT_EQ(run.row_count, 5);
+    EXPECT_EQ(run.anomaly_count, 2);
+    EXPECT_EQ(run.min_ts_us, 1700000000LL * 1000000);
+    EXPECT_EQ(run.max_ts_us, 1700000006LL * 1000000);
+    EXPECT_DOUBLE_EQ(run.metrics[0].mean, 20.0);
+    EXPECT_DOUBLE_EQ(run.metrics[0].max, 40.0);
+    ASSERT_EQ(run.anomaly_types.size(), 1U);
+    EXPECT_EQ(run.anomaly_types.at("POINT_SPIKE"), 1);
+}
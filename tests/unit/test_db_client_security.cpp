@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include "db_client.h"
+#include "analytics_queries.h"
 
 // Test that DbClient::IsValidMetric correctly validates metrics against
 // the allowlist and rejects SQL injection attempts.
@@ -66,3 +67,27 @@ TEST(DbClientSecurityTest, RejectsInvalidAggregations) {
     EXPECT_FALSE(DbClient::IsValidAggregation("mean; DROP TABLE users;"));
     EXPECT_FALSE(DbClient::IsValidAggregation(""));
 }
+
+TEST(DbClientSecurityTest, SearchQueriesBindFilterValues) {
+    telemetry::db::SearchSort sort;
+    sort.dir = "asc";
+    sort.after = telemetry::api::SearchCursor{1700000000000000, 42, "asc"};
+    std::string host = "h1' OR '1'='1";
+    auto q = telemetry::db::BuildSearchQueries("run-1", 20, 0, "", "", "true", "", host, "", "", sort);
+
+    EXPECT_EQ(q.page.sql.find(host), std::string::npos);
+    ASSERT_EQ(q.page.params.size(), 7U);
+    EXPECT_EQ(q.page.params[2], host);
+    // Keyset bound is (ts_us, record_id) in that order, then limit + 1 and offset.
+    EXPECT_NE(q.page.sql.find("'epoch' + $4::bigint * INTERVAL '1 microsecond', $5::bigint)"), std::string::npos);
+    EXPECT_EQ(q.page.params[3], "1700000000000000");
+    EXPECT_EQ(q.page.params[4], "42");
+    EXPECT_EQ(q.page.params[5], "21");
+    EXPECT_EQ(q.page.params[6], "0");
+
+    // Totals share the filters but not the cursor or paging.
+    EXPECT_EQ(q.exact_count.params.size(), 3U);
+    EXPECT_EQ(q.exact_count.sql.find("record_id"), std::string::npos);
+    EXPECT_EQ(q.estimate.params, q.exact_count.params);
+    EXPECT_FALSE(q.catalog_shape);
+}
@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+#include "eval_aggregates.h"
+#include "eval_curve.h"
+#include <algorithm>
+#include <random>
+
+using telemetry::stats::ErrorHistogram;
+using telemetry::stats::EvalAggregates;
+
+namespace {
+
+struct Sample { double err; bool pred; bool label; std::string region; };
+
+auto MakeSamples(size_t n) -> std::vector<Sample> {
+    std::mt19937 rng(11);
+    std::lognormal_distribution<double> err_dist(0.0, 1.0);
+    std::vector<Sample> samples;
+    for (size_t i = 0; i < n; ++i) {
+        double err = err_dist(rng);
+        bool label = rng() % 4 == 0;
+        samples.push_back({err, err > 2.0, label, i % 3 == 0 ? "us-east1" : "eu-west1"});
+    }
+    return samples;
+}
+
+auto Aggregate(const std::vector<Sample>& samples) -> EvalAggregates {
+    EvalAggregates agg;
+    for (const auto& s : samples) { agg.Add(s.err, s.pred, s.label, {s.region, "proj-a", ""}); }
+    return agg;
+}
+
+} // namespace
+
+TEST(EvalAggregatesTest, CurvePointsAreExactAtBucketThresholds) {
+    auto samples = MakeSamples(5000);
+    auto agg = Aggregate(samples);
+    EXPECT_EQ(agg.Samples(), 5000);
+
+    telemetry::api::EvalCurveBuilder exact(static_cast<long>(samples.size()), 50);
+    auto sorted = samples;
+    std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) { return a.err > b.err; });
+    for (const auto& s : sorted) { exact.Add(s.err, s.pred, s.label); }
+    auto expected = exact.Finish();
+    auto out = agg.Eval(50);
+    EXPECT_EQ(out["confusion"], expected["confusion"]);
+    ASSERT_EQ(out["roc"].size(), 50U);
+
+    long positives = std::count_if(samples.begin(), samples.end(), [](const auto& s) { return s.label; });
+    long negatives = static_cast<long>(samples.size()) - positives;
+    for (size_t i = 0; i < out["roc"].size(); ++i) {
+        double threshold = out["roc"][i]["threshold"].get<double>();
+        // Within one bucket of the scanned threshold...
+        double scanned = expected["roc"][i]["threshold"].get<double>();
+        EXPECT_LE(threshold, scanned);
+        EXPECT_GE(threshold * (1 + ErrorHistogram::kRelativeWidth), scanned);
+        // ...and exactly right for the threshold it reports.
+        long tp = 0, fp = 0;
+        for (const auto& s : samples) {
+            if (s.err >= threshold && s.label) { tp++; }
+            else if (s.err >= threshold) { fp++; }
+        }
+        EXPECT_DOUBLE_EQ(out["roc"][i]["tpr"].get<double>(), static_cast<double>(tp) / static_cast<double>(positives));
+        EXPECT_DOUBLE_EQ(out["roc"][i]["fpr"].get<double>(), static_cast<double>(fp) / static_cast<double>(negatives));
+    }
+}
+
+TEST(EvalAggregatesTest, ErrorDistributionApproximatesPercentiles) {
+    auto samples = MakeSamples(4000);
+    auto agg = Aggregate(samples);
+    auto dist = agg.ErrorDistribution("region");
+    ASSERT_TRUE(dist.has_value());
+    ASSERT_EQ(dist->size(), 2U);
+    EXPECT_EQ((*dist)[0]["label"], "eu-west1");
+
+    std::vector<double> errs;
+    double sum = 0.0;
+    for (const auto& s : samples) {
+        if (s.region == "eu-west1") {
+            errs.push_back(s.err);
+            sum += s.err;
+        }
+    }
+    std::sort(errs.begin(), errs.end());
+    EXPECT_EQ((*dist)[0]["count"], static_cast<long>(errs.size()));
+    EXPECT_NEAR((*dist)[0]["mean"].get<double>(), sum / static_cast<double>(errs.size()), 1e-9);
+    auto cont = [&](double q) {
+        double pos = q * static_cast<double>(errs.size() - 1);
+        auto lo = static_cast<size_t>(pos);
+        return errs[lo] + (pos - static_cast<double>(lo)) * (errs[lo + 1] - errs[lo]);
+    };
+    EXPECT_NEAR((*dist)[0]["p50"].get<double>(), cont(0.5), cont(0.5) * ErrorHistogram::kRelativeWidth);
+    EXPECT_NEAR((*dist)[0]["p95"].get<double>(), cont(0.95), cont(0.95) * ErrorHistogram::kRelativeWidth);
+
+    auto types = agg.ErrorDistribution("h.anomaly_type");
+    ASSERT_TRUE(types.has_value());
+    EXPECT_EQ((*types)[0]["label"], "");
+    EXPECT_FALSE(agg.ErrorDistribution("host_id").has_value());
+}
+
+TEST(EvalAggregatesTest, RoundTripsThroughJson) {
+    auto agg = Aggregate(MakeSamples(300));
+    agg.Add(0.0, false, false, {"", "", ""});
+    auto restored = EvalAggregates::FromJson(nlohmann::json::parse(agg.ToJson().dump()));
+    EXPECT_EQ(restored.Samples(), agg.Samples());
+    EXPECT_EQ(restored.Eval(20), agg.Eval(20));
+    EXPECT_EQ(restored.ErrorDistribution("project_id"), agg.ErrorDistribution("project_id"));
+
+    EXPECT_THROW(EvalAggregates::FromJson(nlohmann::json::object()), nlohmann::json::exception);
+}
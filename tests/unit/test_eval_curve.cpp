@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+#include "eval_curve.h"
+#include <algorithm>
+#include <random>
+
+using telemetry::api::EvalCurveBuilder;
+
+namespace {
+
+struct Sample { double err; bool pred; bool label; };
+
+// Reference: one full rescan per threshold, as the endpoint used to do.
+auto BruteForce(std::vector<Sample> samples, int points) -> nlohmann::json {
+    std::sort(samples.begin(), samples.end(), [](const auto& a, const auto& b) { return a.err > b.err; });
+    int n_points = EvalCurveBuilder::ClampPoints(points);
+    long positives = std::count_if(samples.begin(), samples.end(), [](const auto& s) { return s.label; });
+    long negatives = static_cast<long>(samples.size()) - positives;
+    nlohmann::json roc = nlohmann::json::array();
+    nlohmann::json pr = nlohmann::json::array();
+    for (int i = 0; i < n_points && !samples.empty(); ++i) {
+        auto idx = static_cast<size_t>((static_cast<double>(i) / (n_points - 1)) * static_cast<double>(samples.size() - 1));
+        double threshold = samples[idx].err;
+        long ttp = 0, tfp = 0;
+        for (const auto& s : samples) {
+            if (s.err >= threshold && s.label) { ttp++; }
+            else if (s.err >= threshold) { tfp++; }
+        }
+        double tpr = positives > 0 ? static_cast<double>(ttp) / static_cast<double>(positives) : 0.0;
+        double fpr = negatives > 0 ? static_cast<double>(tfp) / static_cast<double>(negatives) : 0.0;
+        double precision = (ttp + tfp) > 0 ? static_cast<double>(ttp) / static_cast<double>(ttp + tfp) : 0.0;
+        roc.push_back({{"fpr", fpr}, {"tpr", tpr}, {"threshold", threshold}});
+        pr.push_back({{"precision", precision}, {"recall", tpr}, {"threshold", threshold}});
+    }
+    return {{"roc", roc}, {"pr", pr}};
+}
+
+auto SinglePass(std::vector<Sample> samples, int points) -> nlohmann::json {
+    std::stable_sort(samples.begin(), samples.end(), [](const auto& a, const auto& b) { return a.err > b.err; });
+    EvalCurveBuilder builder(static_cast<long>(samples.size()), points);
+    for (const auto& s : samples) { builder.Add(s.err, s.pred, s.label); }
+    return builder.Finish();
+}
+
+} // namespace
+
+TEST(EvalCurveTest, MatchesPerThresholdRescan) {
+    std::mt19937 rng(7);
+    for (size_t n : {1UL, 3UL, 57UL, 1000UL}) {
+        std::vector<Sample> samples;
+        for (size_t i = 0; i < n; ++i) {
+            // Coarse errors so many samples tie at a threshold.
+            double err = static_cast<double>(rng() % 20) / 4.0;
+            bool label = rng() % 3 == 0;
+            samples.push_back({err, err > 3.0, label});
+        }
+        for (int points : {0, 10, 37, 500}) {
+            auto expected = BruteForce(samples, points);
+            auto actual = SinglePass(samples, points);
+            EXPECT_EQ(actual["roc"], expected["roc"]) << "n=" << n << " points=" << points;
+            EXPECT_EQ(actual["pr"], expected["pr"]) << "n=" << n << " points=" << points;
+        }
+    }
+}
+
+TEST(EvalCurveTest, ConfusionAndEmptyInput) {
+    EvalCurveBuilder builder(4, 10);
+    builder.Add(0.9, true, true);
+    builder.Add(0.7, true, false);
+    builder.Add(0.4, false, true);
+    builder.Add(0.1, false, false);
+    auto out = builder.Finish();
+    EXPECT_EQ(out["confusion"], nlohmann::json({{"tp", 1}, {"fp", 1}, {"tn", 1}, {"fn", 1}}));
+    ASSERT_EQ(out["roc"].size(), 10U);
+    EXPECT_DOUBLE_EQ(out["roc"].back()["tpr"].get<double>(), 1.0);
+    EXPECT_DOUBLE_EQ(out["roc"].back()["fpr"].get<double>(), 1.0);
+    EXPECT_DOUBLE_EQ(out["pr"][0]["precision"].get<double>(), 1.0);
+
+    auto empty = EvalCurveBuilder(0, 50).Finish();
+    EXPECT_TRUE(empty["roc"].empty());
+    EXPECT_TRUE(empty["pr"].empty());
+    EXPECT_EQ(empty["confusion"]["tp"], 0);
+}
@@ -2,8 +2,12 @@
 #include "generator.h"
 #include "mocks/mock_db_client.h"
 #include <memory>
+#include <atomic>
 #include <ctime>
+#include <filesystem>
+#include <future>
 #include <string>
+#include <thread>
 #include <vector>
 
 // Expose protected members for testing
@@ -24,27 +28,45 @@ public:
 
     void PublicEnqueueBatch(std::vector<TelemetryRecord> batch) { EnqueueBatch(std::move(batch)); }
     void SetMaxQueueSize(size_t s) { max_queue_size_ = s; }
+    void PublicStartWriter() { StartWriter(); }
 };
 
 TEST(GeneratorTest, Backpressure) {
     telemetry::GenerateRequest req;
     auto db = std::make_shared<MockDbClient>();
+    std::promise<void> first_write;
+    std::promise<void> release;
+    auto released = release.get_future().share();
+    std::atomic<int> written{0};
+    EXPECT_CALL(*db, BatchInsertTelemetry(testing::_)).Times(4).WillRepeatedly([&](const auto&) {
+        if (written.fetch_add(1) == 0) {
+            first_write.set_value();
+            released.wait();
+        }
+    });
     TestGenerator gen(req, "test-backpressure", db);
-    
     gen.SetMaxQueueSize(2);
-    
+    gen.PublicStartWriter();
+
     std::vector<TelemetryRecord> batch = {{}};
-    
-    // Fill queue
     gen.PublicEnqueueBatch(batch);
+    first_write.get_future().wait(); // writer holds batch 1
     gen.PublicEnqueueBatch(batch);
-    
-    // Next should be dropped
-    // We can't easily check for drop without checking logs or metrics, 
-    // but we can check that we don't crash.
-    // Let's check if we can verify the metric emission.
-    // Actually, I'll just check that it doesn't throw.
-    EXPECT_NO_THROW(gen.PublicEnqueueBatch(batch));
+    gen.PublicEnqueueBatch(batch);   // queue is now full
+
+    // A full queue blocks the producer rather than dropping the batch.
+    std::atomic<bool> enqueued{false};
+    std::thread producer([&]() {
+        gen.PublicEnqueueBatch(batch);
+        enqueued = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_FALSE(enqueued.load());
+
+    release.set_value();
+    producer.join();
+    EXPECT_TRUE(enqueued.load());
+    while (written.load() < 4) { std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
 }
 
 TEST(GeneratorTest, HostInitialization) {
@@ -183,3 +205,33 @@ TEST(GeneratorMathTest, CorrelationAnomaly) {
         EXPECT_GT(rec1.memory_usage, 50.0);
     }
 }
+
+TEST(GeneratorTest, FileSinkWritesSegmentsWithoutDatabase) {
+    auto dir = std::filesystem::temp_directory_path() / "generator_file_sink_test";
+    std::filesystem::remove_all(dir);
+
+    telemetry::GenerateRequest req;
+    req.set_tier("FILE");
+    req.set_host_count(3);
+    req.set_start_time_iso("2025-01-01T00:00:00Z");
+    req.set_end_time_iso("2025-01-01T01:00:00Z");
+    req.set_interval_seconds(600);
+    req.set_seed(5);
+    req.set_sink("file");
+    req.set_output_dir(dir.string());
+
+    auto progress = std::make_shared<telemetry::RunProgress>("file-run", "");
+    Generator gen(req, "file-run", nullptr);
+    gen.SetProgress(progress);
+    gen.Run();
+
+    EXPECT_EQ(progress->Snapshot().status, "SUCCEEDED");
+    size_t rows = 0;
+    for (const auto& path : telemetry::SegmentReader::ListSegments((dir / "file-run").string())) {
+        auto data = telemetry::SegmentReader::Read(path);
+        EXPECT_EQ(data.run_id, "file-run");
+        rows += data.Size();
+    }
+    EXPECT_EQ(rows, 18u); // 3 hosts x 6 timestamps
+    std::filesystem::remove_all(dir);
+}
@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+#include "generator_kernel.h"
+#include <chrono>
+#include <vector>
+
+using telemetry::GeneratorKernel;
+using telemetry::GeneratorKernelConfig;
+using telemetry::HostSlice;
+using telemetry::Philox4x32;
+
+namespace {
+
+auto MakeHosts(size_t n) -> std::vector<HostProfile> {
+    std::vector<HostProfile> hosts(n);
+    for (size_t i = 0; i < n; ++i) {
+        hosts[i].host_id = "host-" + std::to_string(i);
+        hosts[i].cpu_base = 10.0 + static_cast<double>(i);
+        hosts[i].mem_base = 20.0;
+        hosts[i].phase_shift = 0.1 * static_cast<double>(i);
+    }
+    return hosts;
+}
+
+auto RunKernel(const GeneratorKernelConfig& config, size_t hosts, int steps) -> std::vector<HostSlice> {
+    auto profiles = MakeHosts(hosts);
+    GeneratorKernel kernel(config, profiles);
+    std::vector<HostSlice> out(static_cast<size_t>(steps));
+    auto t = std::chrono::system_clock::time_point(std::chrono::hours(24 * 365 * 55));
+    for (int s = 0; s < steps; ++s) {
+        kernel.Fill(t + std::chrono::minutes(10 * s), profiles, out[static_cast<size_t>(s)]);
+    }
+    return out;
+}
+
+} // namespace
+
+TEST(PhiloxTest, MatchesReferenceVectors) {
+    auto zero = Philox4x32::Generate({0, 0, 0, 0}, {0, 0});
+    EXPECT_EQ(zero, (Philox4x32::Block{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}));
+    auto ones = Philox4x32::Generate({0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}, {0xffffffff, 0xffffffff});
+    EXPECT_EQ(ones, (Philox4x32::Block{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}));
+    auto pi = Philox4x32::Generate({0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}, {0xa4093822, 0x299f31d0});
+    EXPECT_EQ(pi, (Philox4x32::Block{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}));
+}
+
+TEST(GeneratorKernelTest, SameSeedIsDeterministic) {
+    GeneratorKernelConfig config;
+    config.seed = 42;
+    config.anomalies_enabled = true;
+    config.point_rate = 0.05;
+    config.collective_rate = 0.02;
+    auto a = RunKernel(config, 64, 20);
+    auto b = RunKernel(config, 64, 20);
+    for (size_t s = 0; s < a.size(); ++s) {
+        EXPECT_EQ(a[s].cpu_usage, b[s].cpu_usage);
+        EXPECT_EQ(a[s].network_tx_rate, b[s].network_tx_rate);
+        EXPECT_EQ(a[s].anomaly_code, b[s].anomaly_code);
+        EXPECT_EQ(a[s].lag_ms, b[s].lag_ms);
+    }
+
+    config.seed = 43;
+    auto c = RunKernel(config, 64, 20);
+    EXPECT_NE(a[0].cpu_usage, c[0].cpu_usage);
+}
+
+TEST(GeneratorKernelTest, DrawsDoNotDependOnSliceWidth) {
+    // A host's draws are keyed by (seed, timestamp, host index), so adding
+    // hosts after it must not change its values.
+    GeneratorKernelConfig config;
+    config.seed = 7;
+    auto narrow = RunKernel(config, 4, 5);
+    auto wide = RunKernel(config, 100, 5);
+    for (size_t s = 0; s < narrow.size(); ++s) {
+        for (size_t h = 0; h < 4; ++h) {
+            EXPECT_EQ(narrow[s].cpu_usage[h], wide[s].cpu_usage[h]);
+            EXPECT_EQ(narrow[s].memory_usage[h], wide[s].memory_usage[h]);
+        }
+    }
+}
+
+TEST(GeneratorKernelTest, ValuesStayInRangeAndAnomalyRateTracksConfig) {
+    GeneratorKernelConfig config;
+    config.seed = 1234;
+    config.anomalies_enabled = true;
+    config.point_rate = 0.1;
+    auto slices = RunKernel(config, 500, 20);
+    long anomalies = 0;
+    long total = 0;
+    for (const auto& slice : slices) {
+        for (size_t i = 0; i < slice.Size(); ++i) {
+            EXPECT_GE(slice.cpu_usage[i], 0.0);
+            EXPECT_LE(slice.cpu_usage[i], 100.0);
+            EXPECT_GE(slice.memory_usage[i], 0.0);
+            EXPECT_LE(slice.memory_usage[i], 100.0);
+            EXPECT_GE(slice.lag_ms[i], 2000);
+            EXPECT_LE(slice.lag_ms[i], 2500);
+            if (slice.is_anomaly[i] != 0) {
+                anomalies++;
+                EXPECT_EQ(GeneratorKernel::AnomalyTypeName(slice.anomaly_code[i]), "POINT_SPIKE");
+            }
+            total++;
+        }
+    }
+    double rate = static_cast<double>(anomalies) / static_cast<double>(total);
+    EXPECT_NEAR(rate, 0.1, 0.02);
+}
+
+TEST(GeneratorKernelTest, AnomalyTypeNamesPreserveCombinationOrder) {
+    EXPECT_EQ(GeneratorKernel::AnomalyTypeName(0), "");
+    EXPECT_EQ(GeneratorKernel::AnomalyTypeName(GeneratorKernel::kBurst | GeneratorKernel::kPointBit),
+              "COLLECTIVE_BURST,POINT_SPIKE");
+    EXPECT_EQ(GeneratorKernel::AnomalyTypeName(GeneratorKernel::kCorrelationBreak | GeneratorKernel::kContextualBit |
+                                               GeneratorKernel::kPointBit),
+              "CORRELATION_BREAK,CONTEXTUAL,POINT_SPIKE");
+}
@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+#include "inference_codec.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+using telemetry::anomaly::FeatureVector;
+using telemetry::api::BatchRowDecoder;
+using telemetry::api::JsonMissingField;
+using telemetry::api::JsonSyntaxError;
+using telemetry::api::ParseInferenceRequest;
+using telemetry::api::kBatchRowBytes;
+
+TEST(InferenceCodecTest, ParsesSamplesIntoFeatureVectors) {
+    auto req = ParseInferenceRequest(R"({
+        "samples": [
+            {"cpu_usage": 0.5, "memory_usage": 12, "disk_utilization": -1.25e2,
+             "network_rx_rate": 3E-1, "network_tx_rate": 0},
+            {"network_tx_rate": 7.5, "host_id": "h-1", "tags": {"a": [1, {"b": null}], "c": true}},
+            {}
+        ],
+        "extra": [false, "x\"y"],
+        "model_run_id": "model-\u00e9\ud83d\ude00"
+    })", 1000);
+
+    EXPECT_EQ(req.model_run_id, "model-\xc3\xa9\xf0\x9f\x98\x80");
+    ASSERT_EQ(req.samples.size(), 3U);
+    EXPECT_DOUBLE_EQ(req.samples[0].cpu_usage(), 0.5);
+    EXPECT_DOUBLE_EQ(req.samples[0].memory_usage(), 12.0);
+    EXPECT_DOUBLE_EQ(req.samples[0].disk_utilization(), -125.0);
+    EXPECT_DOUBLE_EQ(req.samples[0].network_rx_rate(), 0.3);
+    EXPECT_DOUBLE_EQ(req.samples[0].network_tx_rate(), 0.0);
+    EXPECT_DOUBLE_EQ(req.samples[1].cpu_usage(), 0.0);
+    EXPECT_DOUBLE_EQ(req.samples[1].network_tx_rate(), 7.5);
+    for (double d : req.samples[2].data) { EXPECT_DOUBLE_EQ(d, 0.0); }
+}
+
+TEST(InferenceCodecTest, MatchesNlohmannOnRandomBodies) {
+    std::mt19937_64 rng(7);
+    std::uniform_real_distribution<double> dist(-1e6, 1e6);
+    nlohmann::json body = {{"model_run_id", "m"}, {"samples", nlohmann::json::array()}};
+    for (int i = 0; i < 500; ++i) {
+        body["samples"].push_back({{"cpu_usage", dist(rng)}, {"memory_usage", dist(rng)},
+                                   {"disk_utilization", dist(rng)}, {"network_rx_rate", dist(rng)},
+                                   {"network_tx_rate", dist(rng)}});
+    }
+    auto req = ParseInferenceRequest(body.dump(), 1000);
+    ASSERT_EQ(req.samples.size(), 500U);
+    for (size_t i = 0; i < req.samples.size(); ++i) {
+        const auto& s = body["samples"][i];
+        EXPECT_EQ(req.samples[i].cpu_usage(), s["cpu_usage"].get<double>());
+        EXPECT_EQ(req.samples[i].network_tx_rate(), s["network_tx_rate"].get<double>());
+    }
+}
+
+TEST(InferenceCodecTest, NullSamplesMeansNone) {
+    auto req = ParseInferenceRequest(R"({"model_run_id":"m","samples":null})", 1000);
+    EXPECT_TRUE(req.samples.empty());
+}
+
+TEST(InferenceCodecTest, RejectsMalformedJson) {
+    for (const char* body : {"{ invalid json ", "", "{\"model_run_id\":\"m\",\"samples\":[]} x",
+                             "{\"model_run_id\":\"m\",\"samples\":[{\"cpu_usage\":01}]}",
+                             "{\"model_run_id\":\"m\",\"samples\":[{\"cpu_usage\":1.}]}",
+                             "{\"model_run_id\":\"m\",\"samples\":[],}", "{\"model_run_id\":\"a\tb\"}",
+                             "{\"model_run_id\":\"\\ud800\",\"samples\":[]}",
+                             "{\"model_run_id\":\"m\",\"samples\":[{\"cpu_usage\":1e999}]}"}) {
+        EXPECT_THROW(ParseInferenceRequest(body, 1000), JsonSyntaxError) << body;
+    }
+    std::string deep = R"({"model_run_id":"m","samples":[],"x":)" + std::string(1000, '[');
+    EXPECT_THROW(ParseInferenceRequest(deep, 1000), JsonSyntaxError);
+}
+
+TEST(InferenceCodecTest, ReportsMissingFieldsAndBadTypes) {
+    EXPECT_THROW(ParseInferenceRequest(R"({"samples":null})", 1000), JsonMissingField);
+    EXPECT_THROW(ParseInferenceRequest(R"({"model_run_id":"m"})", 1000), JsonMissingField);
+    EXPECT_THROW(ParseInferenceRequest(R"({"model_run_id":1,"samples":[]})", 1000), std::invalid_argument);
+    EXPECT_THROW(ParseInferenceRequest(R"({"model_run_id":"m","samples":{}})", 1000), std::invalid_argument);
+    EXPECT_THROW(ParseInferenceRequest(R"({"model_run_id":"m","samples":[null]})", 1000), std::invalid_argument);
+    EXPECT_THROW(ParseInferenceRequest(R"({"model_run_id":"m","samples":[{"cpu_usage":"1"}]})", 1000),
+                 std::invalid_argument);
+    EXPECT_THROW(ParseInferenceRequest("[]", 1000), std::invalid_argument);
+}
+
+TEST(InferenceCodecTest, StopsAtSampleLimit) {
+    EXPECT_NO_THROW(ParseInferenceRequest(R"({"model_run_id":"m","samples":[{},{}]})", 2));
+    try {
+        ParseInferenceRequest(R"({"model_run_id":"m","samples":[{},{},{}]})", 2);
+        FAIL() << "expected invalid_argument";
+    } catch (const std::invalid_argument& e) {
+        EXPECT_NE(std::string(e.what()).find("Too many samples"), std::string::npos);
+    }
+}
+
+TEST(InferenceCodecTest, BatchDecoderReassemblesRowsAcrossChunks) {
+    std::vector<double> values;
+    for (int i = 0; i < 25 * 5; ++i) { values.push_back(i * 0.25 - 3.0); }
+    std::string body(values.size() * sizeof(double), '\0');
+    std::memcpy(body.data(), values.data(), body.size()); // little-endian host
+
+    for (size_t chunk : {1UL, 7UL, 40UL, 41UL, 1000UL}) {
+        std::vector<FeatureVector> rows;
+        std::vector<size_t> batches;
+        BatchRowDecoder decoder([&](const FeatureVector* batch, size_t n) {
+            rows.insert(rows.end(), batch, batch + n);
+            batches.push_back(n);
+        }, 8);
+        for (size_t off = 0; off < body.size(); off += chunk) {
+            decoder.Feed(body.data() + off, std::min(chunk, body.size() - off));
+        }
+        decoder.Finish();
+        ASSERT_EQ(rows.size(), 25U) << "chunk " << chunk;
+        EXPECT_EQ(decoder.Rows(), 25U);
+        EXPECT_EQ(batches, (std::vector<size_t>{8, 8, 8, 1}));
+        for (size_t i = 0; i < rows.size(); ++i) {
+            for (size_t j = 0; j < FeatureVector::kSize; ++j) {
+                EXPECT_EQ(rows[i].data[j], values[i * 5 + j]);
+            }
+        }
+    }
+}
+
+TEST(InferenceCodecTest, BatchDecoderRejectsPartialRow) {
+    BatchRowDecoder decoder([](const FeatureVector*, size_t) {});
+    std::string body(kBatchRowBytes + 3, '\0');
+    decoder.Feed(body.data(), body.size());
+    EXPECT_THROW(decoder.Finish(), std::invalid_argument);
+}
@@ -0,0 +1,167 @@
+#include <gtest/gtest.h>
+#include "ingest.h"
+#include "server.h"
+#include "mocks/mock_db_client.h"
+#include <grpcpp/grpcpp.h>
+#include <cmath>
+#include <future>
+#include <limits>
+#include <mutex>
+
+using telemetry::ingest::IngestDecoder;
+
+namespace {
+
+auto MakeBatch(int rows, uint32_t host_index) -> telemetry::TelemetryBatch {
+    telemetry::TelemetryBatch batch;
+    for (int i = 0; i < rows; ++i) {
+        batch.add_host_index(host_index);
+        batch.add_metric_timestamp_ms(1735689600000 + i * 1000);
+        batch.add_cpu_usage(40.0 + i);
+        batch.add_memory_usage(50.0);
+        batch.add_disk_utilization(30.0);
+        batch.add_network_rx_rate(10.0);
+        batch.add_network_tx_rate(8.0);
+    }
+    return batch;
+}
+
+} // namespace
+
+TEST(IngestDecoderTest, DecodesColumnsWithStreamDictionaries) {
+    IngestDecoder decoder("run-1");
+    auto first = MakeBatch(2, 0);
+    auto* host = first.add_hosts();
+    host->set_host_id("host-a");
+    host->set_region("us-east1");
+    first.add_anomaly_types("point_spike");
+    first.add_anomaly_type_index(0);
+    first.add_anomaly_type_index(1);
+
+    std::vector<TelemetryRecord> out;
+    auto r1 = decoder.Decode(first, out);
+    EXPECT_EQ(r1.accepted, 2u);
+    ASSERT_EQ(out.size(), 2u);
+    EXPECT_EQ(out[0].host_id, "host-a");
+    EXPECT_EQ(out[0].run_id, "run-1");
+    EXPECT_EQ(out[0].labels_json, "{}");
+    EXPECT_FALSE(out[0].is_anomaly);
+    EXPECT_TRUE(out[1].is_anomaly);
+    EXPECT_EQ(out[1].anomaly_type, "point_spike");
+    EXPECT_DOUBLE_EQ(out[1].cpu_usage, 41.0);
+
+    // Later batches may reference hosts sent earlier in the stream.
+    auto second = MakeBatch(3, 0);
+    auto r2 = decoder.Decode(second, out);
+    EXPECT_EQ(r2.accepted, 3u);
+    EXPECT_EQ(out.size(), 5u);
+    EXPECT_EQ(out[4].host_id, "host-a");
+}
+
+TEST(IngestDecoderTest, RejectsNonFiniteRows) {
+    IngestDecoder decoder("run-1");
+    auto batch = MakeBatch(2, 0);
+    batch.add_hosts()->set_host_id("host-a");
+    batch.set_cpu_usage(1, std::numeric_limits<double>::quiet_NaN());
+
+    std::vector<TelemetryRecord> out;
+    auto r = decoder.Decode(batch, out);
+    EXPECT_EQ(r.accepted, 1u);
+    EXPECT_EQ(r.rejected, 1u);
+}
+
+TEST(IngestDecoderTest, ThrowsOnMalformedBatch) {
+    IngestDecoder decoder("run-1");
+    std::vector<TelemetryRecord> out;
+
+    auto unknown_host = MakeBatch(1, 3);
+    EXPECT_THROW(decoder.Decode(unknown_host, out), std::invalid_argument);
+
+    auto ragged = MakeBatch(2, 0);
+    ragged.add_hosts()->set_host_id("host-a");
+    ragged.add_cpu_usage(1.0);
+    EXPECT_THROW(decoder.Decode(ragged, out), std::invalid_argument);
+}
+
+TEST(IngestServerTest, StreamsBatchesThroughBatchInsert) {
+    auto mock_db = std::make_shared<MockDbClient>();
+    std::mutex mu;
+    size_t inserted = 0;
+    EXPECT_CALL(*mock_db, CreateRun("ingest-run", testing::_, "RUNNING", testing::_)).Times(1);
+    EXPECT_CALL(*mock_db, Heartbeat(testing::_, testing::_)).Times(testing::AtLeast(0));
+    EXPECT_CALL(*mock_db, UpdateRunStatus("ingest-run", testing::_, testing::_, testing::_)).Times(testing::AtLeast(0));
+    EXPECT_CALL(*mock_db, UpdateRunStatus("ingest-run", "SUCCEEDED", 25, testing::_)).Times(1);
+    EXPECT_CALL(*mock_db, BatchInsertTelemetry(testing::_))
+        .WillRepeatedly([&](const std::vector<TelemetryRecord>& records) {
+            std::lock_guard<std::mutex> lock(mu);
+            inserted += records.size();
+        });
+
+    TelemetryServiceImpl service([mock_db]() { return mock_db; });
+    service.SetIngestFlushRows(10);
+    size_t observed = 0;
+    service.SetIngestObserver([&](const std::vector<TelemetryRecord>& records) {
+        std::lock_guard<std::mutex> lock(mu);
+        observed += records.size();
+    });
+
+    grpc::ServerBuilder builder;
+    builder.RegisterService(&service);
+    auto server = builder.BuildAndStart();
+    auto stub = telemetry::TelemetryService::NewStub(server->InProcessChannel(grpc::ChannelArguments()));
+
+    grpc::ClientContext context;
+    telemetry::IngestResponse response;
+    auto writer = stub->IngestTelemetry(&context, &response);
+    for (int b = 0; b < 5; ++b) {
+        auto batch = MakeBatch(5, 0);
+        if (b == 0) {
+            batch.set_run_id("ingest-run");
+            batch.set_fan_out(true);
+            batch.add_hosts()->set_host_id("host-a");
+        }
+        ASSERT_TRUE(writer->Write(batch));
+    }
+    writer->WritesDone();
+    auto status = writer->Finish();
+    server->Shutdown();
+
+    ASSERT_TRUE(status.ok()) << status.error_message();
+    EXPECT_EQ(response.run_id(), "ingest-run");
+    EXPECT_EQ(response.accepted_rows(), 25);
+    EXPECT_EQ(response.batches(), 5);
+    EXPECT_EQ(response.flushes(), 3);
+    EXPECT_EQ(inserted, 25u);
+    EXPECT_EQ(observed, 25u);
+}
+
+TEST(IngestServerTest, CancelledStreamFailsTheRun) {
+    auto mock_db = std::make_shared<MockDbClient>();
+    std::promise<void> created;
+    EXPECT_CALL(*mock_db, CreateRun("cancel-run", testing::_, "RUNNING", testing::_))
+        .WillOnce([&](auto&&...) { created.set_value(); });
+    EXPECT_CALL(*mock_db, Heartbeat(testing::_, testing::_)).Times(testing::AtLeast(0));
+    EXPECT_CALL(*mock_db, BatchInsertTelemetry(testing::_)).Times(testing::AtLeast(0));
+    EXPECT_CALL(*mock_db, UpdateRunStatus("cancel-run", "SUCCEEDED", testing::_, testing::_)).Times(0);
+    EXPECT_CALL(*mock_db, UpdateRunStatus("cancel-run", "FAILED", testing::_, testing::_)).Times(1);
+
+    TelemetryServiceImpl service([mock_db]() { return mock_db; });
+    grpc::ServerBuilder builder;
+    builder.RegisterService(&service);
+    auto server = builder.BuildAndStart();
+    auto stub = telemetry::TelemetryService::NewStub(server->InProcessChannel(grpc::ChannelArguments()));
+
+    grpc::ClientContext context;
+    telemetry::IngestResponse response;
+    auto writer = stub->IngestTelemetry(&context, &response);
+    auto batch = MakeBatch(5, 0);
+    batch.set_run_id("cancel-run");
+    batch.add_hosts()->set_host_id("host-a");
+    ASSERT_TRUE(writer->Write(batch));
+    created.get_future().wait();
+    context.TryCancel();
+    auto status = writer->Finish();
+    server->Shutdown();
+
+    EXPECT_EQ(status.error_code(), grpc::StatusCode::CANCELLED);
+}
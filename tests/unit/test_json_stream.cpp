@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+#include "json_stream.h"
+#include <limits>
+#include <string>
+#include <vector>
+
+using telemetry::api::CollectJsonObject;
+using telemetry::api::JsonStreamAborted;
+using telemetry::api::JsonStreamWriter;
+
+namespace {
+
+auto WriteToString(const nlohmann::json& j, size_t flush_bytes = JsonStreamWriter::kDefaultFlushBytes) -> std::string {
+    std::string text;
+    JsonStreamWriter out([&text](std::string_view chunk) {
+        text.append(chunk);
+        return true;
+    }, flush_bytes);
+    out.Value(j);
+    out.Flush();
+    return text;
+}
+
+} // namespace
+
+TEST(JsonStreamTest, MatchesNlohmannDump) {
+    nlohmann::json j = {
+        {"items", {{{"record_id", 7}, {"score", 1.0}, {"label", true}}, {{"record_id", -3}, {"score", 0.1}}}},
+        {"total", 2},
+        {"big", std::numeric_limits<uint64_t>::max()},
+        {"tiny", 1e-7},
+        {"text", "quote\" slash\\ tab\t nl\n ctl\x01 utf8 \xc3\xa9"},
+        {"empty_obj", nlohmann::json::object()},
+        {"empty_arr", nlohmann::json::array()},
+        {"nothing", nullptr},
+    };
+    auto text = WriteToString(j);
+    EXPECT_EQ(nlohmann::json::parse(text), j);
+    EXPECT_EQ(text, j.dump());
+}
+
+TEST(JsonStreamTest, NonFiniteDoublesBecomeNull) {
+    std::string text = WriteToString({std::numeric_limits<double>::quiet_NaN(),
+                                      std::numeric_limits<double>::infinity(), 2.5});
+    EXPECT_EQ(text, "[null,null,2.5]");
+}
+
+TEST(JsonStreamTest, FlushesInChunksAndReusesBuffer) {
+    std::vector<size_t> chunks;
+    std::string text;
+    JsonStreamWriter out([&](std::string_view chunk) {
+        chunks.push_back(chunk.size());
+        text.append(chunk);
+        return true;
+    }, 256);
+    out.BeginObject().Key("items").BeginArray();
+    for (int i = 0; i < 1000; ++i) {
+        out.BeginObject().Key("id").Int(i).Key("v").Double(i * 0.5).Key("raw").Raw(R"({"a":1})").EndObject();
+    }
+    out.EndArray().Key("count").Int(1000).EndObject();
+    out.Flush();
+
+    EXPECT_GT(chunks.size(), 10U);
+    for (size_t i = 0; i + 1 < chunks.size(); ++i) { EXPECT_LT(chunks[i], 256U + 64U); }
+    EXPECT_EQ(out.BytesWritten(), text.size());
+    auto parsed = nlohmann::json::parse(text);
+    ASSERT_EQ(parsed["items"].size(), 1000U);
+    EXPECT_EQ(parsed["items"][999]["id"], 999);
+    EXPECT_EQ(parsed["items"][3]["raw"]["a"], 1);
+    EXPECT_EQ(parsed["count"], 1000);
+}
+
+TEST(JsonStreamTest, SinkRefusalAborts) {
+    JsonStreamWriter out([](std::string_view) { return false; }, 16);
+    out.BeginArray();
+    EXPECT_THROW({
+        for (int i = 0; i < 100; ++i) { out.String("0123456789"); }
+    }, JsonStreamAborted);
+}
+
+TEST(JsonStreamTest, CollectJsonObjectBuildsDom) {
+    auto j = CollectJsonObject([](JsonStreamWriter& out) {
+        out.Key("a").Int(1);
+        out.Fields({{"b", "x"}, {"c", {1, 2}}});
+    });
+    EXPECT_EQ(j, (nlohmann::json{{"a", 1}, {"b", "x"}, {"c", {1, 2}}}));
+}
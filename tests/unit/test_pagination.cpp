@@ -13,3 +13,31 @@ TEST(PaginationTest, HasMoreFallsBackToLimitWhenTotalMissing) {
     EXPECT_TRUE(HasMore(20, 0, 20, std::nullopt));
     EXPECT_FALSE(HasMore(20, 0, 10, std::nullopt));
 }
+
+TEST(PaginationTest, SearchCursorRoundTrips) {
+    using telemetry::api::DecodeSearchCursor;
+    using telemetry::api::EncodeSearchCursor;
+    telemetry::api::SearchCursor cursor{1770076800123456LL, 987654321L, "asc"};
+    auto token = EncodeSearchCursor(cursor);
+    EXPECT_EQ(token.find_first_not_of("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_"), std::string::npos);
+    auto decoded = DecodeSearchCursor(token);
+    ASSERT_TRUE(decoded.has_value());
+    EXPECT_EQ(decoded->ts_us, cursor.ts_us);
+    EXPECT_EQ(decoded->record_id, cursor.record_id);
+    EXPECT_EQ(decoded->sort_order, "asc");
+
+    auto negative = DecodeSearchCursor(EncodeSearchCursor({-5, 1, "desc"}));
+    ASSERT_TRUE(negative.has_value());
+    EXPECT_EQ(negative->ts_us, -5);
+}
+
+TEST(PaginationTest, SearchCursorRejectsTamperedTokens) {
+    using telemetry::api::DecodeSearchCursor;
+    EXPECT_FALSE(DecodeSearchCursor("").has_value());
+    EXPECT_FALSE(DecodeSearchCursor("not a cursor!").has_value());
+    // Valid base64url, wrong payloads.
+    EXPECT_FALSE(DecodeSearchCursor("djI6MToyOmFzYw").has_value());       // v2:1:2:asc
+    EXPECT_FALSE(DecodeSearchCursor("djE6MXg6Mjphc2M").has_value());      // v1:1x:2:asc
+    EXPECT_FALSE(DecodeSearchCursor("djE6MToyOnVw").has_value());         // v1:1:2:up
+    EXPECT_TRUE(DecodeSearchCursor("djE6MToyOmFzYw").has_value());        // v1:1:2:asc
+}
@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+#include "partition_manager.h"
+#include <atomic>
+#include <cstdlib>
+#include <stdexcept>
+#include <thread>
+
+using telemetry::partitions::ExpiredMonths;
+using telemetry::partitions::MonthPartition;
+using telemetry::partitions::MonthsCovering;
+using telemetry::partitions::ParseMonthPartition;
+using telemetry::partitions::PartitionMaintainer;
+using telemetry::partitions::PartitionPolicy;
+
+TEST(PartitionManagerTest, MonthPartitionNamesAndBounds) {
+    MonthPartition dec{2026, 12};
+    EXPECT_EQ(dec.Name(), "host_telemetry_archival_2026_12");
+    EXPECT_EQ(dec.From(), "2026-12-01");
+    EXPECT_EQ(dec.To(), "2027-01-01");
+    EXPECT_EQ(dec.Next(), (MonthPartition{2027, 1}));
+    EXPECT_EQ(dec.LeafName(3), "host_telemetry_archival_2026_12_p3");
+    EXPECT_EQ(dec.End(), dec.Next().Begin());
+    EXPECT_EQ(telemetry::partitions::MonthOf(dec.Begin()), dec);
+    EXPECT_EQ(telemetry::partitions::MonthOf(dec.End() - std::chrono::seconds(1)), dec);
+}
+
+TEST(PartitionManagerTest, MonthsCoveringSpansYearBoundary) {
+    auto start = MonthPartition{2026, 11}.Begin() + std::chrono::hours(48);
+    auto end = MonthPartition{2027, 2}.Begin();
+    auto months = MonthsCovering(start, end);
+    ASSERT_EQ(months.size(), 4U);
+    EXPECT_EQ(months.front(), (MonthPartition{2026, 11}));
+    EXPECT_EQ(months.back(), (MonthPartition{2027, 2}));
+
+    EXPECT_EQ(MonthsCovering(start, start).size(), 1U);
+    EXPECT_TRUE(MonthsCovering(end, start).empty());
+}
+
+TEST(PartitionManagerTest, ParsesOnlyMonthPartitions) {
+    auto m = ParseMonthPartition("host_telemetry_archival_2026_01");
+    ASSERT_TRUE(m.has_value());
+    EXPECT_EQ(*m, (MonthPartition{2026, 1}));
+
+    EXPECT_FALSE(ParseMonthPartition("host_telemetry_archival_default").has_value());
+    EXPECT_FALSE(ParseMonthPartition("host_telemetry_archival_2026_01_p3").has_value());
+    EXPECT_FALSE(ParseMonthPartition("host_telemetry_archival_2026_13").has_value());
+    EXPECT_FALSE(ParseMonthPartition("other_table_2026_01").has_value());
+}
+
+TEST(PartitionManagerTest, ExpiredMonthsRequireWholeRangeBeforeCutoff) {
+    std::vector<std::string> names = {
+        "host_telemetry_archival_2026_01",
+        "host_telemetry_archival_2026_02",
+        "host_telemetry_archival_2026_03",
+        "host_telemetry_archival_default",
+    };
+    // Mid-February: January is entirely older, February is not.
+    auto cutoff = MonthPartition{2026, 2}.Begin() + std::chrono::hours(24 * 10);
+    auto expired = ExpiredMonths(names, cutoff);
+    ASSERT_EQ(expired.size(), 1U);
+    EXPECT_EQ(expired[0], (MonthPartition{2026, 1}));
+
+    EXPECT_EQ(ExpiredMonths(names, MonthPartition{2026, 3}.Begin()).size(), 2U);
+}
+
+TEST(PartitionManagerTest, ScoreSetPartitionsFollowEnv) {
+    EXPECT_EQ(telemetry::partitions::ScoreSetPartitionName(42), "dataset_scores_42");
+
+    unsetenv("SCORE_SET_PARTITIONS");
+    EXPECT_TRUE(PartitionPolicy::FromEnv().score_set_partitions);
+    setenv("SCORE_SET_PARTITIONS", "false", 1);
+    EXPECT_FALSE(PartitionPolicy::FromEnv().score_set_partitions);
+    setenv("SCORE_SET_PARTITIONS", "1", 1);
+    EXPECT_TRUE(PartitionPolicy::FromEnv().score_set_partitions);
+    unsetenv("SCORE_SET_PARTITIONS");
+}
+
+TEST(PartitionManagerTest, MaintainerSweepsOnStartAndSurvivesFailures) {
+    std::atomic<int> sweeps{0};
+    PartitionMaintainer maintainer([&] {
+        if (sweeps++ == 0) { throw std::runtime_error("db down"); }
+    });
+    maintainer.Start(std::chrono::milliseconds(5));
+    for (int i = 0; i < 200 && sweeps.load() < 3; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    maintainer.Stop();
+    EXPECT_GE(sweeps.load(), 3);
+
+    int after_stop = sweeps.load();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(sweeps.load(), after_stop);
+}
@@ -0,0 +1,50 @@
+#include <gtest/gtest.h>
+#include "detectors/pca_model.h"
+#include <random>
+#include <vector>
+
+#ifndef TELEMETRY_SOURCE_DIR
+#define TELEMETRY_SOURCE_DIR "."
+#endif
+
+using telemetry::anomaly::FeatureVector;
+using telemetry::anomaly::PcaModel;
+
+TEST(PcaModelTest, ScoreBatchMatchesScore) {
+    PcaModel model;
+    model.Load(std::string(TELEMETRY_SOURCE_DIR) + "/artifacts/pca/default/model.json");
+
+    std::mt19937_64 rng(11);
+    std::normal_distribution<double> noise(0.0, 1.0);
+    std::vector<FeatureVector> rows(2000);
+    for (size_t i = 0; i < rows.size(); ++i) {
+        double scale = (i % 50 == 0) ? 40.0 : 1.0; // some clear outliers
+        rows[i].data = {50.0 + 10.0 * scale * noise(rng), 60.0 + 8.0 * noise(rng), 40.0 + 5.0 * noise(rng),
+                        1000.0 + 100.0 * scale * noise(rng), 800.0 + 80.0 * noise(rng)};
+    }
+    std::vector<double> errors(rows.size());
+    std::vector<uint8_t> flags(rows.size());
+    size_t anomalies = model.ScoreBatch(rows.data(), rows.size(), errors.data(), flags.data());
+
+    size_t expected_anomalies = 0;
+    for (size_t i = 0; i < rows.size(); ++i) {
+        auto score = model.Score(rows[i]);
+        EXPECT_DOUBLE_EQ(errors[i], score.reconstruction_error) << "row " << i;
+        EXPECT_EQ(flags[i] != 0, score.is_anomaly) << "row " << i;
+        expected_anomalies += score.is_anomaly ? 1 : 0;
+    }
+    EXPECT_EQ(anomalies, expected_anomalies);
+    EXPECT_GT(anomalies, 0U);
+}
+
+TEST(PcaModelTest, ScoreBatchOnUnloadedModelScoresZero) {
+    PcaModel model;
+    std::vector<FeatureVector> rows(3, FeatureVector{{1.0, 2.0, 3.0, 4.0, 5.0}});
+    std::vector<double> errors(rows.size(), -1.0);
+    std::vector<uint8_t> flags(rows.size(), 1);
+    EXPECT_EQ(model.ScoreBatch(rows.data(), rows.size(), errors.data(), flags.data()), 0U);
+    for (size_t i = 0; i < rows.size(); ++i) {
+        EXPECT_EQ(errors[i], 0.0);
+        EXPECT_EQ(flags[i], 0);
+    }
+}
@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+#include "progress_reporter.h"
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using telemetry::ProgressReporter;
+using telemetry::ProgressSnapshot;
+
+TEST(ProgressReporterTest, CoalescesUpdatesIntoFewFlushes) {
+    std::mutex mu;
+    std::vector<ProgressSnapshot> flushed;
+    std::atomic<int> beats{0};
+    ProgressReporter reporter(
+        [&](const ProgressSnapshot& p) {
+            std::lock_guard<std::mutex> lock(mu);
+            flushed.push_back(p);
+        },
+        [&]() { beats++; },
+        std::chrono::milliseconds(20));
+    reporter.Start();
+
+    for (long i = 1; i <= 10000; ++i) {
+        reporter.Update(i, i * 2);
+        reporter.Beat();
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    reporter.Stop();
+
+    std::lock_guard<std::mutex> lock(mu);
+    ASSERT_FALSE(flushed.empty());
+    EXPECT_LT(flushed.size(), 10u);
+    EXPECT_EQ(flushed.back().rows, 10000);
+    EXPECT_EQ(flushed.back().cursor, 20000);
+}
+
+TEST(ProgressReporterTest, FlushesRowsAndCursorAsOnePair) {
+    std::atomic<int> torn{0};
+    std::atomic<int> flushes{0};
+    ProgressReporter reporter(
+        [&](const ProgressSnapshot& p) {
+            if (p.cursor != p.rows * 2) { torn++; }
+            flushes++;
+        },
+        nullptr, std::chrono::milliseconds(1));
+    reporter.Start();
+    for (long i = 1; i <= 200000; ++i) {
+        reporter.Update(i, i * 2);
+    }
+    reporter.Stop();
+    EXPECT_GT(flushes.load(), 0);
+    EXPECT_EQ(torn.load(), 0);
+}
+
+TEST(ProgressReporterTest, HeartbeatsOnlyWhenLoopSignalsLiveness) {
+    std::atomic<int> flushes{0};
+    std::atomic<int> beats{0};
+    ProgressReporter reporter([&](const ProgressSnapshot&) { flushes++; }, [&]() { beats++; },
+                              std::chrono::milliseconds(10));
+    reporter.Start();
+
+    // Idle loop: nothing should be written.
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(flushes.load(), 0);
+    EXPECT_EQ(beats.load(), 0);
+
+    reporter.Beat();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    reporter.Stop();
+    EXPECT_EQ(flushes.load(), 0);
+    EXPECT_EQ(beats.load(), 1);
+}
+
+TEST(ProgressReporterTest, FlushNowWritesPendingOnCallerThread) {
+    ProgressSnapshot last;
+    int flushes = 0;
+    ProgressReporter reporter([&](const ProgressSnapshot& p) { last = p; flushes++; }, nullptr,
+                              std::chrono::hours(1));
+    reporter.Update(42, 7);
+    reporter.FlushNow();
+    reporter.FlushNow(); // no change since the last flush
+    EXPECT_EQ(flushes, 1);
+    EXPECT_EQ(last.rows, 42);
+    EXPECT_EQ(last.cursor, 7);
+}
+
+TEST(ProgressReporterTest, FlushErrorsDoNotStopTheReporter) {
+    std::atomic<int> calls{0};
+    ProgressReporter reporter(
+        [&](const ProgressSnapshot&) {
+            calls++;
+            throw std::runtime_error("db down");
+        },
+        nullptr, std::chrono::milliseconds(5));
+    reporter.Start();
+    reporter.Update(1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    reporter.Update(2);
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    reporter.Stop();
+    EXPECT_EQ(calls.load(), 2);
+}
@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+#include "rollup.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using telemetry::rollup::BatchAccumulator;
+using telemetry::rollup::CellKey;
+using telemetry::rollup::ChooseResolution;
+using telemetry::rollup::QuantileSketch;
+using telemetry::rollup::Stats;
+
+namespace {
+
+auto ExactQuantile(std::vector<double> values, double q) -> double {
+    std::sort(values.begin(), values.end());
+    auto rank = std::max<size_t>(1, static_cast<size_t>(std::ceil(q * static_cast<double>(values.size()))));
+    return values[rank - 1];
+}
+
+} // namespace
+
+TEST(RollupTest, SketchQuantilesWithinRelativeAccuracy) {
+    std::mt19937_64 rng(7);
+    std::uniform_real_distribution<double> dist(0.5, 100.0);
+    std::vector<double> values;
+    QuantileSketch sketch;
+    for (int i = 0; i < 5000; ++i) {
+        double v = dist(rng);
+        values.push_back(v);
+        sketch.Add(v);
+    }
+    for (double q : {0.01, 0.5, 0.95, 0.99}) {
+        double exact = ExactQuantile(values, q);
+        EXPECT_NEAR(sketch.Quantile(q), exact, exact * QuantileSketch::kRelativeAccuracy) << "q=" << q;
+    }
+    EXPECT_EQ(sketch.Count(), 5000);
+}
+
+TEST(RollupTest, MergedSketchMatchesSingleSketch) {
+    QuantileSketch left;
+    QuantileSketch right;
+    QuantileSketch all;
+    for (int i = 0; i < 200; ++i) {
+        double v = 0.25 * i;
+        (i % 2 == 0 ? left : right).Add(v);
+        all.Add(v);
+    }
+    left.Merge(right);
+    EXPECT_EQ(left.Bins(), all.Bins());
+    EXPECT_DOUBLE_EQ(left.Quantile(0.95), all.Quantile(0.95));
+}
+
+TEST(RollupTest, PgArrayRoundTrip) {
+    QuantileSketch sketch;
+    sketch.Add(0.0);
+    sketch.Add(42.0, 3);
+    auto text = sketch.ToPgArray();
+    EXPECT_EQ(text.front(), '{');
+    auto parsed = QuantileSketch::FromPgArray(text);
+    EXPECT_EQ(parsed.Bins(), sketch.Bins());
+    EXPECT_EQ(parsed.Count(), 4);
+    EXPECT_EQ(QuantileSketch::FromPgArray("{}").Count(), 0);
+    EXPECT_THROW(QuantileSketch::FromPgArray("{1,x}"), std::invalid_argument);
+    EXPECT_THROW(QuantileSketch::FromPgArray("1,2"), std::invalid_argument);
+}
+
+TEST(RollupTest, StatsMergeKeepsExtremes) {
+    Stats a;
+    a.Add(5.0);
+    a.Add(7.0);
+    Stats b;
+    b.Add(-1.0);
+    Stats empty;
+    a.Merge(b);
+    a.Merge(empty);
+    EXPECT_EQ(a.count, 3);
+    EXPECT_DOUBLE_EQ(a.sum, 11.0);
+    EXPECT_DOUBLE_EQ(a.sumsq, 75.0);
+    EXPECT_DOUBLE_EQ(a.min, -1.0);
+    EXPECT_DOUBLE_EQ(a.max, 7.0);
+}
+
+TEST(RollupTest, ChooseResolutionPicksCoarsestAlignedResolution) {
+    EXPECT_EQ(ChooseResolution(3600, std::nullopt, std::nullopt, false), 3600);
+    EXPECT_EQ(ChooseResolution(7200, std::nullopt, std::nullopt, false), 3600);
+    EXPECT_EQ(ChooseResolution(86400 * 7, std::nullopt, std::nullopt, false), 86400);
+    EXPECT_EQ(ChooseResolution(900, std::nullopt, std::nullopt, false), 300);
+    EXPECT_EQ(ChooseResolution(3600, 1800, std::nullopt, false), 300);
+    EXPECT_EQ(ChooseResolution(3600, 0, 3660, false), 60);
+    EXPECT_EQ(ChooseResolution(3600, 30, std::nullopt, false), std::nullopt);
+    EXPECT_EQ(ChooseResolution(45, std::nullopt, std::nullopt, false), std::nullopt);
+    EXPECT_EQ(ChooseResolution(3600, std::nullopt, std::nullopt, true), std::nullopt);
+    EXPECT_EQ(ChooseResolution(0, std::nullopt, std::nullopt, false), std::nullopt);
+}
+
+TEST(RollupTest, AccumulatorBucketsEveryResolution) {
+    BatchAccumulator acc;
+    EXPECT_TRUE(acc.Empty());
+    auto base = std::chrono::system_clock::time_point(std::chrono::seconds(86400 * 100));
+    for (int i = 0; i < 4; ++i) {
+        TelemetryRecord r;
+        r.run_id = "run-1";
+        r.region = "us-east1";
+        r.metric_timestamp = base + std::chrono::seconds(30 * i);
+        r.cpu_usage = 10.0 * (i + 1);
+        r.memory_usage = 1.0;
+        r.disk_utilization = 2.0;
+        r.network_rx_rate = 3.0;
+        r.network_tx_rate = 4.0;
+        acc.Add(r);
+    }
+    const auto& cells = acc.Cells().at("run-1");
+    int64_t day = 86400 * 100;
+    // Two rows per minute bucket, all four in each coarser bucket.
+    EXPECT_EQ(cells.at(CellKey{60, day, "us-east1", false, 0}).count, 2);
+    EXPECT_EQ(cells.at(CellKey{60, day + 60, "us-east1", false, 0}).count, 2);
+    const auto& hourly = cells.at(CellKey{3600, day, "us-east1", false, 0});
+    EXPECT_EQ(hourly.count, 4);
+    EXPECT_DOUBLE_EQ(hourly.sum, 100.0);
+    EXPECT_DOUBLE_EQ(hourly.max, 40.0);
+    EXPECT_EQ(cells.at(CellKey{86400, day, "us-east1", false, 4}).count, 4);
+    EXPECT_EQ(cells.size(), 5U * (2 + 1 + 1 + 1));
+}
+
+TEST(RollupTest, BinCountsBuildTheSameSketchAsValues) {
+    QuantileSketch from_values;
+    QuantileSketch from_bins;
+    for (double v : {0.0, 0.5, 3.0, 3.01, 75.0, 99.9}) {
+        from_values.Add(v);
+        from_bins.AddBin(QuantileSketch::BinIndex(v), 1);
+    }
+    EXPECT_EQ(from_bins.Bins(), from_values.Bins());
+    EXPECT_DOUBLE_EQ(from_bins.Quantile(0.5), from_values.Quantile(0.5));
+
+    auto sql = QuantileSketch::BinIndexSql("cpu_usage");
+    EXPECT_NE(sql.find("ln(cpu_usage"), std::string::npos);
+    EXPECT_NE(sql.find("ELSE 0"), std::string::npos);
+}
@@ -15,8 +15,8 @@ TEST(RouteRegistryTest, BasicInvariants) {
 }
 
 TEST(RouteRegistryTest, ExpectedCount) {
-    // We identified 35 routes in ApiServer
-    EXPECT_EQ(kRequiredRoutes.size(), 35);
+    // We identified 37 routes in ApiServer
+    EXPECT_EQ(kRequiredRoutes.size(), 37);
 }
 
 } // namespace telemetry::api
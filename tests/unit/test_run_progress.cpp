@@ -0,0 +1,47 @@
+#include <gtest/gtest.h>
+#include "run_progress.h"
+#include <thread>
+
+using telemetry::RunProgress;
+using telemetry::RunProgressRegistry;
+
+TEST(RunProgressTest, UpdateBumpsVersionAndWakesWaiters) {
+    RunProgress progress("run-1", "req-1");
+    auto initial = progress.Snapshot();
+    EXPECT_EQ(initial.status, "PENDING");
+
+    std::thread producer([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        progress.Update("RUNNING", 5000);
+    });
+    EXPECT_TRUE(progress.WaitForChange(initial.version, std::chrono::seconds(2)));
+    producer.join();
+
+    auto snap = progress.Snapshot();
+    EXPECT_EQ(snap.status, "RUNNING");
+    EXPECT_EQ(snap.inserted_rows, 5000);
+    EXPECT_EQ(snap.request_id, "req-1");
+    EXPECT_FALSE(progress.IsTerminal());
+    EXPECT_FALSE(progress.WaitForChange(snap.version, std::chrono::milliseconds(10)));
+}
+
+TEST(RunProgressTest, TerminalStatuses) {
+    EXPECT_TRUE(RunProgress::IsTerminalStatus("SUCCEEDED"));
+    EXPECT_TRUE(RunProgress::IsTerminalStatus("FAILED"));
+    EXPECT_TRUE(RunProgress::IsTerminalStatus("CANCELLED"));
+    EXPECT_FALSE(RunProgress::IsTerminalStatus("RUNNING"));
+}
+
+TEST(RunProgressRegistryTest, PrunesExpiredTerminalRunsOnRegister) {
+    RunProgressRegistry registry(std::chrono::seconds(0));
+    auto done = registry.Register("run-done", "");
+    auto live = registry.Register("run-live", "");
+    done->Update("SUCCEEDED", 10);
+    live->Update("RUNNING", 10);
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+    registry.Register("run-new", "");
+    EXPECT_EQ(registry.Find("run-done"), nullptr);
+    EXPECT_NE(registry.Find("run-live"), nullptr);
+    EXPECT_EQ(registry.Size(), 2u);
+}
@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+#include "segment_file.h"
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using telemetry::SegmentCodec;
+using telemetry::SegmentOptions;
+using telemetry::SegmentReader;
+using telemetry::SegmentWriter;
+
+namespace {
+
+class SegmentFileTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        dir_ = std::filesystem::temp_directory_path() /
+               ("segment_test_" + std::to_string(::testing::UnitTest::GetInstance()->random_seed()) + "_" +
+                ::testing::UnitTest::GetInstance()->current_test_info()->name());
+        std::filesystem::remove_all(dir_);
+    }
+    void TearDown() override { std::filesystem::remove_all(dir_); }
+
+    static auto MakeRecords(size_t n) -> std::vector<TelemetryRecord> {
+        std::vector<TelemetryRecord> records;
+        auto base = std::chrono::system_clock::time_point(std::chrono::hours(24 * 365 * 55));
+        for (size_t i = 0; i < n; ++i) {
+            TelemetryRecord r;
+            r.run_id = "run-1";
+            r.host_id = "host-" + std::to_string(i % 3);
+            r.project_id = "proj";
+            r.region = i % 3 == 0 ? "us-east1" : "eu-west1";
+            r.labels_json = R"({"tier":"A"})";
+            r.metric_timestamp = base + std::chrono::seconds(60 * i);
+            r.ingestion_time = r.metric_timestamp + std::chrono::milliseconds(2000 + i);
+            r.cpu_usage = 10.0 + static_cast<double>(i);
+            r.memory_usage = 20.5;
+            r.disk_utilization = 30.25;
+            r.network_rx_rate = 1.0 / static_cast<double>(i + 1);
+            r.network_tx_rate = 4.0;
+            r.is_anomaly = i % 5 == 0;
+            r.anomaly_type = r.is_anomaly ? (i % 10 == 0 ? "POINT_SPIKE" : "COLLECTIVE_BURST") : "";
+            records.push_back(r);
+        }
+        return records;
+    }
+
+    std::filesystem::path dir_;
+};
+
+void ExpectSameRecord(const TelemetryRecord& a, const TelemetryRecord& b) {
+    EXPECT_EQ(a.run_id, b.run_id);
+    EXPECT_EQ(a.host_id, b.host_id);
+    EXPECT_EQ(a.region, b.region);
+    EXPECT_EQ(a.labels_json, b.labels_json);
+    EXPECT_EQ(a.metric_timestamp, b.metric_timestamp);
+    EXPECT_EQ(a.ingestion_time, b.ingestion_time);
+    EXPECT_EQ(a.cpu_usage, b.cpu_usage);
+    EXPECT_EQ(a.network_rx_rate, b.network_rx_rate);
+    EXPECT_EQ(a.is_anomaly, b.is_anomaly);
+    EXPECT_EQ(a.anomaly_type, b.anomaly_type);
+}
+
+} // namespace
+
+TEST_F(SegmentFileTest, RoundTripsAcrossSegmentsWithEachCodec) {
+    for (auto codec : {SegmentCodec::None, SegmentCodec::Zlib}) {
+        SegmentOptions options;
+        options.rows_per_segment = 40;
+        options.codec = codec;
+        auto records = MakeRecords(100);
+        auto out_dir = dir_ / std::to_string(static_cast<int>(codec));
+
+        SegmentWriter writer(out_dir.string(), "run-1", options);
+        writer.Append({records.begin(), records.begin() + 55});
+        writer.Append({records.begin() + 55, records.end()});
+        writer.Finish();
+        writer.Finish();
+        EXPECT_EQ(writer.RowsWritten(), 100);
+        ASSERT_EQ(writer.SegmentPaths().size(), 3u);
+
+        auto paths = SegmentReader::ListSegments(writer.RunDirectory());
+        ASSERT_EQ(paths, writer.SegmentPaths());
+        size_t i = 0;
+        for (const auto& path : paths) {
+            auto data = SegmentReader::Read(path);
+            for (size_t r = 0; r < data.Size(); ++r) { ExpectSameRecord(data.Record(r), records[i++]); }
+        }
+        EXPECT_EQ(i, records.size());
+    }
+}
+
+TEST_F(SegmentFileTest, ZlibShrinksRepetitiveColumns) {
+    SegmentOptions raw;
+    raw.codec = SegmentCodec::None;
+    SegmentOptions zlib;
+    auto records = MakeRecords(2000);
+
+    SegmentWriter a((dir_ / "raw").string(), "run-1", raw);
+    a.Append(records);
+    a.Finish();
+    SegmentWriter b((dir_ / "zlib").string(), "run-1", zlib);
+    b.Append(records);
+    b.Finish();
+    EXPECT_LT(b.BytesWritten(), a.BytesWritten() / 2);
+}
+
+TEST_F(SegmentFileTest, RejectsForeignAndTruncatedFiles) {
+    std::filesystem::create_directories(dir_);
+    auto bogus = (dir_ / "bogus.tseg").string();
+    {
+        std::ofstream f(bogus, std::ios::binary);
+        f << "NOPE and some more bytes";
+    }
+    EXPECT_THROW(SegmentReader::Read(bogus), std::runtime_error);
+
+    SegmentWriter writer(dir_.string(), "run-1");
+    writer.Append(MakeRecords(10));
+    writer.Finish();
+    const auto& path = writer.SegmentPaths().front();
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 7);
+    EXPECT_THROW(SegmentReader::Read(path), std::runtime_error);
+}
@@ -2,6 +2,7 @@
 #include "server.h"
 #include "mocks/mock_db_client.h"
 #include <grpcpp/grpcpp.h>
+#include <atomic>
 #include <thread>
 #include <chrono>
 
@@ -51,3 +52,57 @@ TEST(ServerTest, GetRunReturnsStatus) {
     EXPECT_EQ(resp.run_id(), "test-id");
     EXPECT_EQ(resp.status(), "RUNNING");
 }
+
+TEST(ServerTest, WatchRunStreamsInMemoryProgressWithoutDb) {
+    auto mock_db = std::make_shared<MockDbClient>();
+    std::atomic<bool> release{false};
+    EXPECT_CALL(*mock_db, CreateRun(testing::_, testing::_, testing::_, testing::_))
+        .WillOnce([&](const std::string&, const telemetry::GenerateRequest&, const std::string&, const std::string&) {
+            // Hold the generator until the watcher has attached.
+            while (!release.load()) { std::this_thread::sleep_for(std::chrono::milliseconds(5)); }
+        });
+    EXPECT_CALL(*mock_db, Heartbeat(testing::_, testing::_)).Times(testing::AtLeast(0));
+    EXPECT_CALL(*mock_db, UpdateRunStatus(testing::_, testing::_, testing::_, testing::_)).Times(testing::AtLeast(0));
+    EXPECT_CALL(*mock_db, BatchInsertTelemetry(testing::_)).Times(testing::AtLeast(0));
+    EXPECT_CALL(*mock_db, GetRunStatus(testing::_)).Times(0);
+
+    TelemetryServiceImpl service([mock_db]() { return mock_db; });
+    service.SetWatchInterval(std::chrono::milliseconds(10));
+
+    telemetry::GenerateRequest req;
+    req.set_tier("TEST");
+    req.set_host_count(2);
+    req.set_start_time_iso("2025-01-01T00:00:00Z");
+    req.set_end_time_iso("2025-01-01T00:01:00Z");
+    req.set_interval_seconds(10);
+    telemetry::GenerateResponse gen_resp;
+    grpc::ServerContext gen_context;
+    ASSERT_TRUE(service.GenerateTelemetry(&gen_context, &req, &gen_resp).ok());
+
+    grpc::ServerBuilder builder;
+    builder.RegisterService(&service);
+    auto server = builder.BuildAndStart();
+    auto stub = telemetry::TelemetryService::NewStub(server->InProcessChannel(grpc::ChannelArguments()));
+
+    grpc::ClientContext context;
+    telemetry::WatchRunRequest watch_req;
+    watch_req.set_run_id(gen_resp.run_id());
+    auto reader = stub->WatchRun(&context, watch_req);
+
+    telemetry::RunStatus update;
+    ASSERT_TRUE(reader->Read(&update));
+    EXPECT_EQ(update.run_id(), gen_resp.run_id());
+    release = true;
+
+    std::string last_status = update.status();
+    long last_rows = update.inserted_rows();
+    while (reader->Read(&update)) {
+        last_status = update.status();
+        last_rows = update.inserted_rows();
+    }
+    EXPECT_TRUE(reader->Finish().ok());
+    EXPECT_EQ(last_status, "SUCCEEDED");
+    EXPECT_EQ(last_rows, 12);
+
+    server->Shutdown();
+}
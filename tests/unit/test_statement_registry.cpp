@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+#include "statement_registry.h"
+#include <stdexcept>
+#include <vector>
+
+using telemetry::db::StatementRegistry;
+
+namespace {
+
+// Stands in for pqxx::connection: records what gets prepared on it.
+struct FakeConnection {
+    int pid = 100;
+    bool fail_next_prepare = false;
+    std::vector<std::string> prepared;
+
+    auto backendpid() const -> int { return pid; }
+    auto prepare(const std::string& name, const std::string& /*sql*/) -> void {
+        if (fail_next_prepare) {
+            fail_next_prepare = false;
+            throw std::runtime_error("connection lost");
+        }
+        prepared.push_back(name);
+    }
+};
+
+} // namespace
+
+TEST(StatementRegistryTest, PreparesOncePerConnectionOnFirstUse) {
+    auto& registry = StatementRegistry::Instance();
+    registry.Register("test_lazy_a", "SELECT 1");
+    registry.Register("test_lazy_b", "SELECT 2");
+
+    FakeConnection c1;
+    FakeConnection c2;
+    c2.pid = 101;
+    registry.Attach(&c1, c1.backendpid());
+    registry.Attach(&c2, c2.backendpid());
+    EXPECT_EQ(registry.PreparedCount(&c1), 0U);
+
+    registry.UsePrepared(c1, "test_lazy_a");
+    registry.UsePrepared(c1, "test_lazy_a");
+    registry.UsePrepared(c2, "test_lazy_a");
+    EXPECT_EQ(c1.prepared, std::vector<std::string>{"test_lazy_a"});
+    EXPECT_EQ(c2.prepared, std::vector<std::string>{"test_lazy_a"});
+    EXPECT_EQ(registry.PreparedCount(&c1), 1U);
+
+    auto stats = registry.Stats();
+    EXPECT_EQ(stats["test_lazy_a"].prepares, 2);
+    EXPECT_EQ(stats["test_lazy_a"].execs, 3);
+    EXPECT_EQ(stats["test_lazy_b"].prepares, 0);
+    EXPECT_EQ(stats["test_lazy_b"].execs, 0);
+
+    registry.Forget(&c1);
+    registry.Forget(&c2);
+}
+
+TEST(StatementRegistryTest, RePreparesAfterReconnect) {
+    auto& registry = StatementRegistry::Instance();
+    registry.Register("test_reconnect", "SELECT 3");
+
+    FakeConnection conn;
+    registry.Attach(&conn, conn.backendpid());
+    registry.UsePrepared(conn, "test_reconnect");
+
+    // Same object, new server session.
+    conn.pid = 200;
+    registry.UsePrepared(conn, "test_reconnect");
+    EXPECT_EQ(conn.prepared.size(), 2U);
+
+    // A failed prepare leaves the statement unprepared for the next attempt.
+    conn.pid = 300;
+    conn.fail_next_prepare = true;
+    EXPECT_THROW(registry.UsePrepared(conn, "test_reconnect"), std::runtime_error);
+    EXPECT_EQ(registry.PreparedCount(&conn), 0U);
+    registry.UsePrepared(conn, "test_reconnect");
+    EXPECT_EQ(conn.prepared.size(), 3U);
+
+    // Re-attaching (a new connection at the same address) starts empty.
+    registry.Attach(&conn, 300);
+    EXPECT_EQ(registry.PreparedCount(&conn), 0U);
+    registry.Forget(&conn);
+}
+
+TEST(StatementRegistryTest, RejectsUnknownAndRedefinedStatements) {
+    auto& registry = StatementRegistry::Instance();
+    registry.Register("test_defined", "SELECT 4");
+    EXPECT_NO_THROW(registry.Register("test_defined", "SELECT 4"));
+    EXPECT_THROW(registry.Register("test_defined", "SELECT 5"), std::invalid_argument);
+    EXPECT_TRUE(registry.IsRegistered("test_defined"));
+
+    FakeConnection conn;
+    EXPECT_THROW(registry.UsePrepared(conn, "test_missing"), std::out_of_range);
+    EXPECT_TRUE(conn.prepared.empty());
+    registry.Forget(&conn);
+}
+
+TEST(StatementRegistryTest, ShapesAreKeyedBySqlText) {
+    auto& registry = StatementRegistry::Instance();
+    auto a = registry.RegisterShape("SELECT region, COUNT(*) FROM t WHERE run_id = $1::uuid GROUP BY region");
+    auto again = registry.RegisterShape("SELECT region, COUNT(*) FROM t WHERE run_id = $1::uuid GROUP BY region");
+    auto b = registry.RegisterShape("SELECT host_id, COUNT(*) FROM t WHERE run_id = $1::uuid GROUP BY host_id");
+    ASSERT_TRUE(a.has_value());
+    ASSERT_TRUE(b.has_value());
+    EXPECT_EQ(a, again);
+    EXPECT_NE(a, b);
+    EXPECT_EQ(a->rfind("shape_", 0), 0U);
+    EXPECT_TRUE(registry.IsRegistered(*a));
+
+    FakeConnection conn;
+    registry.Attach(&conn, conn.backendpid());
+    registry.UsePrepared(conn, *a);
+    registry.UsePrepared(conn, *a);
+    EXPECT_EQ(conn.prepared.size(), 1U);
+    registry.Forget(&conn);
+}
@@ -23,3 +23,13 @@ TEST(TimeResolutionTest, PreviousPeriodWindowRejectsInvalidRange) {
     EXPECT_FALSE(PreviousPeriodWindow("", "2026-02-04T00:00:00Z").has_value());
     EXPECT_FALSE(PreviousPeriodWindow("2026-02-04T00:00:00Z", "2026-02-03T00:00:00Z").has_value());
 }
+
+TEST(TimeResolutionTest, ResolvePercentileModeDefaultsToApproxForWideBuckets) {
+    using telemetry::api::ResolvePercentileMode;
+    EXPECT_EQ(ResolvePercentileMode("", 300), "exact");
+    EXPECT_EQ(ResolvePercentileMode("auto", 3600), "approx");
+    EXPECT_EQ(ResolvePercentileMode("", 86400), "approx");
+    EXPECT_EQ(ResolvePercentileMode("exact", 86400), "exact");
+    EXPECT_EQ(ResolvePercentileMode("approx", 60), "approx");
+    EXPECT_FALSE(ResolvePercentileMode("fast", 3600).has_value());
+}